@@ -19,6 +19,10 @@
 #include "libtropic_mbedtls_v4.h"
 #include "lt_aesgcm.h"
 
+#if LT_L3_STREAM_DECRYPT
+#error "LT_L3_STREAM_DECRYPT is not supported by the mbedtls_v4 CAL."
+#endif
+
 /**
  * @brief Initializes MbedTLS AES-GCM context.
  *
@@ -8,6 +8,7 @@
 #include "aes/aes.h"
 #include "aes/aesgcm.h"
 #include "libtropic_common.h"
+#include "libtropic_macros.h"
 #include "libtropic_trezor_crypto.h"
 #include "lt_aesgcm.h"
 
@@ -101,6 +102,67 @@ lt_ret_t lt_aesgcm_decrypt(void *ctx, const uint8_t *iv, const uint32_t iv_len,
     return LT_OK;
 }
 
+lt_ret_t lt_aesgcm_decrypt_start(void *ctx, const uint8_t *iv, const uint32_t iv_len, const uint8_t *add,
+                                 const uint32_t add_len)
+{
+    lt_ctx_trezor_crypto_t *_ctx = (lt_ctx_trezor_crypto_t *)ctx;
+
+    if (gcm_init_message(iv, iv_len, &_ctx->aesgcm_decrypt_ctx) != RETURN_GOOD
+        || gcm_auth_header(add, add_len, &_ctx->aesgcm_decrypt_ctx) != RETURN_GOOD) {
+        return LT_CRYPTO_ERR;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_aesgcm_decrypt_update(void *ctx, const uint8_t *ciphertext, const uint32_t ciphertext_len,
+                                  uint8_t *plaintext, const uint32_t plaintext_size, uint32_t *plaintext_len)
+{
+    lt_ctx_trezor_crypto_t *_ctx = (lt_ctx_trezor_crypto_t *)ctx;
+
+    if (plaintext_size < ciphertext_len) {
+        return LT_PARAM_ERR;
+    }
+
+    // Copy ciphertext into plaintext, as Trezor's gcm_decrypt() works in-place
+    if (plaintext != ciphertext) {
+        memcpy(plaintext, ciphertext, ciphertext_len);
+    }
+
+    if (gcm_decrypt(plaintext, ciphertext_len, &_ctx->aesgcm_decrypt_ctx) != RETURN_GOOD) {
+        return LT_CRYPTO_ERR;
+    }
+    *plaintext_len = ciphertext_len;
+
+    return LT_OK;
+}
+
+lt_ret_t lt_aesgcm_decrypt_finish(void *ctx, const uint8_t *tag, const uint32_t tag_len, uint8_t *plaintext,
+                                  const uint32_t plaintext_size, uint32_t *plaintext_len)
+{
+    lt_ctx_trezor_crypto_t *_ctx = (lt_ctx_trezor_crypto_t *)ctx;
+    uint8_t local_tag[TR01_L3_TAG_SIZE];
+    uint8_t diff = 0;
+
+    LT_UNUSED(plaintext);
+    LT_UNUSED(plaintext_size);
+    *plaintext_len = 0;
+
+    if (tag_len > sizeof(local_tag)) {
+        return LT_PARAM_ERR;
+    }
+
+    if (gcm_compute_tag(local_tag, tag_len, &_ctx->aesgcm_decrypt_ctx) != RETURN_GOOD) {
+        return LT_CRYPTO_ERR;
+    }
+
+    for (uint32_t i = 0; i < tag_len; i++) {
+        diff |= local_tag[i] ^ tag[i];
+    }
+
+    return diff ? LT_CRYPTO_ERR : LT_OK;
+}
+
 lt_ret_t lt_aesgcm_encrypt_deinit(void *ctx)
 {
     lt_ctx_trezor_crypto_t *_ctx = (lt_ctx_trezor_crypto_t *)ctx;
@@ -0,0 +1,90 @@
+/**
+ * @file libtropic_port_emulator.c
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief Port for communication with the in-process TROPIC01 emulator.
+ *
+ * Waits only advance the virtual time of the emulated chip, so nothing blocks.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include "libtropic_port_emulator.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "libtropic_macros.h"
+#include "libtropic_port.h"
+#include "lt_emu_chip.h"
+
+#if LT_USE_INT_PIN
+#error "Interrupt PIN not supported in the emulator port!"
+#endif
+
+lt_ret_t lt_port_init(lt_l2_state_t *s2)
+{
+    lt_dev_emulator_t *dev = (lt_dev_emulator_t *)(s2->device);
+
+    if (!dev->chip) {
+        LT_LOG_ERROR("No emulated chip configured.");
+        return LT_FAIL;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_port_deinit(lt_l2_state_t *s2)
+{
+    LT_UNUSED(s2);
+    return LT_OK;
+}
+
+lt_ret_t lt_port_spi_csn_low(lt_l2_state_t *s2)
+{
+    lt_dev_emulator_t *dev = (lt_dev_emulator_t *)(s2->device);
+    LT_LOG_DEBUG("-- Driving Chip Select to Low.");
+    return lt_emu_chip_csn_low(dev->chip);
+}
+
+lt_ret_t lt_port_spi_csn_high(lt_l2_state_t *s2)
+{
+    lt_dev_emulator_t *dev = (lt_dev_emulator_t *)(s2->device);
+    LT_LOG_DEBUG("-- Driving Chip Select to High.");
+    return lt_emu_chip_csn_high(dev->chip);
+}
+
+lt_ret_t lt_port_spi_transfer(lt_l2_state_t *s2, uint8_t offset, uint16_t tx_data_length, uint32_t timeout_ms)
+{
+    LT_UNUSED(timeout_ms);
+    lt_dev_emulator_t *dev = (lt_dev_emulator_t *)(s2->device);
+
+    if (offset + tx_data_length > TR01_L1_LEN_MAX) {
+        return LT_L1_DATA_LEN_ERROR;
+    }
+
+    LT_LOG_DEBUG("-- Sending data through SPI bus.");
+    return lt_emu_chip_spi_transfer(dev->chip, s2->buff + offset, tx_data_length);
+}
+
+lt_ret_t lt_port_delay(lt_l2_state_t *s2, uint32_t ms)
+{
+    lt_dev_emulator_t *dev = (lt_dev_emulator_t *)(s2->device);
+    LT_LOG_DEBUG("-- Waiting for the target.");
+    lt_emu_chip_wait(dev->chip, ms);
+    return LT_OK;
+}
+
+lt_ret_t lt_port_random_bytes(lt_l2_state_t *s2, void *buff, size_t count)
+{
+    LT_UNUSED(s2);
+
+    uint8_t *buff_ptr = buff;
+    for (size_t i = 0; i < count; i++) {
+        // Number from rand() is guaranteed to have at least 15 bits valid
+        buff_ptr[i] = (uint8_t)(rand() & 0xFF);
+    }
+
+    return LT_OK;
+}
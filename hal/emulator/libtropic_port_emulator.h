@@ -0,0 +1,34 @@
+#ifndef LIBTROPIC_PORT_EMULATOR_H
+#define LIBTROPIC_PORT_EMULATOR_H
+
+/**
+ * @file libtropic_port_emulator.h
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief Port for communication with the in-process TROPIC01 emulator.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include "libtropic_common.h"
+#include "lt_emu_chip.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Device structure for the emulator port.
+ *
+ * @note Public members are meant to be configured by the developer before passing the handle to
+ *       libtropic.
+ */
+typedef struct lt_dev_emulator_t {
+    /** @public @brief Emulated chip, initialized with `lt_emu_chip_init()`. */
+    lt_emu_chip_t *chip;
+} lt_dev_emulator_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LIBTROPIC_PORT_EMULATOR_H
@@ -0,0 +1,798 @@
+/**
+ * @file lt_emu_chip.c
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief Software emulation of TROPIC01: L1, L2 and the Secure Channel Session.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include "lt_emu_chip.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "libtropic_macros.h"
+#include "lt_aesgcm.h"
+#include "lt_asn1_der.h"
+#include "lt_crc16.h"
+#include "lt_crypto_common.h"
+#include "lt_emu_l3.h"
+#include "lt_hkdf.h"
+#include "lt_l1.h"
+#include "lt_l2_api_structs.h"
+#include "lt_l2_frame_check.h"
+#include "lt_secure_memzero.h"
+#include "lt_sha256.h"
+#include "lt_x25519.h"
+
+/** @brief Size of a Get_Info data block. */
+#define LT_EMU_GET_INFO_BLOCK_LEN 128
+/** @brief Size of an L3 Result chunk in an Encrypted_Cmd response (the chip never sends bigger ones). */
+#define LT_EMU_L3_RES_CHUNK_LEN 128
+/** @brief Seed of the PRNG used if none is configured. */
+#define LT_EMU_PRNG_SEED_DEFAULT 0x9e3779b97f4a7c15ULL
+
+/** @brief STPRIV used if none is configured. */
+static const uint8_t stpriv_default[TR01_X25519_KEY_LEN]
+    = {0x58, 0x1d, 0x5e, 0x7d, 0x0b, 0x8c, 0x34, 0x62, 0x9e, 0x17, 0xa3, 0x04, 0xc6, 0x55, 0x2f, 0x91,
+       0x3a, 0xd8, 0x6e, 0x41, 0xf0, 0x27, 0xb5, 0x88, 0x19, 0xcc, 0x63, 0x0a, 0xe4, 0x72, 0x3d, 0x4f};
+
+/** @brief Default FW versions (the most significant byte is the major version). */
+static const uint8_t riscv_fw_ver_default[TR01_L2_GET_INFO_RISCV_FW_SIZE] = {0x00, 0x00, 0x00, 0x02};
+static const uint8_t spect_fw_ver_default[TR01_L2_GET_INFO_SPECT_FW_SIZE] = {0x00, 0x00, 0x00, 0x01};
+#ifdef ABAB
+/** @brief Versions reported in Maintenance mode: RISC-V bootloader 1.0.1 and the dummy SPECT version. */
+static const uint8_t riscv_boot_ver[TR01_L2_GET_INFO_RISCV_FW_SIZE] = {0x00, 0x01, 0x00, 0x81};
+#else
+/** @brief Versions reported in Maintenance mode: RISC-V bootloader 2.0.1 and the dummy SPECT version. */
+static const uint8_t riscv_boot_ver[TR01_L2_GET_INFO_RISCV_FW_SIZE] = {0x00, 0x01, 0x00, 0x82};
+#endif
+static const uint8_t spect_boot_ver[TR01_L2_GET_INFO_SPECT_FW_SIZE] = {0x00, 0x00, 0x00, 0x80};
+
+/** @brief Noise_KK1_25519_AESGCM_SHA256 padded with zeros to 32 bytes. */
+static const uint8_t protocol_name[32]
+    = {'N', 'o', 'i', 's', 'e', '_', 'K', 'K', '1', '_', '2', '5', '5', '1', '9', '_',
+       'A', 'E', 'S', 'G', 'C', 'M', '_', 'S', 'H', 'A', '2', '5', '6', 0x00, 0x00, 0x00};
+
+void lt_emu_random(lt_emu_chip_t *chip, uint8_t *buff, const uint16_t len)
+{
+    // xorshift64*, good enough for an emulator and reproducible.
+    for (uint16_t i = 0; i < len; i++) {
+        uint64_t x = chip->prng;
+        x ^= x >> 12;
+        x ^= x << 25;
+        x ^= x >> 27;
+        chip->prng = x;
+        buff[i] = (uint8_t)((x * 0x2545f4914f6cdd1dULL) >> 56);
+    }
+}
+
+static void advance_us(lt_emu_chip_t *chip, const uint32_t us)
+{
+    chip->now_ns += (uint64_t)us * 1000;
+}
+
+static uint8_t chip_status(const lt_emu_chip_t *chip)
+{
+    if (chip->now_ns < chip->boot_done_ns) {
+        return 0;
+    }
+
+    return TR01_L1_CHIP_MODE_READY_bit | (chip->maintenance ? TR01_L1_CHIP_MODE_STARTUP_bit : 0);
+}
+
+static void nonce_to_iv(const uint32_t nonce, uint8_t *iv)
+{
+    memset(iv, 0, TR01_L3_IV_SIZE);
+    iv[0] = nonce & 0xff;
+    iv[1] = (nonce >> 8) & 0xff;
+    iv[2] = (nonce >> 16) & 0xff;
+    iv[3] = (nonce >> 24) & 0xff;
+}
+
+/**
+ * @brief Prepares an L2 Response, which is ready after the configured L2 latency plus `extra_us`.
+ */
+static void set_rsp(lt_emu_chip_t *chip, const uint8_t status, const uint8_t *data, const uint8_t len,
+                    const uint32_t extra_us)
+{
+    chip->rsp[0] = 0;  // CHIP_STATUS is clocked out live.
+    chip->rsp[1] = status;
+    chip->rsp[2] = len;
+    if (len) {
+        memcpy(&chip->rsp[3], data, len);
+    }
+    add_crc(&chip->rsp[1]);
+    chip->rsp_len = TR01_L1_CHIP_STATUS_SIZE + TR01_L2_STATUS_SIZE + TR01_L2_REQ_RSP_LEN_SIZE + len
+                    + TR01_L2_REQ_RSP_CRC_SIZE;
+    chip->rsp_ready_ns = chip->now_ns + ((uint64_t)chip->config.latency.l2_rsp_us + extra_us) * 1000;
+}
+
+static void session_drop(lt_emu_chip_t *chip)
+{
+    if (chip->session) {
+        lt_ret_t ret = lt_crypto_ctx_deinit(chip->config.crypto_ctx);
+        if (ret != LT_OK) {
+            LT_LOG_ERROR("Emulator: lt_crypto_ctx_deinit() failed, ret=%d", ret);
+        }
+    }
+    chip->session = false;
+    chip->l3_cmd_len = 0;
+    chip->l3_cmd_complete = false;
+    chip->l3_res_len = 0;
+    chip->l3_res_sent = 0;
+}
+
+/**
+ * @brief Computes hash = SHA256(hash || data).
+ */
+static lt_ret_t hash_append(void *ctx, uint8_t *hash, const uint8_t *data, const size_t len)
+{
+    lt_ret_t ret = lt_sha256_start(ctx);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    ret = lt_sha256_update(ctx, hash, LT_SHA256_DIGEST_LENGTH);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    ret = lt_sha256_update(ctx, data, len);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    return lt_sha256_finish(ctx, hash);
+}
+
+/**
+ * @brief Chip side of the Noise KK1 handshake. On success, the Secure Channel Session is established.
+ */
+static lt_ret_t handshake(lt_emu_chip_t *chip, const struct lt_l2_handshake_req_t *req, uint8_t *e_tpub,
+                          uint8_t *t_tauth)
+{
+    void *ctx = chip->config.crypto_ctx;
+    const uint8_t *shipub = chip->nvm.pairing_keys[req->pkey_index];
+    uint8_t etpriv[TR01_X25519_KEY_LEN];
+    uint8_t hash[LT_SHA256_DIGEST_LENGTH];
+    uint8_t shared_secret[TR01_X25519_KEY_LEN];
+    uint8_t output_1[33] = {0}, output_2[32] = {0};
+    uint8_t kauth[TR01_AES256_KEY_LEN], kcmd[TR01_AES256_KEY_LEN], kres[TR01_AES256_KEY_LEN];
+    uint8_t iv[TR01_L3_IV_SIZE] = {0};
+    lt_ret_t ret;
+
+    lt_emu_random(chip, etpriv, sizeof(etpriv));
+    memcpy(e_tpub, etpriv, sizeof(etpriv));
+    ret = lt_X25519_scalarmult(etpriv, e_tpub);
+    if (ret != LT_OK) {
+        goto cleanup;
+    }
+
+    // h = SHA256(protocol_name), then SHiPUB, STPUB, EHPUB, PKEY_INDEX and ETPUB are appended.
+    ret = lt_sha256_init(ctx);
+    if (ret != LT_OK) {
+        goto cleanup;
+    }
+    ret = lt_sha256_start(ctx);
+    if (ret != LT_OK) {
+        goto cleanup;
+    }
+    ret = lt_sha256_update(ctx, protocol_name, sizeof(protocol_name));
+    if (ret != LT_OK) {
+        goto cleanup;
+    }
+    ret = lt_sha256_finish(ctx, hash);
+    if (ret != LT_OK) {
+        goto cleanup;
+    }
+    const struct {
+        const uint8_t *data;
+        size_t len;
+    } transcript[] = {
+        {shipub, TR01_SHIPUB_LEN},
+        {chip->stpub, TR01_STPUB_LEN},
+        {req->e_hpub, TR01_EHPUB_LEN},
+        {&req->pkey_index, sizeof(req->pkey_index)},
+        {e_tpub, TR01_ETPUB_LEN},
+    };
+    for (size_t i = 0; i < sizeof(transcript) / sizeof(transcript[0]); i++) {
+        ret = hash_append(ctx, hash, transcript[i].data, transcript[i].len);
+        if (ret != LT_OK) {
+            goto cleanup;
+        }
+    }
+
+    // ck = HKDF(protocol_name, X25519(ETPRIV, EHPUB), 1)
+    ret = lt_X25519(etpriv, req->e_hpub, shared_secret);
+    if (ret != LT_OK) {
+        goto cleanup;
+    }
+    ret = lt_hkdf(protocol_name, sizeof(protocol_name), shared_secret, sizeof(shared_secret), 1, output_1, output_2);
+    if (ret != LT_OK) {
+        goto cleanup;
+    }
+    // ck = HKDF(ck, X25519(ETPRIV, SHiPUB), 1)
+    ret = lt_X25519(etpriv, shipub, shared_secret);
+    if (ret != LT_OK) {
+        goto cleanup;
+    }
+    ret = lt_hkdf(output_1, sizeof(output_1), shared_secret, sizeof(shared_secret), 1, output_1, output_2);
+    if (ret != LT_OK) {
+        goto cleanup;
+    }
+    // ck, kAUTH = HKDF(ck, X25519(STPRIV, EHPUB), 2)
+    ret = lt_X25519(chip->stpriv, req->e_hpub, shared_secret);
+    if (ret != LT_OK) {
+        goto cleanup;
+    }
+    ret = lt_hkdf(output_1, sizeof(output_1), shared_secret, sizeof(shared_secret), 2, output_1, kauth);
+    if (ret != LT_OK) {
+        goto cleanup;
+    }
+    // kCMD, kRES = HKDF(ck, emptystring, 2)
+    ret = lt_hkdf(output_1, sizeof(output_1), (uint8_t *)"", 0, 2, kcmd, kres);
+    if (ret != LT_OK) {
+        goto cleanup;
+    }
+
+    // T_TAUTH = AES-GCM tag of an empty plaintext with the handshake hash as associated data.
+    ret = lt_aesgcm_encrypt_init(ctx, kauth, sizeof(kauth));
+    if (ret != LT_OK) {
+        goto cleanup;
+    }
+    ret = lt_aesgcm_encrypt(ctx, iv, sizeof(iv), hash, sizeof(hash), (uint8_t *)"", 0, t_tauth, TR01_L3_TAG_SIZE);
+    lt_ret_t ret_deinit = lt_aesgcm_encrypt_deinit(ctx);
+    if (ret == LT_OK) {
+        ret = ret_deinit;
+    }
+    if (ret != LT_OK) {
+        goto cleanup;
+    }
+
+    // The chip decrypts commands with kCMD and encrypts results with kRES.
+    ret = lt_aesgcm_decrypt_init(ctx, kcmd, sizeof(kcmd));
+    if (ret != LT_OK) {
+        goto cleanup;
+    }
+    ret = lt_aesgcm_encrypt_init(ctx, kres, sizeof(kres));
+    if (ret != LT_OK) {
+        lt_ret_t ret_unused = lt_crypto_ctx_deinit(ctx);
+        LT_UNUSED(ret_unused);
+        goto cleanup;
+    }
+
+    chip->session = true;
+    chip->cmd_nonce = 0;
+    chip->res_nonce = 0;
+
+cleanup:
+    lt_secure_memzero(etpriv, sizeof(etpriv));
+    lt_secure_memzero(shared_secret, sizeof(shared_secret));
+    lt_secure_memzero(output_1, sizeof(output_1));
+    lt_secure_memzero(output_2, sizeof(output_2));
+    lt_secure_memzero(kauth, sizeof(kauth));
+    lt_secure_memzero(kcmd, sizeof(kcmd));
+    lt_secure_memzero(kres, sizeof(kres));
+
+    return ret;
+}
+
+static void process_get_info(lt_emu_chip_t *chip)
+{
+    const struct lt_l2_get_info_req_t *req = (const struct lt_l2_get_info_req_t *)chip->mosi;
+    uint8_t data[LT_EMU_GET_INFO_BLOCK_LEN] = {0};
+
+    if (req->req_len != TR01_L2_GET_INFO_REQ_LEN) {
+        set_rsp(chip, TR01_L2_STATUS_GEN_ERR, NULL, 0, 0);
+        return;
+    }
+
+    switch (req->object_id) {
+        case TR01_L2_GET_INFO_REQ_OBJECT_ID_X509_CERTIFICATE: {
+            const uint16_t offset = req->block_index * LT_EMU_GET_INFO_BLOCK_LEN;
+            if (offset >= TR01_L2_GET_INFO_REQ_CERT_SIZE_TOTAL) {
+                set_rsp(chip, TR01_L2_STATUS_GEN_ERR, NULL, 0, 0);
+                return;
+            }
+            // The rest of the certificate store is filled with zeros.
+            if (offset < LT_EMU_CERT_STORE_LEN) {
+                const uint16_t avail = LT_EMU_CERT_STORE_LEN - offset;
+                memcpy(data, &chip->cert_store[offset], avail < sizeof(data) ? avail : sizeof(data));
+            }
+            set_rsp(chip, TR01_L2_STATUS_REQUEST_OK, data, sizeof(data), 0);
+            return;
+        }
+        case TR01_L2_GET_INFO_REQ_OBJECT_ID_CHIP_ID: {
+            struct lt_chip_id_t *chip_id = (struct lt_chip_id_t *)data;
+            chip_id->chip_id_ver[0] = 0x01;
+            memcpy(chip_id->silicon_rev, "EMU0", sizeof(chip_id->silicon_rev));
+            chip_id->packg_type_id[0] = TR01_CHIP_PKG_QFN32_ID >> 8;
+            chip_id->packg_type_id[1] = TR01_CHIP_PKG_QFN32_ID & 0xff;
+            set_rsp(chip, TR01_L2_STATUS_REQUEST_OK, data, TR01_L2_GET_INFO_CHIP_ID_SIZE, 0);
+            return;
+        }
+        case TR01_L2_GET_INFO_REQ_OBJECT_ID_RISCV_FW_VERSION:
+            set_rsp(chip, TR01_L2_STATUS_REQUEST_OK, chip->maintenance ? riscv_boot_ver : chip->config.riscv_fw_ver,
+                    TR01_L2_GET_INFO_RISCV_FW_SIZE, 0);
+            return;
+        case TR01_L2_GET_INFO_REQ_OBJECT_ID_SPECT_FW_VERSION:
+            set_rsp(chip, TR01_L2_STATUS_REQUEST_OK, chip->maintenance ? spect_boot_ver : chip->config.spect_fw_ver,
+                    TR01_L2_GET_INFO_SPECT_FW_SIZE, 0);
+            return;
+        case TR01_L2_GET_INFO_REQ_OBJECT_ID_FW_BANK:
+            // FW banks are not emulated, the bootloader reports them empty (bootloader 1.0.1 by a zeroed header).
+            if (chip->maintenance) {
+#ifdef ABAB
+                set_rsp(chip, TR01_L2_STATUS_REQUEST_OK, data, TR01_L2_GET_INFO_FW_HEADER_SIZE_BOOT_V1, 0);
+#else
+                set_rsp(chip, TR01_L2_STATUS_REQUEST_OK, NULL, TR01_L2_GET_INFO_FW_HEADER_SIZE_BOOT_V2_EMPTY_BANK, 0);
+#endif
+            }
+            else {
+                set_rsp(chip, TR01_L2_STATUS_GEN_ERR, NULL, 0, 0);
+            }
+            return;
+        default:
+            set_rsp(chip, TR01_L2_STATUS_GEN_ERR, NULL, 0, 0);
+            return;
+    }
+}
+
+static void process_handshake(lt_emu_chip_t *chip)
+{
+    const struct lt_l2_handshake_req_t *req = (const struct lt_l2_handshake_req_t *)chip->mosi;
+    uint8_t data[TR01_L2_HANDSHAKE_RSP_LEN];
+
+    session_drop(chip);
+
+    if (req->req_len != TR01_L2_HANDSHAKE_REQ_LEN || req->pkey_index >= LT_EMU_PAIRING_KEY_SLOT_CNT
+        || chip->nvm.pairing_key_state[req->pkey_index] != LT_EMU_PAIRING_KEY_WRITTEN) {
+        set_rsp(chip, TR01_L2_STATUS_HSK_ERR, NULL, 0, 0);
+        return;
+    }
+
+    lt_ret_t ret = handshake(chip, req, data, &data[TR01_ETPUB_LEN]);
+    if (ret != LT_OK) {
+        LT_LOG_ERROR("Emulator: handshake failed, ret=%d", ret);
+        set_rsp(chip, TR01_L2_STATUS_HSK_ERR, NULL, 0, 0);
+        return;
+    }
+
+    chip->stats.handshakes++;
+    set_rsp(chip, TR01_L2_STATUS_REQUEST_OK, data, sizeof(data), chip->config.latency.handshake_us);
+}
+
+static void process_encrypted_cmd(lt_emu_chip_t *chip)
+{
+    const struct lt_l2_encrypted_cmd_req_t *req = (const struct lt_l2_encrypted_cmd_req_t *)chip->mosi;
+
+    if (!chip->session) {
+        set_rsp(chip, TR01_L2_STATUS_NO_SESSION, NULL, 0, 0);
+        return;
+    }
+
+    // A new L3 Command starts when the previous one was completed.
+    if (chip->l3_cmd_complete || chip->l3_res_len) {
+        chip->l3_cmd_len = 0;
+        chip->l3_cmd_complete = false;
+        chip->l3_res_len = 0;
+        chip->l3_res_sent = 0;
+    }
+
+    if (chip->l3_cmd_len + req->req_len > sizeof(chip->l3_cmd)) {
+        chip->l3_cmd_len = 0;
+        set_rsp(chip, TR01_L2_STATUS_GEN_ERR, NULL, 0, 0);
+        return;
+    }
+    memcpy(&chip->l3_cmd[chip->l3_cmd_len], req->l3_chunk, req->req_len);
+    chip->l3_cmd_len += req->req_len;
+
+    if (chip->l3_cmd_len < TR01_L3_SIZE_SIZE) {
+        set_rsp(chip, TR01_L2_STATUS_REQUEST_CONT, NULL, 0, 0);
+        return;
+    }
+
+    const uint16_t cmd_size = ((const struct lt_l3_gen_frame_t *)chip->l3_cmd)->cmd_size;
+    const uint32_t packet_size = TR01_L3_SIZE_SIZE + cmd_size + TR01_L3_TAG_SIZE;
+    if (cmd_size > TR01_L3_CMD_CIPHERTEXT_MAX_SIZE || chip->l3_cmd_len > packet_size) {
+        chip->l3_cmd_len = 0;
+        set_rsp(chip, TR01_L2_STATUS_GEN_ERR, NULL, 0, 0);
+        return;
+    }
+    if (chip->l3_cmd_len < packet_size) {
+        set_rsp(chip, TR01_L2_STATUS_REQUEST_CONT, NULL, 0, 0);
+        return;
+    }
+
+    // The command is executed once libtropic reads this response.
+    chip->l3_cmd_complete = true;
+    set_rsp(chip, TR01_L2_STATUS_REQUEST_OK, NULL, 0, 0);
+}
+
+/**
+ * @brief Prepares the next chunk of the L3 Result packet, ready after `extra_us` plus the L2 latency.
+ */
+static void send_l3_res_chunk(lt_emu_chip_t *chip, const uint32_t extra_us)
+{
+    uint16_t len = chip->l3_res_len - chip->l3_res_sent;
+    if (len > LT_EMU_L3_RES_CHUNK_LEN) {
+        len = LT_EMU_L3_RES_CHUNK_LEN;
+    }
+    const uint8_t status
+        = chip->l3_res_sent + len == chip->l3_res_len ? TR01_L2_STATUS_RESULT_OK : TR01_L2_STATUS_RESULT_CONT;
+
+    set_rsp(chip, status, &chip->l3_res[chip->l3_res_sent], (uint8_t)len, extra_us);
+    chip->l3_res_sent += len;
+}
+
+/**
+ * @brief Decrypts and executes the received L3 Command and starts sending its L3 Result.
+ */
+static void execute_l3_cmd(lt_emu_chip_t *chip)
+{
+    struct lt_l3_gen_frame_t *cmd = (struct lt_l3_gen_frame_t *)chip->l3_cmd;
+    uint8_t iv[TR01_L3_IV_SIZE];
+
+    chip->l3_cmd_complete = false;
+    chip->l3_cmd_len = 0;
+
+    nonce_to_iv(chip->cmd_nonce, iv);
+    lt_ret_t ret = lt_aesgcm_decrypt(chip->config.crypto_ctx, iv, sizeof(iv), (uint8_t *)"", 0, cmd->data,
+                                     cmd->cmd_size + TR01_L3_TAG_SIZE, cmd->data, cmd->cmd_size);
+    if (ret != LT_OK) {
+        session_drop(chip);
+        set_rsp(chip, TR01_L2_STATUS_TAG_ERR, NULL, 0, 0);
+        return;
+    }
+    chip->cmd_nonce++;
+
+    chip->stats.l3_commands++;
+    lt_emu_l3_execute(chip);
+
+    struct lt_l3_gen_frame_t *res = (struct lt_l3_gen_frame_t *)chip->l3_res;
+    nonce_to_iv(chip->res_nonce, iv);
+    ret = lt_aesgcm_encrypt(chip->config.crypto_ctx, iv, sizeof(iv), (uint8_t *)"", 0, res->data, res->cmd_size,
+                            res->data, res->cmd_size + TR01_L3_TAG_SIZE);
+    if (ret != LT_OK) {
+        LT_LOG_ERROR("Emulator: encryption of the L3 Result failed, ret=%d", ret);
+        session_drop(chip);
+        set_rsp(chip, TR01_L2_STATUS_GEN_ERR, NULL, 0, 0);
+        return;
+    }
+    chip->res_nonce++;
+
+    chip->l3_res_len = TR01_L3_SIZE_SIZE + res->cmd_size + TR01_L3_TAG_SIZE;
+    chip->l3_res_sent = 0;
+    send_l3_res_chunk(chip, chip->config.latency.l3_cmd_us);
+}
+
+static void reboot(lt_emu_chip_t *chip, const uint8_t startup_id)
+{
+    session_drop(chip);
+    chip->maintenance = startup_id == TR01_MAINTENANCE_REBOOT;
+    chip->rsp_len = 0;
+    chip->last_rsp_len = 0;
+    chip->boot_done_ns = chip->now_ns + (uint64_t)chip->config.latency.boot_us * 1000;
+}
+
+/**
+ * @brief Processes an L2 Request frame received between CSN low and CSN high.
+ */
+static void process_request(lt_emu_chip_t *chip)
+{
+    const uint8_t req_id = chip->mosi[0];
+    const uint8_t req_len = chip->mosi[TR01_L2_REQ_LEN_OFFSET];
+
+    chip->stats.l2_requests++;
+
+    // A chip which is booting does not listen.
+    if (!(chip_status(chip) & TR01_L1_CHIP_MODE_READY_bit)) {
+        return;
+    }
+
+    if (chip->mosi_len < TR01_L2_REQ_ID_SIZE + TR01_L2_REQ_RSP_LEN_SIZE + TR01_L2_REQ_RSP_CRC_SIZE
+        || chip->mosi_len != TR01_L2_REQ_ID_SIZE + TR01_L2_REQ_RSP_LEN_SIZE + req_len + TR01_L2_REQ_RSP_CRC_SIZE) {
+        set_rsp(chip, TR01_L2_STATUS_GEN_ERR, NULL, 0, 0);
+        return;
+    }
+
+    const uint16_t crc_len = TR01_L2_REQ_ID_SIZE + TR01_L2_REQ_RSP_LEN_SIZE + req_len;
+    const uint16_t frame_crc = (uint16_t)(chip->mosi[crc_len] << 8) | chip->mosi[crc_len + 1];
+    if (frame_crc != crc16(chip->mosi, crc_len)) {
+        set_rsp(chip, TR01_L2_STATUS_CRC_ERR, NULL, 0, 0);
+        return;
+    }
+
+    // An unfinished L3 Result is abandoned by any request other than Resend.
+    if (req_id != TR01_L2_RESEND_REQ_ID && req_id != TR01_L2_ENCRYPTED_CMD_REQ_ID) {
+        chip->l3_cmd_len = 0;
+        chip->l3_cmd_complete = false;
+        chip->l3_res_len = 0;
+        chip->l3_res_sent = 0;
+    }
+
+    switch (req_id) {
+        case TR01_L2_GET_INFO_REQ_ID:
+            process_get_info(chip);
+            return;
+
+        case TR01_L2_RESEND_REQ_ID:
+            if (req_len != TR01_L2_RESEND_REQ_LEN || !chip->last_rsp_len) {
+                set_rsp(chip, TR01_L2_STATUS_GEN_ERR, NULL, 0, 0);
+                return;
+            }
+            // A prepared, but unread chunk of the L3 Result is prepared again after the resent response is read.
+            if (chip->rsp_len
+                && (chip->rsp[TR01_L2_STATUS_OFFSET] == TR01_L2_STATUS_RESULT_CONT
+                    || chip->rsp[TR01_L2_STATUS_OFFSET] == TR01_L2_STATUS_RESULT_OK)) {
+                chip->l3_res_sent -= chip->rsp[TR01_L2_RSP_LEN_OFFSET];
+            }
+            memcpy(chip->rsp, chip->last_rsp, chip->last_rsp_len);
+            chip->rsp_len = chip->last_rsp_len;
+            chip->rsp_ready_ns = chip->now_ns + (uint64_t)chip->config.latency.l2_rsp_us * 1000;
+            return;
+
+        case TR01_L2_STARTUP_REQ_ID: {
+            const uint8_t startup_id = chip->mosi[TR01_L2_REQ_LEN_OFFSET + 1];
+            if (req_len != TR01_L2_STARTUP_REQ_LEN
+                || (startup_id != TR01_REBOOT && startup_id != TR01_MAINTENANCE_REBOOT)) {
+                set_rsp(chip, TR01_L2_STATUS_GEN_ERR, NULL, 0, 0);
+                return;
+            }
+            // The chip reboots after the response is read.
+            chip->reboot_pending = startup_id;
+            set_rsp(chip, TR01_L2_STATUS_REQUEST_OK, NULL, TR01_L2_STARTUP_RSP_LEN, 0);
+            return;
+        }
+
+        case TR01_L2_GET_LOG_REQ_ID:
+            // No log messages are produced.
+            set_rsp(chip, req_len == TR01_L2_GET_LOG_REQ_LEN ? TR01_L2_STATUS_REQUEST_OK : TR01_L2_STATUS_GEN_ERR, NULL,
+                    0, 0);
+            return;
+
+        default:
+            break;
+    }
+
+    // The rest of the requests is supported by the Application FW only, bootloader 1.0.1 (ABAB) refuses them with
+    // GEN_ERR, bootloader 2.0.1 (ACAB) does not know them.
+    if (chip->maintenance) {
+#ifdef ABAB
+        set_rsp(chip, TR01_L2_STATUS_GEN_ERR, NULL, 0, 0);
+#else
+        set_rsp(chip, TR01_L2_STATUS_UNKNOWN_ERR, NULL, 0, 0);
+#endif
+        return;
+    }
+
+    switch (req_id) {
+        case TR01_L2_HANDSHAKE_REQ_ID:
+            process_handshake(chip);
+            return;
+
+        case TR01_L2_ENCRYPTED_CMD_REQ_ID:
+            process_encrypted_cmd(chip);
+            return;
+
+        case TR01_L2_ENCRYPTED_SESSION_ABT_ID:
+            session_drop(chip);
+            set_rsp(chip, TR01_L2_STATUS_REQUEST_OK, NULL, TR01_L2_ENCRYPTED_SESSION_ABT_RSP_LEN, 0);
+            return;
+
+        case TR01_L2_SLEEP_REQ_ID:
+            if (req_len != TR01_L2_SLEEP_REQ_LEN) {
+                set_rsp(chip, TR01_L2_STATUS_GEN_ERR, NULL, 0, 0);
+                return;
+            }
+            // The session does not survive the sleep, the chip wakes up on the next CSN.
+            session_drop(chip);
+            set_rsp(chip, TR01_L2_STATUS_REQUEST_OK, NULL, TR01_L2_SLEEP_RSP_LEN, 0);
+            return;
+
+        default:
+            // FW update requests are not emulated.
+            set_rsp(chip, TR01_L2_STATUS_UNKNOWN_ERR, NULL, 0, 0);
+            return;
+    }
+}
+
+/**
+ * @brief Called when libtropic read the pending L2 Response.
+ */
+static void rsp_read(lt_emu_chip_t *chip)
+{
+    memcpy(chip->last_rsp, chip->rsp, chip->rsp_len);
+    chip->last_rsp_len = chip->rsp_len;
+    chip->rsp_len = 0;
+
+    if (chip->reboot_pending) {
+        reboot(chip, chip->reboot_pending);
+        chip->reboot_pending = 0;
+    }
+    else if (chip->l3_cmd_complete) {
+        execute_l3_cmd(chip);
+    }
+    else if (chip->l3_res_sent < chip->l3_res_len) {
+        send_l3_res_chunk(chip, 0);
+    }
+}
+
+lt_ret_t lt_emu_chip_init(lt_emu_chip_t *chip)
+{
+    lt_emu_config_t *cfg = &chip->config;
+    uint8_t zeros[TR01_L2_GET_INFO_RISCV_FW_SIZE] = {0};
+
+    if (!cfg->crypto_ctx) {
+        return LT_PARAM_ERR;
+    }
+
+    memset(&chip->stats, 0, sizeof(chip->stats));
+    chip->now_ns = 0;
+    chip->boot_done_ns = 0;
+    chip->rsp_ready_ns = 0;
+    chip->prng = cfg->seed ? cfg->seed : LT_EMU_PRNG_SEED_DEFAULT;
+    chip->maintenance = false;
+    chip->reboot_pending = 0;
+    chip->csn_low = false;
+    chip->rsp_len = 0;
+    chip->last_rsp_len = 0;
+    chip->session = false;
+    chip->l3_cmd_len = 0;
+    chip->l3_cmd_complete = false;
+    chip->l3_res_len = 0;
+    chip->l3_res_sent = 0;
+
+    if (!memcmp(cfg->riscv_fw_ver, zeros, sizeof(zeros))) {
+        memcpy(cfg->riscv_fw_ver, riscv_fw_ver_default, sizeof(cfg->riscv_fw_ver));
+    }
+    if (!memcmp(cfg->spect_fw_ver, zeros, sizeof(zeros))) {
+        memcpy(cfg->spect_fw_ver, spect_fw_ver_default, sizeof(cfg->spect_fw_ver));
+    }
+
+    lt_ret_t ret = lt_crypto_ctx_init(cfg->crypto_ctx);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    memcpy(chip->stpriv, cfg->stpriv ? cfg->stpriv : stpriv_default, sizeof(chip->stpriv));
+    memcpy(chip->stpub, chip->stpriv, sizeof(chip->stpub));
+    ret = lt_X25519_scalarmult(chip->stpriv, chip->stpub);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    // Certificate store: header followed by LT_NUM_CERTIFICATES certificates of LT_EMU_CERT_LEN bytes. Each one is
+    // just SEQUENCE { SEQUENCE { OID id-X25519 }, BIT STRING key, OCTET STRING filler }, which is enough for libtropic
+    // to find STPUB in the device certificate. The other certificates carry a zero key.
+    uint8_t *p = chip->cert_store;
+    *p++ = LT_CERT_STORE_VERSION;
+    *p++ = LT_NUM_CERTIFICATES;
+    for (int i = 0; i < LT_NUM_CERTIFICATES; i++) {
+        *p++ = LT_EMU_CERT_LEN >> 8;
+        *p++ = LT_EMU_CERT_LEN & 0xff;
+    }
+    for (int i = 0; i < LT_NUM_CERTIFICATES; i++) {
+        static const uint8_t prefix[] = {0x30, 0x82, (LT_EMU_CERT_LEN - 4) >> 8, (LT_EMU_CERT_LEN - 4) & 0xff,
+                                         0x30, 0x05, 0x06, 0x03, (LT_OBJ_ID_CURVEX25519 >> 16) & 0xff,
+                                         (LT_OBJ_ID_CURVEX25519 >> 8) & 0xff, LT_OBJ_ID_CURVEX25519 & 0xff,
+                                         0x03, 0x01 + TR01_STPUB_LEN, 0x00};
+        const uint16_t filler_len = LT_EMU_CERT_LEN - sizeof(prefix) - TR01_STPUB_LEN - 4;
+
+        memcpy(p, prefix, sizeof(prefix));
+        p += sizeof(prefix);
+        if (i == LT_CERT_KIND_DEVICE) {
+            memcpy(p, chip->stpub, TR01_STPUB_LEN);
+        }
+        else {
+            memset(p, 0, TR01_STPUB_LEN);
+        }
+        p += TR01_STPUB_LEN;
+        *p++ = 0x04;
+        *p++ = 0x82;
+        *p++ = filler_len >> 8;
+        *p++ = filler_len & 0xff;
+        memset(p, i, filler_len);
+        p += filler_len;
+    }
+
+    // Erased memories, pairing keys from the configuration.
+    memset(&chip->nvm, 0, sizeof(chip->nvm));
+    memset(chip->nvm.r_config, 0xff, sizeof(chip->nvm.r_config));
+    memset(chip->nvm.i_config, 0xff, sizeof(chip->nvm.i_config));
+    for (int i = 0; i < LT_EMU_PAIRING_KEY_SLOT_CNT; i++) {
+        if (cfg->pairing_keys[i]) {
+            memcpy(chip->nvm.pairing_keys[i], cfg->pairing_keys[i], TR01_SHIPUB_LEN);
+            chip->nvm.pairing_key_state[i] = LT_EMU_PAIRING_KEY_WRITTEN;
+        }
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_emu_chip_deinit(lt_emu_chip_t *chip)
+{
+    session_drop(chip);
+    lt_secure_memzero(chip->stpriv, sizeof(chip->stpriv));
+
+    return lt_crypto_ctx_deinit(chip->config.crypto_ctx);
+}
+
+lt_ret_t lt_emu_chip_csn_low(lt_emu_chip_t *chip)
+{
+    if (chip->csn_low) {
+        return LT_FAIL;
+    }
+
+    chip->csn_low = true;
+    chip->mosi_len = 0;
+    chip->get_response = false;
+    chip->rsp_clocked = false;
+
+    return LT_OK;
+}
+
+lt_ret_t lt_emu_chip_csn_high(lt_emu_chip_t *chip)
+{
+    if (!chip->csn_low) {
+        return LT_OK;
+    }
+    chip->csn_low = false;
+
+    if (chip->get_response) {
+        if (chip->rsp_clocked) {
+            rsp_read(chip);
+        }
+    }
+    else if (chip->mosi_len) {
+        process_request(chip);
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_emu_chip_spi_transfer(lt_emu_chip_t *chip, uint8_t *data, const uint16_t len)
+{
+    if (!chip->csn_low || chip->mosi_len + len > sizeof(chip->mosi)) {
+        return LT_FAIL;
+    }
+
+    for (uint16_t i = 0; i < len; i++) {
+        const uint16_t pos = chip->mosi_len++;
+        chip->mosi[pos] = data[i];
+        chip->now_ns += chip->config.latency.spi_byte_ns;
+
+        if (pos == 0) {
+            chip->get_response = data[i] == TR01_L1_GET_RESPONSE_REQ_ID;
+            data[i] = chip_status(chip);
+        }
+        else if (!chip->get_response) {
+            data[i] = 0;
+        }
+        else {
+            if (pos == 1) {
+                // The response is either complete or not there at all for the whole frame.
+                chip->rsp_clocked = chip->rsp_len && (chip_status(chip) & TR01_L1_CHIP_MODE_READY_bit)
+                                    && chip->now_ns >= chip->rsp_ready_ns;
+                if (!chip->rsp_clocked) {
+                    chip->stats.l2_rsp_not_ready++;
+                }
+            }
+            data[i] = chip->rsp_clocked && pos < chip->rsp_len ? chip->rsp[pos] : TR01_L2_STATUS_NO_RESP;
+        }
+    }
+    chip->stats.spi_bytes += len;
+
+    return LT_OK;
+}
+
+void lt_emu_chip_wait(lt_emu_chip_t *chip, const uint32_t ms)
+{
+    advance_us(chip, ms * 1000);
+}
+
+uint64_t lt_emu_chip_time_ns(const lt_emu_chip_t *chip)
+{
+    return chip->now_ns;
+}
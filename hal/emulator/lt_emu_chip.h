@@ -0,0 +1,279 @@
+#ifndef LT_EMU_CHIP_H
+#define LT_EMU_CHIP_H
+
+/**
+ * @file lt_emu_chip.h
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief Software emulation of TROPIC01 running in the same process as libtropic.
+ *
+ * The emulated chip is driven by the SPI signals only (CSN and transferred bytes) and implements:
+ *  - L1: CHIP_STATUS and the Get_Response frame,
+ *  - L2: framing with CRC, Get_Info (certificate store, chip ID, FW versions), Handshake (Noise KK1), Encrypted_Cmd,
+ *        Encrypted_Session_Abt, Resend, Sleep, Startup and Get_Log,
+ *  - L3: AES-GCM protected commands Ping, Pairing_Key_*, R_Config_*, I_Config_*, R_Mem_Data_*, Random_Value_Get,
+ *        ECC_Key_*, ECDSA_Sign, EDDSA_Sign and MCounter_*.
+ *
+ * Time is virtual: it advances with transferred bytes and with waits of libtropic, never with the wall clock, so
+ * results do not depend on the machine. Latencies of the chip are configured in `lt_emu_latency_t`.
+ *
+ * The Maintenance mode (bootloader) follows the silicon revision libtropic is compiled for (`ABAB` or `ACAB`): its
+ * version, the FW bank headers and the status of requests supported by the Application FW only.
+ *
+ * Not emulated: Mac_And_Destroy, FW update, user access privileges (UAP) and alarms. ECC math is available only when
+ * compiled with `LT_EMULATOR_ECC=1` and trezor_crypto, otherwise ECC_Key_Generate/ECC_Key_Store fail.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "libtropic_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Number of pairing key slots. */
+#define LT_EMU_PAIRING_KEY_SLOT_CNT (TR01_PAIRING_KEY_SLOT_INDEX_3 + 1)
+/** @brief Number of ECC key slots. */
+#define LT_EMU_ECC_SLOT_CNT (TR01_ECC_SLOT_31 + 1)
+/** @brief Number of monotonic counters. */
+#define LT_EMU_MCOUNTER_CNT (TR01_MCOUNTER_INDEX_15 + 1)
+/** @brief Number of User Data slots in R-Memory. */
+#define LT_EMU_R_MEM_SLOT_CNT (TR01_R_MEM_DATA_SLOT_MAX + 1)
+/** @brief Size of a User Data slot with Application FW 2.0.0 and newer. */
+#define LT_EMU_R_MEM_SLOT_SIZE 475
+/** @brief Number of 32-bit words of the configuration space (addresses 0x000-0x1fc). */
+#define LT_EMU_CONFIG_WORDS 128
+/** @brief Length of each emulated certificate. */
+#define LT_EMU_CERT_LEN 256
+/** @brief Length of the certificate store header (version, number of certificates and their lengths). */
+#define LT_EMU_CERT_STORE_HEADER_LEN (2 + 2 * LT_NUM_CERTIFICATES)
+/** @brief Length of the whole certificate store. */
+#define LT_EMU_CERT_STORE_LEN (LT_EMU_CERT_STORE_HEADER_LEN + LT_NUM_CERTIFICATES * LT_EMU_CERT_LEN)
+
+/**
+ * @brief Latencies of the emulated chip. Zero means no latency.
+ */
+typedef struct lt_emu_latency_t {
+    /** @brief Time to clock one byte over SPI in nanoseconds. */
+    uint32_t spi_byte_ns;
+    /** @brief Time between an L2 Request frame and its L2 Response in microseconds. */
+    uint32_t l2_rsp_us;
+    /** @brief Time to compute the Handshake in microseconds (added to `l2_rsp_us`). */
+    uint32_t handshake_us;
+    /** @brief Time to execute an L3 Command in microseconds. */
+    uint32_t l3_cmd_us;
+    /** @brief Time between the Startup request and CHIP_STATUS READY in microseconds. */
+    uint32_t boot_us;
+} lt_emu_latency_t;
+
+/**
+ * @brief Configuration of the emulated chip.
+ */
+typedef struct lt_emu_config_t {
+    /**
+     * @brief Crypto context of the chip (same type as the one of libtropic, e.g. `lt_ctx_trezor_crypto_t`). It must be
+     * a different instance than the one of libtropic, as both keep their own AES-GCM keys.
+     */
+    void *crypto_ctx;
+    /** @brief Private X25519 key of the chip (STPRIV). If NULL, a built-in key is used. */
+    const uint8_t *stpriv;
+    /** @brief Pairing keys (SHiPUB) written at manufacturing. NULL slots are empty. */
+    const uint8_t *pairing_keys[LT_EMU_PAIRING_KEY_SLOT_CNT];
+    /** @brief RISC-V FW version reported by Get_Info. If zero, 2.0.0 is reported. */
+    uint8_t riscv_fw_ver[TR01_L2_GET_INFO_RISCV_FW_SIZE];
+    /** @brief SPECT FW version reported by Get_Info. If zero, 1.0.0 is reported. */
+    uint8_t spect_fw_ver[TR01_L2_GET_INFO_SPECT_FW_SIZE];
+    /** @brief Seed of the chip's PRNG (ephemeral keys, random values, generated ECC keys). */
+    uint64_t seed;
+    /** @brief Latencies of the chip. */
+    lt_emu_latency_t latency;
+} lt_emu_config_t;
+
+/**
+ * @brief Counters of the emulated chip, for tests and benchmarks.
+ */
+typedef struct lt_emu_stats_t {
+    /** @brief Number of bytes transferred over SPI. */
+    uint64_t spi_bytes;
+    /** @brief Number of processed L2 Request frames (including invalid ones). */
+    uint32_t l2_requests;
+    /** @brief Number of Get_Response frames, which found no response ready. */
+    uint32_t l2_rsp_not_ready;
+    /** @brief Number of executed L3 Commands. */
+    uint32_t l3_commands;
+    /** @brief Number of successful Handshakes. */
+    uint32_t handshakes;
+} lt_emu_stats_t;
+
+/** @brief State of a pairing key slot. */
+typedef enum lt_emu_pairing_key_state_t {
+    LT_EMU_PAIRING_KEY_EMPTY = 0,
+    LT_EMU_PAIRING_KEY_WRITTEN,
+    LT_EMU_PAIRING_KEY_INVALID,
+} lt_emu_pairing_key_state_t;
+
+/** @brief ECC key slot. */
+typedef struct lt_emu_ecc_key_t {
+    /** @brief `lt_ecc_curve_type_t`, zero if the slot is empty. */
+    uint8_t curve;
+    /** @brief `lt_ecc_key_origin_t`. */
+    uint8_t origin;
+    /** @brief Private key. */
+    uint8_t priv[TR01_CURVE_PRIVKEY_LEN];
+    /** @brief Public key (X||Y for P256). */
+    uint8_t pub[TR01_CURVE_P256_PUBKEY_LEN];
+} lt_emu_ecc_key_t;
+
+/** @brief Persistent memories of the emulated chip, kept over reboots. */
+typedef struct lt_emu_nvm_t {
+    uint8_t pairing_key_state[LT_EMU_PAIRING_KEY_SLOT_CNT];
+    uint8_t pairing_keys[LT_EMU_PAIRING_KEY_SLOT_CNT][TR01_SHIPUB_LEN];
+    uint32_t r_config[LT_EMU_CONFIG_WORDS];
+    /** @brief Bitmap of R-Config words written since the last erase. */
+    uint32_t r_config_written[LT_EMU_CONFIG_WORDS / 32];
+    uint32_t i_config[LT_EMU_CONFIG_WORDS];
+    lt_emu_ecc_key_t ecc_keys[LT_EMU_ECC_SLOT_CNT];
+    /** @brief Monotonic counters, a counter is initialized if its bit in `mcounter_init` is set. */
+    uint32_t mcounters[LT_EMU_MCOUNTER_CNT];
+    uint16_t mcounter_init;
+    /** @brief Lengths of data in the User Data slots, zero if empty. */
+    uint16_t r_mem_len[LT_EMU_R_MEM_SLOT_CNT];
+    uint8_t r_mem[LT_EMU_R_MEM_SLOT_CNT][LT_EMU_R_MEM_SLOT_SIZE];
+} lt_emu_nvm_t;
+
+/**
+ * @brief Emulated chip.
+ *
+ * @note Public members are meant to be configured before calling `lt_emu_chip_init()`. Zero-initialize the
+ *       structure, so members which are not configured keep their defaults. The structure is large (about 260 kB),
+ *       do not place it on the stack.
+ */
+typedef struct lt_emu_chip_t {
+    /** @public @brief Configuration of the chip. */
+    lt_emu_config_t config;
+    /** @public @brief Counters, can be read and reset at any time. */
+    lt_emu_stats_t stats;
+
+    /** @private @brief Virtual time in nanoseconds. */
+    uint64_t now_ns;
+    /** @private @brief Virtual time when CHIP_STATUS READY is set after a reboot. */
+    uint64_t boot_done_ns;
+    /** @private @brief Virtual time when the pending L2 Response is ready. */
+    uint64_t rsp_ready_ns;
+    /** @private @brief State of the PRNG. */
+    uint64_t prng;
+    /** @private @brief True if the chip runs the bootloader (Maintenance mode). */
+    bool maintenance;
+    /** @private @brief `lt_startup_id_t` of a reboot executed once the Startup response is read, zero if none. */
+    uint8_t reboot_pending;
+
+    /** @private @brief STPRIV and STPUB. */
+    uint8_t stpriv[TR01_X25519_KEY_LEN];
+    uint8_t stpub[TR01_STPUB_LEN];
+    /** @private @brief Certificate store returned by Get_Info. */
+    uint8_t cert_store[LT_EMU_CERT_STORE_LEN];
+
+    /** @private @brief True while CSN is low. */
+    bool csn_low;
+    /** @private @brief Bytes received since CSN went low. */
+    uint16_t mosi_len;
+    uint8_t mosi[TR01_L1_LEN_MAX];
+    /** @private @brief Set when the frame started by CSN low is a Get_Response frame. */
+    bool get_response;
+    /** @private @brief Set if the Get_Response frame clocked out the status of a ready response. */
+    bool rsp_clocked;
+
+    /** @private @brief Pending L2 Response, `rsp[0]` is a placeholder of CHIP_STATUS. */
+    uint8_t rsp[TR01_L1_LEN_MAX];
+    uint16_t rsp_len;
+    /** @private @brief Last L2 Response read by libtropic, for Resend. */
+    uint8_t last_rsp[TR01_L1_LEN_MAX];
+    uint16_t last_rsp_len;
+
+    /** @private @brief True if there is an established Secure Channel Session. */
+    bool session;
+    /** @private @brief Nonces of L3 Commands and L3 Results. */
+    uint32_t cmd_nonce;
+    uint32_t res_nonce;
+    /** @private @brief L3 Command packet assembled from Encrypted_Cmd chunks. */
+    uint8_t l3_cmd[TR01_L3_PACKET_MAX_SIZE];
+    uint16_t l3_cmd_len;
+    /** @private @brief Set when the whole L3 Command packet was received, it is executed once REQUEST_OK is read. */
+    bool l3_cmd_complete;
+    /** @private @brief Encrypted L3 Result packet, sent in Encrypted_Cmd response chunks. */
+    uint8_t l3_res[TR01_L3_PACKET_MAX_SIZE];
+    uint16_t l3_res_len;
+    uint16_t l3_res_sent;
+
+    /** @private @brief Persistent memories. */
+    lt_emu_nvm_t nvm;
+} lt_emu_chip_t;
+
+/**
+ * @brief Initializes the chip: computes STPUB, builds the certificate store, erases all memories and writes the
+ * configured pairing keys. The chip starts in Application mode.
+ *
+ * @param chip  Chip with configured public members
+ * @return      LT_OK if success, otherwise returns other error code.
+ */
+lt_ret_t lt_emu_chip_init(lt_emu_chip_t *chip) __attribute__((warn_unused_result));
+
+/**
+ * @brief Deinitializes the chip: drops the session and deinitializes its crypto context.
+ *
+ * @param chip  Chip
+ * @return      LT_OK if success, otherwise returns other error code.
+ */
+lt_ret_t lt_emu_chip_deinit(lt_emu_chip_t *chip) __attribute__((warn_unused_result));
+
+/**
+ * @brief Chip select was driven low.
+ *
+ * @param chip  Chip
+ * @return      LT_OK if success, LT_FAIL if CSN is already low.
+ */
+lt_ret_t lt_emu_chip_csn_low(lt_emu_chip_t *chip) __attribute__((warn_unused_result));
+
+/**
+ * @brief Chip select was driven high, the chip processes the received frame.
+ *
+ * @param chip  Chip
+ * @return      LT_OK if success, otherwise returns other error code.
+ */
+lt_ret_t lt_emu_chip_csn_high(lt_emu_chip_t *chip) __attribute__((warn_unused_result));
+
+/**
+ * @brief SPI transfer of `len` bytes, MISO data replace MOSI data in `data`.
+ *
+ * @param chip  Chip
+ * @param data  MOSI data on input, MISO data on output
+ * @param len   Number of bytes
+ * @return      LT_OK if success, LT_FAIL if CSN is high or the frame is too long.
+ */
+lt_ret_t lt_emu_chip_spi_transfer(lt_emu_chip_t *chip, uint8_t *data, const uint16_t len)
+    __attribute__((warn_unused_result));
+
+/**
+ * @brief Advances the virtual time.
+ *
+ * @param chip  Chip
+ * @param ms    Milliseconds
+ */
+void lt_emu_chip_wait(lt_emu_chip_t *chip, const uint32_t ms);
+
+/**
+ * @brief Returns the virtual time since `lt_emu_chip_init()`.
+ *
+ * @param chip  Chip
+ * @return      Time in nanoseconds.
+ */
+uint64_t lt_emu_chip_time_ns(const lt_emu_chip_t *chip);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LT_EMU_CHIP_H
@@ -0,0 +1,580 @@
+/**
+ * @file lt_emu_l3.c
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief L3 Commands of the emulated chip.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include "lt_emu_l3.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "libtropic_common.h"
+#include "libtropic_macros.h"
+#include "lt_emu_chip.h"
+#include "lt_l3_api_structs.h"
+#include "lt_l3_process.h"
+#include "lt_secure_memzero.h"
+
+#if LT_EMULATOR_ECC
+#include "ecdsa.h"
+#include "ed25519-donna/ed25519.h"
+#include "nist256p1.h"
+#endif
+
+/** @brief Size of the RES_SIZE field followed by RESULT. */
+#define LT_EMU_L3_RES_HDR_SIZE (TR01_L3_SIZE_SIZE + TR01_L3_RESULT_SIZE)
+/** @brief Size of a User Data slot with Application FW older than 2.0.0. */
+#define LT_EMU_R_MEM_SLOT_SIZE_FW_V1 444
+/** @brief Size of RESULT, CURVE, ORIGIN and padding in the ECC_Key_Read result. */
+#define LT_EMU_ECC_KEY_READ_RES_HDR_SIZE 16
+
+/**
+ * @brief Sets an L3 Result, which consists of RESULT followed by `data_len` bytes already written to the result.
+ */
+static void set_res(lt_emu_chip_t *chip, const uint8_t result, const uint16_t data_len)
+{
+    struct lt_l3_gen_frame_t *res = (struct lt_l3_gen_frame_t *)chip->l3_res;
+
+    res->cmd_size = TR01_L3_RESULT_SIZE + data_len;
+    res->data[0] = result;
+}
+
+static bool config_addr_valid(const uint16_t address)
+{
+    return !(address % sizeof(uint32_t)) && address < LT_EMU_CONFIG_WORDS * sizeof(uint32_t);
+}
+
+static uint16_t r_mem_slot_size(const lt_emu_chip_t *chip)
+{
+    // The most significant byte of the version is the major version.
+    return chip->config.riscv_fw_ver[3] < 2 ? LT_EMU_R_MEM_SLOT_SIZE_FW_V1 : LT_EMU_R_MEM_SLOT_SIZE;
+}
+
+static void cmd_ping(lt_emu_chip_t *chip)
+{
+    const struct lt_l3_ping_cmd_t *cmd = (const struct lt_l3_ping_cmd_t *)chip->l3_cmd;
+    struct lt_l3_ping_res_t *res = (struct lt_l3_ping_res_t *)chip->l3_res;
+    const uint16_t len = cmd->cmd_size - TR01_L3_CMD_ID_SIZE;
+
+    memcpy(res->data_out, cmd->data_in, len);
+    set_res(chip, TR01_L3_RESULT_OK, len);
+}
+
+static void cmd_pairing_key_write(lt_emu_chip_t *chip)
+{
+    const struct lt_l3_pairing_key_write_cmd_t *cmd = (const struct lt_l3_pairing_key_write_cmd_t *)chip->l3_cmd;
+
+    if (cmd->cmd_size != TR01_L3_PAIRING_KEY_WRITE_CMD_SIZE || cmd->slot >= LT_EMU_PAIRING_KEY_SLOT_CNT
+        || chip->nvm.pairing_key_state[cmd->slot] != LT_EMU_PAIRING_KEY_EMPTY) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+
+    memcpy(chip->nvm.pairing_keys[cmd->slot], cmd->s_hipub, TR01_SHIPUB_LEN);
+    chip->nvm.pairing_key_state[cmd->slot] = LT_EMU_PAIRING_KEY_WRITTEN;
+    set_res(chip, TR01_L3_RESULT_OK, 0);
+}
+
+static void cmd_pairing_key_read(lt_emu_chip_t *chip)
+{
+    const struct lt_l3_pairing_key_read_cmd_t *cmd = (const struct lt_l3_pairing_key_read_cmd_t *)chip->l3_cmd;
+    struct lt_l3_pairing_key_read_res_t *res = (struct lt_l3_pairing_key_read_res_t *)chip->l3_res;
+
+    if (cmd->cmd_size != TR01_L3_PAIRING_KEY_READ_CMD_SIZE || cmd->slot >= LT_EMU_PAIRING_KEY_SLOT_CNT) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+
+    switch (chip->nvm.pairing_key_state[cmd->slot]) {
+        case LT_EMU_PAIRING_KEY_EMPTY:
+            set_res(chip, TR01_L3_RESULT_SLOT_EMPTY, 0);
+            return;
+        case LT_EMU_PAIRING_KEY_INVALID:
+            set_res(chip, TR01_L3_RESULT_SLOT_INVALID, 0);
+            return;
+        default:
+            memset(res->padding, 0, sizeof(res->padding));
+            memcpy(res->s_hipub, chip->nvm.pairing_keys[cmd->slot], TR01_SHIPUB_LEN);
+            set_res(chip, TR01_L3_RESULT_OK, TR01_L3_PAIRING_KEY_READ_RES_SIZE - TR01_L3_RESULT_SIZE);
+            return;
+    }
+}
+
+static void cmd_pairing_key_invalidate(lt_emu_chip_t *chip)
+{
+    const struct lt_l3_pairing_key_invalidate_cmd_t *cmd
+        = (const struct lt_l3_pairing_key_invalidate_cmd_t *)chip->l3_cmd;
+
+    if (cmd->cmd_size != TR01_L3_PAIRING_KEY_INVALIDATE_CMD_SIZE || cmd->slot >= LT_EMU_PAIRING_KEY_SLOT_CNT) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+
+    // The running session is not affected.
+    lt_secure_memzero(chip->nvm.pairing_keys[cmd->slot], TR01_SHIPUB_LEN);
+    chip->nvm.pairing_key_state[cmd->slot] = LT_EMU_PAIRING_KEY_INVALID;
+    set_res(chip, TR01_L3_RESULT_OK, 0);
+}
+
+static void cmd_r_config_write(lt_emu_chip_t *chip)
+{
+    const struct lt_l3_r_config_write_cmd_t *cmd = (const struct lt_l3_r_config_write_cmd_t *)chip->l3_cmd;
+
+    if (cmd->cmd_size != TR01_L3_R_CONFIG_WRITE_CMD_SIZE || !config_addr_valid(cmd->address)) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+
+    // A written object can be written again only after R_Config_Erase.
+    const uint16_t word = cmd->address / sizeof(uint32_t);
+    if (chip->nvm.r_config_written[word / 32] & (1UL << (word % 32))) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+
+    chip->nvm.r_config[word] = cmd->value;
+    chip->nvm.r_config_written[word / 32] |= 1UL << (word % 32);
+    set_res(chip, TR01_L3_RESULT_OK, 0);
+}
+
+static void cmd_r_config_read(lt_emu_chip_t *chip)
+{
+    const struct lt_l3_r_config_read_cmd_t *cmd = (const struct lt_l3_r_config_read_cmd_t *)chip->l3_cmd;
+    struct lt_l3_r_config_read_res_t *res = (struct lt_l3_r_config_read_res_t *)chip->l3_res;
+
+    if (cmd->cmd_size != TR01_L3_R_CONFIG_READ_CMD_SIZE || !config_addr_valid(cmd->address)) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+
+    memset(res->padding, 0, sizeof(res->padding));
+    res->value = chip->nvm.r_config[cmd->address / sizeof(uint32_t)];
+    set_res(chip, TR01_L3_RESULT_OK, TR01_L3_R_CONFIG_READ_RES_SIZE - TR01_L3_RESULT_SIZE);
+}
+
+static void cmd_r_config_erase(lt_emu_chip_t *chip)
+{
+    const struct lt_l3_r_config_erase_cmd_t *cmd = (const struct lt_l3_r_config_erase_cmd_t *)chip->l3_cmd;
+
+    if (cmd->cmd_size != TR01_L3_R_CONFIG_ERASE_CMD_SIZE) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+
+    memset(chip->nvm.r_config, 0xff, sizeof(chip->nvm.r_config));
+    memset(chip->nvm.r_config_written, 0, sizeof(chip->nvm.r_config_written));
+    set_res(chip, TR01_L3_RESULT_OK, 0);
+}
+
+static void cmd_i_config_write(lt_emu_chip_t *chip)
+{
+    const struct lt_l3_i_config_write_cmd_t *cmd = (const struct lt_l3_i_config_write_cmd_t *)chip->l3_cmd;
+
+    if (cmd->cmd_size != TR01_L3_I_CONFIG_WRITE_CMD_SIZE || !config_addr_valid(cmd->address)
+        || cmd->bit_index > 31) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+
+    // Irreversible: bits can only be cleared.
+    chip->nvm.i_config[cmd->address / sizeof(uint32_t)] &= ~(1UL << cmd->bit_index);
+    set_res(chip, TR01_L3_RESULT_OK, 0);
+}
+
+static void cmd_i_config_read(lt_emu_chip_t *chip)
+{
+    const struct lt_l3_i_config_read_cmd_t *cmd = (const struct lt_l3_i_config_read_cmd_t *)chip->l3_cmd;
+    struct lt_l3_i_config_read_res_t *res = (struct lt_l3_i_config_read_res_t *)chip->l3_res;
+
+    if (cmd->cmd_size != TR01_L3_I_CONFIG_READ_CMD_SIZE || !config_addr_valid(cmd->address)) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+
+    memset(res->padding, 0, sizeof(res->padding));
+    res->value = chip->nvm.i_config[cmd->address / sizeof(uint32_t)];
+    set_res(chip, TR01_L3_RESULT_OK, TR01_L3_I_CONFIG_READ_RES_SIZE - TR01_L3_RESULT_SIZE);
+}
+
+static void cmd_r_mem_data_write(lt_emu_chip_t *chip)
+{
+    const struct lt_l3_r_mem_data_write_cmd_t *cmd = (const struct lt_l3_r_mem_data_write_cmd_t *)chip->l3_cmd;
+
+    if (cmd->cmd_size < TR01_L3_R_MEM_DATA_WRITE_CMD_SIZE_MIN
+        || cmd->cmd_size > TR01_L3_R_MEM_DATA_WRITE_CMD_SIZE_MIN - TR01_R_MEM_DATA_SIZE_MIN + r_mem_slot_size(chip)
+        || cmd->udata_slot >= LT_EMU_R_MEM_SLOT_CNT) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+    if (chip->nvm.r_mem_len[cmd->udata_slot]) {
+        set_res(chip, TR01_L3_RESULT_SLOT_NOT_EMPTY, 0);
+        return;
+    }
+
+    const uint16_t len = cmd->cmd_size - (TR01_L3_R_MEM_DATA_WRITE_CMD_SIZE_MIN - TR01_R_MEM_DATA_SIZE_MIN);
+    memcpy(chip->nvm.r_mem[cmd->udata_slot], cmd->data, len);
+    chip->nvm.r_mem_len[cmd->udata_slot] = len;
+    set_res(chip, TR01_L3_RESULT_OK, 0);
+}
+
+static void cmd_r_mem_data_read(lt_emu_chip_t *chip)
+{
+    const struct lt_l3_r_mem_data_read_cmd_t *cmd = (const struct lt_l3_r_mem_data_read_cmd_t *)chip->l3_cmd;
+
+    if (cmd->cmd_size != TR01_L3_R_MEM_DATA_READ_CMD_SIZE || cmd->udata_slot >= LT_EMU_R_MEM_SLOT_CNT) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+
+    // An empty slot is read as OK without data. The result layout is written directly, as the data of a slot can
+    // exceed the data field of lt_l3_r_mem_data_read_res_t.
+    const uint16_t len = chip->nvm.r_mem_len[cmd->udata_slot];
+    uint8_t *data = &chip->l3_res[LT_EMU_L3_RES_HDR_SIZE];
+    memset(data, 0, TR01_L3_R_MEM_DATA_READ_PADDING_SIZE);
+    memcpy(data + TR01_L3_R_MEM_DATA_READ_PADDING_SIZE, chip->nvm.r_mem[cmd->udata_slot], len);
+    set_res(chip, TR01_L3_RESULT_OK, TR01_L3_R_MEM_DATA_READ_PADDING_SIZE + len);
+}
+
+static void cmd_r_mem_data_erase(lt_emu_chip_t *chip)
+{
+    const struct lt_l3_r_mem_data_erase_cmd_t *cmd = (const struct lt_l3_r_mem_data_erase_cmd_t *)chip->l3_cmd;
+
+    if (cmd->cmd_size != TR01_L3_R_MEM_DATA_ERASE_CMD_SIZE || cmd->udata_slot >= LT_EMU_R_MEM_SLOT_CNT) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+
+    memset(chip->nvm.r_mem[cmd->udata_slot], 0, LT_EMU_R_MEM_SLOT_SIZE);
+    chip->nvm.r_mem_len[cmd->udata_slot] = 0;
+    set_res(chip, TR01_L3_RESULT_OK, 0);
+}
+
+static void cmd_random_value_get(lt_emu_chip_t *chip)
+{
+    const struct lt_l3_random_value_get_cmd_t *cmd = (const struct lt_l3_random_value_get_cmd_t *)chip->l3_cmd;
+    struct lt_l3_random_value_get_res_t *res = (struct lt_l3_random_value_get_res_t *)chip->l3_res;
+
+    if (cmd->cmd_size != TR01_L3_RANDOM_VALUE_GET_CMD_SIZE) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+
+    const uint8_t n_bytes = cmd->n_bytes;
+    memset(res->padding, 0, sizeof(res->padding));
+    lt_emu_random(chip, res->random_data, n_bytes);
+    set_res(chip, TR01_L3_RESULT_OK, sizeof(res->padding) + n_bytes);
+}
+
+/**
+ * @brief Computes the public key of an ECC key slot from its private key.
+ *
+ * @return true if the private key is valid for the curve.
+ */
+static bool ecc_key_derive(lt_emu_ecc_key_t *key)
+{
+#if LT_EMULATOR_ECC
+    if (key->curve == TR01_CURVE_P256) {
+        uint8_t pub65[TR01_CURVE_P256_PUBKEY_LEN + 1];
+        if (ecdsa_get_public_key65(&nist256p1, key->priv, pub65)) {
+            return false;
+        }
+        memcpy(key->pub, &pub65[1], TR01_CURVE_P256_PUBKEY_LEN);
+        return true;
+    }
+    ed25519_publickey(key->priv, key->pub);
+    return true;
+#else
+    LT_UNUSED(key);
+    return false;
+#endif
+}
+
+static void cmd_ecc_key_generate(lt_emu_chip_t *chip)
+{
+    const struct lt_l3_ecc_key_generate_cmd_t *cmd = (const struct lt_l3_ecc_key_generate_cmd_t *)chip->l3_cmd;
+
+    if (cmd->cmd_size != TR01_L3_ECC_KEY_GENERATE_CMD_SIZE || cmd->slot >= LT_EMU_ECC_SLOT_CNT
+        || (cmd->curve != TR01_CURVE_P256 && cmd->curve != TR01_CURVE_ED25519)
+        || chip->nvm.ecc_keys[cmd->slot].curve) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+
+    lt_emu_ecc_key_t *key = &chip->nvm.ecc_keys[cmd->slot];
+    key->curve = cmd->curve;
+    key->origin = TR01_CURVE_GENERATED;
+#if LT_EMULATOR_ECC
+    // Out of range P256 scalars are extremely unlikely, just draw again.
+    do {
+        lt_emu_random(chip, key->priv, sizeof(key->priv));
+    } while (!ecc_key_derive(key));
+#else
+    if (!ecc_key_derive(key)) {
+        memset(key, 0, sizeof(*key));
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+#endif
+    set_res(chip, TR01_L3_RESULT_OK, 0);
+}
+
+static void cmd_ecc_key_store(lt_emu_chip_t *chip)
+{
+    const struct lt_l3_ecc_key_store_cmd_t *cmd = (const struct lt_l3_ecc_key_store_cmd_t *)chip->l3_cmd;
+
+    if (cmd->cmd_size != TR01_L3_ECC_KEY_STORE_CMD_SIZE || cmd->slot >= LT_EMU_ECC_SLOT_CNT
+        || (cmd->curve != TR01_CURVE_P256 && cmd->curve != TR01_CURVE_ED25519)
+        || chip->nvm.ecc_keys[cmd->slot].curve) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+
+    lt_emu_ecc_key_t *key = &chip->nvm.ecc_keys[cmd->slot];
+    key->curve = cmd->curve;
+    key->origin = TR01_CURVE_STORED;
+    memcpy(key->priv, cmd->k, sizeof(key->priv));
+    if (!ecc_key_derive(key)) {
+        lt_secure_memzero(key, sizeof(*key));
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+    set_res(chip, TR01_L3_RESULT_OK, 0);
+}
+
+static void cmd_ecc_key_read(lt_emu_chip_t *chip)
+{
+    const struct lt_l3_ecc_key_read_cmd_t *cmd = (const struct lt_l3_ecc_key_read_cmd_t *)chip->l3_cmd;
+    struct lt_l3_ecc_key_read_res_t *res = (struct lt_l3_ecc_key_read_res_t *)chip->l3_res;
+
+    if (cmd->cmd_size != TR01_L3_ECC_KEY_READ_CMD_SIZE || cmd->slot >= LT_EMU_ECC_SLOT_CNT) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+
+    const lt_emu_ecc_key_t *key = &chip->nvm.ecc_keys[cmd->slot];
+    if (!key->curve) {
+        set_res(chip, TR01_L3_RESULT_INVALID_KEY, 0);
+        return;
+    }
+
+    const uint16_t pub_len
+        = key->curve == TR01_CURVE_P256 ? TR01_CURVE_P256_PUBKEY_LEN : TR01_CURVE_ED25519_PUBKEY_LEN;
+    res->curve = key->curve;
+    res->origin = key->origin;
+    memset(res->padding, 0, sizeof(res->padding));
+    memcpy(res->pub_key, key->pub, pub_len);
+    set_res(chip, TR01_L3_RESULT_OK, LT_EMU_ECC_KEY_READ_RES_HDR_SIZE - TR01_L3_RESULT_SIZE + pub_len);
+}
+
+static void cmd_ecc_key_erase(lt_emu_chip_t *chip)
+{
+    const struct lt_l3_ecc_key_erase_cmd_t *cmd = (const struct lt_l3_ecc_key_erase_cmd_t *)chip->l3_cmd;
+
+    if (cmd->cmd_size != TR01_L3_ECC_KEY_ERASE_CMD_SIZE || cmd->slot >= LT_EMU_ECC_SLOT_CNT) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+
+    lt_secure_memzero(&chip->nvm.ecc_keys[cmd->slot], sizeof(lt_emu_ecc_key_t));
+    set_res(chip, TR01_L3_RESULT_OK, 0);
+}
+
+static void cmd_ecdsa_sign(lt_emu_chip_t *chip)
+{
+    const struct lt_l3_ecdsa_sign_cmd_t *cmd = (const struct lt_l3_ecdsa_sign_cmd_t *)chip->l3_cmd;
+
+    if (cmd->cmd_size != TR01_L3_ECDSA_SIGN_CMD_SIZE || cmd->slot >= LT_EMU_ECC_SLOT_CNT) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+    if (chip->nvm.ecc_keys[cmd->slot].curve != TR01_CURVE_P256) {
+        set_res(chip, TR01_L3_RESULT_INVALID_KEY, 0);
+        return;
+    }
+
+#if LT_EMULATOR_ECC
+    uint8_t sig[2 * TR01_CURVE_PRIVKEY_LEN];
+    struct lt_l3_ecdsa_sign_res_t *res = (struct lt_l3_ecdsa_sign_res_t *)chip->l3_res;
+
+    if (ecdsa_sign_digest(&nist256p1, chip->nvm.ecc_keys[cmd->slot].priv, cmd->msg_hash, sig, NULL, NULL)) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+    memset(res->padding, 0, sizeof(res->padding));
+    memcpy(res->r, sig, sizeof(res->r));
+    memcpy(res->s, &sig[sizeof(res->r)], sizeof(res->s));
+    set_res(chip, TR01_L3_RESULT_OK, TR01_L3_ECDSA_SIGN_RES_SIZE - TR01_L3_RESULT_SIZE);
+#else
+    set_res(chip, TR01_L3_RESULT_FAIL, 0);
+#endif
+}
+
+static void cmd_eddsa_sign(lt_emu_chip_t *chip)
+{
+    const struct lt_l3_eddsa_sign_cmd_t *cmd = (const struct lt_l3_eddsa_sign_cmd_t *)chip->l3_cmd;
+
+    if (cmd->cmd_size < TR01_L3_EDDSA_SIGN_CMD_SIZE_MIN || cmd->cmd_size > TR01_L3_EDDSA_SIGN_CMD_SIZE_MAX
+        || cmd->slot >= LT_EMU_ECC_SLOT_CNT) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+    if (chip->nvm.ecc_keys[cmd->slot].curve != TR01_CURVE_ED25519) {
+        set_res(chip, TR01_L3_RESULT_INVALID_KEY, 0);
+        return;
+    }
+
+#if LT_EMULATOR_ECC
+    uint8_t sig[2 * TR01_CURVE_PRIVKEY_LEN];
+    struct lt_l3_eddsa_sign_res_t *res = (struct lt_l3_eddsa_sign_res_t *)chip->l3_res;
+
+    ed25519_sign(cmd->msg, cmd->cmd_size - TR01_L3_EDDSA_SIGN_CMD_SIZE_MIN, chip->nvm.ecc_keys[cmd->slot].priv, sig);
+    memset(res->padding, 0, sizeof(res->padding));
+    memcpy(res->r, sig, sizeof(res->r));
+    memcpy(res->s, &sig[sizeof(res->r)], sizeof(res->s));
+    set_res(chip, TR01_L3_RESULT_OK, TR01_L3_EDDSA_SIGN_RES_SIZE - TR01_L3_RESULT_SIZE);
+#else
+    set_res(chip, TR01_L3_RESULT_FAIL, 0);
+#endif
+}
+
+static void cmd_mcounter_init(lt_emu_chip_t *chip)
+{
+    const struct lt_l3_mcounter_init_cmd_t *cmd = (const struct lt_l3_mcounter_init_cmd_t *)chip->l3_cmd;
+
+    if (cmd->cmd_size != TR01_L3_MCOUNTER_INIT_CMD_SIZE || cmd->mcounter_index >= LT_EMU_MCOUNTER_CNT
+        || cmd->mcounter_val > TR01_MCOUNTER_VALUE_MAX) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+
+    chip->nvm.mcounters[cmd->mcounter_index] = cmd->mcounter_val;
+    chip->nvm.mcounter_init |= 1U << cmd->mcounter_index;
+    set_res(chip, TR01_L3_RESULT_OK, 0);
+}
+
+static void cmd_mcounter_update(lt_emu_chip_t *chip)
+{
+    const struct lt_l3_mcounter_update_cmd_t *cmd = (const struct lt_l3_mcounter_update_cmd_t *)chip->l3_cmd;
+
+    if (cmd->cmd_size != TR01_L3_MCOUNTER_UPDATE_CMD_SIZE || cmd->mcounter_index >= LT_EMU_MCOUNTER_CNT) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+    if (!(chip->nvm.mcounter_init & (1U << cmd->mcounter_index))) {
+        set_res(chip, TR01_L3_RESULT_COUNTER_INVALID, 0);
+        return;
+    }
+    if (!chip->nvm.mcounters[cmd->mcounter_index]) {
+        set_res(chip, TR01_L3_RESULT_UPDATE_ERR, 0);
+        return;
+    }
+
+    chip->nvm.mcounters[cmd->mcounter_index]--;
+    set_res(chip, TR01_L3_RESULT_OK, 0);
+}
+
+static void cmd_mcounter_get(lt_emu_chip_t *chip)
+{
+    const struct lt_l3_mcounter_get_cmd_t *cmd = (const struct lt_l3_mcounter_get_cmd_t *)chip->l3_cmd;
+    struct lt_l3_mcounter_get_res_t *res = (struct lt_l3_mcounter_get_res_t *)chip->l3_res;
+
+    if (cmd->cmd_size != TR01_L3_MCOUNTER_GET_CMD_SIZE || cmd->mcounter_index >= LT_EMU_MCOUNTER_CNT) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+    if (!(chip->nvm.mcounter_init & (1U << cmd->mcounter_index))) {
+        set_res(chip, TR01_L3_RESULT_COUNTER_INVALID, 0);
+        return;
+    }
+
+    memset(res->padding, 0, sizeof(res->padding));
+    res->mcounter_val = chip->nvm.mcounters[cmd->mcounter_index];
+    set_res(chip, TR01_L3_RESULT_OK, TR01_L3_MCOUNTER_GET_RES_SIZE - TR01_L3_RESULT_SIZE);
+}
+
+void lt_emu_l3_execute(lt_emu_chip_t *chip)
+{
+    const struct lt_l3_gen_frame_t *cmd = (const struct lt_l3_gen_frame_t *)chip->l3_cmd;
+
+    if (cmd->cmd_size < TR01_L3_CMD_ID_SIZE) {
+        set_res(chip, TR01_L3_RESULT_FAIL, 0);
+        return;
+    }
+
+    switch (cmd->data[0]) {
+        case TR01_L3_PING_CMD_ID:
+            cmd_ping(chip);
+            return;
+        case TR01_L3_PAIRING_KEY_WRITE_CMD_ID:
+            cmd_pairing_key_write(chip);
+            return;
+        case TR01_L3_PAIRING_KEY_READ_CMD_ID:
+            cmd_pairing_key_read(chip);
+            return;
+        case TR01_L3_PAIRING_KEY_INVALIDATE_CMD_ID:
+            cmd_pairing_key_invalidate(chip);
+            return;
+        case TR01_L3_R_CONFIG_WRITE_CMD_ID:
+            cmd_r_config_write(chip);
+            return;
+        case TR01_L3_R_CONFIG_READ_CMD_ID:
+            cmd_r_config_read(chip);
+            return;
+        case TR01_L3_R_CONFIG_ERASE_CMD_ID:
+            cmd_r_config_erase(chip);
+            return;
+        case TR01_L3_I_CONFIG_WRITE_CMD_ID:
+            cmd_i_config_write(chip);
+            return;
+        case TR01_L3_I_CONFIG_READ_CMD_ID:
+            cmd_i_config_read(chip);
+            return;
+        case TR01_L3_R_MEM_DATA_WRITE_CMD_ID:
+            cmd_r_mem_data_write(chip);
+            return;
+        case TR01_L3_R_MEM_DATA_READ_CMD_ID:
+            cmd_r_mem_data_read(chip);
+            return;
+        case TR01_L3_R_MEM_DATA_ERASE_CMD_ID:
+            cmd_r_mem_data_erase(chip);
+            return;
+        case TR01_L3_RANDOM_VALUE_GET_CMD_ID:
+            cmd_random_value_get(chip);
+            return;
+        case TR01_L3_ECC_KEY_GENERATE_CMD_ID:
+            cmd_ecc_key_generate(chip);
+            return;
+        case TR01_L3_ECC_KEY_STORE_CMD_ID:
+            cmd_ecc_key_store(chip);
+            return;
+        case TR01_L3_ECC_KEY_READ_CMD_ID:
+            cmd_ecc_key_read(chip);
+            return;
+        case TR01_L3_ECC_KEY_ERASE_CMD_ID:
+            cmd_ecc_key_erase(chip);
+            return;
+        case TR01_L3_ECDSA_SIGN_CMD_ID:
+            cmd_ecdsa_sign(chip);
+            return;
+        case TR01_L3_EDDSA_SIGN_CMD_ID:
+            cmd_eddsa_sign(chip);
+            return;
+        case TR01_L3_MCOUNTER_INIT_CMD_ID:
+            cmd_mcounter_init(chip);
+            return;
+        case TR01_L3_MCOUNTER_UPDATE_CMD_ID:
+            cmd_mcounter_update(chip);
+            return;
+        case TR01_L3_MCOUNTER_GET_CMD_ID:
+            cmd_mcounter_get(chip);
+            return;
+        default:
+            // Mac_And_Destroy is not emulated.
+            set_res(chip, TR01_L3_RESULT_INVALID_CMD, 0);
+            return;
+    }
+}
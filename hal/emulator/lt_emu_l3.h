@@ -0,0 +1,41 @@
+#ifndef LT_EMU_L3_H
+#define LT_EMU_L3_H
+
+/**
+ * @file lt_emu_l3.h
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief L3 Commands of the emulated chip (internal to the emulator).
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <stdint.h>
+
+#include "lt_emu_chip.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Executes the decrypted L3 Command in `chip->l3_cmd` and writes the plaintext L3 Result (including its size)
+ * to `chip->l3_res`.
+ *
+ * @param chip  Chip
+ */
+void lt_emu_l3_execute(lt_emu_chip_t *chip);
+
+/**
+ * @brief Fills a buffer with bytes from the PRNG of the chip.
+ *
+ * @param chip  Chip
+ * @param buff  Buffer
+ * @param len   Number of bytes
+ */
+void lt_emu_random(lt_emu_chip_t *chip, uint8_t *buff, const uint16_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LT_EMU_L3_H
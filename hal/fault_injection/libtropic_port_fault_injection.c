@@ -0,0 +1,317 @@
+/**
+ * @file libtropic_port_fault_injection.c
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief Port wrapping another port and injecting transport faults into the traffic from TROPIC01.
+ *
+ * Faults are applied to what the inner port received, except for the spurious 0xFF: the STATUS and RSP_LEN bytes
+ * are then not clocked from the chip at all, so the chip keeps its response like after a CHIP_STATUS poll.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include "libtropic_port_fault_injection.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "libtropic_macros.h"
+#include "libtropic_port.h"
+#include "lt_l1.h"
+#include "lt_l2_api_structs.h"
+
+/** @brief Seed of the fault generator used when `seed` is 0 (xorshift needs a non-zero state). */
+#define LT_FI_SEED_DEFAULT 0x9e3779b97f4a7c15ULL
+/** @brief Maximal number of bits missing from a truncated frame. */
+#define LT_FI_TRUNCATED_BITS_MAX 16
+
+// Functions of the inner port, renamed at compile time.
+lt_ret_t lt_fi_inner_port_init(lt_l2_state_t *s2);
+lt_ret_t lt_fi_inner_port_deinit(lt_l2_state_t *s2);
+lt_ret_t lt_fi_inner_port_spi_csn_low(lt_l2_state_t *s2);
+lt_ret_t lt_fi_inner_port_spi_csn_high(lt_l2_state_t *s2);
+lt_ret_t lt_fi_inner_port_spi_transfer(lt_l2_state_t *s2, uint8_t offset, uint16_t tx_len, uint32_t timeout_ms);
+lt_ret_t lt_fi_inner_port_delay(lt_l2_state_t *s2, uint32_t ms);
+#if LT_USE_INT_PIN
+lt_ret_t lt_fi_inner_port_delay_on_int(lt_l2_state_t *s2, uint32_t ms);
+#endif
+lt_ret_t lt_fi_inner_port_random_bytes(lt_l2_state_t *s2, void *buff, size_t count);
+
+const char *lt_fi_fault_name(const lt_fi_fault_t fault)
+{
+    switch (fault) {
+        case LT_FI_FAULT_BIT_FLIP:
+            return "bit_flip";
+        case LT_FI_FAULT_TRUNCATED_FRAME:
+            return "truncated_frame";
+        case LT_FI_FAULT_DELAYED_READY:
+            return "delayed_ready";
+        case LT_FI_FAULT_SPURIOUS_NO_RSP:
+            return "spurious_no_rsp";
+        default:
+            return "unknown";
+    }
+}
+
+/** @brief xorshift64*, good enough to spread the faults and reproducible from the seed. */
+static uint64_t fi_next(lt_dev_fault_injection_t *dev)
+{
+    dev->prng ^= dev->prng >> 12;
+    dev->prng ^= dev->prng << 25;
+    dev->prng ^= dev->prng >> 27;
+    return dev->prng * 0x2545f4914f6cdd1dULL;
+}
+
+static bool fi_draw(lt_dev_fault_injection_t *dev, const lt_fi_fault_t fault)
+{
+    if (dev->rate_ppm[fault] == 0) {
+        return false;
+    }
+    return (fi_next(dev) % 1000000u) < dev->rate_ppm[fault];
+}
+
+static uint64_t fi_now(const lt_dev_fault_injection_t *dev)
+{
+    return dev->clock_ns ? dev->clock_ns(dev->clock_ctx) : 0;
+}
+
+static void fi_inject(lt_dev_fault_injection_t *dev, const lt_fi_fault_t fault)
+{
+    LT_LOG_DEBUG("-- Injecting fault: %s.", lt_fi_fault_name(fault));
+    dev->stats[fault].injected++;
+    if (!dev->recovering) {
+        dev->recovering = true;
+        dev->recovery_fault = fault;
+        dev->recovery_start_ns = fi_now(dev);
+    }
+}
+
+static void fi_recovery_end(lt_dev_fault_injection_t *dev, const bool recovered)
+{
+    if (!dev->recovering) {
+        return;
+    }
+
+    lt_fi_stats_t *stats = &dev->stats[dev->recovery_fault];
+    if (recovered) {
+        stats->recovered++;
+    }
+    else {
+        stats->unrecovered++;
+    }
+    if (dev->clock_ns) {
+        stats->time_ns += fi_now(dev) - dev->recovery_start_ns;
+    }
+    dev->recovering = false;
+}
+
+/** @brief Applies a bit flip or truncation to the received L2 Response data and CRC, if drawn. */
+static bool fi_corrupt_rsp(lt_dev_fault_injection_t *dev, uint8_t *data, const uint16_t len)
+{
+    if (len == 0) {
+        return false;
+    }
+    const uint32_t bits = (uint32_t)len * 8;
+
+    if (fi_draw(dev, LT_FI_FAULT_BIT_FLIP)) {
+        const uint32_t bit = fi_next(dev) % bits;
+        data[bit / 8] ^= (uint8_t)(0x80 >> (bit % 8));
+        fi_inject(dev, LT_FI_FAULT_BIT_FLIP);
+        return true;
+    }
+
+    if (fi_draw(dev, LT_FI_FAULT_TRUNCATED_FRAME)) {
+        uint32_t missing = 1 + fi_next(dev) % LT_FI_TRUNCATED_BITS_MAX;
+        if (missing > bits) {
+            missing = bits;
+        }
+        // Missing bits are read as zeros, the frame is only corrupted if some of them were ones.
+        bool changed = false;
+        for (uint32_t bit = bits - missing; bit < bits; bit++) {
+            const uint8_t mask = (uint8_t)(0x80 >> (bit % 8));
+            changed |= (data[bit / 8] & mask) != 0;
+            data[bit / 8] &= (uint8_t)~mask;
+        }
+        if (changed) {
+            fi_inject(dev, LT_FI_FAULT_TRUNCATED_FRAME);
+        }
+        return changed;
+    }
+
+    return false;
+}
+
+lt_ret_t lt_port_init(lt_l2_state_t *s2)
+{
+    lt_dev_fault_injection_t *dev = (lt_dev_fault_injection_t *)(s2->device);
+
+    if (!dev->inner_device) {
+        LT_LOG_ERROR("No inner device configured.");
+        return LT_FAIL;
+    }
+
+    memset(dev->stats, 0, sizeof(dev->stats));
+    dev->prng = dev->seed ? dev->seed : LT_FI_SEED_DEFAULT;
+    dev->first_transfer = false;
+    dev->frame_faked = false;
+    dev->frame_is_read = false;
+    dev->frame_clean = false;
+    dev->recovering = false;
+
+    s2->device = dev->inner_device;
+    lt_ret_t ret = lt_fi_inner_port_init(s2);
+    s2->device = dev;
+
+    return ret;
+}
+
+lt_ret_t lt_port_deinit(lt_l2_state_t *s2)
+{
+    lt_dev_fault_injection_t *dev = (lt_dev_fault_injection_t *)(s2->device);
+
+    fi_recovery_end(dev, false);
+
+    s2->device = dev->inner_device;
+    lt_ret_t ret = lt_fi_inner_port_deinit(s2);
+    s2->device = dev;
+
+    return ret;
+}
+
+lt_ret_t lt_port_spi_csn_low(lt_l2_state_t *s2)
+{
+    lt_dev_fault_injection_t *dev = (lt_dev_fault_injection_t *)(s2->device);
+
+    dev->first_transfer = true;
+    dev->frame_faked = false;
+    dev->frame_is_read = false;
+    dev->frame_clean = false;
+
+    s2->device = dev->inner_device;
+    lt_ret_t ret = lt_fi_inner_port_spi_csn_low(s2);
+    s2->device = dev;
+
+    return ret;
+}
+
+lt_ret_t lt_port_spi_csn_high(lt_l2_state_t *s2)
+{
+    lt_dev_fault_injection_t *dev = (lt_dev_fault_injection_t *)(s2->device);
+
+    // A READY chip read without a fault ends the recovery.
+    if (dev->frame_clean) {
+        fi_recovery_end(dev, true);
+    }
+    dev->frame_faked = false;
+    dev->frame_clean = false;
+
+    s2->device = dev->inner_device;
+    lt_ret_t ret = lt_fi_inner_port_spi_csn_high(s2);
+    s2->device = dev;
+
+    return ret;
+}
+
+lt_ret_t lt_port_spi_transfer(lt_l2_state_t *s2, uint8_t offset, uint16_t tx_data_length, uint32_t timeout_ms)
+{
+    lt_dev_fault_injection_t *dev = (lt_dev_fault_injection_t *)(s2->device);
+
+    if (offset + tx_data_length > TR01_L1_LEN_MAX) {
+        return LT_L1_DATA_LEN_ERROR;
+    }
+
+    if (dev->first_transfer) {
+        dev->first_transfer = false;
+        dev->frame_is_read = (offset == 0 && s2->buff[0] == TR01_L1_GET_RESPONSE_REQ_ID);
+
+        if (!dev->frame_is_read && dev->recovering && s2->buff[TR01_L2_REQ_ID_OFFSET] != TR01_L2_RESEND_REQ_ID) {
+            // Libtropic gave up on the recovery and sends a new L2 Request.
+            fi_recovery_end(dev, false);
+        }
+    }
+
+    if (dev->frame_is_read && offset == TR01_L2_STATUS_OFFSET && !dev->frame_faked
+        && fi_draw(dev, LT_FI_FAULT_SPURIOUS_NO_RSP)) {
+        fi_inject(dev, LT_FI_FAULT_SPURIOUS_NO_RSP);
+        dev->frame_faked = true;
+        dev->frame_clean = false;
+    }
+    if (dev->frame_faked) {
+        memset(s2->buff + offset, 0xff, tx_data_length);
+        return LT_OK;
+    }
+
+    s2->device = dev->inner_device;
+    lt_ret_t ret = lt_fi_inner_port_spi_transfer(s2, offset, tx_data_length, timeout_ms);
+    s2->device = dev;
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    if (dev->recovering) {
+        dev->stats[dev->recovery_fault].transfers++;
+        dev->stats[dev->recovery_fault].bytes += tx_data_length;
+    }
+
+    if (!dev->frame_is_read) {
+        return LT_OK;
+    }
+
+    if (offset == TR01_L2_CHIP_STATUS_OFFSET && (s2->buff[offset] & TR01_L1_CHIP_MODE_READY_bit)) {
+        if (fi_draw(dev, LT_FI_FAULT_DELAYED_READY)) {
+            fi_inject(dev, LT_FI_FAULT_DELAYED_READY);
+            s2->buff[offset] &= (uint8_t)~TR01_L1_CHIP_MODE_READY_bit;
+        }
+        else {
+            dev->frame_clean = true;
+        }
+    }
+    // The L2 Response data and CRC follow CHIP_STATUS, STATUS and RSP_LEN.
+    else if (offset == TR01_L2_RSP_DATA_RSP_CRC_OFFSET && fi_corrupt_rsp(dev, s2->buff + offset, tx_data_length)) {
+        dev->frame_clean = false;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_port_delay(lt_l2_state_t *s2, uint32_t ms)
+{
+    lt_dev_fault_injection_t *dev = (lt_dev_fault_injection_t *)(s2->device);
+
+    if (dev->recovering) {
+        dev->stats[dev->recovery_fault].delay_ms += ms;
+    }
+
+    s2->device = dev->inner_device;
+    lt_ret_t ret = lt_fi_inner_port_delay(s2, ms);
+    s2->device = dev;
+
+    return ret;
+}
+
+#if LT_USE_INT_PIN
+lt_ret_t lt_port_delay_on_int(lt_l2_state_t *s2, uint32_t ms)
+{
+    lt_dev_fault_injection_t *dev = (lt_dev_fault_injection_t *)(s2->device);
+
+    s2->device = dev->inner_device;
+    lt_ret_t ret = lt_fi_inner_port_delay_on_int(s2, ms);
+    s2->device = dev;
+
+    return ret;
+}
+#endif
+
+lt_ret_t lt_port_random_bytes(lt_l2_state_t *s2, void *buff, size_t count)
+{
+    lt_dev_fault_injection_t *dev = (lt_dev_fault_injection_t *)(s2->device);
+
+    s2->device = dev->inner_device;
+    lt_ret_t ret = lt_fi_inner_port_random_bytes(s2, buff, count);
+    s2->device = dev;
+
+    return ret;
+}
@@ -0,0 +1,117 @@
+#ifndef LIBTROPIC_PORT_FAULT_INJECTION_H
+#define LIBTROPIC_PORT_FAULT_INJECTION_H
+
+/**
+ * @file libtropic_port_fault_injection.h
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief Port wrapping another port and injecting transport faults into the traffic from TROPIC01.
+ *
+ * The wrapped (inner) port is compiled with its `lt_port_*` functions renamed to `lt_fi_inner_port_*` (see
+ * `hal/fault_injection/CMakeLists.txt`), this port then implements `lt_port_*` and forwards to it.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "libtropic_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Faults injected by the port. All of them affect the traffic from TROPIC01 only, because libtropic recovers
+ * from errors in the L2 Response frames, but not from errors in L2 Request frames.
+ */
+typedef enum lt_fi_fault_t {
+    /** @brief One bit of the received L2 Response data or CRC is flipped. Recovered by a Resend Request. */
+    LT_FI_FAULT_BIT_FLIP = 0,
+    /** @brief Last bits of the L2 Response frame are missing (read as zeros), like in Erratum
+     * CI_TR01_ERR_2025091800. Recovered by a Resend Request. */
+    LT_FI_FAULT_TRUNCATED_FRAME,
+    /** @brief CHIP_STATUS reports the chip is not READY. Recovered by polling again after a delay. */
+    LT_FI_FAULT_DELAYED_READY,
+    /** @brief The chip is READY, but answers 0xFF (no response). Recovered by polling again after a delay. */
+    LT_FI_FAULT_SPURIOUS_NO_RSP,
+    /** @brief Number of fault kinds, not a fault. */
+    LT_FI_FAULT_CNT
+} lt_fi_fault_t;
+
+/**
+ * @brief Cost of the recovery from one kind of fault.
+ *
+ * Recovery starts when the fault is injected and ends when the chip is next read READY without a fault (reading of
+ * that frame included). Faults injected during a recovery extend it and are accounted to the fault which started it.
+ */
+typedef struct lt_fi_stats_t {
+    /** @brief Number of injected faults. */
+    uint32_t injected;
+    /** @brief Number of finished recoveries. */
+    uint32_t recovered;
+    /** @brief Number of recoveries abandoned by libtropic (a new L2 Request was sent before they finished). */
+    uint32_t unrecovered;
+    /** @brief SPI transfers forwarded to the inner port during recoveries. */
+    uint32_t transfers;
+    /** @brief Bytes transferred by the inner port during recoveries. */
+    uint32_t bytes;
+    /** @brief Time waited in `lt_port_delay()` during recoveries, in milliseconds. */
+    uint32_t delay_ms;
+    /** @brief Duration of the recoveries in nanoseconds, measured by `clock_ns` (0 if it is not set). */
+    uint64_t time_ns;
+} lt_fi_stats_t;
+
+/**
+ * @brief Device structure for the fault injection port.
+ *
+ * @note Public members are meant to be configured by the developer before passing the handle to
+ *       libtropic.
+ */
+typedef struct lt_dev_fault_injection_t {
+    /** @public @brief Device structure of the inner port. */
+    void *inner_device;
+    /** @public @brief Probability of each fault in parts per million. Delayed READY is drawn for every CHIP_STATUS
+     * with READY, spurious 0xFF for every read of STATUS and RSP_LEN, bit flip and truncation for every received L2
+     * Response frame. */
+    uint32_t rate_ppm[LT_FI_FAULT_CNT];
+    /** @public @brief Seed of the fault generator, so runs can be reproduced. */
+    uint64_t seed;
+    /** @public @brief Optional monotonic clock used to measure the duration of recoveries. */
+    uint64_t (*clock_ns)(void *clock_ctx);
+    /** @public @brief Context passed to `clock_ns`. */
+    void *clock_ctx;
+    /** @public @brief Recovery costs per fault kind. Cleared in `lt_port_init()`. */
+    lt_fi_stats_t stats[LT_FI_FAULT_CNT];
+
+    /** @private @brief State of the fault generator. */
+    uint64_t prng;
+    /** @private @brief Next transfer is the first one after CSN low. */
+    bool first_transfer;
+    /** @private @brief Rest of the current CSN frame is faked, transfers are not forwarded to the inner port. */
+    bool frame_faked;
+    /** @private @brief The current CSN frame reads an L2 Response. */
+    bool frame_is_read;
+    /** @private @brief The current CSN frame found the chip READY and no fault was injected into it. */
+    bool frame_clean;
+    /** @private @brief A recovery is in progress. */
+    bool recovering;
+    /** @private @brief Fault which started the recovery in progress. */
+    lt_fi_fault_t recovery_fault;
+    /** @private @brief Timestamp of the start of the recovery in progress. */
+    uint64_t recovery_start_ns;
+} lt_dev_fault_injection_t;
+
+/**
+ * @brief Returns a printable name of the fault.
+ *
+ * @param fault  Fault kind
+ * @return       Name of the fault, "unknown" for an invalid value.
+ */
+const char *lt_fi_fault_name(const lt_fi_fault_t fault);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LIBTROPIC_PORT_FAULT_INJECTION_H
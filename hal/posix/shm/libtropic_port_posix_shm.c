@@ -0,0 +1,211 @@
+/**
+ * @file libtropic_port_posix_shm.c
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief Port for communication with a local TROPIC01 emulator over shared memory (Linux only).
+ *
+ * CSN changes and waits are posted to the request ring without waiting for the server, only SPI transfers wait for
+ * their response. Errors of the posted requests are reported in the response to the next transfer.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include "libtropic_port_posix_shm.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "libtropic_macros.h"
+#include "libtropic_port.h"
+#include "lt_shm_ring.h"
+
+#if LT_USE_INT_PIN
+#error "Interrupt PIN not supported in the shared memory port!"
+#endif
+
+/**
+ * @brief Posts a request to the server.
+ */
+static lt_ret_t post_request(lt_dev_posix_shm_t *dev, const uint8_t tag, const uint8_t *data, const uint16_t len)
+{
+    lt_posix_shm_msg_t *msg;
+
+    lt_ret_t ret = lt_shm_ring_acquire_write(&dev->region->req, LT_SHM_TIMEOUT_MS, &msg);
+    if (ret != LT_OK) {
+        LT_LOG_ERROR("Server does not take requests.");
+        return ret;
+    }
+
+    msg->tag = tag;
+    msg->status = LT_SHM_STATUS_OK;
+    msg->len = len;
+    if (len) {
+        memcpy(msg->payload, data, len);
+    }
+    lt_shm_ring_commit_write(&dev->region->req);
+
+    return LT_OK;
+}
+
+lt_ret_t lt_port_init(lt_l2_state_t *s2)
+{
+    lt_dev_posix_shm_t *dev = (lt_dev_posix_shm_t *)(s2->device);
+    const char *name = dev->shm_name ? dev->shm_name : LT_SHM_DEFAULT_NAME;
+    struct stat st;
+
+    dev->shm_fd = shm_open(name, O_RDWR, 0);
+    if (dev->shm_fd < 0) {
+        LT_LOG_ERROR("Could not open shared memory object %s: %s (%d).", name, strerror(errno), errno);
+        return LT_FAIL;
+    }
+
+    if (fstat(dev->shm_fd, &st) < 0 || (size_t)st.st_size < sizeof(lt_posix_shm_region_t)) {
+        LT_LOG_ERROR("Shared memory object %s has unexpected size.", name);
+        close(dev->shm_fd);
+        return LT_FAIL;
+    }
+
+    void *addr = mmap(NULL, sizeof(lt_posix_shm_region_t), PROT_READ | PROT_WRITE, MAP_SHARED, dev->shm_fd, 0);
+    if (addr == MAP_FAILED) {
+        LT_LOG_ERROR("Could not map shared memory: %s (%d).", strerror(errno), errno);
+        close(dev->shm_fd);
+        return LT_FAIL;
+    }
+    dev->region = addr;
+
+    if (__atomic_load_n(&dev->region->magic, __ATOMIC_ACQUIRE) != LT_SHM_MAGIC
+        || dev->region->version != LT_SHM_VERSION) {
+        LT_LOG_ERROR("Shared memory object %s is not initialized by a compatible server.", name);
+        goto cleanup;
+    }
+
+    uint32_t expected = 0;
+    if (!__atomic_compare_exchange_n(&dev->region->host_attached, &expected, 1, false, __ATOMIC_ACQ_REL,
+                                     __ATOMIC_ACQUIRE)) {
+        LT_LOG_ERROR("Another instance is attached to %s.", name);
+        goto cleanup;
+    }
+
+    // Drop responses a previous instance did not collect.
+    __atomic_store_n(&dev->region->rsp.tail, __atomic_load_n(&dev->region->rsp.head, __ATOMIC_ACQUIRE),
+                     __ATOMIC_RELEASE);
+
+    LT_LOG_DEBUG("Attached to shared memory object %s.", name);
+    return LT_OK;
+
+cleanup:
+    munmap(dev->region, sizeof(lt_posix_shm_region_t));
+    dev->region = NULL;
+    close(dev->shm_fd);
+    return LT_FAIL;
+}
+
+lt_ret_t lt_port_deinit(lt_l2_state_t *s2)
+{
+    lt_dev_posix_shm_t *dev = (lt_dev_posix_shm_t *)(s2->device);
+
+    if (!dev->region) {
+        return LT_OK;
+    }
+
+    __atomic_store_n(&dev->region->host_attached, 0, __ATOMIC_RELEASE);
+
+    lt_ret_t ret = LT_OK;
+    if (munmap(dev->region, sizeof(lt_posix_shm_region_t)) < 0) {
+        LT_LOG_ERROR("Could not unmap shared memory: %s (%d).", strerror(errno), errno);
+        ret = LT_FAIL;
+    }
+    dev->region = NULL;
+
+    if (close(dev->shm_fd) < 0) {
+        LT_LOG_ERROR("Could not close shared memory object: %s (%d).", strerror(errno), errno);
+        ret = LT_FAIL;
+    }
+
+    return ret;
+}
+
+lt_ret_t lt_port_spi_csn_low(lt_l2_state_t *s2)
+{
+    lt_dev_posix_shm_t *dev = (lt_dev_posix_shm_t *)(s2->device);
+    LT_LOG_DEBUG("-- Driving Chip Select to Low.");
+    return post_request(dev, LT_SHM_TAG_SPI_DRIVE_CSN_LOW, NULL, 0);
+}
+
+lt_ret_t lt_port_spi_csn_high(lt_l2_state_t *s2)
+{
+    lt_dev_posix_shm_t *dev = (lt_dev_posix_shm_t *)(s2->device);
+    LT_LOG_DEBUG("-- Driving Chip Select to High.");
+    return post_request(dev, LT_SHM_TAG_SPI_DRIVE_CSN_HIGH, NULL, 0);
+}
+
+lt_ret_t lt_port_spi_transfer(lt_l2_state_t *s2, uint8_t offset, uint16_t tx_data_length, uint32_t timeout_ms)
+{
+    LT_UNUSED(timeout_ms);
+    lt_dev_posix_shm_t *dev = (lt_dev_posix_shm_t *)(s2->device);
+    lt_posix_shm_msg_t *msg;
+
+    if (offset + tx_data_length > TR01_L1_LEN_MAX) {
+        return LT_L1_DATA_LEN_ERROR;
+    }
+
+    LT_LOG_DEBUG("-- Sending data through SPI bus.");
+    lt_ret_t ret = post_request(dev, LT_SHM_TAG_SPI_SEND, s2->buff + offset, tx_data_length);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_shm_ring_acquire_read(&dev->region->rsp, LT_SHM_TIMEOUT_MS, &msg);
+    if (ret != LT_OK) {
+        LT_LOG_ERROR("Server did not respond.");
+        return ret;
+    }
+
+    if (msg->tag != LT_SHM_TAG_SPI_SEND || msg->len != tx_data_length) {
+        LT_LOG_ERROR("Unexpected response: tag 0x%02x, length %d.", msg->tag, (int)msg->len);
+        ret = LT_FAIL;
+    }
+    else if (msg->status != LT_SHM_STATUS_OK) {
+        LT_LOG_ERROR("Server failed to process a request.");
+        ret = LT_FAIL;
+    }
+    else {
+        memcpy(s2->buff + offset, msg->payload, tx_data_length);
+    }
+    lt_shm_ring_commit_read(&dev->region->rsp);
+
+    return ret;
+}
+
+lt_ret_t lt_port_delay(lt_l2_state_t *s2, uint32_t ms)
+{
+    lt_dev_posix_shm_t *dev = (lt_dev_posix_shm_t *)(s2->device);
+    LT_LOG_DEBUG("-- Waiting for the target.");
+
+    // The wait is left to the server, so an emulator can skip it or advance its own clock.
+    const uint8_t ms_le[sizeof(uint32_t)]
+        = {ms & 0x000000ff, (ms & 0x0000ff00) >> 8, (ms & 0x00ff0000) >> 16, (ms & 0xff000000) >> 24};
+    return post_request(dev, LT_SHM_TAG_WAIT, ms_le, sizeof(ms_le));
+}
+
+lt_ret_t lt_port_random_bytes(lt_l2_state_t *s2, void *buff, size_t count)
+{
+    LT_UNUSED(s2);
+
+    uint8_t *buff_ptr = buff;
+    for (size_t i = 0; i < count; i++) {
+        // Number from rand() is guaranteed to have at least 15 bits valid
+        buff_ptr[i] = (uint8_t)(rand() & 0xFF);
+    }
+
+    return LT_OK;
+}
@@ -0,0 +1,42 @@
+#ifndef LIBTROPIC_PORT_POSIX_SHM_H
+#define LIBTROPIC_PORT_POSIX_SHM_H
+
+/**
+ * @file libtropic_port_posix_shm.h
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief Port for communication with a local TROPIC01 emulator over shared memory (Linux only).
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include "libtropic_common.h"
+#include "lt_shm_ring.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Device structure for the shared memory port.
+ *
+ * @note Public members are meant to be configured by the developer before passing the handle to
+ *       libtropic. Zero-initialize the structure, so members which are not configured keep their defaults.
+ */
+typedef struct lt_dev_posix_shm_t {
+    /**
+     * @public @brief Name of the shared memory object created by the server (see `lt_shm_server.h`), e.g.
+     * "/libtropic_shm". If NULL, `LT_SHM_DEFAULT_NAME` is used.
+     */
+    const char *shm_name;
+
+    /** @private @brief File descriptor of the shared memory object. */
+    int shm_fd;
+    /** @private @brief Mapped shared memory region. */
+    lt_posix_shm_region_t *region;
+} lt_dev_posix_shm_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LIBTROPIC_PORT_POSIX_SHM_H
@@ -0,0 +1,164 @@
+/**
+ * @file lt_shm_ring.c
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief Single-producer/single-consumer rings in shared memory with futex wakeups.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include "lt_shm_ring.h"
+
+#include <linux/futex.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "libtropic_common.h"
+#include "libtropic_macros.h"
+
+/** @brief Hints the CPU that we are in a spin loop. */
+static inline void cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ volatile("yield");
+#endif
+}
+
+/**
+ * @brief Sleeps while `*addr == val`, at most for `timeout`. The futex is not private, as the region is shared between
+ * processes.
+ */
+static void futex_wait(uint32_t *addr, const uint32_t val, const struct timespec *timeout)
+{
+    // Return value does not matter: wakeup, timeout, EINTR and EAGAIN (value already changed) all lead to a recheck.
+    long ret_unused = syscall(SYS_futex, addr, FUTEX_WAIT, val, timeout, NULL, 0);
+    LT_UNUSED(ret_unused);
+}
+
+/** @brief Wakes the side sleeping on `addr`. */
+static void futex_wake(uint32_t *addr)
+{
+    long ret_unused = syscall(SYS_futex, addr, FUTEX_WAKE, 1, NULL, NULL, 0);
+    LT_UNUSED(ret_unused);
+}
+
+/**
+ * @brief Returns how many times to poll before sleeping. Spinning only helps if the other side runs on another CPU,
+ * on a single CPU it just burns the time slice the other side needs.
+ */
+static int spin_iterations(void)
+{
+    static int iterations = -1;
+
+    if (__atomic_load_n(&iterations, __ATOMIC_RELAXED) < 0) {
+        __atomic_store_n(&iterations, sysconf(_SC_NPROCESSORS_ONLN) > 1 ? LT_SHM_SPIN_ITERATIONS : 0,
+                         __ATOMIC_RELAXED);
+    }
+    return __atomic_load_n(&iterations, __ATOMIC_RELAXED);
+}
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * @brief Waits until `*word` differs from `old`. Spins first, then announces itself in `*waiting` and sleeps on the
+ * futex. The other side wakes the futex only when it sees `*waiting` set after changing `*word`; both sides use
+ * sequentially consistent accesses, so at least one of them sees the other's store and the wakeup cannot be lost.
+ */
+static lt_ret_t wait_for_change(uint32_t *word, const uint32_t old, uint32_t *waiting, const uint32_t timeout_ms)
+{
+    const int spins = spin_iterations();
+    for (int i = 0; i < spins; i++) {
+        if (__atomic_load_n(word, __ATOMIC_ACQUIRE) != old) {
+            return LT_OK;
+        }
+        cpu_relax();
+    }
+
+    const int64_t deadline_ns = now_ns() + (int64_t)timeout_ms * 1000000;
+    lt_ret_t ret = LT_OK;
+
+    while (true) {
+        __atomic_store_n(waiting, 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(word, __ATOMIC_SEQ_CST) != old) {
+            break;
+        }
+
+        const int64_t remaining_ns = deadline_ns - now_ns();
+        if (remaining_ns <= 0) {
+            ret = LT_FAIL;
+            break;
+        }
+
+        const struct timespec timeout = {.tv_sec = remaining_ns / 1000000000, .tv_nsec = remaining_ns % 1000000000};
+        futex_wait(word, old, &timeout);
+    }
+
+    __atomic_store_n(waiting, 0, __ATOMIC_RELAXED);
+    return ret;
+}
+
+void lt_shm_ring_init(lt_posix_shm_ring_t *ring)
+{
+    memset(ring, 0, sizeof(lt_posix_shm_ring_t));
+}
+
+lt_ret_t lt_shm_ring_acquire_write(lt_posix_shm_ring_t *ring, const uint32_t timeout_ms, lt_posix_shm_msg_t **msg)
+{
+    const uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+    if (head - tail >= LT_SHM_RING_SLOTS) {
+        lt_ret_t ret = wait_for_change(&ring->tail, tail, &ring->producer_waiting, timeout_ms);
+        if (ret != LT_OK) {
+            return ret;
+        }
+    }
+
+    *msg = &ring->slots[head % LT_SHM_RING_SLOTS];
+    return LT_OK;
+}
+
+void lt_shm_ring_commit_write(lt_posix_shm_ring_t *ring)
+{
+    const uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->consumer_waiting, __ATOMIC_SEQ_CST)) {
+        futex_wake(&ring->head);
+    }
+}
+
+lt_ret_t lt_shm_ring_acquire_read(lt_posix_shm_ring_t *ring, const uint32_t timeout_ms, lt_posix_shm_msg_t **msg)
+{
+    const uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+
+    if (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == tail) {
+        lt_ret_t ret = wait_for_change(&ring->head, tail, &ring->consumer_waiting, timeout_ms);
+        if (ret != LT_OK) {
+            return ret;
+        }
+    }
+
+    *msg = &ring->slots[tail % LT_SHM_RING_SLOTS];
+    return LT_OK;
+}
+
+void lt_shm_ring_commit_read(lt_posix_shm_ring_t *ring)
+{
+    const uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->producer_waiting, __ATOMIC_SEQ_CST)) {
+        futex_wake(&ring->tail);
+    }
+}
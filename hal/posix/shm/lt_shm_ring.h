@@ -0,0 +1,154 @@
+#ifndef LT_SHM_RING_H
+#define LT_SHM_RING_H
+
+/**
+ * @file lt_shm_ring.h
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief Layout of the shared memory region and single-producer/single-consumer rings used by the shared memory port
+ * and the shared memory server.
+ *
+ * The region holds two rings: requests (libtropic -> server) and responses (server -> libtropic). Each ring has
+ * exactly one producer and one consumer, so head and tail are only ever written by one side and no locks are needed.
+ * A side waiting for the other one first spins for a while and then sleeps on a futex, which the other side wakes
+ * only if the waiting flag is set, so no syscall is made while both sides keep up.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <stdint.h>
+
+#include "libtropic_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Name of the shared memory object used if no name is configured. */
+#define LT_SHM_DEFAULT_NAME "/libtropic_shm"
+/** @brief Identifies an initialized region ("LTSH"). */
+#define LT_SHM_MAGIC 0x4853544cu
+/** @brief Version of the region layout, bumped on incompatible changes. */
+#define LT_SHM_VERSION 1u
+/** @brief Number of slots in each ring, has to be a power of two. */
+#define LT_SHM_RING_SLOTS 16u
+/** @brief Largest payload of a message, which is the largest SPI transfer libtropic makes. */
+#define LT_SHM_MAX_PAYLOAD_LEN TR01_L1_LEN_MAX
+
+/** @brief Maximal time to wait for the other side to take a message or to respond. */
+#define LT_SHM_TIMEOUT_MS 5000
+
+#ifndef LT_SHM_SPIN_ITERATIONS
+/** @brief Number of polls of the ring before the waiting side goes to sleep on a futex. */
+#define LT_SHM_SPIN_ITERATIONS 4000
+#endif
+
+/** @brief Possible values for `tag` field of `lt_posix_shm_msg_t`. */
+typedef enum lt_posix_shm_tag_t {
+    /** No response. */
+    LT_SHM_TAG_SPI_DRIVE_CSN_LOW = 0x01,
+    /** No response. */
+    LT_SHM_TAG_SPI_DRIVE_CSN_HIGH = 0x02,
+    /** Payload is MOSI data, the response with the same tag carries MISO data of the same length. */
+    LT_SHM_TAG_SPI_SEND = 0x03,
+    /** Payload is a little-endian 32-bit number of milliseconds. No response. */
+    LT_SHM_TAG_WAIT = 0x06,
+} lt_posix_shm_tag_t;
+
+/** @brief Possible values for `status` field of a response. */
+typedef enum lt_posix_shm_status_t {
+    LT_SHM_STATUS_OK = 0x00,
+    /** The server failed to process this or any preceding request without a response since the last response. */
+    LT_SHM_STATUS_ERROR = 0x01,
+} lt_posix_shm_status_t;
+
+/** @brief Single slot of a ring. */
+typedef struct lt_posix_shm_msg_t {
+    /** @brief One of `lt_posix_shm_tag_t`. */
+    uint8_t tag;
+    /** @brief One of `lt_posix_shm_status_t`, used only in responses. */
+    uint8_t status;
+    /** @brief Number of valid bytes in `payload`. */
+    uint16_t len;
+    /** @brief Message payload. */
+    uint8_t payload[LT_SHM_MAX_PAYLOAD_LEN];
+} lt_posix_shm_msg_t;
+
+/**
+ * @brief Single-producer/single-consumer ring. Head and tail are free-running counters, so the ring is empty when they
+ * are equal and full when they differ by `LT_SHM_RING_SLOTS`.
+ */
+typedef struct lt_posix_shm_ring_t {
+    /** @brief Number of messages written, written only by the producer. The consumer sleeps on it. */
+    uint32_t head __attribute__((aligned(64)));
+    /** @brief Set by the consumer before it sleeps on `head`. */
+    uint32_t consumer_waiting;
+    /** @brief Number of messages read, written only by the consumer. The producer sleeps on it. */
+    uint32_t tail __attribute__((aligned(64)));
+    /** @brief Set by the producer before it sleeps on `tail`. */
+    uint32_t producer_waiting;
+    /** @brief Message slots. */
+    lt_posix_shm_msg_t slots[LT_SHM_RING_SLOTS] __attribute__((aligned(64)));
+} lt_posix_shm_ring_t;
+
+/** @brief Layout of the whole shared memory region. */
+typedef struct lt_posix_shm_region_t {
+    /** @brief `LT_SHM_MAGIC`, written last by the server when the region is initialized. */
+    uint32_t magic;
+    /** @brief `LT_SHM_VERSION`. */
+    uint32_t version;
+    /** @brief 1 while a libtropic instance is attached, only one can be attached at a time. */
+    uint32_t host_attached;
+    /** @brief Requests, produced by libtropic and consumed by the server. */
+    lt_posix_shm_ring_t req;
+    /** @brief Responses, produced by the server and consumed by libtropic. */
+    lt_posix_shm_ring_t rsp;
+} lt_posix_shm_region_t;
+
+/**
+ * @brief Initializes an empty ring.
+ *
+ * @param ring  Ring to initialize
+ */
+void lt_shm_ring_init(lt_posix_shm_ring_t *ring);
+
+/**
+ * @brief Waits for a free slot. The slot is published by `lt_shm_ring_commit_write()`.
+ *
+ * @param ring        Ring to write to
+ * @param timeout_ms  Maximal time to wait for the consumer
+ * @param msg         Pointer to the free slot
+ * @return            LT_OK on success, LT_FAIL on timeout.
+ */
+lt_ret_t lt_shm_ring_acquire_write(lt_posix_shm_ring_t *ring, const uint32_t timeout_ms, lt_posix_shm_msg_t **msg)
+    __attribute__((warn_unused_result));
+
+/**
+ * @brief Publishes the slot returned by `lt_shm_ring_acquire_write()` and wakes the consumer if it sleeps.
+ *
+ * @param ring  Ring to write to
+ */
+void lt_shm_ring_commit_write(lt_posix_shm_ring_t *ring);
+
+/**
+ * @brief Waits for a message. The slot is released by `lt_shm_ring_commit_read()`.
+ *
+ * @param ring        Ring to read from
+ * @param timeout_ms  Maximal time to wait for the producer
+ * @param msg         Pointer to the oldest unread message
+ * @return            LT_OK on success, LT_FAIL on timeout.
+ */
+lt_ret_t lt_shm_ring_acquire_read(lt_posix_shm_ring_t *ring, const uint32_t timeout_ms, lt_posix_shm_msg_t **msg)
+    __attribute__((warn_unused_result));
+
+/**
+ * @brief Releases the slot returned by `lt_shm_ring_acquire_read()` and wakes the producer if it sleeps.
+ *
+ * @param ring  Ring to read from
+ */
+void lt_shm_ring_commit_read(lt_posix_shm_ring_t *ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LT_SHM_RING_H
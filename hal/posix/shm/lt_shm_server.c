@@ -0,0 +1,199 @@
+/**
+ * @file lt_shm_server.c
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief Server side of the shared memory port (Linux only).
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include "lt_shm_server.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "lt_shm_ring.h"
+
+static const char *server_shm_name(const lt_shm_server_t *srv)
+{
+    return srv->shm_name ? srv->shm_name : LT_SHM_DEFAULT_NAME;
+}
+
+lt_ret_t lt_shm_server_init(lt_shm_server_t *srv)
+{
+    const char *name = server_shm_name(srv);
+
+    srv->shm_fd = shm_open(name, O_CREAT | O_RDWR, 0600);
+    if (srv->shm_fd < 0) {
+        LT_LOG_ERROR("Could not create shared memory object %s: %s (%d).", name, strerror(errno), errno);
+        return LT_FAIL;
+    }
+
+    if (ftruncate(srv->shm_fd, sizeof(lt_posix_shm_region_t)) < 0) {
+        LT_LOG_ERROR("Could not resize shared memory object %s: %s (%d).", name, strerror(errno), errno);
+        close(srv->shm_fd);
+        shm_unlink(name);
+        return LT_FAIL;
+    }
+
+    void *addr = mmap(NULL, sizeof(lt_posix_shm_region_t), PROT_READ | PROT_WRITE, MAP_SHARED, srv->shm_fd, 0);
+    if (addr == MAP_FAILED) {
+        LT_LOG_ERROR("Could not map shared memory: %s (%d).", strerror(errno), errno);
+        close(srv->shm_fd);
+        shm_unlink(name);
+        return LT_FAIL;
+    }
+    srv->region = addr;
+
+    // Invalidate first, so a libtropic instance does not attach to a half-initialized region.
+    __atomic_store_n(&srv->region->magic, 0, __ATOMIC_RELEASE);
+    lt_shm_ring_init(&srv->region->req);
+    lt_shm_ring_init(&srv->region->rsp);
+    srv->region->version = LT_SHM_VERSION;
+    __atomic_store_n(&srv->region->host_attached, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&srv->region->magic, LT_SHM_MAGIC, __ATOMIC_RELEASE);
+
+    srv->pending_error = 0;
+    __atomic_store_n(&srv->stop, 0, __ATOMIC_RELAXED);
+
+    LT_LOG_DEBUG("Shared memory object %s created.", name);
+    return LT_OK;
+}
+
+/**
+ * @brief Executes a request which has no response and latches its error.
+ */
+static void process_posted(lt_shm_server_t *srv, const lt_posix_shm_msg_t *req)
+{
+    const lt_shm_server_handler_t *h = &srv->handler;
+    lt_ret_t ret = LT_OK;
+
+    switch (req->tag) {
+        case LT_SHM_TAG_SPI_DRIVE_CSN_LOW:
+            ret = h->csn_low ? h->csn_low(h->ctx) : LT_OK;
+            break;
+        case LT_SHM_TAG_SPI_DRIVE_CSN_HIGH:
+            ret = h->csn_high ? h->csn_high(h->ctx) : LT_OK;
+            break;
+        case LT_SHM_TAG_WAIT:
+            if (req->len != sizeof(uint32_t)) {
+                ret = LT_FAIL;
+                break;
+            }
+            if (h->wait) {
+                const uint32_t ms = (uint32_t)req->payload[0] | ((uint32_t)req->payload[1] << 8)
+                                    | ((uint32_t)req->payload[2] << 16) | ((uint32_t)req->payload[3] << 24);
+                ret = h->wait(h->ctx, ms);
+            }
+            break;
+        default:
+            LT_LOG_ERROR("Unknown request tag 0x%02x.", req->tag);
+            ret = LT_FAIL;
+            break;
+    }
+
+    if (ret != LT_OK) {
+        srv->pending_error = 1;
+    }
+}
+
+/**
+ * @brief Executes an SPI transfer directly in the response slot.
+ */
+static lt_ret_t process_transfer(lt_shm_server_t *srv, const lt_posix_shm_msg_t *req)
+{
+    const lt_shm_server_handler_t *h = &srv->handler;
+    lt_posix_shm_msg_t *rsp;
+
+    lt_ret_t ret = lt_shm_ring_acquire_write(&srv->region->rsp, LT_SHM_TIMEOUT_MS, &rsp);
+    if (ret != LT_OK) {
+        LT_LOG_ERROR("Libtropic does not collect responses.");
+        return ret;
+    }
+
+    rsp->tag = LT_SHM_TAG_SPI_SEND;
+    rsp->len = req->len;
+    if (req->len > LT_SHM_MAX_PAYLOAD_LEN) {
+        rsp->len = 0;
+        srv->pending_error = 1;
+    }
+    else {
+        memcpy(rsp->payload, req->payload, req->len);
+        if (h->spi_transfer && h->spi_transfer(h->ctx, rsp->payload, rsp->len) != LT_OK) {
+            srv->pending_error = 1;
+        }
+    }
+    rsp->status = srv->pending_error ? LT_SHM_STATUS_ERROR : LT_SHM_STATUS_OK;
+    srv->pending_error = 0;
+
+    lt_shm_ring_commit_write(&srv->region->rsp);
+    return LT_OK;
+}
+
+lt_ret_t lt_shm_server_poll(lt_shm_server_t *srv, const uint32_t timeout_ms)
+{
+    lt_posix_shm_msg_t *req;
+
+    if (lt_shm_ring_acquire_read(&srv->region->req, timeout_ms, &req) != LT_OK) {
+        // Nothing arrived, which is not an error of the server.
+        return LT_OK;
+    }
+
+    lt_ret_t ret = LT_OK;
+    if (req->tag == LT_SHM_TAG_SPI_SEND) {
+        ret = process_transfer(srv, req);
+    }
+    else {
+        process_posted(srv, req);
+    }
+    lt_shm_ring_commit_read(&srv->region->req);
+
+    return ret;
+}
+
+lt_ret_t lt_shm_server_run(lt_shm_server_t *srv)
+{
+    while (!__atomic_load_n(&srv->stop, __ATOMIC_ACQUIRE)) {
+        lt_ret_t ret = lt_shm_server_poll(srv, LT_SHM_SERVER_POLL_MS);
+        if (ret != LT_OK) {
+            return ret;
+        }
+    }
+
+    return LT_OK;
+}
+
+void lt_shm_server_stop(lt_shm_server_t *srv)
+{
+    __atomic_store_n(&srv->stop, 1, __ATOMIC_RELEASE);
+}
+
+lt_ret_t lt_shm_server_deinit(lt_shm_server_t *srv)
+{
+    const char *name = server_shm_name(srv);
+    lt_ret_t ret = LT_OK;
+
+    if (munmap(srv->region, sizeof(lt_posix_shm_region_t)) < 0) {
+        LT_LOG_ERROR("Could not unmap shared memory: %s (%d).", strerror(errno), errno);
+        ret = LT_FAIL;
+    }
+    srv->region = NULL;
+
+    if (close(srv->shm_fd) < 0) {
+        LT_LOG_ERROR("Could not close shared memory object: %s (%d).", strerror(errno), errno);
+        ret = LT_FAIL;
+    }
+
+    if (shm_unlink(name) < 0) {
+        LT_LOG_ERROR("Could not remove shared memory object %s: %s (%d).", name, strerror(errno), errno);
+        ret = LT_FAIL;
+    }
+
+    return ret;
+}
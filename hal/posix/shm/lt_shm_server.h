@@ -0,0 +1,110 @@
+#ifndef LT_SHM_SERVER_H
+#define LT_SHM_SERVER_H
+
+/**
+ * @file lt_shm_server.h
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief Server side of the shared memory port (Linux only). A TROPIC01 emulator links this library, implements
+ * `lt_shm_server_handler_t` and serves a libtropic instance compiled with the shared memory port, either from another
+ * process or from another thread of the same process.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <stdint.h>
+
+#include "libtropic_common.h"
+#include "lt_shm_ring.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Period in which `lt_shm_server_run()` checks whether it was stopped while there are no requests. */
+#define LT_SHM_SERVER_POLL_MS 100
+
+/**
+ * @brief Callbacks implementing the emulated chip. All of them are executed from the thread calling
+ * `lt_shm_server_poll()` or `lt_shm_server_run()`. An error returned by any of them is reported to libtropic in the
+ * response to the next SPI transfer.
+ */
+typedef struct lt_shm_server_handler_t {
+    /** @brief Chip select was driven low. */
+    lt_ret_t (*csn_low)(void *ctx);
+    /** @brief Chip select was driven high. */
+    lt_ret_t (*csn_high)(void *ctx);
+    /** @brief SPI transfer of `len` bytes, MISO data replace MOSI data in `data`. */
+    lt_ret_t (*spi_transfer)(void *ctx, uint8_t *data, uint16_t len);
+    /** @brief Libtropic waits for `ms` milliseconds. Optional, waits are ignored if NULL. */
+    lt_ret_t (*wait)(void *ctx, uint32_t ms);
+    /** @brief Context passed to the callbacks. */
+    void *ctx;
+} lt_shm_server_handler_t;
+
+/**
+ * @brief Server state.
+ *
+ * @note Public members are meant to be configured before calling `lt_shm_server_init()`. Zero-initialize the
+ *       structure, so members which are not configured keep their defaults.
+ */
+typedef struct lt_shm_server_t {
+    /** @public @brief Name of the shared memory object to create. If NULL, `LT_SHM_DEFAULT_NAME` is used. */
+    const char *shm_name;
+    /** @public @brief Emulated chip. */
+    lt_shm_server_handler_t handler;
+
+    /** @private @brief File descriptor of the shared memory object. */
+    int shm_fd;
+    /** @private @brief Mapped shared memory region. */
+    lt_posix_shm_region_t *region;
+    /** @private @brief Set if a callback failed since the last response. */
+    uint8_t pending_error;
+    /** @private @brief Set by `lt_shm_server_stop()`. */
+    uint32_t stop;
+} lt_shm_server_t;
+
+/**
+ * @brief Creates and initializes the shared memory object. An existing object of the same name is reinitialized.
+ *
+ * @param srv  Server state
+ * @return     LT_OK if success, otherwise returns other error code.
+ */
+lt_ret_t lt_shm_server_init(lt_shm_server_t *srv) __attribute__((warn_unused_result));
+
+/**
+ * @brief Processes a single request, waiting for it at most `timeout_ms`.
+ *
+ * @param srv         Server state
+ * @param timeout_ms  Maximal time to wait for a request
+ * @return            LT_OK if a request was processed or none arrived, LT_FAIL if the response could not be posted.
+ */
+lt_ret_t lt_shm_server_poll(lt_shm_server_t *srv, const uint32_t timeout_ms) __attribute__((warn_unused_result));
+
+/**
+ * @brief Processes requests until `lt_shm_server_stop()` is called.
+ *
+ * @param srv  Server state
+ * @return     LT_OK when stopped, LT_FAIL if a response could not be posted.
+ */
+lt_ret_t lt_shm_server_run(lt_shm_server_t *srv) __attribute__((warn_unused_result));
+
+/**
+ * @brief Makes `lt_shm_server_run()` return. Can be called from another thread or a signal handler.
+ *
+ * @param srv  Server state
+ */
+void lt_shm_server_stop(lt_shm_server_t *srv);
+
+/**
+ * @brief Unmaps and removes the shared memory object.
+ *
+ * @param srv  Server state
+ * @return     LT_OK if success, otherwise returns other error code.
+ */
+lt_ret_t lt_shm_server_deinit(lt_shm_server_t *srv) __attribute__((warn_unused_result));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LT_SHM_SERVER_H
@@ -11,11 +11,14 @@
 #include <arpa/inet.h>
 #include <errno.h>
 #include <inttypes.h>
+#include <netinet/tcp.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -30,6 +33,39 @@
 
 static lt_ret_t connect_to_server(lt_dev_posix_tcp_t *dev)
 {
+    if (dev->unix_socket_path) {
+        struct sockaddr_un server;
+
+        if (strlen(dev->unix_socket_path) >= sizeof(server.sun_path)) {
+            LT_LOG_ERROR("Unix socket path is too long: %s.", dev->unix_socket_path);
+            return LT_FAIL;
+        }
+
+        // Create socket
+        dev->socket_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (dev->socket_fd < 0) {
+            LT_LOG_ERROR("Could not create socket: %s (%d).", strerror(errno), errno);
+            return LT_FAIL;
+        }
+        LT_LOG_DEBUG("Unix socket created.");
+
+        // Server information
+        memset(&server, 0, sizeof(server));
+        server.sun_family = AF_UNIX;
+        strcpy(server.sun_path, dev->unix_socket_path);
+
+        // Connect to the server
+        LT_LOG_DEBUG("Connecting to %s.", dev->unix_socket_path);
+        if (connect(dev->socket_fd, (struct sockaddr *)(&server), sizeof(server)) < 0) {
+            LT_LOG_ERROR("Could not connect: %s (%d).", strerror(errno), errno);
+            close(dev->socket_fd);
+            return LT_FAIL;
+        }
+        LT_LOG_DEBUG("Connected to the server.");
+
+        return LT_OK;
+    }
+
     struct sockaddr_in server;
 
     // Create socket
@@ -40,6 +76,12 @@ static lt_ret_t connect_to_server(lt_dev_posix_tcp_t *dev)
     }
     LT_LOG_DEBUG("Socket created.");
 
+    // Every frame waits for a response, so Nagle's algorithm would only delay the small frames.
+    int flag = 1;
+    if (setsockopt(dev->socket_fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag)) < 0) {
+        LT_LOG_WARN("Could not set TCP_NODELAY: %s (%d).", strerror(errno), errno);
+    }
+
     // Server information
     memset(&server, 0, sizeof(server));
     server.sin_family = AF_INET;
@@ -50,6 +92,7 @@ static lt_ret_t connect_to_server(lt_dev_posix_tcp_t *dev)
     LT_LOG_DEBUG("Connecting to %s:%d.", inet_ntoa(server.sin_addr), dev->port);
     if (connect(dev->socket_fd, (struct sockaddr *)(&server), sizeof(server)) < 0) {
         LT_LOG_ERROR("Could not connect: %s (%d).", strerror(errno), errno);
+        close(dev->socket_fd);
         return LT_FAIL;
     }
     LT_LOG_DEBUG("Connected to the server.");
@@ -90,72 +133,114 @@ static lt_ret_t send_all(int socket, uint8_t *buffer, size_t length)
     return LT_FAIL;
 }
 
-static lt_ret_t communicate(lt_dev_posix_tcp_t *dev, int *tx_payload_length_ptr, int *rx_payload_length_ptr)
+/**
+ * @brief Receives exactly `length` bytes. TCP may deliver a frame in arbitrary pieces, so this loops until all bytes
+ * are received, the peer closes the connection or an error occurs.
+ */
+static lt_ret_t recv_all(int socket, uint8_t *buffer, size_t length)
 {
-    lt_ret_t ret;
-    int nb_bytes_received;
-    int nb_bytes_received_total = 0;
-    int nb_bytes_to_receive = LT_TCP_TAG_AND_LENGTH_SIZE;
-    uint8_t *rx_ptr = dev->rx_buffer.buff;
-    // number of bytes to send
-    int nb_bytes_to_send = LT_TCP_TAG_AND_LENGTH_SIZE;
+    size_t nb_bytes_received_total = 0;
+
+    while (nb_bytes_received_total < length) {
+        ssize_t nb_bytes_received = recv(socket, buffer + nb_bytes_received_total, length - nb_bytes_received_total, 0);
+
+        if (nb_bytes_received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LT_LOG_ERROR("Receive failed: %s (%d).", strerror(errno), errno);
+            return LT_FAIL;
+        }
+        if (nb_bytes_received == 0) {
+            LT_LOG_ERROR("Connection closed by the server after %zu of %zu bytes.", nb_bytes_received_total, length);
+            return LT_FAIL;
+        }
 
-    if (tx_payload_length_ptr != NULL) {
-        nb_bytes_to_send += *tx_payload_length_ptr;
+        nb_bytes_received_total += (size_t)nb_bytes_received;
     }
 
+    return LT_OK;
+}
+
+/**
+ * @brief Sends the frame in the TX buffer with `tx_payload_length` bytes of payload.
+ */
+static lt_ret_t send_frame(lt_dev_posix_tcp_t *dev, const int tx_payload_length)
+{
     // update payload length field
-    dev->tx_buffer.len = nb_bytes_to_send - LT_TCP_TAG_AND_LENGTH_SIZE;
+    dev->tx_buffer.len = tx_payload_length;
+
+    return send_all(dev->socket_fd, dev->tx_buffer.buff, LT_TCP_TAG_AND_LENGTH_SIZE + tx_payload_length);
+}
 
-    ret = send_all(dev->socket_fd, dev->tx_buffer.buff, nb_bytes_to_send);
+/**
+ * @brief Receives the tag and the length field of a response into the RX buffer, the payload is left in the socket
+ * for the caller to receive where it is needed.
+ */
+static lt_ret_t recv_header(lt_dev_posix_tcp_t *dev)
+{
+    // receive the tag and the length field first, so we know how much to wait for
+    LT_LOG_DEBUG("- Receiving data from target.");
+    lt_ret_t ret = recv_all(dev->socket_fd, dev->rx_buffer.buff, LT_TCP_TAG_AND_LENGTH_SIZE);
     if (ret != LT_OK) {
         return ret;
     }
 
-    // receive data
-    LT_LOG_DEBUG("- Receiving data from target.");
-    nb_bytes_received = recv(dev->socket_fd, dev->rx_buffer.buff, LT_TCP_MAX_RECV_SIZE, 0);
-
-    if (nb_bytes_received < 0) {
-        LT_LOG_ERROR("Receive failed: %s (%d).", strerror(errno), errno);
-        return LT_FAIL;
-    }
-    else if (nb_bytes_received < nb_bytes_to_receive) {
-        LT_LOG_ERROR("At least %d bytes are expected: %d.", nb_bytes_to_receive, nb_bytes_received);
+    LT_LOG_DEBUG("Length field: %" PRIu16 ".", dev->rx_buffer.len);
+    if (dev->rx_buffer.len > LT_TCP_MAX_PAYLOAD_LEN) {
+        LT_LOG_ERROR("Length field %" PRIu16 " exceeds the maximum of %d.", dev->rx_buffer.len,
+                     (int)LT_TCP_MAX_PAYLOAD_LEN);
         return LT_FAIL;
     }
 
-    LT_LOG_DEBUG("Length field: %" PRIu16 ".", dev->rx_buffer.len);
-    nb_bytes_to_receive += dev->rx_buffer.len;
-    nb_bytes_received_total += nb_bytes_received;
-    LT_LOG_DEBUG("Received %d bytes out of %d expected.", nb_bytes_received_total, nb_bytes_to_receive);
+    return LT_OK;
+}
 
-    if (nb_bytes_received_total < nb_bytes_to_receive) {
-        rx_ptr += nb_bytes_received;
+/**
+ * @brief Receives and drops `length` bytes of a response payload which is not used, so the next response is read from
+ * its start. `length` must not exceed `LT_TCP_MAX_PAYLOAD_LEN`.
+ */
+static void recv_discard(lt_dev_posix_tcp_t *dev, const uint16_t length)
+{
+    lt_ret_t ret_unused = recv_all(dev->socket_fd, dev->rx_buffer.payload, length);
+    LT_UNUSED(ret_unused);
+}
 
-        for (int i = 0; i < LT_TCP_RX_ATTEMPTS; i++) {
-            LT_LOG_DEBUG("Attempting to receive remaining bytes: attempt #%d.", i);
-            nb_bytes_received = recv(dev->socket_fd, dev->rx_buffer.buff, LT_TCP_MAX_RECV_SIZE, 0);
+/**
+ * @brief Sends the frame in the TX buffer and receives the response into the RX buffer.
+ * @note The response tag is not checked.
+ */
+static lt_ret_t transceive(lt_dev_posix_tcp_t *dev, int *tx_payload_length_ptr, int *rx_payload_length_ptr)
+{
+    lt_ret_t ret = send_frame(dev, tx_payload_length_ptr ? *tx_payload_length_ptr : 0);
+    if (ret != LT_OK) {
+        return ret;
+    }
 
-            if (nb_bytes_received < 0) {
-                LT_LOG_ERROR("Receive failed: %s (%d).", strerror(errno), errno);
-                return LT_FAIL;
-            }
+    ret = recv_header(dev);
+    if (ret != LT_OK) {
+        return ret;
+    }
 
-            nb_bytes_received_total += nb_bytes_received;
-            if (nb_bytes_received_total >= nb_bytes_to_receive) {
-                LT_LOG_DEBUG("Received %d bytes in total.", nb_bytes_received_total);
-                break;
-            }
-            rx_ptr += nb_bytes_received;
-        }
+    // receive exactly the payload, so nothing of a possible following frame is consumed
+    ret = recv_all(dev->socket_fd, dev->rx_buffer.payload, dev->rx_buffer.len);
+    if (ret != LT_OK) {
+        return ret;
     }
+    LT_LOG_DEBUG("Received %d bytes in total.", (int)(LT_TCP_TAG_AND_LENGTH_SIZE + dev->rx_buffer.len));
 
-    if (nb_bytes_received_total != nb_bytes_to_receive) {
-        LT_LOG_ERROR("Received %d bytes in total instead of %d.", nb_bytes_received_total, nb_bytes_to_receive);
-        return LT_FAIL;
+    if (rx_payload_length_ptr != NULL) {
+        *rx_payload_length_ptr = dev->rx_buffer.len;
     }
 
+    return LT_OK;
+}
+
+/**
+ * @brief Checks the tag of the response in the RX buffer against the tag of the sent frame.
+ */
+static lt_ret_t check_tag(lt_dev_posix_tcp_t *dev)
+{
     // server does not know the sent tag
     if ((lt_posix_tcp_tag_t)dev->rx_buffer.tag == LT_TCP_TAG_INVALID) {
         LT_LOG_ERROR("Tag %" PRIu8 " is not known by the server.", dev->tx_buffer.tag);
@@ -173,23 +258,171 @@ static lt_ret_t communicate(lt_dev_posix_tcp_t *dev, int *tx_payload_length_ptr,
     }
 
     LT_LOG_DEBUG("Rx tag and tx tag match: %" PRIu8 ".", dev->rx_buffer.tag);
-    if (rx_payload_length_ptr != NULL) {
-        *rx_payload_length_ptr = nb_bytes_received_total - LT_TCP_TAG_AND_LENGTH_SIZE;
+
+    return LT_OK;
+}
+
+static lt_ret_t communicate(lt_dev_posix_tcp_t *dev, int *tx_payload_length_ptr, int *rx_payload_length_ptr)
+{
+    lt_ret_t ret = transceive(dev, tx_payload_length_ptr, rx_payload_length_ptr);
+    if (ret != LT_OK) {
+        return ret;
     }
 
+    return check_tag(dev);
+}
+
+/**
+ * @brief Sends all frames queued for the batch and checks the responses. The responses are received one by one, so
+ * the data of the SPI transfer is received straight into `miso`.
+ *
+ * @param dev   Device structure
+ * @param miso  Where to store the data received for the SPI transfer in the batch (NULL if there is none)
+ */
+static lt_ret_t batch_flush(lt_dev_posix_tcp_t *dev, uint8_t *miso)
+{
+    if (dev->batch_len == 0) {
+        return LT_OK;
+    }
+
+    const int tx_payload_length = dev->batch_len;
+
+    dev->tx_buffer.tag = LT_TCP_TAG_BATCH;
+    dev->batch_len = 0;
+
+    lt_ret_t ret = send_frame(dev, tx_payload_length);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = recv_header(dev);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    // Payload bytes of the batch response not received yet.
+    uint16_t rx_remaining = dev->rx_buffer.len;
+
+    ret = check_tag(dev);
+
+    // Walk the sent frames and receive their responses in lockstep.
+    int tx_idx = 0;
+    while (ret == LT_OK && tx_idx < tx_payload_length) {
+        const uint8_t *tx_frame = &dev->tx_buffer.payload[tx_idx];
+        const uint16_t tx_len = tx_frame[1] | (tx_frame[2] << 8);
+        uint8_t rx_frame[LT_TCP_TAG_AND_LENGTH_SIZE];
+
+        if (rx_remaining < LT_TCP_TAG_AND_LENGTH_SIZE) {
+            LT_LOG_ERROR("Batch response is missing a response for tag %" PRIu8 ".", tx_frame[0]);
+            ret = LT_FAIL;
+            break;
+        }
+        ret = recv_all(dev->socket_fd, rx_frame, LT_TCP_TAG_AND_LENGTH_SIZE);
+        if (ret != LT_OK) {
+            return ret;
+        }
+        rx_remaining -= LT_TCP_TAG_AND_LENGTH_SIZE;
+
+        const uint16_t rx_len = rx_frame[1] | (rx_frame[2] << 8);
+        if (rx_len > rx_remaining) {
+            LT_LOG_ERROR("Batch response for tag %" PRIu8 " is truncated.", tx_frame[0]);
+            ret = LT_FAIL;
+            break;
+        }
+
+        if (rx_frame[0] != tx_frame[0]) {
+            LT_LOG_ERROR("Expected tag %" PRIu8 " in batch response, received %" PRIu8 ".", tx_frame[0], rx_frame[0]);
+            ret = LT_FAIL;
+            break;
+        }
+
+        // Responses without data (CSN changes and waits) go to the RX buffer.
+        uint8_t *rx_payload = dev->rx_buffer.payload;
+        if (tx_frame[0] == LT_TCP_TAG_SPI_SEND) {
+            // SPI is full duplex, a shorter response would leave stale bytes in the L1 buffer.
+            if (!miso || rx_len != tx_len) {
+                LT_LOG_ERROR("Expected %" PRIu16 " bytes of SPI data in batch response, received %" PRIu16 ".", tx_len,
+                             rx_len);
+                ret = LT_FAIL;
+                break;
+            }
+            rx_payload = miso;
+        }
+
+        ret = recv_all(dev->socket_fd, rx_payload, rx_len);
+        if (ret != LT_OK) {
+            return ret;
+        }
+        rx_remaining -= rx_len;
+
+        tx_idx += LT_TCP_TAG_AND_LENGTH_SIZE + tx_len;
+    }
+
+    if (ret == LT_OK && rx_remaining != 0) {
+        LT_LOG_ERROR("Batch response has %" PRIu16 " unexpected trailing bytes.", rx_remaining);
+        ret = LT_FAIL;
+    }
+
+    if (ret != LT_OK) {
+        recv_discard(dev, rx_remaining);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Queues a frame for the next batch. The batch is flushed first if the frame would not fit.
+ */
+static lt_ret_t batch_append(lt_dev_posix_tcp_t *dev, const uint8_t tag, const uint8_t *data, const uint16_t len)
+{
+    if (dev->batch_len + LT_TCP_TAG_AND_LENGTH_SIZE + len > LT_TCP_BATCH_MAX_PAYLOAD_LEN) {
+        lt_ret_t ret = batch_flush(dev, NULL);
+        if (ret != LT_OK) {
+            return ret;
+        }
+    }
+
+    uint8_t *frame = &dev->tx_buffer.payload[dev->batch_len];
+    frame[0] = tag;
+    frame[1] = len & 0xff;
+    frame[2] = len >> 8;
+    if (len) {
+        memcpy(&frame[LT_TCP_TAG_AND_LENGTH_SIZE], data, len);
+    }
+    dev->batch_len += LT_TCP_TAG_AND_LENGTH_SIZE + len;
+
     return LT_OK;
 }
 
-static lt_ret_t server_connect(lt_dev_posix_tcp_t *dev)
+/**
+ * @brief Finds out whether the server supports LT_TCP_TAG_BATCH by sending an empty batch.
+ */
+static lt_ret_t batch_negotiate(lt_dev_posix_tcp_t *dev)
 {
-    bzero(dev->tx_buffer.buff, LT_TCP_MAX_BUFFER_LEN);
-    bzero(dev->rx_buffer.buff, LT_TCP_MAX_BUFFER_LEN);
+    int tx_payload_length = 0;
+    int rx_payload_length;
 
-    lt_ret_t ret = connect_to_server(dev);
+    dev->batch_supported = false;
+    dev->batch_len = 0;
+    dev->tx_buffer.tag = LT_TCP_TAG_BATCH;
+
+    lt_ret_t ret = transceive(dev, &tx_payload_length, &rx_payload_length);
     if (ret != LT_OK) {
         return ret;
     }
 
+    if (dev->rx_buffer.tag == LT_TCP_TAG_BATCH && rx_payload_length == 0) {
+        dev->batch_supported = true;
+        LT_LOG_DEBUG("Server supports batched frames.");
+    }
+    else if (dev->rx_buffer.tag == LT_TCP_TAG_INVALID || dev->rx_buffer.tag == LT_TCP_TAG_UNSUPPORTED) {
+        LT_LOG_DEBUG("Server does not support batched frames, using single frames.");
+    }
+    else {
+        LT_LOG_ERROR("Unexpected response to batch negotiation: tag %" PRIu8 ".", dev->rx_buffer.tag);
+        return LT_FAIL;
+    }
+
     return LT_OK;
 }
 
@@ -204,6 +437,35 @@ static lt_ret_t server_disconnect(int socket_fd)
     return LT_OK;
 }
 
+static lt_ret_t server_connect(lt_dev_posix_tcp_t *dev)
+{
+    bzero(dev->tx_buffer.buff, LT_TCP_MAX_BUFFER_LEN);
+    bzero(dev->rx_buffer.buff, LT_TCP_MAX_BUFFER_LEN);
+    dev->batch_supported = false;
+    dev->batch_len = 0;
+
+    lt_ret_t ret = connect_to_server(dev);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = batch_negotiate(dev);
+    if (ret != LT_OK) {
+        // Servers which do not implement the negotiation at all may drop the connection, so start over with the
+        // legacy single-frame protocol.
+        LT_LOG_WARN("Batch negotiation failed, reconnecting without batching.");
+        lt_ret_t ret_unused = server_disconnect(dev->socket_fd);
+        LT_UNUSED(ret_unused);
+        ret = connect_to_server(dev);
+        if (ret != LT_OK) {
+            return ret;
+        }
+        dev->batch_supported = false;
+    }
+
+    return LT_OK;
+}
+
 lt_ret_t lt_port_init(lt_l2_state_t *s2)
 {
     lt_dev_posix_tcp_t *dev = (lt_dev_posix_tcp_t *)(s2->device);
@@ -219,18 +481,25 @@ lt_ret_t lt_port_init(lt_l2_state_t *s2)
 lt_ret_t lt_port_deinit(lt_l2_state_t *s2)
 {
     lt_dev_posix_tcp_t *dev = (lt_dev_posix_tcp_t *)(s2->device);
+
+    // Deliver the frames still queued (usually the last CSN high).
+    lt_ret_t ret_flush = batch_flush(dev, NULL);
+
     lt_ret_t ret = server_disconnect(dev->socket_fd);
     if (ret != LT_OK) {
         return ret;
     }
 
-    return LT_OK;
+    return ret_flush;
 }
 
 lt_ret_t lt_port_spi_csn_low(lt_l2_state_t *s2)
 {
     lt_dev_posix_tcp_t *dev = (lt_dev_posix_tcp_t *)(s2->device);
     LT_LOG_DEBUG("-- Driving Chip Select to Low.");
+    if (dev->batch_supported) {
+        return batch_append(dev, LT_TCP_TAG_SPI_DRIVE_CSN_LOW, NULL, 0);
+    }
     dev->tx_buffer.tag = LT_TCP_TAG_SPI_DRIVE_CSN_LOW;
     return communicate(dev, NULL, NULL);
 }
@@ -239,6 +508,9 @@ lt_ret_t lt_port_spi_csn_high(lt_l2_state_t *s2)
 {
     lt_dev_posix_tcp_t *dev = (lt_dev_posix_tcp_t *)(s2->device);
     LT_LOG_DEBUG("-- Driving Chip Select to High.");
+    if (dev->batch_supported) {
+        return batch_append(dev, LT_TCP_TAG_SPI_DRIVE_CSN_HIGH, NULL, 0);
+    }
     dev->tx_buffer.tag = LT_TCP_TAG_SPI_DRIVE_CSN_HIGH;
     return communicate(dev, NULL, NULL);
 }
@@ -255,21 +527,47 @@ lt_ret_t lt_port_spi_transfer(lt_l2_state_t *s2, uint8_t offset, uint16_t tx_dat
 
     LT_LOG_DEBUG("-- Sending data through SPI bus.");
 
-    int tx_payload_length = tx_data_length;
-    int rx_payload_length;
+    if (dev->batch_supported) {
+        // The transfer needs the MISO data right away, so it is sent together with all queued frames.
+        ret = batch_append(dev, LT_TCP_TAG_SPI_SEND, s2->buff + offset, tx_data_length);
+        if (ret != LT_OK) {
+            return ret;
+        }
+        return batch_flush(dev, s2->buff + offset);
+    }
 
     dev->tx_buffer.tag = LT_TCP_TAG_SPI_SEND;
-    dev->tx_buffer.len = (uint16_t)tx_payload_length;
 
     // copy tx_data to tx payload
-    memcpy(&dev->tx_buffer.payload, s2->buff, tx_payload_length);
+    memcpy(&dev->tx_buffer.payload, s2->buff + offset, tx_data_length);
+
+    ret = send_frame(dev, tx_data_length);
+    if (ret != LT_OK) {
+        return LT_FAIL;
+    }
 
-    ret = communicate(dev, &tx_payload_length, &rx_payload_length);
+    ret = recv_header(dev);
     if (ret != LT_OK) {
         return LT_FAIL;
     }
 
-    memcpy(s2->buff + offset, &dev->rx_buffer.payload, rx_payload_length);
+    ret = check_tag(dev);
+    if (ret == LT_OK && dev->rx_buffer.len != tx_data_length) {
+        // SPI is full duplex, a shorter response would leave stale bytes in the L1 buffer.
+        LT_LOG_ERROR("Expected %" PRIu16 " bytes of SPI data, received %" PRIu16 ".", tx_data_length,
+                     dev->rx_buffer.len);
+        ret = LT_FAIL;
+    }
+    if (ret != LT_OK) {
+        recv_discard(dev, dev->rx_buffer.len);
+        return LT_FAIL;
+    }
+
+    // The MISO data is received straight into the L1 buffer, without a copy from the RX buffer.
+    ret = recv_all(dev->socket_fd, s2->buff + offset, tx_data_length);
+    if (ret != LT_OK) {
+        return LT_FAIL;
+    }
 
     return LT_OK;
 }
@@ -279,13 +577,18 @@ lt_ret_t lt_port_delay(lt_l2_state_t *s2, uint32_t ms)
     lt_dev_posix_tcp_t *dev = (lt_dev_posix_tcp_t *)(s2->device);
     LT_LOG_DEBUG("-- Waiting for the target.");
 
+    if (dev->batch_supported) {
+        const uint8_t ms_le[sizeof(uint32_t)]
+            = {ms & 0x000000ff, (ms & 0x0000ff00) >> 8, (ms & 0x00ff0000) >> 16, (ms & 0xff000000) >> 24};
+        return batch_append(dev, LT_TCP_TAG_WAIT, ms_le, sizeof(ms_le));
+    }
+
     dev->tx_buffer.tag = LT_TCP_TAG_WAIT;
     int payload_length = sizeof(uint32_t);
-    //*(uint32_t *)(&tx_buffer.PAYLOAD) = wait_time_usecs;
-    dev->rx_buffer.payload[0] = ms & 0x000000ff;
-    dev->rx_buffer.payload[1] = (ms & 0x0000ff00) >> 8;
-    dev->rx_buffer.payload[2] = (ms & 0x00ff0000) >> 16;
-    dev->rx_buffer.payload[3] = (ms & 0xff000000) >> 24;
+    dev->tx_buffer.payload[0] = ms & 0x000000ff;
+    dev->tx_buffer.payload[1] = (ms & 0x0000ff00) >> 8;
+    dev->tx_buffer.payload[2] = (ms & 0x00ff0000) >> 16;
+    dev->tx_buffer.payload[3] = (ms & 0xff000000) >> 24;
 
     return communicate(dev, &payload_length, NULL);
 }
@@ -10,19 +10,26 @@
  */
 
 #include <netinet/in.h>
+#include <stdbool.h>
 
 #include "libtropic_common.h"
+#include "libtropic_macros.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 #define LT_TCP_TAG_AND_LENGTH_SIZE (sizeof(uint8_t) + sizeof(uint16_t))
-#define LT_TCP_MAX_PAYLOAD_LEN TR01_L2_MAX_FRAME_SIZE
+/**
+ * @brief Largest payload of a `LT_TCP_TAG_BATCH` frame which the port builds: a pending CSN high, a wait and a CSN low
+ * followed by one SPI transfer of maximal length. Bigger batches are split.
+ */
+#define LT_TCP_BATCH_MAX_PAYLOAD_LEN \
+    (4 * LT_TCP_TAG_AND_LENGTH_SIZE + sizeof(uint32_t) + TR01_L1_LEN_MAX)
+#define LT_TCP_MAX_PAYLOAD_LEN LT_COMPTIME_MAX(TR01_L2_MAX_FRAME_SIZE, LT_TCP_BATCH_MAX_PAYLOAD_LEN)
 #define LT_TCP_MAX_BUFFER_LEN (LT_TCP_TAG_AND_LENGTH_SIZE + LT_TCP_MAX_PAYLOAD_LEN)
 
 #define LT_TCP_TX_ATTEMPTS 3
-#define LT_TCP_RX_ATTEMPTS 3
 #define LT_TCP_MAX_RECV_SIZE (LT_TCP_MAX_PAYLOAD_LEN + LT_TCP_TAG_AND_LENGTH_SIZE)
 
 /** @brief Possible values for `tag` field of `lt_posix_tcp_buffer_t`. */
@@ -34,6 +41,12 @@ typedef enum lt_posix_tcp_tag_t {
     LT_TCP_TAG_POWER_OFF = 0x05,
     LT_TCP_TAG_WAIT = 0x06,
     LT_TCP_TAG_RESET_TARGET = 0x10,
+    /**
+     * Payload is a sequence of frames with any of the tags above (each with its own tag, little-endian length and
+     * payload), which the server executes in order. The server responds with `LT_TCP_TAG_BATCH`, whose payload is the
+     * sequence of the respective responses. Support is negotiated in `lt_port_init()` by sending an empty batch.
+     */
+    LT_TCP_TAG_BATCH = 0x20,
     LT_TCP_TAG_INVALID = 0xfd,
     LT_TCP_TAG_UNSUPPORTED = 0xfe,
 } lt_posix_tcp_tag_t;
@@ -54,13 +67,18 @@ typedef struct lt_posix_tcp_buffer_t {
  * @brief Device structure for model port (TCP communication).
  *
  * @note Public members are meant to be configured by the developer before passing the handle to
- *       libtropic.
+ *       libtropic. Zero-initialize the structure, so members which are not configured keep their defaults.
  */
 typedef struct lt_dev_posix_tcp_t {
     /** @public @brief Address of the model server. */
     in_addr_t addr;
     /** @public @brief Port of the model server. */
     in_port_t port;
+    /**
+     * @public @brief Path of a Unix domain socket of the server. If not NULL, it is used instead of `addr` and `port`.
+     * A Unix domain socket avoids the TCP/IP stack when the server runs on the same machine.
+     */
+    const char *unix_socket_path;
 
     /** @private @brief Socket file descriptor. */
     int socket_fd;
@@ -68,6 +86,10 @@ typedef struct lt_dev_posix_tcp_t {
     struct lt_posix_tcp_buffer_t rx_buffer;
     /** @private @brief Emission buffer. */
     struct lt_posix_tcp_buffer_t tx_buffer;
+    /** @private @brief True if the server supports `LT_TCP_TAG_BATCH` (negotiated in `lt_port_init()`). */
+    bool batch_supported;
+    /** @private @brief Number of bytes of frames queued in `tx_buffer.payload` for the next batch. */
+    uint16_t batch_len;
 } lt_dev_posix_tcp_t;
 
 #ifdef __cplusplus
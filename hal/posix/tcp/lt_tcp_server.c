@@ -0,0 +1,400 @@
+/**
+ * @file lt_tcp_server.c
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief Server side of the TCP port.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include "lt_tcp_server.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "libtropic_port_posix_tcp.h"
+
+static lt_ret_t listen_unix(lt_tcp_server_t *srv)
+{
+    struct sockaddr_un server;
+
+    if (strlen(srv->unix_socket_path) >= sizeof(server.sun_path)) {
+        LT_LOG_ERROR("Unix socket path is too long: %s.", srv->unix_socket_path);
+        return LT_FAIL;
+    }
+
+    srv->listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (srv->listen_fd < 0) {
+        LT_LOG_ERROR("Could not create socket: %s (%d).", strerror(errno), errno);
+        return LT_FAIL;
+    }
+
+    memset(&server, 0, sizeof(server));
+    server.sun_family = AF_UNIX;
+    strcpy(server.sun_path, srv->unix_socket_path);
+
+    // A socket left behind by a previous server would make bind() fail.
+    unlink(srv->unix_socket_path);
+    if (bind(srv->listen_fd, (struct sockaddr *)(&server), sizeof(server)) < 0) {
+        LT_LOG_ERROR("Could not bind %s: %s (%d).", srv->unix_socket_path, strerror(errno), errno);
+        close(srv->listen_fd);
+        return LT_FAIL;
+    }
+
+    return LT_OK;
+}
+
+static lt_ret_t listen_inet(lt_tcp_server_t *srv)
+{
+    struct sockaddr_in server;
+    socklen_t server_len = sizeof(server);
+
+    srv->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (srv->listen_fd < 0) {
+        LT_LOG_ERROR("Could not create socket: %s (%d).", strerror(errno), errno);
+        return LT_FAIL;
+    }
+
+    int flag = 1;
+    if (setsockopt(srv->listen_fd, SOL_SOCKET, SO_REUSEADDR, &flag, sizeof(flag)) < 0) {
+        LT_LOG_WARN("Could not set SO_REUSEADDR: %s (%d).", strerror(errno), errno);
+    }
+
+    memset(&server, 0, sizeof(server));
+    server.sin_family = AF_INET;
+    server.sin_addr.s_addr = srv->addr;
+    server.sin_port = htons(srv->port);
+
+    if (bind(srv->listen_fd, (struct sockaddr *)(&server), sizeof(server)) < 0) {
+        LT_LOG_ERROR("Could not bind port %" PRIu16 ": %s (%d).", srv->port, strerror(errno), errno);
+        close(srv->listen_fd);
+        return LT_FAIL;
+    }
+
+    // Report the port chosen by the system if none was given.
+    if (getsockname(srv->listen_fd, (struct sockaddr *)(&server), &server_len) < 0) {
+        LT_LOG_ERROR("Could not get the bound port: %s (%d).", strerror(errno), errno);
+        close(srv->listen_fd);
+        return LT_FAIL;
+    }
+    srv->port = ntohs(server.sin_port);
+
+    return LT_OK;
+}
+
+lt_ret_t lt_tcp_server_init(lt_tcp_server_t *srv)
+{
+    lt_ret_t ret = srv->unix_socket_path ? listen_unix(srv) : listen_inet(srv);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    // libtropic connects once per lt_init(), so one pending connection is enough.
+    if (listen(srv->listen_fd, 1) < 0) {
+        LT_LOG_ERROR("Could not listen: %s (%d).", strerror(errno), errno);
+        close(srv->listen_fd);
+        return LT_FAIL;
+    }
+
+    srv->client_fd = -1;
+    memset(&srv->stats, 0, sizeof(srv->stats));
+    __atomic_store_n(&srv->stop, 0, __ATOMIC_RELAXED);
+
+    LT_LOG_DEBUG("TCP server listening.");
+    return LT_OK;
+}
+
+static lt_ret_t send_all(int socket, const uint8_t *buffer, size_t length)
+{
+    size_t nb_bytes_sent_total = 0;
+
+    while (nb_bytes_sent_total < length) {
+        ssize_t nb_bytes_sent = send(socket, buffer + nb_bytes_sent_total, length - nb_bytes_sent_total, MSG_NOSIGNAL);
+        if (nb_bytes_sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LT_LOG_ERROR("Send failed: %s (%d).", strerror(errno), errno);
+            return LT_FAIL;
+        }
+        nb_bytes_sent_total += (size_t)nb_bytes_sent;
+    }
+
+    return LT_OK;
+}
+
+static lt_ret_t recv_all(int socket, uint8_t *buffer, size_t length)
+{
+    size_t nb_bytes_received_total = 0;
+
+    while (nb_bytes_received_total < length) {
+        ssize_t nb_bytes_received = recv(socket, buffer + nb_bytes_received_total, length - nb_bytes_received_total, 0);
+        if (nb_bytes_received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LT_LOG_ERROR("Receive failed: %s (%d).", strerror(errno), errno);
+            return LT_FAIL;
+        }
+        if (nb_bytes_received == 0) {
+            // Regular end of the connection if it happens between frames.
+            if (nb_bytes_received_total != 0) {
+                LT_LOG_ERROR("Connection closed after %zu of %zu bytes.", nb_bytes_received_total, length);
+            }
+            return LT_FAIL;
+        }
+        nb_bytes_received_total += (size_t)nb_bytes_received;
+    }
+
+    return LT_OK;
+}
+
+/**
+ * @brief Executes a single frame and writes its response (tag, little-endian length and payload) to `rsp`.
+ *
+ * @return Length of the response including the tag and length fields, never more than the length of the request.
+ */
+static uint16_t process_frame(lt_tcp_server_t *srv, const uint8_t tag, const uint8_t *payload, const uint16_t len,
+                              uint8_t *rsp)
+{
+    const lt_tcp_server_handler_t *h = &srv->handler;
+    uint8_t *rsp_payload = &rsp[LT_TCP_TAG_AND_LENGTH_SIZE];
+    uint8_t rsp_tag = tag;
+    uint16_t rsp_len = 0;
+    lt_ret_t ret = LT_OK;
+
+    srv->stats.frames++;
+
+    switch (tag) {
+        case LT_TCP_TAG_SPI_DRIVE_CSN_LOW:
+            ret = h->csn_low ? h->csn_low(h->ctx) : LT_OK;
+            break;
+        case LT_TCP_TAG_SPI_DRIVE_CSN_HIGH:
+            ret = h->csn_high ? h->csn_high(h->ctx) : LT_OK;
+            break;
+        case LT_TCP_TAG_SPI_SEND:
+            memcpy(rsp_payload, payload, len);
+            ret = h->spi_transfer ? h->spi_transfer(h->ctx, rsp_payload, len) : LT_OK;
+            rsp_len = len;
+            break;
+        case LT_TCP_TAG_WAIT:
+            if (len != sizeof(uint32_t)) {
+                rsp_tag = LT_TCP_TAG_INVALID;
+                break;
+            }
+            if (h->wait) {
+                const uint32_t ms = (uint32_t)payload[0] | ((uint32_t)payload[1] << 8) | ((uint32_t)payload[2] << 16)
+                                    | ((uint32_t)payload[3] << 24);
+                ret = h->wait(h->ctx, ms);
+            }
+            break;
+        case LT_TCP_TAG_POWER_ON:
+        case LT_TCP_TAG_POWER_OFF:
+        case LT_TCP_TAG_RESET_TARGET:
+            // The emulated chip has no power or reset control.
+            rsp_tag = LT_TCP_TAG_UNSUPPORTED;
+            break;
+        default:
+            // Including LT_TCP_TAG_BATCH nested in a batch.
+            LT_LOG_ERROR("Unknown request tag 0x%02" PRIx8 ".", tag);
+            rsp_tag = LT_TCP_TAG_INVALID;
+            break;
+    }
+
+    if (ret != LT_OK) {
+        rsp_tag = LT_TCP_TAG_UNSUPPORTED;
+    }
+    if (rsp_tag != tag) {
+        rsp_len = 0;
+    }
+
+    rsp[0] = rsp_tag;
+    rsp[1] = rsp_len & 0xff;
+    rsp[2] = rsp_len >> 8;
+
+    return LT_TCP_TAG_AND_LENGTH_SIZE + rsp_len;
+}
+
+/**
+ * @brief Executes the frames of a batch in order and writes the batch of their responses to `rsp`.
+ *
+ * @return Length of the response including the tag and length fields.
+ */
+static uint16_t process_batch(lt_tcp_server_t *srv, const uint8_t *payload, const uint16_t len, uint8_t *rsp)
+{
+    uint16_t idx = 0;
+    uint16_t rsp_idx = LT_TCP_TAG_AND_LENGTH_SIZE;
+
+    if (len) {
+        srv->stats.batches++;
+    }
+
+    while (idx < len) {
+        if (idx + LT_TCP_TAG_AND_LENGTH_SIZE > len
+            || idx + LT_TCP_TAG_AND_LENGTH_SIZE + (payload[idx + 1] | (payload[idx + 2] << 8)) > len) {
+            LT_LOG_ERROR("Frame at offset %" PRIu16 " of the batch is truncated.", idx);
+            // The frames executed so far cannot be taken back, the whole batch is reported as invalid.
+            rsp_idx = LT_TCP_TAG_AND_LENGTH_SIZE;
+            rsp[0] = LT_TCP_TAG_INVALID;
+            rsp[1] = 0;
+            rsp[2] = 0;
+            return rsp_idx;
+        }
+
+        const uint16_t frame_len = payload[idx + 1] | (payload[idx + 2] << 8);
+        // Each response is at most as long as its request, so the responses fit behind the batch header.
+        rsp_idx += process_frame(srv, payload[idx], &payload[idx + LT_TCP_TAG_AND_LENGTH_SIZE], frame_len,
+                                 &rsp[rsp_idx]);
+        idx += LT_TCP_TAG_AND_LENGTH_SIZE + frame_len;
+    }
+
+    const uint16_t rsp_len = rsp_idx - LT_TCP_TAG_AND_LENGTH_SIZE;
+    rsp[0] = LT_TCP_TAG_BATCH;
+    rsp[1] = rsp_len & 0xff;
+    rsp[2] = rsp_len >> 8;
+
+    return rsp_idx;
+}
+
+/**
+ * @brief Receives a request from the client, executes it and sends the response.
+ *
+ * @return LT_OK if success, LT_FAIL if the connection was closed or broken.
+ */
+static lt_ret_t serve_request(lt_tcp_server_t *srv)
+{
+    lt_ret_t ret = recv_all(srv->client_fd, srv->req.buff, LT_TCP_TAG_AND_LENGTH_SIZE);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    if (srv->req.len > LT_TCP_MAX_PAYLOAD_LEN) {
+        // The rest of the frame cannot be skipped reliably, so the connection is dropped.
+        LT_LOG_ERROR("Length field %" PRIu16 " exceeds the maximum of %d.", srv->req.len, (int)LT_TCP_MAX_PAYLOAD_LEN);
+        return LT_FAIL;
+    }
+
+    ret = recv_all(srv->client_fd, srv->req.payload, srv->req.len);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    uint16_t rsp_len;
+    if (srv->req.tag == LT_TCP_TAG_BATCH) {
+        rsp_len = process_batch(srv, srv->req.payload, srv->req.len, srv->rsp.buff);
+    }
+    else {
+        rsp_len = process_frame(srv, srv->req.tag, srv->req.payload, srv->req.len, srv->rsp.buff);
+    }
+
+    return send_all(srv->client_fd, srv->rsp.buff, rsp_len);
+}
+
+/**
+ * @brief Waits at most `LT_TCP_SERVER_POLL_MS` for `fd` to become readable.
+ *
+ * @return 1 if readable, 0 on timeout, -1 on error.
+ */
+static int wait_readable(int fd)
+{
+    struct pollfd pfd = {.fd = fd, .events = POLLIN};
+
+    int ret = poll(&pfd, 1, LT_TCP_SERVER_POLL_MS);
+    if (ret < 0) {
+        if (errno == EINTR) {
+            return 0;
+        }
+        LT_LOG_ERROR("poll() failed: %s (%d).", strerror(errno), errno);
+        return -1;
+    }
+
+    return ret;
+}
+
+static void close_client(lt_tcp_server_t *srv)
+{
+    LT_LOG_DEBUG("Client disconnected.");
+    close(srv->client_fd);
+    srv->client_fd = -1;
+}
+
+lt_ret_t lt_tcp_server_run(lt_tcp_server_t *srv)
+{
+    while (!__atomic_load_n(&srv->stop, __ATOMIC_ACQUIRE)) {
+        if (srv->client_fd < 0) {
+            int ready = wait_readable(srv->listen_fd);
+            if (ready < 0) {
+                return LT_FAIL;
+            }
+            if (ready == 0) {
+                continue;
+            }
+
+            srv->client_fd = accept(srv->listen_fd, NULL, NULL);
+            if (srv->client_fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) {
+                    continue;
+                }
+                LT_LOG_ERROR("accept() failed: %s (%d).", strerror(errno), errno);
+                return LT_FAIL;
+            }
+
+            if (!srv->unix_socket_path) {
+                // Every response is awaited by libtropic, so Nagle's algorithm would only delay it.
+                int flag = 1;
+                if (setsockopt(srv->client_fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag)) < 0) {
+                    LT_LOG_WARN("Could not set TCP_NODELAY: %s (%d).", strerror(errno), errno);
+                }
+            }
+            LT_LOG_DEBUG("Client connected.");
+            continue;
+        }
+
+        int ready = wait_readable(srv->client_fd);
+        if (ready < 0) {
+            close_client(srv);
+            continue;
+        }
+        if (ready == 0) {
+            continue;
+        }
+
+        if (serve_request(srv) != LT_OK) {
+            close_client(srv);
+        }
+    }
+
+    return LT_OK;
+}
+
+void lt_tcp_server_stop(lt_tcp_server_t *srv) { __atomic_store_n(&srv->stop, 1, __ATOMIC_RELEASE); }
+
+lt_ret_t lt_tcp_server_deinit(lt_tcp_server_t *srv)
+{
+    lt_ret_t ret = LT_OK;
+
+    if (srv->client_fd >= 0) {
+        close_client(srv);
+    }
+
+    if (close(srv->listen_fd) < 0) {
+        LT_LOG_ERROR("Could not close the listening socket: %s (%d).", strerror(errno), errno);
+        ret = LT_FAIL;
+    }
+
+    if (srv->unix_socket_path && unlink(srv->unix_socket_path) < 0) {
+        LT_LOG_ERROR("Could not remove %s: %s (%d).", srv->unix_socket_path, strerror(errno), errno);
+        ret = LT_FAIL;
+    }
+
+    return ret;
+}
@@ -0,0 +1,122 @@
+#ifndef LT_TCP_SERVER_H
+#define LT_TCP_SERVER_H
+
+/**
+ * @file lt_tcp_server.h
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief Server side of the TCP port. A TROPIC01 emulator links this library, implements `lt_tcp_server_handler_t`
+ * and serves a libtropic instance compiled with the TCP port, including batched frames (`LT_TCP_TAG_BATCH`).
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <netinet/in.h>
+#include <stdint.h>
+
+#include "libtropic_common.h"
+#include "libtropic_port_posix_tcp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Period in which `lt_tcp_server_run()` checks whether it was stopped while there are no requests. */
+#define LT_TCP_SERVER_POLL_MS 100
+
+/**
+ * @brief Callbacks implementing the emulated chip. All of them are executed from the thread calling
+ * `lt_tcp_server_run()`. An error returned by any of them is reported to libtropic by `LT_TCP_TAG_UNSUPPORTED` in the
+ * response to the failed frame.
+ */
+typedef struct lt_tcp_server_handler_t {
+    /** @brief Chip select was driven low. */
+    lt_ret_t (*csn_low)(void *ctx);
+    /** @brief Chip select was driven high. */
+    lt_ret_t (*csn_high)(void *ctx);
+    /** @brief SPI transfer of `len` bytes, MISO data replace MOSI data in `data`. */
+    lt_ret_t (*spi_transfer)(void *ctx, uint8_t *data, uint16_t len);
+    /** @brief Libtropic waits for `ms` milliseconds. Optional, waits are ignored if NULL. */
+    lt_ret_t (*wait)(void *ctx, uint32_t ms);
+    /** @brief Context passed to the callbacks. */
+    void *ctx;
+} lt_tcp_server_handler_t;
+
+/**
+ * @brief Counters of the server, for tests and benchmarks.
+ */
+typedef struct lt_tcp_server_stats_t {
+    /** @brief Number of executed frames, including the frames in batches. */
+    uint32_t frames;
+    /** @brief Number of executed non-empty batches (the empty batch of the negotiation is not counted). */
+    uint32_t batches;
+} lt_tcp_server_stats_t;
+
+/**
+ * @brief Server state.
+ *
+ * @note Public members are meant to be configured before calling `lt_tcp_server_init()`. Zero-initialize the
+ *       structure, so members which are not configured keep their defaults.
+ */
+typedef struct lt_tcp_server_t {
+    /** @public @brief Address to listen on. */
+    in_addr_t addr;
+    /** @public @brief Port to listen on. If zero, a free port is chosen and stored here by `lt_tcp_server_init()`. */
+    in_port_t port;
+    /**
+     * @public @brief Path of a Unix domain socket to listen on. If not NULL, it is used instead of `addr` and `port`.
+     */
+    const char *unix_socket_path;
+    /** @public @brief Emulated chip. */
+    lt_tcp_server_handler_t handler;
+    /** @public @brief Counters, can be read once `lt_tcp_server_run()` returned. */
+    lt_tcp_server_stats_t stats;
+
+    /** @private @brief Listening socket. */
+    int listen_fd;
+    /** @private @brief Socket of the connected libtropic instance, -1 if there is none. */
+    int client_fd;
+    /** @private @brief Request being processed. */
+    struct lt_posix_tcp_buffer_t req;
+    /** @private @brief Response being built. */
+    struct lt_posix_tcp_buffer_t rsp;
+    /** @private @brief Set by `lt_tcp_server_stop()`. */
+    uint32_t stop;
+} lt_tcp_server_t;
+
+/**
+ * @brief Creates the listening socket. An existing Unix domain socket of the same path is replaced.
+ *
+ * @param srv  Server state
+ * @return     LT_OK if success, otherwise returns other error code.
+ */
+lt_ret_t lt_tcp_server_init(lt_tcp_server_t *srv) __attribute__((warn_unused_result));
+
+/**
+ * @brief Serves connections one after another until `lt_tcp_server_stop()` is called. A connection with a malformed
+ * frame is closed and the server waits for the next one.
+ *
+ * @param srv  Server state
+ * @return     LT_OK when stopped, LT_FAIL if the listening socket failed.
+ */
+lt_ret_t lt_tcp_server_run(lt_tcp_server_t *srv) __attribute__((warn_unused_result));
+
+/**
+ * @brief Makes `lt_tcp_server_run()` return. Can be called from another thread or a signal handler.
+ *
+ * @param srv  Server state
+ */
+void lt_tcp_server_stop(lt_tcp_server_t *srv);
+
+/**
+ * @brief Closes the sockets and removes the Unix domain socket.
+ *
+ * @param srv  Server state
+ * @return     LT_OK if success, otherwise returns other error code.
+ */
+lt_ret_t lt_tcp_server_deinit(lt_tcp_server_t *srv) __attribute__((warn_unused_result));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LT_TCP_SERVER_H
@@ -7,6 +7,10 @@
  * implements the protocol. More info about the dongle in GitHub repo:
  * https://github.com/tropicsquare/ts13-usb-dev-kit-fw
  *
+ * Besides the ASCII protocol, the port can negotiate a binary framing with the dongle (see
+ * `lt_usb_dongle_framing_t`): each SPI transfer is sent as [flags, length (2 B, LE), data, CRC16] and answered by
+ * [status, length (2 B, LE), received data, CRC16], with CSN released by a flag instead of a separate command.
+ *
  * @license For the license see file LICENSE.txt file in the root directory of this source tree.
  */
 
@@ -16,6 +20,9 @@
 #include <fcntl.h>
 #include <inttypes.h>
 #include <limits.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -29,6 +36,13 @@
 #include "libtropic_logging.h"
 #include "libtropic_macros.h"
 #include "libtropic_port.h"
+#include "lt_crc16.h"
+#include "lt_hex.h"
+#include "lt_l1.h"
+
+#ifdef __linux__
+#include "lt_usb_dongle_termios2.h"
+#endif
 
 #if LT_USE_INT_PIN
 #error "Interrupt PIN not supported in the USB dongle port!"
@@ -42,6 +56,52 @@
 #define GETENTROPY_MAX 256
 #endif
 
+/** @brief Terminator of the replies of the dongle. */
+#define LT_USB_DONGLE_TERMINATOR "\r\n"
+/** @brief Length of `LT_USB_DONGLE_TERMINATOR`. */
+#define LT_USB_DONGLE_TERMINATOR_LEN 2
+/** @brief Bits on the wire per character (start bit, 8 data bits, stop bit). */
+#define LT_USB_DONGLE_BITS_PER_CHAR 10
+/** @brief ASCII command switching the dongle to the binary framing, answered by "OK\r\n" if supported. */
+#define LT_USB_DONGLE_CMD_BINARY "MODE=BIN\n"
+/** @brief Binary frame header: flags (requests) or status (replies), followed by the data length (little endian). */
+#define LT_USB_DONGLE_BIN_HDR_LEN 3
+/** @brief Binary frame trailer: CRC16 of the header and the data, in the byte order of L2 frames. */
+#define LT_USB_DONGLE_BIN_CRC_LEN 2
+/** @brief Header and trailer of a binary frame. */
+#define LT_USB_DONGLE_BIN_OVERHEAD (LT_USB_DONGLE_BIN_HDR_LEN + LT_USB_DONGLE_BIN_CRC_LEN)
+/** @brief Request flag: set CSN high after the data are transferred (or right away for a frame without data). */
+#define LT_USB_DONGLE_BIN_FLAG_CSN_HIGH 0x01
+/** @brief Request flag: switch the dongle back to the ASCII protocol after acknowledging the frame. */
+#define LT_USB_DONGLE_BIN_FLAG_ASCII 0x02
+/** @brief Reply status of a successfully executed request. */
+#define LT_USB_DONGLE_BIN_STATUS_OK 0x00
+
+/**
+ * @brief Returns the value of the monotonic clock in milliseconds.
+ */
+static int64_t now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Returns the time the dongle has to answer a command.
+ *
+ * @param device  Device structure
+ * @param chars   Number of characters of the command and the reply
+ *
+ * @return Reply timeout in milliseconds: the wire time of the characters plus `LT_USB_DONGLE_REPLY_TIMEOUT_MS`.
+ */
+static int64_t reply_timeout_ms(const lt_dev_posix_usb_dongle_t *device, const size_t chars)
+{
+    const uint32_t baud_rate = device->baud_rate ? device->baud_rate : 9600;
+    return LT_USB_DONGLE_REPLY_TIMEOUT_MS
+           + ((int64_t)chars * LT_USB_DONGLE_BITS_PER_CHAR * 1000 + baud_rate - 1) / baud_rate;
+}
+
 /**
  * @brief Writes data to a serial port (specified by fd).
  *
@@ -51,43 +111,465 @@
  *
  * @return Returns 0 on success, or -1 on error.
  */
-static int write_port(int fd, uint8_t *buffer, size_t size)
+static int write_port(int fd, const uint8_t *buffer, size_t size)
 {
-    ssize_t written_bytes = write(fd, buffer, size);
-    if (written_bytes != (ssize_t)size) {
-        LT_LOG_ERROR("Failed to write to port, written_bytes=%zd.", written_bytes);
-        return -1;
+    size_t written = 0;
+    while (written < size) {
+        ssize_t written_bytes = write(fd, buffer + written, size - written);
+        if (written_bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LT_LOG_ERROR("Failed to write to port: %s (%d).", strerror(errno), errno);
+            return -1;
+        }
+        written += written_bytes;
     }
     return 0;
 }
 
 /**
- * @brief Reads data from a serial port (specified by fd).
+ * @brief Reads exactly `size` bytes from a serial port (specified by fd).
  *
- * @note  Returns after all the desired bytes have been read, or if there is a timeout or other error.
+ * @note  Waits with poll(), so it returns as soon as the data arrive. Never reads past `size` bytes, so the next reply
+ *        is not consumed.
  *
- * @param fd        The file descriptor to read from.
- * @param buffer    Pointer to the buffer where the read data will be stored.
- * @param size      The maximum number of bytes to read into the buffer.
+ * @param fd           The file descriptor to read from.
+ * @param buffer       Pointer to the buffer where the data will be stored.
+ * @param size         Number of bytes to read.
+ * @param deadline_ms  Value of now_ms() when the read times out.
+ * @param ascii        Fail as soon as a newline (the end of an ASCII reply) is read before `size` bytes.
  *
- * @return Returns the number of bytes actually read on success, or -1 on error.
+ * @return Returns 0 if all the bytes were read, or -1 on error, timeout or a short ASCII reply.
  */
-static ssize_t read_port(int fd, uint8_t *buffer, size_t size)
+static int read_exact(int fd, uint8_t *buffer, size_t size, int64_t deadline_ms, bool ascii)
 {
     size_t received = 0;
+
     while (received < size) {
+        const int64_t remaining_ms = deadline_ms - now_ms();
+        if (remaining_ms <= 0) {
+            LT_LOG_ERROR("Timeout when reading from port, received %zu of %zu bytes.", received, size);
+            return -1;
+        }
+
+        struct pollfd pfd = {.fd = fd, .events = POLLIN};
+        int ready = poll(&pfd, 1, (int)remaining_ms);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LT_LOG_ERROR("poll() failed: %s (%d).", strerror(errno), errno);
+            return -1;
+        }
+        if (ready == 0) {
+            continue;
+        }
+        if (pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) {
+            LT_LOG_ERROR("Port closed or in error, revents=0x%x.", (unsigned)pfd.revents);
+            return -1;
+        }
+
         ssize_t read_bytes = read(fd, buffer + received, size - received);
         if (read_bytes < 0) {
-            LT_LOG_ERROR("Failed to read from port, read_bytes=%zd.", read_bytes);
+            if (errno == EINTR || errno == EAGAIN) {
+                continue;
+            }
+            LT_LOG_ERROR("Failed to read from port: %s (%d).", strerror(errno), errno);
+            return -1;
+        }
+        received += read_bytes;
+
+        if (ascii && received < size && memchr(buffer + received - read_bytes, '\n', read_bytes)) {
+            LT_LOG_ERROR("Unexpected reply of length %zu, expected %zu.", received, size);
             return -1;
         }
-        if (read_bytes == 0) {
-            // Timeout.
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Reads an ASCII reply of the dongle from a serial port (specified by fd).
+ *
+ * @note  A reply terminated sooner than expected (e.g. an error reply) is detected right away, without waiting for the
+ *        timeout.
+ *
+ * @param fd          The file descriptor to read from.
+ * @param buffer      Pointer to the buffer where the reply will be stored.
+ * @param size        Expected length of the reply, including `LT_USB_DONGLE_TERMINATOR`.
+ * @param timeout_ms  Time to wait for the whole reply.
+ *
+ * @return Returns 0 if the whole reply was read, or -1 on error, timeout or unexpected reply.
+ */
+static int read_reply(int fd, uint8_t *buffer, size_t size, int64_t timeout_ms)
+{
+    if (read_exact(fd, buffer, size, now_ms() + timeout_ms, true) != 0) {
+        return -1;
+    }
+
+    if (memcmp(buffer + size - LT_USB_DONGLE_TERMINATOR_LEN, LT_USB_DONGLE_TERMINATOR,
+               LT_USB_DONGLE_TERMINATOR_LEN)
+        != 0) {
+        LT_LOG_ERROR("Reply is not terminated correctly.");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Returns the termios speed of a standard baud rate.
+ *
+ * @param baud_rate  Baud rate
+ * @return           Speed constant, or B0 if the baud rate is not a standard one.
+ */
+static speed_t baud_rate_to_speed(const uint32_t baud_rate)
+{
+    switch (baud_rate) {
+        case 4800:
+            return B4800;
+        case 9600:
+            return B9600;
+        case 19200:
+            return B19200;
+        case 38400:
+            return B38400;
+#ifdef B57600
+        case 57600:
+            return B57600;
+#endif
+        case 115200:
+            return B115200;
+#ifdef B230400
+        case 230400:
+            return B230400;
+#endif
+#ifdef B460800
+        case 460800:
+            return B460800;
+#endif
+#ifdef B921600
+        case 921600:
+            return B921600;
+#endif
+#ifdef B1000000
+        case 1000000:
+            return B1000000;
+#endif
+#ifdef B2000000
+        case 2000000:
+            return B2000000;
+#endif
+#ifdef B3000000
+        case 3000000:
+            return B3000000;
+#endif
+#ifdef B4000000
+        case 4000000:
+            return B4000000;
+#endif
+        default:
+            return B0;
+    }
+}
+
+/**
+ * @brief Builds a binary request frame.
+ *
+ * @param frame  Buffer for the frame, at least `len + LT_USB_DONGLE_BIN_OVERHEAD` bytes
+ * @param flags  Request flags (`LT_USB_DONGLE_BIN_FLAG_*`)
+ * @param data   Data to transfer over SPI, NULL if `len` is 0
+ * @param len    Number of bytes to transfer over SPI
+ *
+ * @return Length of the frame.
+ */
+static size_t bin_frame(uint8_t *frame, const uint8_t flags, const uint8_t *data, const uint16_t len)
+{
+    frame[0] = flags;
+    frame[1] = len & 0xff;
+    frame[2] = len >> 8;
+    if (len) {
+        memcpy(frame + LT_USB_DONGLE_BIN_HDR_LEN, data, len);
+    }
+    uint16_t crc = crc16(frame, LT_USB_DONGLE_BIN_HDR_LEN + len);
+    frame[LT_USB_DONGLE_BIN_HDR_LEN + len] = crc >> 8;
+    frame[LT_USB_DONGLE_BIN_HDR_LEN + len + 1] = crc & 0xff;
+
+    return len + LT_USB_DONGLE_BIN_OVERHEAD;
+}
+
+/**
+ * @brief Sends a binary frame to the dongle.
+ *
+ * @param device  Device structure
+ * @param flags   Request flags (`LT_USB_DONGLE_BIN_FLAG_*`)
+ * @param data    Data to transfer over SPI, NULL if `len` is 0
+ * @param len     Number of bytes to transfer over SPI
+ *
+ * @return Returns 0 on success, or -1 on error.
+ */
+static int bin_send(const lt_dev_posix_usb_dongle_t *device, const uint8_t flags, const uint8_t *data,
+                    const uint16_t len)
+{
+    uint8_t frame[TR01_L1_LEN_MAX + LT_USB_DONGLE_BIN_OVERHEAD];
+    return write_port(device->fd, frame, bin_frame(frame, flags, data, len));
+}
+
+/**
+ * @brief Reads a binary reply frame of the dongle and checks it.
+ *
+ * @param device       Device structure
+ * @param data         Buffer for the data received over SPI, written only if the frame is valid
+ * @param len          Expected number of bytes received over SPI
+ * @param deadline_ms  Value of now_ms() when the read times out
+ *
+ * @return Returns 0 on success, or -1 on error, timeout, CRC mismatch, unexpected length or error status.
+ */
+static int bin_read(const lt_dev_posix_usb_dongle_t *device, uint8_t *data, const uint16_t len,
+                    const int64_t deadline_ms)
+{
+    uint8_t frame[TR01_L1_LEN_MAX + LT_USB_DONGLE_BIN_OVERHEAD];
+
+    if (read_exact(device->fd, frame, LT_USB_DONGLE_BIN_HDR_LEN, deadline_ms, false) != 0) {
+        return -1;
+    }
+    const uint16_t rx_len = frame[1] | (frame[2] << 8);
+    // Error replies carry no data, other lengths mean the stream is out of sync.
+    if (rx_len != len && !(rx_len == 0 && frame[0] != LT_USB_DONGLE_BIN_STATUS_OK)) {
+        LT_LOG_ERROR("Unexpected binary reply length %" PRIu16 ", expected %" PRIu16 ".", rx_len, len);
+        return -1;
+    }
+    if (read_exact(device->fd, frame + LT_USB_DONGLE_BIN_HDR_LEN, rx_len + LT_USB_DONGLE_BIN_CRC_LEN, deadline_ms,
+                   false)
+        != 0) {
+        return -1;
+    }
+
+    const uint16_t crc = crc16(frame, LT_USB_DONGLE_BIN_HDR_LEN + rx_len);
+    if (frame[LT_USB_DONGLE_BIN_HDR_LEN + rx_len] != (crc >> 8)
+        || frame[LT_USB_DONGLE_BIN_HDR_LEN + rx_len + 1] != (crc & 0xff)) {
+        LT_LOG_ERROR("Wrong CRC of binary reply.");
+        return -1;
+    }
+    if (frame[0] != LT_USB_DONGLE_BIN_STATUS_OK) {
+        LT_LOG_ERROR("Dongle returned status 0x%02" PRIX8 ".", frame[0]);
+        return -1;
+    }
+
+    if (len) {
+        memcpy(data, frame + LT_USB_DONGLE_BIN_HDR_LEN, len);
+    }
+    return 0;
+}
+
+/**
+ * @brief Reads the acknowledgements of the CSN high frames sent without waiting for them.
+ *
+ * @param device       Device structure
+ * @param deadline_ms  Value of now_ms() when the read times out
+ *
+ * @return Returns 0 on success, or -1 if some of the frames failed.
+ */
+static int bin_read_csn_acks(lt_dev_posix_usb_dongle_t *device, const int64_t deadline_ms)
+{
+    int ret = 0;
+    while (device->csn_acks_pending) {
+        device->csn_acks_pending--;
+        if (bin_read(device, NULL, 0, deadline_ms) != 0) {
+            ret = -1;
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief Asks the dongle to switch to the binary framing.
+ *
+ * @param device  Device structure
+ *
+ * @return Returns 0 if the dongle switched, or -1 if it does not support the binary framing.
+ */
+static int bin_negotiate(lt_dev_posix_usb_dongle_t *device)
+{
+    static const uint8_t cmd[] = LT_USB_DONGLE_CMD_BINARY;
+    uint8_t buff[4];
+
+    if (write_port(device->fd, cmd, sizeof(cmd) - 1) != 0) {
+        return -1;
+    }
+    if (read_reply(device->fd, buff, sizeof(buff), reply_timeout_ms(device, sizeof(cmd) - 1 + sizeof(buff))) == 0
+        && memcmp(buff, "OK" LT_USB_DONGLE_TERMINATOR, sizeof(buff)) == 0) {
+        return 0;
+    }
+
+    // Drop the rest of whatever the dongle answered, so it does not end up in the next reply.
+    usleep(LT_USB_DONGLE_REPLY_TIMEOUT_MS * 1000 / 10);
+    if (tcflush(device->fd, TCIFLUSH)) {
+        LT_LOG_WARN("tcflush failed: %s (%d).", strerror(errno), errno);
+    }
+    return -1;
+}
+
+/** @brief Kinds of replies read by the I/O thread (`lt_usb_dongle_io_t.kind`). */
+enum {
+    /** @brief Hex characters of the received bytes, terminated by `LT_USB_DONGLE_TERMINATOR`. */
+    LT_USB_DONGLE_IO_ASCII_DATA = 0,
+    /** @brief "OK" terminated by `LT_USB_DONGLE_TERMINATOR`. */
+    LT_USB_DONGLE_IO_ASCII_OK,
+    /** @brief Binary reply frame. */
+    LT_USB_DONGLE_IO_BINARY
+};
+
+/**
+ * @brief Reads and decodes the reply to a submitted transfer (runs in the I/O thread).
+ *
+ * @param device  Device structure
+ * @param io      Submitted transfer
+ *
+ * @return LT_OK if the reply is valid, LT_L1_SPI_ERROR otherwise.
+ */
+static lt_ret_t io_read_reply(lt_dev_posix_usb_dongle_t *device, lt_usb_dongle_io_t *io)
+{
+    uint8_t chars[LT_USB_DONGLE_SPI_TRANSFER_BUFF_SIZE_MAX];
+
+    switch (io->kind) {
+        case LT_USB_DONGLE_IO_ASCII_DATA: {
+            const size_t reply_len = (io->len * 2) + LT_USB_DONGLE_TERMINATOR_LEN;
+            if (read_reply(device->fd, chars, reply_len, reply_timeout_ms(device, 2 * reply_len)) != 0
+                || lt_hex_decode((char *)chars, io->len, io->rx) != LT_OK) {
+                return LT_L1_SPI_ERROR;
+            }
+            return LT_OK;
+        }
+        case LT_USB_DONGLE_IO_ASCII_OK:
+            if (read_reply(device->fd, chars, 4, reply_timeout_ms(device, 2 * 5)) != 0
+                || memcmp(chars, "OK" LT_USB_DONGLE_TERMINATOR, 4) != 0) {
+                return LT_L1_SPI_ERROR;
+            }
+            return LT_OK;
+        case LT_USB_DONGLE_IO_BINARY:
+            if (bin_read(device, io->rx, io->len,
+                         now_ms() + reply_timeout_ms(device, 2 * (io->len + LT_USB_DONGLE_BIN_OVERHEAD)))
+                != 0) {
+                return LT_L1_SPI_ERROR;
+            }
+            return LT_OK;
+        default:
+            return LT_L1_SPI_ERROR;
+    }
+}
+
+/**
+ * @brief I/O thread: reads the replies to the submitted transfers in the order they were sent.
+ *
+ * @param arg  Device structure
+ * @return     NULL
+ */
+static void *io_thread_main(void *arg)
+{
+    lt_dev_posix_usb_dongle_t *device = arg;
+
+    pthread_mutex_lock(&device->io_lock);
+    for (;;) {
+        while (!device->io_stop && device->io_completed == device->io_submitted) {
+            pthread_cond_wait(&device->io_cond, &device->io_lock);
+        }
+        if (device->io_completed == device->io_submitted) {
             break;
         }
-        received += read_bytes;
+        lt_usb_dongle_io_t *io = &device->io_queue[device->io_completed % LT_USB_DONGLE_IO_QUEUE_DEPTH];
+        pthread_mutex_unlock(&device->io_lock);
+
+        // The submitter does not touch the transfer until it is completed.
+        lt_ret_t ret = io_read_reply(device, io);
+
+        pthread_mutex_lock(&device->io_lock);
+        io->ret = ret;
+        if (io->posted && ret != LT_OK && device->io_posted_ret == LT_OK) {
+            device->io_posted_ret = ret;
+        }
+        device->io_completed++;
+        pthread_cond_broadcast(&device->io_cond);
+    }
+    pthread_mutex_unlock(&device->io_lock);
+
+    return NULL;
+}
+
+/**
+ * @brief Sends a frame and submits the reading of its reply to the I/O thread.
+ *
+ * @param device     Device structure
+ * @param frame      Frame to send
+ * @param frame_len  Length of the frame
+ * @param kind       Kind of the expected reply
+ * @param len        Number of bytes transferred over SPI
+ * @param rx         Buffer for the bytes received over SPI, or NULL to post the transfer without waiting for the
+ *                   reply (its errors are then reported by the next waited transfer)
+ *
+ * @return LT_OK on success, LT_L1_SPI_ERROR if the frame could not be sent or the transfer (or one posted before it)
+ *         failed.
+ */
+static lt_ret_t io_submit(lt_dev_posix_usb_dongle_t *device, const uint8_t *frame, const size_t frame_len,
+                          const uint8_t kind, const uint16_t len, uint8_t *rx)
+{
+    pthread_mutex_lock(&device->io_lock);
+    while (device->io_submitted - device->io_completed >= LT_USB_DONGLE_IO_QUEUE_DEPTH) {
+        pthread_cond_wait(&device->io_cond, &device->io_lock);
+    }
+    const uint32_t seq = device->io_submitted;
+    lt_usb_dongle_io_t *io = &device->io_queue[seq % LT_USB_DONGLE_IO_QUEUE_DEPTH];
+    pthread_mutex_unlock(&device->io_lock);
+
+    // Only this thread submits, so the slot stays reserved. The frame is sent before the transfer is published, so
+    // the I/O thread never waits for a reply to a frame which was not sent.
+    io->kind = kind;
+    io->posted = (rx == NULL);
+    io->len = len;
+    io->ret = LT_OK;
+    if (write_port(device->fd, frame, frame_len) != 0) {
+        return LT_L1_SPI_ERROR;
+    }
+
+    pthread_mutex_lock(&device->io_lock);
+    device->io_submitted++;
+    pthread_cond_broadcast(&device->io_cond);
+
+    lt_ret_t ret = LT_OK;
+    if (rx) {
+        while ((int32_t)(device->io_completed - seq) <= 0) {
+            pthread_cond_wait(&device->io_cond, &device->io_lock);
+        }
+        ret = device->io_posted_ret != LT_OK ? device->io_posted_ret : io->ret;
+        device->io_posted_ret = LT_OK;
+        if (ret == LT_OK) {
+            memcpy(rx, io->rx, len);
+        }
     }
-    return received;
+    pthread_mutex_unlock(&device->io_lock);
+
+    return ret;
+}
+
+/**
+ * @brief Waits for the replies to all submitted transfers and stops the I/O thread.
+ *
+ * @param device  Device structure
+ *
+ * @return LT_OK if all posted transfers succeeded, LT_L1_SPI_ERROR otherwise.
+ */
+static lt_ret_t io_stop(lt_dev_posix_usb_dongle_t *device)
+{
+    pthread_mutex_lock(&device->io_lock);
+    device->io_stop = true;
+    pthread_cond_broadcast(&device->io_cond);
+    pthread_mutex_unlock(&device->io_lock);
+
+    pthread_join(device->io_thread, NULL);
+    pthread_cond_destroy(&device->io_cond);
+    pthread_mutex_destroy(&device->io_lock);
+
+    return device->io_posted_ret;
 }
 
 lt_ret_t lt_port_init(lt_l2_state_t *s2)
@@ -118,40 +600,29 @@ lt_ret_t lt_port_init(lt_l2_state_t *s2)
     }
 
     // Turn off any options that might interfere with our ability to send and
-    // receive raw binary bytes.
-    options.c_iflag &= ~(INLCR | IGNCR | ICRNL | IXON | IXOFF);
-    options.c_oflag &= ~(ONLCR | OCRNL);
+    // receive raw binary bytes (the binary framing uses all byte values).
+    options.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL | IXON | IXOFF);
+    options.c_oflag &= ~(OPOST | ONLCR | OCRNL);
     options.c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
+    options.c_cflag &= ~(CSIZE | PARENB);
+    options.c_cflag |= CS8;
 
-    // Set up timeouts: Calls to read() will return as soon as there is
-    // at least one byte available or when 100 ms has passed.
-    options.c_cc[VTIME] = 1;
+    // Reads never block, read_reply() waits for the data with poll().
+    options.c_cc[VTIME] = 0;
     options.c_cc[VMIN] = 0;
 
-    // This code only supports certain standard baud rates. Supporting
-    // non-standard baud rates should be possible but takes more work.
-    switch (device->baud_rate) {
-        case 4800:
-            cfsetospeed(&options, B4800);
-            break;
-        case 9600:
-            cfsetospeed(&options, B9600);
-            break;
-        case 19200:
-            cfsetospeed(&options, B19200);
-            break;
-        case 38400:
-            cfsetospeed(&options, B38400);
-            break;
-        case 115200:
-            cfsetospeed(&options, B115200);
-            break;
-        default:
-            LT_LOG_WARN("Baud rate %" PRIu32 " is not supported, using 9600.\n", device->baud_rate);
-            cfsetospeed(&options, B9600);
-            break;
+    // Standard baud rates are set by termios, the others (on Linux) by termios2 once the rest is configured.
+    speed_t speed = baud_rate_to_speed(device->baud_rate);
+#ifndef __linux__
+    if (speed == B0) {
+        LT_LOG_WARN("Baud rate %" PRIu32 " is not supported, using 9600.", device->baud_rate);
+        speed = B9600;
+    }
+#endif
+    if (speed != B0) {
+        cfsetospeed(&options, speed);
+        cfsetispeed(&options, speed);
     }
-    cfsetispeed(&options, cfgetospeed(&options));
 
     result = tcsetattr(device->fd, TCSANOW, &options);
     if (result) {
@@ -160,17 +631,93 @@ lt_ret_t lt_port_init(lt_l2_state_t *s2)
         return LT_FAIL;
     }
 
+#ifdef __linux__
+    if (speed == B0 && lt_usb_dongle_set_baud_termios2(device->fd, device->baud_rate)) {
+        LT_LOG_ERROR("Setting baud rate %" PRIu32 " failed: %s (%d).", device->baud_rate, strerror(errno), errno);
+        close(device->fd);
+        return LT_FAIL;
+    }
+#endif
+
+    device->binary = false;
+    device->csn_acks_pending = 0;
+    if (device->framing != LT_USB_DONGLE_FRAMING_ASCII) {
+        if (bin_negotiate(device) == 0) {
+            device->binary = true;
+        }
+        else if (device->framing == LT_USB_DONGLE_FRAMING_BINARY) {
+            LT_LOG_ERROR("Dongle does not support the binary framing.");
+            close(device->fd);
+            return LT_FAIL;
+        }
+        else {
+            LT_LOG_INFO("Dongle does not support the binary framing, using the ASCII protocol.");
+        }
+    }
+
+    if (device->async) {
+        device->io_submitted = 0;
+        device->io_completed = 0;
+        device->io_posted_ret = LT_OK;
+        device->io_stop = false;
+        if (pthread_mutex_init(&device->io_lock, NULL) != 0) {
+            LT_LOG_ERROR("Cannot create the I/O lock.");
+            close(device->fd);
+            return LT_FAIL;
+        }
+        if (pthread_cond_init(&device->io_cond, NULL) != 0) {
+            LT_LOG_ERROR("Cannot create the I/O condition variable.");
+            pthread_mutex_destroy(&device->io_lock);
+            close(device->fd);
+            return LT_FAIL;
+        }
+        if (pthread_create(&device->io_thread, NULL, io_thread_main, device) != 0) {
+            LT_LOG_ERROR("Cannot start the I/O thread.");
+            pthread_cond_destroy(&device->io_cond);
+            pthread_mutex_destroy(&device->io_lock);
+            close(device->fd);
+            return LT_FAIL;
+        }
+    }
+
     return LT_OK;
 }
 
 lt_ret_t lt_port_deinit(lt_l2_state_t *s2)
 {
     lt_dev_posix_usb_dongle_t *device = (lt_dev_posix_usb_dongle_t *)s2->device;
+    lt_ret_t ret = LT_OK;
+
+    if (device->async) {
+        if (device->binary) {
+            // Leave the dongle in the ASCII protocol, which is what the next user of the dongle expects.
+            uint8_t frame[LT_USB_DONGLE_BIN_OVERHEAD];
+            uint8_t rx_unused;
+            if (io_submit(device, frame, bin_frame(frame, LT_USB_DONGLE_BIN_FLAG_ASCII, NULL, 0),
+                          LT_USB_DONGLE_IO_BINARY, 0, &rx_unused)
+                != LT_OK) {
+                ret = LT_FAIL;
+            }
+            device->binary = false;
+        }
+        if (io_stop(device) != LT_OK) {
+            ret = LT_FAIL;
+        }
+    }
+    else if (device->binary) {
+        // Leave the dongle in the ASCII protocol, which is what the next user of the dongle expects.
+        const int64_t deadline_ms = now_ms() + reply_timeout_ms(device, 2 * 2 * LT_USB_DONGLE_BIN_OVERHEAD);
+        if (bin_read_csn_acks(device, deadline_ms) != 0 || bin_send(device, LT_USB_DONGLE_BIN_FLAG_ASCII, NULL, 0) != 0
+            || bin_read(device, NULL, 0, deadline_ms) != 0) {
+            ret = LT_FAIL;
+        }
+        device->binary = false;
+    }
 
     if (close(device->fd)) {
         return LT_FAIL;
     }
-    return LT_OK;
+    return ret;
 }
 
 lt_ret_t lt_port_delay(lt_l2_state_t *s2, uint32_t ms)
@@ -220,19 +767,40 @@ lt_ret_t lt_port_spi_csn_low(lt_l2_state_t *s2)
 lt_ret_t lt_port_spi_csn_high(lt_l2_state_t *s2)
 {
     lt_dev_posix_usb_dongle_t *device = (lt_dev_posix_usb_dongle_t *)s2->device;
+    static const uint8_t cs_high[] = "CS=0\n";  // Yes, CS=0 really means that CSN is low
+
+    if (device->async) {
+        // Nothing is received during CSN release, so it is posted.
+        if (device->binary) {
+            uint8_t frame[LT_USB_DONGLE_BIN_OVERHEAD];
+            return io_submit(device, frame, bin_frame(frame, LT_USB_DONGLE_BIN_FLAG_CSN_HIGH, NULL, 0),
+                             LT_USB_DONGLE_IO_BINARY, 0, NULL);
+        }
+        return io_submit(device, cs_high, sizeof(cs_high) - 1, LT_USB_DONGLE_IO_ASCII_OK, 0, NULL);
+    }
 
-    uint8_t cs_high[] = "CS=0\n";  // Yes, CS=0 really means that CSN is low
-    if (write_port(device->fd, cs_high, 5) != 0) {
+    if (device->binary) {
+        // CSN goes high as soon as the dongle gets the frame. Its acknowledgement is read together with the reply to
+        // the next frame, which saves a round trip per L1 frame.
+        if (bin_read_csn_acks(device, now_ms() + reply_timeout_ms(device, 2 * LT_USB_DONGLE_BIN_OVERHEAD)) != 0
+            || bin_send(device, LT_USB_DONGLE_BIN_FLAG_CSN_HIGH, NULL, 0) != 0) {
+            return LT_L1_SPI_ERROR;
+        }
+        device->csn_acks_pending = 1;
+        return LT_OK;
+    }
+
+    if (write_port(device->fd, cs_high, sizeof(cs_high) - 1) != 0) {
         return LT_L1_SPI_ERROR;
     }
 
     uint8_t buff[4];
-    int read_bytes = read_port(device->fd, buff, 4);
-    if (read_bytes != 4) {
+    if (read_reply(device->fd, buff, sizeof(buff), reply_timeout_ms(device, sizeof(cs_high) - 1 + sizeof(buff)))
+        != 0) {
         return LT_L1_SPI_ERROR;
     }
 
-    if (memcmp(buff, "OK\r\n", 4) != 0) {
+    if (memcmp(buff, "OK" LT_USB_DONGLE_TERMINATOR, sizeof(buff)) != 0) {
         return LT_L1_SPI_ERROR;
     }
     return LT_OK;
@@ -248,31 +816,59 @@ lt_ret_t lt_port_spi_transfer(lt_l2_state_t *s2, uint8_t offset, uint16_t tx_dat
         return LT_L1_DATA_LEN_ERROR;
     }
 
-    // Bytes from handle which are about to be sent are encoded as chars and stored to buffered_chars.
-    uint8_t buffered_chars[LT_USB_DONGLE_SPI_TRANSFER_BUFF_SIZE_MAX] = {0};
-    for (int i = 0; i < tx_data_length; i++) {
-        sprintf((char *)(buffered_chars + i * 2), "%02" PRIX8, s2->buff[i + offset]);
+    if (device->async) {
+        // L1 ignores the bytes received during an L2 Request frame (they are not defined, except for CHIP_STATUS), so
+        // such transfer is posted and the next frame can be encoded and sent while the dongle is still clocking it.
+        const bool posted = (offset == 0 && s2->buff[0] != TR01_L1_GET_RESPONSE_REQ_ID);
+        uint8_t *rx = posted ? NULL : s2->buff + offset;
+        uint8_t frame[LT_USB_DONGLE_SPI_TRANSFER_BUFF_SIZE_MAX];
+
+        if (device->binary) {
+            return io_submit(device, frame, bin_frame(frame, 0, s2->buff + offset, tx_data_length),
+                             LT_USB_DONGLE_IO_BINARY, tx_data_length, rx);
+        }
+        lt_hex_encode(s2->buff + offset, tx_data_length, (char *)frame);
+        frame[tx_data_length * 2] = 'x';
+        frame[tx_data_length * 2 + 1] = '\n';
+        return io_submit(device, frame, (tx_data_length * 2) + 2, LT_USB_DONGLE_IO_ASCII_DATA, tx_data_length, rx);
+    }
+
+    if (device->binary) {
+        const uint8_t acks = device->csn_acks_pending;
+        const int64_t deadline_ms
+            = now_ms() + reply_timeout_ms(device, 2 * (tx_data_length + (1 + acks) * LT_USB_DONGLE_BIN_OVERHEAD));
+        if (bin_send(device, 0, s2->buff + offset, tx_data_length) != 0) {
+            return LT_L1_SPI_ERROR;
+        }
+        if (bin_read_csn_acks(device, deadline_ms) != 0
+            || bin_read(device, s2->buff + offset, tx_data_length, deadline_ms) != 0) {
+            return LT_L1_SPI_ERROR;
+        }
+        return LT_OK;
     }
 
+    // Bytes from handle which are about to be sent are encoded as chars and stored to buffered_chars.
+    uint8_t buffered_chars[LT_USB_DONGLE_SPI_TRANSFER_BUFF_SIZE_MAX];
+    lt_hex_encode(s2->buff + offset, tx_data_length, (char *)buffered_chars);
+
     // Control characters to keep CS LOW (they are expected by USB dongle, see the top of this file
     // for more information).
     buffered_chars[tx_data_length * 2] = 'x';
     buffered_chars[tx_data_length * 2 + 1] = '\n';
 
-    int ret = write_port(device->fd, buffered_chars, (tx_data_length * 2) + 2);
-    if (ret != 0) {
+    const size_t frame_len = (tx_data_length * 2) + 2;
+    if (write_port(device->fd, buffered_chars, frame_len) != 0) {
         return LT_L1_SPI_ERROR;
     }
 
-    lt_port_delay(s2, LT_USB_DONGLE_READ_WRITE_DELAY);
-
-    int read_bytes = read_port(device->fd, buffered_chars, (2 * tx_data_length) + 2);
-    if (read_bytes != ((2 * tx_data_length) + 2)) {
+    // The reply carries the received bytes as chars, terminated by LT_USB_DONGLE_TERMINATOR.
+    if (read_reply(device->fd, buffered_chars, frame_len, reply_timeout_ms(device, 2 * frame_len)) != 0) {
         return LT_L1_SPI_ERROR;
     }
 
-    for (size_t count = 0; count < tx_data_length; count++) {
-        sscanf((char *)&buffered_chars[count * 2], "%02" SCNx8, &s2->buff[count + offset]);
+    if (lt_hex_decode((char *)buffered_chars, tx_data_length, s2->buff + offset) != LT_OK) {
+        LT_LOG_ERROR("Dongle returned non-hex characters.");
+        return LT_L1_SPI_ERROR;
     }
 
     return LT_OK;
@@ -9,14 +9,50 @@
  * @license For the license see file LICENSE.txt file in the root directory of this source tree.
  */
 
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
 #include "libtropic_port.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-#define LT_USB_DONGLE_READ_WRITE_DELAY 10
-#define LT_USB_DONGLE_SPI_TRANSFER_BUFF_SIZE_MAX ((TR01_L1_LEN_MAX * 2) + 1)
+#define LT_USB_DONGLE_SPI_TRANSFER_BUFF_SIZE_MAX ((TR01_L1_LEN_MAX * 2) + 2)
+/** @brief Time the dongle has to answer a command, on top of the time the command and the reply take on the wire. */
+#define LT_USB_DONGLE_REPLY_TIMEOUT_MS 100
+
+/**
+ * @brief Framing of the SPI transfers sent to the dongle.
+ */
+typedef enum lt_usb_dongle_framing_t {
+    /** @brief ASCII protocol: hex characters terminated by a newline, CSN released by a separate command. */
+    LT_USB_DONGLE_FRAMING_ASCII = 0,
+    /** @brief Binary framing if the dongle accepts it in `lt_port_init()`, ASCII otherwise. */
+    LT_USB_DONGLE_FRAMING_AUTO,
+    /** @brief Binary framing, `lt_port_init()` fails if the dongle does not accept it. */
+    LT_USB_DONGLE_FRAMING_BINARY
+} lt_usb_dongle_framing_t;
+
+/** @brief Number of transfers which can wait for the reply of the dongle when `async` is enabled. */
+#define LT_USB_DONGLE_IO_QUEUE_DEPTH 8
+
+/**
+ * @brief Transfer submitted to the I/O thread, whose reply the thread reads and decodes.
+ */
+typedef struct lt_usb_dongle_io_t {
+    /** @brief Kind of the expected reply. */
+    uint8_t kind;
+    /** @brief The submitter does not wait for the reply, errors are reported by the next waited transfer. */
+    bool posted;
+    /** @brief Number of bytes transferred over SPI. */
+    uint16_t len;
+    /** @brief Result of the transfer, set by the I/O thread. */
+    lt_ret_t ret;
+    /** @brief Bytes received over SPI, set by the I/O thread. */
+    uint8_t rx[TR01_L1_LEN_MAX];
+} lt_usb_dongle_io_t;
 
 /**
  * @brief Device structure for USB Dongle POSIX port.
@@ -27,11 +63,36 @@ extern "C" {
 typedef struct lt_dev_posix_usb_dongle_t {
     /** @public @brief Path to USB UART device. */
     char dev_path[LT_DEVICE_PATH_MAX_LEN];
-    /** @public @brief UART baudrate. */
+    /** @public @brief UART baudrate. Non-standard baud rates are supported on Linux only. */
     uint32_t baud_rate;
+    /** @public @brief Requested framing, the ASCII protocol by default. */
+    lt_usb_dongle_framing_t framing;
+    /** @public @brief Read the replies of the dongle in an I/O thread, so L2 Request frames and CSN releases are sent
+     * without waiting for them. Needs the application to be linked with pthreads. */
+    bool async;
 
     /** @private @brief UART device file descriptor. */
     int fd;
+    /** @private @brief The binary framing was negotiated in `lt_port_init()`. */
+    bool binary;
+    /** @private @brief Number of CSN high frames whose acknowledgements were not read yet (binary framing only). */
+    uint8_t csn_acks_pending;
+    /** @private @brief I/O thread reading the replies (`async` only). */
+    pthread_t io_thread;
+    /** @private @brief Protects the queue and the counters below. */
+    pthread_mutex_t io_lock;
+    /** @private @brief Signals submitted and completed transfers. */
+    pthread_cond_t io_cond;
+    /** @private @brief Ring of transfers, indexed by their sequence number. */
+    lt_usb_dongle_io_t io_queue[LT_USB_DONGLE_IO_QUEUE_DEPTH];
+    /** @private @brief Number of transfers submitted to the I/O thread. */
+    uint32_t io_submitted;
+    /** @private @brief Number of transfers whose reply was read by the I/O thread. */
+    uint32_t io_completed;
+    /** @private @brief First error of a posted transfer, not reported yet. */
+    lt_ret_t io_posted_ret;
+    /** @private @brief The I/O thread should end once the queue is empty. */
+    bool io_stop;
 } lt_dev_posix_usb_dongle_t;
 
 #ifdef __cplusplus
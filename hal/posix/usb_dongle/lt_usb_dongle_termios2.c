@@ -0,0 +1,29 @@
+/**
+ * @file lt_usb_dongle_termios2.c
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief Arbitrary baud rates of the USB Dongle (TS1302) serial port, using Linux's termios2.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include "lt_usb_dongle_termios2.h"
+
+#include <asm/termbits.h>
+#include <stdint.h>
+#include <sys/ioctl.h>
+
+int lt_usb_dongle_set_baud_termios2(int fd, uint32_t baud_rate)
+{
+    struct termios2 options;
+
+    if (ioctl(fd, TCGETS2, &options)) {
+        return -1;
+    }
+
+    options.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+    options.c_cflag |= BOTHER | (BOTHER << IBSHIFT);
+    options.c_ispeed = baud_rate;
+    options.c_ospeed = baud_rate;
+
+    return ioctl(fd, TCSETS2, &options);
+}
@@ -0,0 +1,35 @@
+#ifndef LT_USB_DONGLE_TERMIOS2_H
+#define LT_USB_DONGLE_TERMIOS2_H
+
+/**
+ * @file lt_usb_dongle_termios2.h
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief Arbitrary baud rates of the USB Dongle (TS1302) serial port, using Linux's termios2.
+ *
+ * Linux's `struct termios2` is declared in `<asm/termbits.h>`, which conflicts with `<termios.h>`, so it is only used
+ * in its own translation unit, which is compiled on Linux only.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Sets an arbitrary input and output baud rate of a serial port (the `BOTHER` speed of termios2).
+ * @note Other attributes of the port are kept.
+ *
+ * @param fd         File descriptor of the serial port
+ * @param baud_rate  Baud rate
+ * @return           0 on success, -1 on error (with `errno` set).
+ */
+int lt_usb_dongle_set_baud_termios2(int fd, uint32_t baud_rate);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LT_USB_DONGLE_TERMIOS2_H
@@ -0,0 +1,209 @@
+/**
+ * @file libtropic_port_rtos.c
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief Port wrapping another port and making its waits RTOS friendly (FreeRTOS or Zephyr).
+ *
+ * The INT semaphore is not drained before a wait: an edge given before the wait started (e.g. between reading
+ * CHIP_STATUS and the wait) must wake the task, while a stale one only costs libtropic one more CHIP_STATUS poll.
+ *
+ * The functions forwarding to the inner port point `s2->device` to the inner device for the duration of the call, so
+ * they do not lock: a second task would read the inner device instead of this one. Tasks sharing a handle hold
+ * `lt_rtos_lock()` around whole libtropic calls instead.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include "libtropic_port_rtos.h"
+
+#include <stdint.h>
+
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "libtropic_macros.h"
+#include "libtropic_port.h"
+
+#if !LT_RTOS_ZEPHYR
+#include "task.h"
+#endif
+
+// Functions of the inner port, renamed at compile time.
+lt_ret_t lt_rtos_inner_port_init(lt_l2_state_t *s2);
+lt_ret_t lt_rtos_inner_port_deinit(lt_l2_state_t *s2);
+lt_ret_t lt_rtos_inner_port_spi_csn_low(lt_l2_state_t *s2);
+lt_ret_t lt_rtos_inner_port_spi_csn_high(lt_l2_state_t *s2);
+lt_ret_t lt_rtos_inner_port_spi_transfer(lt_l2_state_t *s2, uint8_t offset, uint16_t tx_len, uint32_t timeout_ms);
+lt_ret_t lt_rtos_inner_port_random_bytes(lt_l2_state_t *s2, void *buff, size_t count);
+
+#if !LT_RTOS_ZEPHYR
+/** @brief Converts milliseconds to ticks, rounding up, so the task never waits shorter than requested. */
+static TickType_t ms_to_ticks(uint32_t ms)
+{
+    return (TickType_t)(((uint64_t)ms * configTICK_RATE_HZ + 999) / 1000);
+}
+#endif
+
+void lt_rtos_lock(lt_dev_rtos_t *dev)
+{
+#if LT_RTOS_ZEPHYR
+    k_mutex_lock(&dev->lock, K_FOREVER);
+#else
+    xSemaphoreTakeRecursive(dev->lock, portMAX_DELAY);
+#endif
+}
+
+void lt_rtos_unlock(lt_dev_rtos_t *dev)
+{
+#if LT_RTOS_ZEPHYR
+    k_mutex_unlock(&dev->lock);
+#else
+    xSemaphoreGiveRecursive(dev->lock);
+#endif
+}
+
+#if LT_USE_INT_PIN
+void lt_rtos_int_isr(lt_dev_rtos_t *dev)
+{
+#if LT_RTOS_ZEPHYR
+    k_sem_give(&dev->int_sem);
+#else
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(dev->int_sem, &woken);
+    portYIELD_FROM_ISR(woken);
+#endif
+}
+#endif
+
+lt_ret_t lt_port_init(lt_l2_state_t *s2)
+{
+    lt_dev_rtos_t *dev = (lt_dev_rtos_t *)(s2->device);
+
+#if LT_RTOS_ZEPHYR
+    k_mutex_init(&dev->lock);
+#if LT_USE_INT_PIN
+    k_sem_init(&dev->int_sem, 0, 1);
+#endif
+#else
+    dev->lock = xSemaphoreCreateRecursiveMutex();
+    if (!dev->lock) {
+        LT_LOG_ERROR("Failed to create the mutex");
+        return LT_FAIL;
+    }
+#if LT_USE_INT_PIN
+    dev->int_sem = xSemaphoreCreateBinary();
+    if (!dev->int_sem) {
+        LT_LOG_ERROR("Failed to create the INT semaphore");
+        vSemaphoreDelete(dev->lock);
+        dev->lock = NULL;
+        return LT_FAIL;
+    }
+#endif
+#endif
+
+    s2->device = dev->inner_device;
+    lt_ret_t ret = lt_rtos_inner_port_init(s2);
+    s2->device = dev;
+
+    return ret;
+}
+
+lt_ret_t lt_port_deinit(lt_l2_state_t *s2)
+{
+    lt_dev_rtos_t *dev = (lt_dev_rtos_t *)(s2->device);
+
+    s2->device = dev->inner_device;
+    lt_ret_t ret = lt_rtos_inner_port_deinit(s2);
+    s2->device = dev;
+
+#if !LT_RTOS_ZEPHYR
+#if LT_USE_INT_PIN
+    vSemaphoreDelete(dev->int_sem);
+    dev->int_sem = NULL;
+#endif
+    vSemaphoreDelete(dev->lock);
+    dev->lock = NULL;
+#endif
+
+    return ret;
+}
+
+lt_ret_t lt_port_spi_csn_low(lt_l2_state_t *s2)
+{
+    lt_dev_rtos_t *dev = (lt_dev_rtos_t *)(s2->device);
+
+    s2->device = dev->inner_device;
+    lt_ret_t ret = lt_rtos_inner_port_spi_csn_low(s2);
+    s2->device = dev;
+
+    return ret;
+}
+
+lt_ret_t lt_port_spi_csn_high(lt_l2_state_t *s2)
+{
+    lt_dev_rtos_t *dev = (lt_dev_rtos_t *)(s2->device);
+
+    s2->device = dev->inner_device;
+    lt_ret_t ret = lt_rtos_inner_port_spi_csn_high(s2);
+    s2->device = dev;
+
+    return ret;
+}
+
+lt_ret_t lt_port_spi_transfer(lt_l2_state_t *s2, uint8_t offset, uint16_t tx_data_length, uint32_t timeout_ms)
+{
+    lt_dev_rtos_t *dev = (lt_dev_rtos_t *)(s2->device);
+
+    s2->device = dev->inner_device;
+    lt_ret_t ret = lt_rtos_inner_port_spi_transfer(s2, offset, tx_data_length, timeout_ms);
+    s2->device = dev;
+
+    return ret;
+}
+
+lt_ret_t lt_port_delay(lt_l2_state_t *s2, uint32_t ms)
+{
+    LT_UNUSED(s2);
+
+#if LT_RTOS_ZEPHYR
+    k_msleep((int32_t)ms);
+#else
+    if (ms == 0) {
+        taskYIELD();
+    }
+    else {
+        // One tick more, the current tick is already partly gone.
+        vTaskDelay(ms_to_ticks(ms) + 1);
+    }
+#endif
+
+    return LT_OK;
+}
+
+#if LT_USE_INT_PIN
+lt_ret_t lt_port_delay_on_int(lt_l2_state_t *s2, uint32_t ms)
+{
+    lt_dev_rtos_t *dev = (lt_dev_rtos_t *)(s2->device);
+
+#if LT_RTOS_ZEPHYR
+    if (k_sem_take(&dev->int_sem, K_MSEC(ms)) != 0) {
+        return LT_L1_INT_TIMEOUT;
+    }
+#else
+    if (xSemaphoreTake(dev->int_sem, ms_to_ticks(ms) + 1) != pdTRUE) {
+        return LT_L1_INT_TIMEOUT;
+    }
+#endif
+
+    return LT_OK;
+}
+#endif
+
+lt_ret_t lt_port_random_bytes(lt_l2_state_t *s2, void *buff, size_t count)
+{
+    lt_dev_rtos_t *dev = (lt_dev_rtos_t *)(s2->device);
+
+    s2->device = dev->inner_device;
+    lt_ret_t ret = lt_rtos_inner_port_random_bytes(s2, buff, count);
+    s2->device = dev;
+
+    return ret;
+}
@@ -0,0 +1,88 @@
+#ifndef LIBTROPIC_PORT_RTOS_H
+#define LIBTROPIC_PORT_RTOS_H
+
+/**
+ * @file libtropic_port_rtos.h
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief Port wrapping another port and making its waits RTOS friendly (FreeRTOS or Zephyr).
+ *
+ * The wrapped (inner) port is compiled with its `lt_port_*` functions renamed to `lt_rtos_inner_port_*` (see
+ * `hal/rtos/CMakeLists.txt`), this port then implements `lt_port_*`: SPI, chip select and random bytes are forwarded
+ * to the inner port, delays and waits for the INT pin are done by the RTOS, so other tasks run meanwhile.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <stdint.h>
+
+#include "libtropic_common.h"
+
+#if LT_RTOS_ZEPHYR
+#include <zephyr/kernel.h>
+#else
+#include "FreeRTOS.h"
+#include "semphr.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Device structure for the RTOS port.
+ *
+ * @note Public members are meant to be configured by the developer before passing the handle to
+ *       libtropic.
+ */
+typedef struct lt_dev_rtos_t {
+    /** @public @brief Device structure of the inner port. */
+    void *inner_device;
+
+#if LT_RTOS_ZEPHYR
+    /** @private @brief Recursive mutex guarding the handle, see `lt_rtos_lock()`. */
+    struct k_mutex lock;
+    /** @private @brief Semaphore given by `lt_rtos_int_isr()`. */
+    struct k_sem int_sem;
+#else
+    /** @private @brief Recursive mutex guarding the handle, see `lt_rtos_lock()`. */
+    SemaphoreHandle_t lock;
+    /** @private @brief Binary semaphore given by `lt_rtos_int_isr()`. */
+    SemaphoreHandle_t int_sem;
+#endif
+} lt_dev_rtos_t;
+
+/**
+ * @brief Locks the handle for the calling task.
+ *
+ * The port does not lock by itself: an L2 request/response exchange spans two CSN frames and an L3 command several
+ * exchanges, and the port temporarily points the handle to the inner device during each call to the inner port. Tasks
+ * sharing one handle therefore have to hold the lock around each libtropic call. The lock is recursive.
+ *
+ * @note Valid between `lt_init()` and `lt_deinit()`, which create and delete the RTOS objects, so these two have to be
+ *       called before and after the handle is shared.
+ *
+ * @param dev  Device structure passed to libtropic
+ */
+void lt_rtos_lock(lt_dev_rtos_t *dev);
+
+/**
+ * @brief Unlocks the handle locked by `lt_rtos_lock()`.
+ *
+ * @param dev  Device structure passed to libtropic
+ */
+void lt_rtos_unlock(lt_dev_rtos_t *dev);
+
+#if LT_USE_INT_PIN
+/**
+ * @brief Wakes up the task waiting in `lt_port_delay_on_int()`. Call from the ISR of the rising edge on the INT pin.
+ *
+ * @param dev  Device structure passed to libtropic
+ */
+void lt_rtos_int_isr(lt_dev_rtos_t *dev);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LIBTROPIC_PORT_RTOS_H
@@ -0,0 +1,122 @@
+#ifndef LIBTROPIC_PORT_STM32_NUCLEO_F439ZI_DMA_H
+#define LIBTROPIC_PORT_STM32_NUCLEO_F439ZI_DMA_H
+
+/**
+ * @file libtropic_port_stm32_nucleo_f439zi_dma.h
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief Port for STM32 F439ZI using SPI with DMA and EXTI on the INT pin, sleeping the core while waiting.
+ *
+ * The DMA streams, their interrupts and the EXTI interrupt of the INT pin are owned by the application: link the DMA
+ * handles to the SPI handle in `HAL_SPI_MspInit()`, enable the interrupts in the NVIC and forward the HAL callbacks
+ * to the `lt_stm32_f439zi_dma_*_callback()` functions below.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "libtropic_port.h"
+#include "stm32f4xx_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef LT_STM32_DMA_MIN_LEN
+/** @brief Transfers shorter than this are done by polling, because setting up the DMA would take longer. */
+#define LT_STM32_DMA_MIN_LEN 16
+#endif
+
+/** @brief State of the SPI DMA transfer in progress. */
+typedef enum lt_stm32_dma_state_t {
+    LT_STM32_DMA_IDLE = 0,
+    LT_STM32_DMA_BUSY,
+    LT_STM32_DMA_DONE,
+    LT_STM32_DMA_ERROR
+} lt_stm32_dma_state_t;
+
+/**
+ * @brief Device structure for STM32 F439ZI DMA port.
+ *
+ * @note Public members are meant to be configured by the developer before passing the handle to
+ *       libtropic.
+ */
+typedef struct lt_dev_stm32_nucleo_f439zi_dma_t {
+    /** @brief @public Instance of STM SPI interface. Use STM32 macro (SPIX, e.g. SPI1). */
+    SPI_TypeDef *spi_instance;
+
+    /**
+     * @brief @public Baudrate prescaler value, used to set SPI speed. Use STM32 macro (e.g. SPI_BAUDRATEPRESCALER_32).
+     *
+     * @note If set to zero, it will default to SPI_BAUDRATEPRESCALER_32.
+     */
+    uint16_t baudrate_prescaler;
+
+    /** @brief @public GPIO pin used for chip select. Use STM32 macro (GPIO_PIN_XX). */
+    uint16_t spi_cs_gpio_pin;
+    /** @brief @public GPIO bank of the pin used for chip select. Use STM32 macro (GPIOX). */
+    GPIO_TypeDef *spi_cs_gpio_bank;
+
+#if LT_USE_INT_PIN
+    /** @brief @public GPIO pin used for interrupts, configured for EXTI on the rising edge. Use STM32 macro
+     * (GPIO_PIN_XX). */
+    uint16_t int_gpio_pin;
+    /** @brief @public GPIO bank of the pin used for interrupts. Use STM32 macro (GPIOX). */
+    GPIO_TypeDef *int_gpio_bank;
+#endif
+
+    /**
+     * @brief @public Optional hook called whenever the port waits for the DMA, the INT pin or a delay.
+     *
+     * @note If NULL, the core sleeps (WFI) until the next interrupt. The hook lets the application run its own work
+     *       meanwhile; it should return soon, because the port checks its wait condition only between the calls.
+     */
+    void (*idle_hook)(void *idle_ctx);
+    /** @brief @public Context passed to `idle_hook`. */
+    void *idle_ctx;
+
+    /** @brief @private Random number generator handle. */
+    RNG_HandleTypeDef *rng_handle;
+
+    /** @brief @private SPI handle. The DMA handles are linked to it by the application. */
+    SPI_HandleTypeDef spi_handle;
+    /** @brief @private State of the DMA transfer, updated from the SPI callbacks. */
+    volatile lt_stm32_dma_state_t dma_state;
+#if LT_USE_INT_PIN
+    /** @brief @private Rising edge on the INT pin seen since the last wait started. */
+    volatile bool int_fired;
+#endif
+} lt_dev_stm32_nucleo_f439zi_dma_t;
+
+/**
+ * @brief Call from `HAL_SPI_TxRxCpltCallback()`. Transfers of other SPI handles are ignored.
+ *
+ * @param device  Device structure passed to libtropic
+ * @param hspi    SPI handle passed to the HAL callback
+ */
+void lt_stm32_f439zi_dma_spi_callback(lt_dev_stm32_nucleo_f439zi_dma_t *device, SPI_HandleTypeDef *hspi);
+
+/**
+ * @brief Call from `HAL_SPI_ErrorCallback()`. Errors of other SPI handles are ignored.
+ *
+ * @param device  Device structure passed to libtropic
+ * @param hspi    SPI handle passed to the HAL callback
+ */
+void lt_stm32_f439zi_dma_spi_error_callback(lt_dev_stm32_nucleo_f439zi_dma_t *device, SPI_HandleTypeDef *hspi);
+
+#if LT_USE_INT_PIN
+/**
+ * @brief Call from `HAL_GPIO_EXTI_Callback()`. Edges on other pins are ignored.
+ *
+ * @param device    Device structure passed to libtropic
+ * @param gpio_pin  Pin passed to the HAL callback
+ */
+void lt_stm32_f439zi_dma_exti_callback(lt_dev_stm32_nucleo_f439zi_dma_t *device, uint16_t gpio_pin);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LIBTROPIC_PORT_STM32_NUCLEO_F439ZI_DMA_H
@@ -0,0 +1,291 @@
+/**
+ * @file libtropic_port_stm32_nucleo_l432kc_dma.c
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief Port for STM32 L432KC using SPI with DMA and EXTI on the INT pin, sleeping the core while waiting.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include "libtropic_port_stm32_nucleo_l432kc_dma.h"
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "libtropic_macros.h"
+#include "libtropic_port.h"
+#include "main.h"
+#include "stm32l4xx_hal.h"
+
+/**
+ * @brief Sleeps the core, or calls the idle hook, until an interrupt may have changed the state.
+ *
+ * Interrupts are masked while `done` is checked, so an interrupt coming after the check is not lost: it is kept
+ * pending, WFI returns immediately and the interrupt is served after unmasking.
+ *
+ * @param device  Device structure
+ * @param done    Wait condition, checked with interrupts masked
+ */
+static void wait_for_event(lt_dev_stm32_nucleo_l432kc_dma_t *device, bool (*done)(lt_dev_stm32_nucleo_l432kc_dma_t *))
+{
+    if (device->idle_hook) {
+        device->idle_hook(device->idle_ctx);
+        return;
+    }
+
+    __disable_irq();
+    if (!done(device)) {
+        __WFI();
+    }
+    __enable_irq();
+}
+
+static bool dma_finished(lt_dev_stm32_nucleo_l432kc_dma_t *device)
+{
+    return device->dma_state != LT_STM32_DMA_BUSY;
+}
+
+static bool never(lt_dev_stm32_nucleo_l432kc_dma_t *device)
+{
+    LT_UNUSED(device);
+    return false;
+}
+
+#if LT_USE_INT_PIN
+static bool int_asserted(lt_dev_stm32_nucleo_l432kc_dma_t *device)
+{
+    // The level is checked too, the edge may have come before the wait started.
+    return device->int_fired || HAL_GPIO_ReadPin(device->int_gpio_bank, device->int_gpio_pin) == GPIO_PIN_SET;
+}
+#endif
+
+void lt_stm32_l432kc_dma_spi_callback(lt_dev_stm32_nucleo_l432kc_dma_t *device, SPI_HandleTypeDef *hspi)
+{
+    if (hspi == &device->spi_handle) {
+        device->dma_state = LT_STM32_DMA_DONE;
+    }
+}
+
+void lt_stm32_l432kc_dma_spi_error_callback(lt_dev_stm32_nucleo_l432kc_dma_t *device, SPI_HandleTypeDef *hspi)
+{
+    if (hspi == &device->spi_handle) {
+        device->dma_state = LT_STM32_DMA_ERROR;
+    }
+}
+
+#if LT_USE_INT_PIN
+void lt_stm32_l432kc_dma_exti_callback(lt_dev_stm32_nucleo_l432kc_dma_t *device, uint16_t gpio_pin)
+{
+    if (gpio_pin == device->int_gpio_pin) {
+        device->int_fired = true;
+    }
+}
+#endif
+
+lt_ret_t lt_port_random_bytes(lt_l2_state_t *s2, void *buff, size_t count)
+{
+    lt_dev_stm32_nucleo_l432kc_dma_t *device = (lt_dev_stm32_nucleo_l432kc_dma_t *)(s2->device);
+    size_t bytes_left = count;
+    uint8_t *buff_ptr = buff;
+    int ret;
+    uint32_t random_data;
+
+    while (bytes_left) {
+        ret = HAL_RNG_GenerateRandomNumber(device->rng_handle, &random_data);
+        if (ret != HAL_OK) {
+            LT_LOG_ERROR("HAL_RNG_GenerateRandomNumber failed, ret=%d", ret);
+            return LT_FAIL;
+        }
+
+        size_t cpy_cnt = bytes_left < sizeof(random_data) ? bytes_left : sizeof(random_data);
+        memcpy(buff_ptr, &random_data, cpy_cnt);
+        bytes_left -= cpy_cnt;
+        buff_ptr += cpy_cnt;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_port_spi_csn_low(lt_l2_state_t *s2)
+{
+    lt_dev_stm32_nucleo_l432kc_dma_t *device = (lt_dev_stm32_nucleo_l432kc_dma_t *)(s2->device);
+
+    // The write to BSRR takes effect before the next SPI transfer starts, no need to read the pin back.
+    HAL_GPIO_WritePin(device->spi_cs_gpio_bank, device->spi_cs_gpio_pin, GPIO_PIN_RESET);
+
+    return LT_OK;
+}
+
+lt_ret_t lt_port_spi_csn_high(lt_l2_state_t *s2)
+{
+    lt_dev_stm32_nucleo_l432kc_dma_t *device = (lt_dev_stm32_nucleo_l432kc_dma_t *)(s2->device);
+
+    HAL_GPIO_WritePin(device->spi_cs_gpio_bank, device->spi_cs_gpio_pin, GPIO_PIN_SET);
+
+    return LT_OK;
+}
+
+lt_ret_t lt_port_init(lt_l2_state_t *s2)
+{
+    lt_dev_stm32_nucleo_l432kc_dma_t *device = (lt_dev_stm32_nucleo_l432kc_dma_t *)(s2->device);
+    int ret;
+
+    device->dma_state = LT_STM32_DMA_IDLE;
+
+    // Set the SPI parameters.
+    device->spi_handle.Instance = device->spi_instance;
+
+    if (device->baudrate_prescaler == 0) {
+        device->spi_handle.Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_32;
+    }
+    else {
+        device->spi_handle.Init.BaudRatePrescaler = device->baudrate_prescaler;
+    }
+
+    device->spi_handle.Init.Direction = SPI_DIRECTION_2LINES;
+    device->spi_handle.Init.CLKPhase = SPI_PHASE_1EDGE;
+    device->spi_handle.Init.CLKPolarity = SPI_POLARITY_LOW;
+    device->spi_handle.Init.CRCCalculation = SPI_CRCCALCULATION_DISABLE;
+    device->spi_handle.Init.DataSize = SPI_DATASIZE_8BIT;
+    device->spi_handle.Init.FirstBit = SPI_FIRSTBIT_MSB;
+    device->spi_handle.Init.NSS = SPI_NSS_HARD_OUTPUT;
+    device->spi_handle.Init.TIMode = SPI_TIMODE_DISABLE;
+    device->spi_handle.Init.Mode = SPI_MODE_MASTER;
+    device->spi_handle.Init.CRCLength = SPI_CRC_LENGTH_DATASIZE;
+    device->spi_handle.Init.NSSPMode = SPI_NSS_PULSE_DISABLE;
+
+    // HAL_SPI_MspInit() of the application links the DMA handles.
+    ret = HAL_SPI_Init(&device->spi_handle);
+    if (ret != HAL_OK) {
+        LT_LOG_ERROR("Failed to init SPI, ret=%d", ret);
+        return LT_L1_SPI_ERROR;
+    }
+    if (!device->spi_handle.hdmatx || !device->spi_handle.hdmarx) {
+        LT_LOG_ERROR("DMA handles not linked to the SPI handle in HAL_SPI_MspInit()");
+        return LT_L1_SPI_ERROR;
+    }
+
+    // GPIO for chip select.
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    LT_SPI_CS_CLK_ENABLE();
+    HAL_GPIO_WritePin(device->spi_cs_gpio_bank, device->spi_cs_gpio_pin, GPIO_PIN_SET);
+    GPIO_InitStruct.Pin = device->spi_cs_gpio_pin;
+    GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+    GPIO_InitStruct.Pull = GPIO_PULLUP;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_MEDIUM;
+    HAL_GPIO_Init(device->spi_cs_gpio_bank, &GPIO_InitStruct);
+
+#if LT_USE_INT_PIN
+    // GPIO for INT pin, the EXTI interrupt is enabled in the NVIC by the application.
+    device->int_fired = false;
+    LT_INT_CLK_ENABLE();
+    GPIO_InitStruct.Pin = device->int_gpio_pin;
+    GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+    HAL_GPIO_Init(device->int_gpio_bank, &GPIO_InitStruct);
+#endif
+
+    return LT_OK;
+}
+
+lt_ret_t lt_port_deinit(lt_l2_state_t *s2)
+{
+    lt_dev_stm32_nucleo_l432kc_dma_t *device = (lt_dev_stm32_nucleo_l432kc_dma_t *)(s2->device);
+    int ret;
+
+#if LT_USE_INT_PIN
+    HAL_GPIO_DeInit(device->int_gpio_bank, device->int_gpio_pin);
+#endif
+
+    ret = HAL_SPI_DeInit(&device->spi_handle);
+    if (ret != HAL_OK) {
+        LT_LOG_ERROR("Failed to deinit SPI, ret=%d", ret);
+        return LT_L1_SPI_ERROR;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_port_spi_transfer(lt_l2_state_t *s2, uint8_t offset, uint16_t tx_data_length, uint32_t timeout_ms)
+{
+    lt_dev_stm32_nucleo_l432kc_dma_t *device = (lt_dev_stm32_nucleo_l432kc_dma_t *)(s2->device);
+    int ret;
+
+    if (offset + tx_data_length > TR01_L1_LEN_MAX) {
+        LT_LOG_ERROR("Invalid data length!");
+        return LT_L1_DATA_LEN_ERROR;
+    }
+
+    if (tx_data_length < LT_STM32_DMA_MIN_LEN) {
+        ret = HAL_SPI_TransmitReceive(&device->spi_handle, s2->buff + offset, s2->buff + offset, tx_data_length,
+                                      timeout_ms);
+        if (ret != HAL_OK) {
+            LT_LOG_ERROR("HAL_SPI_TransmitReceive failed, ret=%d", ret);
+            return LT_L1_SPI_ERROR;
+        }
+        return LT_OK;
+    }
+
+    device->dma_state = LT_STM32_DMA_BUSY;
+    ret = HAL_SPI_TransmitReceive_DMA(&device->spi_handle, s2->buff + offset, s2->buff + offset, tx_data_length);
+    if (ret != HAL_OK) {
+        device->dma_state = LT_STM32_DMA_IDLE;
+        LT_LOG_ERROR("HAL_SPI_TransmitReceive_DMA failed, ret=%d", ret);
+        return LT_L1_SPI_ERROR;
+    }
+
+    uint32_t time_initial = HAL_GetTick();
+    while (!dma_finished(device)) {
+        if ((HAL_GetTick() - time_initial) > timeout_ms) {
+            HAL_SPI_Abort(&device->spi_handle);
+            device->dma_state = LT_STM32_DMA_IDLE;
+            LT_LOG_ERROR("SPI DMA transfer timed out");
+            return LT_L1_SPI_ERROR;
+        }
+        wait_for_event(device, dma_finished);
+    }
+
+    if (device->dma_state == LT_STM32_DMA_ERROR) {
+        device->dma_state = LT_STM32_DMA_IDLE;
+        LT_LOG_ERROR("SPI DMA transfer failed, error=0x%" PRIx32, HAL_SPI_GetError(&device->spi_handle));
+        return LT_L1_SPI_ERROR;
+    }
+    device->dma_state = LT_STM32_DMA_IDLE;
+
+    return LT_OK;
+}
+
+lt_ret_t lt_port_delay(lt_l2_state_t *s2, uint32_t ms)
+{
+    lt_dev_stm32_nucleo_l432kc_dma_t *device = (lt_dev_stm32_nucleo_l432kc_dma_t *)(s2->device);
+    uint32_t time_initial = HAL_GetTick();
+
+    // SysTick wakes the core every millisecond.
+    while ((HAL_GetTick() - time_initial) < ms) {
+        wait_for_event(device, never);
+    }
+
+    return LT_OK;
+}
+
+#if LT_USE_INT_PIN
+lt_ret_t lt_port_delay_on_int(lt_l2_state_t *s2, uint32_t ms)
+{
+    lt_dev_stm32_nucleo_l432kc_dma_t *device = (lt_dev_stm32_nucleo_l432kc_dma_t *)(s2->device);
+    uint32_t time_initial = HAL_GetTick();
+
+    device->int_fired = false;
+    while (!int_asserted(device)) {
+        if ((HAL_GetTick() - time_initial) > ms) {
+            return LT_L1_INT_TIMEOUT;
+        }
+        wait_for_event(device, int_asserted);
+    }
+
+    return LT_OK;
+}
+#endif
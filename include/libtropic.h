@@ -44,6 +44,8 @@ lt_ret_t lt_init(lt_handle_t *h);
  *                    of the return value (if you pass correct handle).
  *                    After calling this function, it will not be possible to send L3 commands
  *                    unless new Secure Session is started.
+ * @note              With `LT_R_MEM_CACHE`, slots written by `lt_r_mem_cache_write()` are written into the R-Memory
+ *                    first, if a Secure Session is running.
  *
  * @param h           Handle for communication with TROPIC01
  *
@@ -53,6 +55,46 @@ lt_ret_t lt_init(lt_handle_t *h);
  */
 lt_ret_t lt_deinit(lt_handle_t *h);
 
+#if LT_L3_BUFF_POOL
+/**
+ * @brief Initializes a pool of L3 buffers to be shared by several handles.
+ *
+ * Set `l3.pool` of each handle to the pool before calling `lt_init()`. Each L3 command leases a buffer for its
+ * duration and zeroes it when returning it; a command started while all buffers are leased returns
+ * `LT_L3_BUFF_POOL_EMPTY`.
+ *
+ * @param pool        Pool to initialize
+ * @param buffs       Memory for the buffers, aligned to 16 bytes
+ * @param buffs_size  Size of `buffs` in bytes
+ * @param buff_len    Length of each buffer, a multiple of 16 not smaller than `LT_L3_BUFF_LEN_MIN`
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            LT_PARAM_ERR Misaligned memory, invalid `buff_len`, or no or more than 32 buffers fit
+ */
+lt_ret_t lt_l3_buff_pool_init(lt_l3_buff_pool_t *pool, uint8_t *buffs, const size_t buffs_size,
+                              const uint16_t buff_len);
+#endif
+
+#if LT_R_MEM_CACHE
+/**
+ * @brief Initializes a cache of R-Memory slots.
+ *
+ * Set `l3.r_mem_cache` of a handle to the cache to use it. The first `lt_r_mem_data_read()` of a slot in a Secure
+ * Session keeps the slot in the cache, later reads of the slot are served from the cache without an L3 command.
+ * `lt_r_mem_data_write()` and `lt_r_mem_data_erase()` drop the slot from the cache, together with content written by
+ * `lt_r_mem_cache_write()` and not yet written into the R-Memory. When all lines are taken, the
+ * least recently used one is reused.
+ *
+ * @param cache       Cache to initialize
+ * @param lines       Lines of the cache, one per slot held
+ * @param count       Number of lines
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            LT_PARAM_ERR No lines
+ */
+lt_ret_t lt_r_mem_cache_init(lt_r_mem_cache_t *cache, lt_r_mem_cache_line_t *lines, const uint8_t count);
+#endif
+
 /**
  * @brief Gets current mode (Libtropic defined, see lt_tr01_mode_t) of TROPIC01.
  * @note The `mode` parameter can be considered valid only when this function returns LT_OK.
@@ -66,6 +108,7 @@ lt_ret_t lt_deinit(lt_handle_t *h);
  */
 lt_ret_t lt_get_tr01_mode(lt_handle_t *h, lt_tr01_mode_t *mode);
 
+#if LT_L2_CMD_GET_INFO_CERT_STORE
 /**
  * @brief Read out PKI chain from TROPIC01's Certificate Store
  *
@@ -90,11 +133,13 @@ lt_ret_t lt_get_info_cert_store(lt_handle_t *h, struct lt_cert_store_t *store);
  * of returned value
  */
 lt_ret_t lt_get_st_pub(const struct lt_cert_store_t *store, uint8_t *stpub);
+#endif
 
 //--------------------------------------------------------------------------------------------------------------------//
 /** @brief Maximal size of returned CHIP ID */
 #define TR01_L2_GET_INFO_CHIP_ID_SIZE 128
 
+#if LT_L2_CMD_GET_INFO_CHIP_ID
 /**
  * @brief Read TROPIC01's CHIP ID
  *
@@ -106,6 +151,7 @@ lt_ret_t lt_get_st_pub(const struct lt_cert_store_t *store, uint8_t *stpub);
  * of returned value
  */
 lt_ret_t lt_get_info_chip_id(lt_handle_t *h, struct lt_chip_id_t *chip_id);
+#endif
 
 /**
  * @brief Read TROPIC01's RISC-V firmware version
@@ -119,6 +165,7 @@ lt_ret_t lt_get_info_chip_id(lt_handle_t *h, struct lt_chip_id_t *chip_id);
  */
 lt_ret_t lt_get_info_riscv_fw_ver(lt_handle_t *h, uint8_t *ver);
 
+#if LT_L2_CMD_GET_INFO_SPECT_FW_VER
 /**
  * @brief Read TROPIC01's SPECT firmware version
  *
@@ -130,7 +177,9 @@ lt_ret_t lt_get_info_riscv_fw_ver(lt_handle_t *h, uint8_t *ver);
  * of returned value
  */
 lt_ret_t lt_get_info_spect_fw_ver(lt_handle_t *h, uint8_t *ver);
+#endif
 
+#if LT_L2_CMD_GET_INFO_FW_BANK
 /**
  * @brief Read TROPIC01's firmware bank info
  *
@@ -148,6 +197,7 @@ lt_ret_t lt_get_info_spect_fw_ver(lt_handle_t *h, uint8_t *ver);
  */
 lt_ret_t lt_get_info_fw_bank(lt_handle_t *h, const lt_bank_id_t bank_id, uint8_t *header,
                              const uint16_t header_max_size, uint16_t *header_read_size);
+#endif
 
 /**
  * @brief Establishes encrypted secure session between TROPIC01 and host MCU
@@ -177,6 +227,8 @@ lt_ret_t lt_session_start(lt_handle_t *h, const uint8_t *stpub, const lt_pkey_in
  *                    of the result of the abort request (if you pass correct handle).
  *                    After calling this function, it will not be possible to send L3 commands
  *                    unless new Secure Session is started.
+ * @note              With `LT_R_MEM_CACHE`, slots written by `lt_r_mem_cache_write()` are written into the R-Memory
+ *                    before the session is aborted.
  *
  * @param h           Handle for communication with TROPIC01
  *
@@ -279,6 +331,7 @@ lt_ret_t lt_mutable_fw_update_data(lt_handle_t *h, const uint8_t *update_data, c
  */
 lt_ret_t lt_get_log_req(lt_handle_t *h, uint8_t *log_msg, const uint16_t log_msg_max_size, uint16_t *log_msg_read_size);
 
+#if LT_L3_CMD_PING
 /**
  * @brief A dummy command to check the Secure Channel Session communication by exchanging a message with TROPIC01, whish
  * is echoed through the Secure Channel.
@@ -293,7 +346,9 @@ lt_ret_t lt_get_log_req(lt_handle_t *h, uint8_t *log_msg, const uint16_t log_msg
  * of returned value
  */
 lt_ret_t lt_ping(lt_handle_t *h, const uint8_t *msg_out, uint8_t *msg_in, const uint16_t msg_len);
+#endif
 
+#if LT_L3_CMD_PAIRING_KEY_WRITE
 /**
  * @brief Writes pairing public key into TROPIC01's pairing key slot 0-3
  * @warning The pairing keys reside in I-Memory, which has narrower operating temperature range (-20 °C to 85 °C) than
@@ -311,7 +366,9 @@ lt_ret_t lt_ping(lt_handle_t *h, const uint8_t *msg_out, uint8_t *msg_in, const
  * of returned value
  */
 lt_ret_t lt_pairing_key_write(lt_handle_t *h, const uint8_t *pairing_pub, const uint8_t slot);
+#endif
 
+#if LT_L3_CMD_PAIRING_KEY_READ
 /**
  * @brief Reads pairing public key from TROPIC01's pairing key slot 0-3
  *
@@ -324,7 +381,9 @@ lt_ret_t lt_pairing_key_write(lt_handle_t *h, const uint8_t *pairing_pub, const
  * of returned value
  */
 lt_ret_t lt_pairing_key_read(lt_handle_t *h, uint8_t *pairing_pub, const uint8_t slot);
+#endif
 
+#if LT_L3_CMD_PAIRING_KEY_INVALIDATE
 /**
  * @brief Invalidates pairing key in slot 0-3
  * @warning The pairing keys reside in I-Memory, which has narrower operating temperature range (-20 °C to 85 °C) than
@@ -341,7 +400,9 @@ lt_ret_t lt_pairing_key_read(lt_handle_t *h, uint8_t *pairing_pub, const uint8_t
  * of returned value
  */
 lt_ret_t lt_pairing_key_invalidate(lt_handle_t *h, const uint8_t slot);
+#endif
 
+#if LT_L3_CMD_R_CONFIG_WRITE
 /**
  * @brief Writes configuration object specified by `addr`
  *
@@ -354,7 +415,9 @@ lt_ret_t lt_pairing_key_invalidate(lt_handle_t *h, const uint8_t slot);
  * of returned value
  */
 lt_ret_t lt_r_config_write(lt_handle_t *h, const enum lt_config_obj_addr_t addr, const uint32_t obj);
+#endif
 
+#if LT_L3_CMD_R_CONFIG_READ
 /**
  * @brief Reads configuration object specified by `addr`
  *
@@ -368,7 +431,9 @@ lt_ret_t lt_r_config_write(lt_handle_t *h, const enum lt_config_obj_addr_t addr,
  *
  */
 lt_ret_t lt_r_config_read(lt_handle_t *h, const enum lt_config_obj_addr_t addr, uint32_t *obj);
+#endif
 
+#if LT_L3_CMD_R_CONFIG_ERASE
 /**
  * @brief Erases all configuration objects
  *
@@ -379,7 +444,9 @@ lt_ret_t lt_r_config_read(lt_handle_t *h, const enum lt_config_obj_addr_t addr,
  * of returned value
  */
 lt_ret_t lt_r_config_erase(lt_handle_t *h);
+#endif
 
+#if LT_L3_CMD_I_CONFIG_WRITE
 /**
  * @brief Writes configuration object specified by `addr` to I-Config
  * @warning The I-Config resides in I-Memory, which has narrower operating temperature range (-20 °C to 85 °C) than
@@ -397,7 +464,9 @@ lt_ret_t lt_r_config_erase(lt_handle_t *h);
  * of returned value
  */
 lt_ret_t lt_i_config_write(lt_handle_t *h, const enum lt_config_obj_addr_t addr, const uint8_t bit_index);
+#endif
 
+#if LT_L3_CMD_I_CONFIG_READ
 /**
  * @brief Reads configuration object specified by `addr` from I-Config
  *
@@ -410,7 +479,9 @@ lt_ret_t lt_i_config_write(lt_handle_t *h, const enum lt_config_obj_addr_t addr,
  * of returned value
  */
 lt_ret_t lt_i_config_read(lt_handle_t *h, const enum lt_config_obj_addr_t addr, uint32_t *obj);
+#endif
 
+#if LT_L3_CMD_R_MEM_DATA_WRITE
 /**
  * @brief Writes bytes into a given slot of the User Partition in the R memory
  *
@@ -425,7 +496,9 @@ lt_ret_t lt_i_config_read(lt_handle_t *h, const enum lt_config_obj_addr_t addr,
  * of returned value
  */
 lt_ret_t lt_r_mem_data_write(lt_handle_t *h, const uint16_t udata_slot, const uint8_t *data, const uint16_t data_size);
+#endif
 
+#if LT_L3_CMD_R_MEM_DATA_READ
 /**
  * @brief Reads bytes from a given slot of the User Partition in the R memory
  *
@@ -441,7 +514,9 @@ lt_ret_t lt_r_mem_data_write(lt_handle_t *h, const uint16_t udata_slot, const ui
  */
 lt_ret_t lt_r_mem_data_read(lt_handle_t *h, const uint16_t udata_slot, uint8_t *data, const uint16_t data_max_size,
                             uint16_t *data_read_size);
+#endif
 
+#if LT_L3_CMD_R_MEM_DATA_ERASE
 /**
  * @brief Erases the given slot of the User Partition in the R memory
  *
@@ -453,7 +528,93 @@ lt_ret_t lt_r_mem_data_read(lt_handle_t *h, const uint16_t udata_slot, uint8_t *
  * of returned value
  */
 lt_ret_t lt_r_mem_data_erase(lt_handle_t *h, const uint16_t udata_slot);
+#endif
 
+#if LT_R_MEM_CACHE
+/**
+ * @brief Replaces the content of a slot in the R-Memory cache of the handle, the slot does not have to be erased.
+ *
+ * The slot is written into the R-Memory, by one erase and one write however many times it was replaced, by
+ * `lt_r_mem_cache_flush()`, `lt_session_abort()`, `lt_deinit()` or when its line is reused. Content not written
+ * before the Secure Session ends otherwise (e.g. by an error) is lost. So is content of a slot which is then written
+ * by `lt_r_mem_data_write()` or erased by `lt_r_mem_data_erase()`, these supersede it.
+ *
+ * @param h           Handle for communication with TROPIC01, with `l3.r_mem_cache` set
+ * @param udata_slot  Memory's slot to be written
+ * @param data        Buffer of data to be written into R MEMORY slot
+ * @param data_size   Size of data to be written (valid range given by macros `TR01_R_MEM_DATA_SIZE_MIN` and
+ * `TR01_R_MEM_DATA_SIZE_MAX`)
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_r_mem_cache_write(lt_handle_t *h, const uint16_t udata_slot, const uint8_t *data, const uint16_t data_size);
+
+/**
+ * @brief Writes the slots replaced by `lt_r_mem_cache_write()` into the R-Memory.
+ *
+ * @param h           Handle for communication with TROPIC01, with `l3.r_mem_cache` set
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_r_mem_cache_flush(lt_handle_t *h);
+#endif
+
+#if LT_L3_CMD_R_MEM_DATA_WRITE && LT_L3_CMD_R_MEM_DATA_ERASE
+/**
+ * @brief Writes an object larger than one slot into consecutive slots of the R-Memory, starting at `first_slot`.
+ *
+ * The first slot holds a header (length, version and SHA-256 of the object) followed by the beginning of the object,
+ * the next slots hold the rest. The object spans `(LT_R_MEM_OBJECT_HEADER_SIZE + obj_len)` bytes rounded up to whole
+ * slots. Every slot is erased before it is written, the first slot is erased first and written last, so an interrupted
+ * write leaves an empty first slot instead of a torn object. The object is hashed while the chip executes the erases.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param first_slot  First slot of the object
+ * @param obj         Object to write
+ * @param obj_len     Length of the object, it must fit into the slots from `first_slot` to `TR01_R_MEM_DATA_SLOT_MAX`
+ * @param version     Version of the object, stored in the header for the application
+ * @param stats       Optional statistics of the write, can be NULL
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_r_mem_object_write(lt_handle_t *h, const uint16_t first_slot, const uint8_t *obj, const uint32_t obj_len,
+                               const uint32_t version, lt_r_mem_object_stats_t *stats);
+#endif
+
+#if LT_L3_CMD_R_MEM_DATA_READ
+/**
+ * @brief Reads an object written by `lt_r_mem_object_write()` and verifies its SHA-256.
+ *
+ * Each part of the object is hashed while the chip reads the next slot. With `LT_R_MEM_CACHE`, the slots replaced by
+ * `lt_r_mem_cache_write()` are written into the R-Memory first.
+ *
+ * @param h             Handle for communication with TROPIC01
+ * @param first_slot    First slot of the object
+ * @param obj           Buffer to read the object into, zeroed if the object turns out invalid
+ * @param obj_max_size  Size of `obj`
+ * @param obj_len       Length of the object
+ * @param version       Version of the object
+ * @param stats         Optional statistics of the read, can be NULL
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            LT_L3_R_MEM_DATA_READ_SLOT_EMPTY There is no object in `first_slot`
+ * @retval            LT_R_MEM_OBJECT_INVALID The header is invalid, a slot of the object was overwritten or the
+ * SHA-256 does not match
+ * @retval            LT_PARAM_ERR `obj` is too small, `obj_len` and `version` are set
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_r_mem_object_read(lt_handle_t *h, const uint16_t first_slot, uint8_t *obj, const uint32_t obj_max_size,
+                              uint32_t *obj_len, uint32_t *version, lt_r_mem_object_stats_t *stats);
+#endif
+
+#if LT_L3_CMD_RANDOM_VALUE_GET
 /**
  * @brief Gets random bytes from TROPIC01's Random Number Generator.
  *
@@ -466,7 +627,9 @@ lt_ret_t lt_r_mem_data_erase(lt_handle_t *h, const uint16_t udata_slot);
  * encoding of returned value
  */
 lt_ret_t lt_random_value_get(lt_handle_t *h, uint8_t *rnd_bytes, const uint16_t rnd_bytes_cnt);
+#endif
 
+#if LT_L3_CMD_ECC_KEY_GENERATE
 /**
  * @brief Generates ECC key in the specified ECC key slot
  *
@@ -479,7 +642,9 @@ lt_ret_t lt_random_value_get(lt_handle_t *h, uint8_t *rnd_bytes, const uint16_t
  * of returned value
  */
 lt_ret_t lt_ecc_key_generate(lt_handle_t *h, const lt_ecc_slot_t slot, const lt_ecc_curve_type_t curve);
+#endif
 
+#if LT_L3_CMD_ECC_KEY_STORE
 /**
  * @brief Stores ECC key to the specified ECC key slot
  *
@@ -494,7 +659,9 @@ lt_ret_t lt_ecc_key_generate(lt_handle_t *h, const lt_ecc_slot_t slot, const lt_
  */
 lt_ret_t lt_ecc_key_store(lt_handle_t *h, const lt_ecc_slot_t slot, const lt_ecc_curve_type_t curve,
                           const uint8_t *key);
+#endif
 
+#if LT_L3_CMD_ECC_KEY_READ
 /**
  * @brief Reads ECC public key corresponding to a private key in the specified ECC key slot.
  *
@@ -513,7 +680,9 @@ lt_ret_t lt_ecc_key_store(lt_handle_t *h, const lt_ecc_slot_t slot, const lt_ecc
  */
 lt_ret_t lt_ecc_key_read(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, uint8_t *key, const uint8_t key_max_size,
                          lt_ecc_curve_type_t *curve, lt_ecc_key_origin_t *origin);
+#endif
 
+#if LT_L3_CMD_ECC_KEY_ERASE
 /**
  * @brief Erases ECC key from the specified ECC key slot
  *
@@ -525,7 +694,9 @@ lt_ret_t lt_ecc_key_read(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, uint8_t *
  * of returned value
  */
 lt_ret_t lt_ecc_key_erase(lt_handle_t *h, const lt_ecc_slot_t ecc_slot);
+#endif
 
+#if LT_L3_CMD_ECC_ECDSA_SIGN
 /**
  * @brief Performs ECDSA sign of a message with a private ECC key stored in TROPIC01
  *
@@ -541,7 +712,9 @@ lt_ret_t lt_ecc_key_erase(lt_handle_t *h, const lt_ecc_slot_t ecc_slot);
  */
 lt_ret_t lt_ecc_ecdsa_sign(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, const uint8_t *msg, const uint32_t msg_len,
                            uint8_t *rs);
+#endif
 
+#if LT_L3_CMD_ECC_EDDSA_SIGN
 /**
  * @brief Performs EdDSA sign of a message with a private ECC key stored in TROPIC01
  *
@@ -557,7 +730,9 @@ lt_ret_t lt_ecc_ecdsa_sign(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, const u
  */
 lt_ret_t lt_ecc_eddsa_sign(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, const uint8_t *msg, const uint16_t msg_len,
                            uint8_t *rs);
+#endif
 
+#if LT_L3_CMD_MCOUNTER_INIT
 /**
  * @brief Initializes monotonic counter of a given index
  *
@@ -570,7 +745,9 @@ lt_ret_t lt_ecc_eddsa_sign(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, const u
  * encoding of returned value
  */
 lt_ret_t lt_mcounter_init(lt_handle_t *h, const enum lt_mcounter_index_t mcounter_index, const uint32_t mcounter_value);
+#endif
 
+#if LT_L3_CMD_MCOUNTER_UPDATE
 /**
  * @brief Updates monotonic counter of a given index
  *
@@ -582,7 +759,9 @@ lt_ret_t lt_mcounter_init(lt_handle_t *h, const enum lt_mcounter_index_t mcounte
  * encoding of returned value
  */
 lt_ret_t lt_mcounter_update(lt_handle_t *h, const enum lt_mcounter_index_t mcounter_index);
+#endif
 
+#if LT_L3_CMD_MCOUNTER_GET
 /**
  * @brief Gets a value of a monotonic counter of a given index
  *
@@ -595,7 +774,9 @@ lt_ret_t lt_mcounter_update(lt_handle_t *h, const enum lt_mcounter_index_t mcoun
  * encoding of returned value
  */
 lt_ret_t lt_mcounter_get(lt_handle_t *h, const enum lt_mcounter_index_t mcounter_index, uint32_t *mcounter_value);
+#endif
 
+#if LT_L3_CMD_MAC_AND_DESTROY
 /**
  * @brief Executes the MAC-and-Destroy sequence.
  * @details This command is just a part of MAC And Destroy sequence, which takes place between the host and TROPIC01.
@@ -613,6 +794,7 @@ lt_ret_t lt_mcounter_get(lt_handle_t *h, const enum lt_mcounter_index_t mcounter
  */
 lt_ret_t lt_mac_and_destroy(lt_handle_t *h, const lt_mac_and_destroy_slot_t slot, const uint8_t *data_out,
                             uint8_t *data_in);
+#endif
 
 /** @} */  // end of libtropic_API group
 
@@ -641,6 +823,7 @@ extern struct lt_config_obj_desc_t cfg_desc_table[LT_CONFIG_OBJ_CNT];
  */
 const char *lt_ret_verbose(lt_ret_t ret);
 
+#if LT_L3_CMD_R_CONFIG_WRITE
 /**
  * @brief Writes the whole R-Config with the passed `config`.
  *
@@ -652,7 +835,9 @@ const char *lt_ret_verbose(lt_ret_t ret);
  * of returned value
  */
 lt_ret_t lt_write_whole_R_config(lt_handle_t *h, const struct lt_config_t *config);
+#endif
 
+#if LT_L3_CMD_R_CONFIG_READ
 /**
  * @brief Reads all of the R-Config objects into `config`.
  *
@@ -664,7 +849,9 @@ lt_ret_t lt_write_whole_R_config(lt_handle_t *h, const struct lt_config_t *confi
  * of returned value
  */
 lt_ret_t lt_read_whole_R_config(lt_handle_t *h, struct lt_config_t *config);
+#endif
 
+#if LT_L3_CMD_I_CONFIG_READ
 /**
  * @brief Reads all of the I-Config objects into `config`.
  *
@@ -676,7 +863,9 @@ lt_ret_t lt_read_whole_R_config(lt_handle_t *h, struct lt_config_t *config);
  * of returned value
  */
 lt_ret_t lt_read_whole_I_config(lt_handle_t *h, struct lt_config_t *config);
+#endif
 
+#if LT_L3_CMD_I_CONFIG_WRITE
 /**
  * @brief Writes the whole I-Config with the passed `config`.
  * @details Only the zero bits in `config` are written.
@@ -694,7 +883,49 @@ lt_ret_t lt_read_whole_I_config(lt_handle_t *h, struct lt_config_t *config);
  * of returned value
  */
 lt_ret_t lt_write_whole_I_config(lt_handle_t *h, const struct lt_config_t *config);
+#endif
 
+#if LT_L3_CMD_R_CONFIG_WRITE && LT_L3_CMD_R_CONFIG_ERASE
+/**
+ * @brief Changes the R-Config to `config`, writing only the objects which differ from `snapshot`.
+ *
+ * `snapshot` is the current R-Config, as read by `lt_read_whole_R_config()` once and then kept up to date by this
+ * function, so no object is read again. Objects holding `LT_CONFIG_OBJ_ERASED` in `snapshot` are written directly.
+ * When a written object has to change, the R-Config is erased first and every object of `config` which is not
+ * `LT_CONFIG_OBJ_ERASED` is written. Nothing is sent when `config` equals `snapshot`.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param config      Requested R-Config
+ * @param snapshot    Current R-Config, updated after each written object
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_apply_R_config(lt_handle_t *h, const struct lt_config_t *config, struct lt_config_t *snapshot);
+#endif
+
+#if LT_L3_CMD_I_CONFIG_WRITE
+/**
+ * @brief Changes the I-Config to `config`, clearing only the bits which are set in `snapshot` and cleared in `config`.
+ * @warning Clearing I-Config bits is irreversible. See `lt_write_whole_I_config()` for the operating temperature range.
+ *
+ * `snapshot` is the current I-Config, as read by `lt_read_whole_I_config()` once and then kept up to date by this
+ * function. Nothing is sent when `config` equals `snapshot`.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param config      Requested I-Config
+ * @param snapshot    Current I-Config, updated after each cleared bit
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            LT_PARAM_ERR `config` sets a bit cleared in `snapshot`, nothing was written
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_apply_I_config(lt_handle_t *h, const struct lt_config_t *config, struct lt_config_t *snapshot);
+#endif
+
+#if LT_L2_CMD_GET_INFO_CERT_STORE
 /**
  * @brief Establishes a secure channel between host MCU and TROPIC01
  *
@@ -715,6 +946,7 @@ lt_ret_t lt_write_whole_I_config(lt_handle_t *h, const struct lt_config_t *confi
  */
 lt_ret_t lt_verify_chip_and_start_secure_session(lt_handle_t *h, const uint8_t *shipriv, const uint8_t *shipub,
                                                  const lt_pkey_index_t pkey_index);
+#endif
 
 /**
  * @brief Prints bytes in hex format to the given output buffer.
@@ -742,6 +974,7 @@ lt_ret_t lt_print_bytes(const uint8_t *bytes, const size_t bytes_cnt, char *out_
  */
 lt_ret_t lt_print_chip_id(const struct lt_chip_id_t *chip_id, int (*print_func)(const char *format, ...));
 
+#if LT_L2_CMD_GET_INFO_FW_BANK
 /**
  * @brief Prints interpreted firmware header of the given bank using the passed printf-like function.
  *
@@ -753,6 +986,7 @@ lt_ret_t lt_print_chip_id(const struct lt_chip_id_t *chip_id, int (*print_func)(
  * @retval             LT_OK if success, otherwise returns other error code.
  */
 lt_ret_t lt_print_fw_header(lt_handle_t *h, const lt_bank_id_t bank_id, int (*print_func)(const char *format, ...));
+#endif
 
 /**
  * @brief Performs mutable firmware update on ABAB and ACAB silicon revisions.
@@ -768,6 +1002,51 @@ lt_ret_t lt_print_fw_header(lt_handle_t *h, const lt_bank_id_t bank_id, int (*pr
 lt_ret_t lt_do_mutable_fw_update(lt_handle_t *h, const uint8_t *update_data, const uint16_t update_data_size,
                                  const lt_bank_id_t bank_id);
 
+/**
+ * @brief Performs mutable firmware update on ABAB and ACAB silicon revisions, reading the update image with the passed
+ * reader instead of from memory. Only one L2 Request worth of the image is read at a time, straight into the L2 buffer.
+ *
+ * The image has the same format as the one passed to `lt_do_mutable_fw_update()` (e.g. `*.bin` files from
+ * `TROPIC01_fw_update_files/`):
+ *   - For ABAB: raw firmware, read in pieces of 128 bytes.
+ *   - For ACAB: length-prefixed chunks, read as the length byte followed by the chunk itself.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param reader      Reader of the update image
+ * @param reader_ctx  Context passed to `reader`
+ * @param bank_id     Bank ID where the update should be applied, valid values are
+ *                       For ABAB: TR01_FW_BANK_FW1, TR01_FW_BANK_FW2, TR01_FW_BANK_SPECT1, TR01_FW_BANK_SPECT2
+ *                       For ACAB: Parameter is ignored, chip is handling firmware banks on its own
+ * @return            LT_OK if success, LT_PARAM_ERR if the image is malformed or too big, error returned by `reader` or
+ *                    other error code.
+ */
+lt_ret_t lt_do_mutable_fw_update_stream(lt_handle_t *h, lt_fw_update_reader_t reader, void *reader_ctx,
+                                        const lt_bank_id_t bank_id);
+
+/**
+ * @brief Same as `lt_do_mutable_fw_update_stream()`, but checkpoints the update in `progress`, so it can continue after
+ * an error instead of starting from the first chunk.
+ *
+ * The reader has to provide the image from its start on every call, the already acknowledged part is read and skipped.
+ * With zeroed `progress`, the update starts from scratch (on ABAB, the bank is erased first). Otherwise it continues
+ * with the first chunk not acknowledged by TROPIC01. If TROPIC01 refuses to continue (e.g. it was reset meanwhile or
+ * the interrupted chunk was already written), `progress` is zeroed and `LT_L2_GEN_ERR` is returned, so the next call
+ * restarts the update of this bank only. The chip must stay in Start-up Mode between the calls.
+ *
+ * @param h             Handle for communication with TROPIC01
+ * @param reader        Reader of the update image
+ * @param reader_ctx    Context passed to `reader`
+ * @param bank_id       Bank ID where the update should be applied, see `lt_do_mutable_fw_update_stream()`
+ * @param progress      Checkpoint of the update, updated after every acknowledged chunk
+ * @param progress_cb   Optional callback called whenever `progress` changes, can be NULL
+ * @param progress_ctx  Context passed to `progress_cb`
+ * @return              LT_OK if success, LT_L2_GEN_ERR if the update has to start over, otherwise returns other error
+ *                      code.
+ */
+lt_ret_t lt_do_mutable_fw_update_resumable(lt_handle_t *h, lt_fw_update_reader_t reader, void *reader_ctx,
+                                           const lt_bank_id_t bank_id, lt_fw_update_progress_t *progress,
+                                           lt_fw_update_progress_cb_t progress_cb, void *progress_ctx);
+
 /** @} */  // end of libtropic_API_helpers group
 #endif
 
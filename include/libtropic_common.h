@@ -216,6 +216,54 @@ typedef struct lt_l2_state_t {
 #define LT_SIZE_OF_L3_BUFF TR01_L3_PACKET_MAX_SIZE
 #endif
 
+/**
+ * @brief Smallest L3 buffer accepted by `lt_init()`.
+ *
+ * It fits every L3 command and result of fixed size, the largest being ECC_Key_Read and the signatures (98 B incl.
+ * size and tag). Ping, R_Mem_Data_Write/Read, Random_Value_Get and EdDSA_Sign are variable and are checked against the
+ * buffer when called, returning `LT_L3_BUFFER_TOO_SMALL` before anything is sent. E.g. a 512 B buffer supports
+ * every command except Ping and EdDSA_Sign with messages over 493 and 478 B.
+ */
+#define LT_L3_BUFF_LEN_MIN ((LT_SIZE_OF_L3_BUFF) < 98u ? (LT_SIZE_OF_L3_BUFF) : 98u)
+
+/**
+ * @brief L3 commands and Get_Info requests compiled into libtropic.
+ *
+ * All of them by default. The `LT_L3_COMMANDS` CMake list selects a subset: it defines `LT_L3_CMD_SELECT`, the
+ * `LT_L3_CMD_<COMMAND>` macro of each selected command, the `LT_L2_CMD_GET_INFO_<OBJECT>` macro of each selected
+ * Get_Info request and `LT_SIZE_OF_L3_BUFF` fitting the largest selected command. Functions of the others are not
+ * compiled. Get_Info of the RISC-V FW version is always compiled, `lt_init()` needs it.
+ */
+#ifndef LT_L3_CMD_SELECT
+#define LT_L3_CMD_PING 1
+#define LT_L3_CMD_PAIRING_KEY_WRITE 1
+#define LT_L3_CMD_PAIRING_KEY_READ 1
+#define LT_L3_CMD_PAIRING_KEY_INVALIDATE 1
+#define LT_L3_CMD_R_CONFIG_WRITE 1
+#define LT_L3_CMD_R_CONFIG_READ 1
+#define LT_L3_CMD_R_CONFIG_ERASE 1
+#define LT_L3_CMD_I_CONFIG_WRITE 1
+#define LT_L3_CMD_I_CONFIG_READ 1
+#define LT_L3_CMD_R_MEM_DATA_WRITE 1
+#define LT_L3_CMD_R_MEM_DATA_READ 1
+#define LT_L3_CMD_R_MEM_DATA_ERASE 1
+#define LT_L3_CMD_RANDOM_VALUE_GET 1
+#define LT_L3_CMD_ECC_KEY_GENERATE 1
+#define LT_L3_CMD_ECC_KEY_STORE 1
+#define LT_L3_CMD_ECC_KEY_READ 1
+#define LT_L3_CMD_ECC_KEY_ERASE 1
+#define LT_L3_CMD_ECC_ECDSA_SIGN 1
+#define LT_L3_CMD_ECC_EDDSA_SIGN 1
+#define LT_L3_CMD_MCOUNTER_INIT 1
+#define LT_L3_CMD_MCOUNTER_UPDATE 1
+#define LT_L3_CMD_MCOUNTER_GET 1
+#define LT_L3_CMD_MAC_AND_DESTROY 1
+#define LT_L2_CMD_GET_INFO_CERT_STORE 1
+#define LT_L2_CMD_GET_INFO_CHIP_ID 1
+#define LT_L2_CMD_GET_INFO_SPECT_FW_VER 1
+#define LT_L2_CMD_GET_INFO_FW_BANK 1
+#endif
+
 /**
  * @brief Used to indicate whether the Secure Session is on or off.
  *
@@ -225,6 +273,30 @@ typedef enum lt_secure_session_status_t {
     LT_SECURE_SESSION_OFF = 0
 } lt_secure_session_status_t;
 
+#if LT_L3_BUFF_POOL
+#if !LT_SEPARATE_L3_BUFF
+#error "LT_L3_BUFF_POOL requires LT_SEPARATE_L3_BUFF"
+#endif
+
+/**
+ * @brief Pool of L3 buffers shared by several handles, initialized by `lt_l3_buff_pool_init()`.
+ *
+ * A handle with `l3.pool` set leases a buffer in `lt_out__*()` and returns it, zeroed, at the end of `lt_in__*()`, so
+ * RAM scales with the number of L3 commands in flight instead of the number of handles. Leasing is lock-free and may
+ * be done from several threads.
+ */
+typedef struct lt_l3_buff_pool_t {
+    /** @private @brief `count` buffers of `buff_len` bytes each, aligned to 16 bytes. */
+    uint8_t *buffs;
+    /** @private @brief Length of each buffer, a multiple of 16. */
+    uint16_t buff_len;
+    /** @private @brief Number of buffers, 32 at most. */
+    uint8_t count;
+    /** @private @brief Bit per buffer, set while the buffer is leased. */
+    uint32_t in_use;
+} lt_l3_buff_pool_t;
+#endif
+
 typedef struct lt_l3_state_t {
     enum lt_secure_session_status_t session_status;
     uint8_t encryption_IV[TR01_L3_IV_SIZE];
@@ -238,6 +310,18 @@ typedef struct lt_l3_state_t {
     uint8_t buff[LT_SIZE_OF_L3_BUFF] __attribute__((aligned(16)));
 #endif
     uint16_t buff_len; /**< Length of the buffer */
+#if LT_L3_STREAM_DECRYPT
+    /** Response in `buff` was decrypted and verified while being received */
+    bool res_decrypted;
+#endif
+#if LT_L3_BUFF_POOL
+    /** Pool to lease `buff` from for each L3 command, NULL when the user sets `buff` and `buff_len` */
+    lt_l3_buff_pool_t *pool;
+#endif
+#if LT_R_MEM_CACHE
+    /** Cache of R-Memory slots for the Secure Session, NULL when not used */
+    struct lt_r_mem_cache_t *r_mem_cache;
+#endif
 } lt_l3_state_t;
 
 /** @brief Length of key used by AES256. */
@@ -392,9 +476,19 @@ typedef enum lt_ret_t {
     LT_CERT_ITEM_NOT_FOUND = 45,
     /** @brief The nonce has reached its maximum value. */
     LT_NONCE_OVERFLOW = 46,
+    /** @brief All buffers of the L3 buffer pool are leased by other handles. */
+    LT_L3_BUFF_POOL_EMPTY = 47,
+
+    // Key/value store related errors
+    /** @brief The key is not in the key/value store. */
+    LT_KV_KEY_NOT_FOUND = 48,
+    /** @brief No room for the key or its value in the key/value store. */
+    LT_KV_FULL = 49,
+    /** @brief Header of an R-Memory object is invalid or its content does not match the SHA-256 in the header. */
+    LT_R_MEM_OBJECT_INVALID = 50,
 
     /** @brief Special helper value used to signalize the last enum value, used in lt_ret_verbose. */
-    LT_RET_T_LAST_VALUE = 47
+    LT_RET_T_LAST_VALUE = 51
 } lt_ret_t;
 
 #define LT_TR01_REBOOT_DELAY_MS 250
@@ -629,6 +723,38 @@ typedef enum lt_bank_id_t {
     TR01_FW_BANK_SPECT2 = 18,  // SPECT bank 2
 } lt_bank_id_t;
 
+/**
+ * @brief Reader of a firmware update image, used by `lt_do_mutable_fw_update_stream()` to pull the image piece by
+ * piece (e.g. from a file, external flash or a socket) instead of having it in memory.
+ *
+ * @param ctx       Context passed to `lt_do_mutable_fw_update_stream()`
+ * @param buff      Buffer for the read bytes
+ * @param len       Number of bytes to read
+ * @param read_len  Number of bytes read, less than `len` only at the end of the image
+ * @return          LT_OK if success, any other value aborts the update and is returned by the caller.
+ */
+typedef lt_ret_t (*lt_fw_update_reader_t)(void *ctx, uint8_t *buff, const uint16_t len, uint16_t *read_len);
+
+/**
+ * @brief Checkpoint of a firmware update, used by `lt_do_mutable_fw_update_resumable()`. Zero-initialized for a new
+ * update.
+ */
+typedef struct lt_fw_update_progress_t {
+    /** @brief Number of update chunks (L2 Requests carrying the update image) acknowledged by TROPIC01. On ACAB, the
+     * update request is the first one. */
+    uint32_t chunks_acked;
+    /** @brief Number of bytes of the update image in the acknowledged chunks, i.e. where the update continues. */
+    uint32_t bytes_acked;
+} lt_fw_update_progress_t;
+
+/**
+ * @brief Called after every update chunk acknowledged by TROPIC01 and when the update has to start over.
+ *
+ * @param ctx       Context passed to `lt_do_mutable_fw_update_resumable()`
+ * @param progress  Current checkpoint
+ */
+typedef void (*lt_fw_update_progress_cb_t)(void *ctx, const lt_fw_update_progress_t *progress);
+
 /**
  * @brief When in MAINTENANCE mode, it is possible to read firmware header from a firmware bank. Returned data differs
  * based on bootloader version. This header layout is returned by bootloader version v1.0.1
@@ -833,9 +959,73 @@ typedef enum lt_config_obj_idx_t {
 //--------------------------------------------------------------------------------------------------------------------//
 /** @brief Minimal size of one data slot in bytes */
 #define TR01_R_MEM_DATA_SIZE_MIN (1)
+/** @brief Maximal size of one data slot in bytes across all Application FWs, the actual one is in `lt_tr01_attrs_t` */
+#define TR01_R_MEM_DATA_SIZE_MAX (475)
 /** @brief Index of last data slot. TROPIC01 contains 512 slots indexed 0-511. */
 #define TR01_R_MEM_DATA_SLOT_MAX (511)
 
+#if LT_R_MEM_CACHE
+#if !LT_L3_CMD_R_MEM_DATA_READ || !LT_L3_CMD_R_MEM_DATA_WRITE || !LT_L3_CMD_R_MEM_DATA_ERASE
+#error "LT_R_MEM_CACHE requires the R_Mem_Data_Read, R_Mem_Data_Write and R_Mem_Data_Erase L3 commands"
+#endif
+
+/** @brief One slot held by `lt_r_mem_cache_t`. */
+typedef struct lt_r_mem_cache_line_t {
+    /** @private @brief Content of the slot. */
+    uint8_t data[TR01_R_MEM_DATA_SIZE_MAX];
+    /** @private @brief Slot index. */
+    uint16_t slot;
+    /** @private @brief Length of the content, 0 if the slot is empty. */
+    uint16_t len;
+    /** @private @brief Value of `lt_r_mem_cache_t.tick` at the last access, 0 if the line is free. */
+    uint32_t used;
+    /** @private @brief The content was written by `lt_r_mem_cache_write()` and not yet to the R-Memory. */
+    bool dirty;
+    /** @private @brief The content is being written into the R-Memory, the line is not dropped meanwhile. */
+    bool flushing;
+} lt_r_mem_cache_line_t;
+
+/**
+ * @brief Cache of R-Memory slots, initialized by `lt_r_mem_cache_init()`.
+ *
+ * A handle with `l3.r_mem_cache` set serves `lt_r_mem_data_read()` of a cached slot without an L3 command. The cache
+ * holds the slots for the Secure Session only: `lt_l3_invalidate_host_session_data()` zeroes it.
+ */
+typedef struct lt_r_mem_cache_t {
+    /** @private @brief Lines of the cache. */
+    lt_r_mem_cache_line_t *lines;
+    /** @private @brief Number of lines. */
+    uint8_t count;
+    /** @private @brief Incremented on each access, orders the lines for eviction. */
+    uint32_t tick;
+} lt_r_mem_cache_t;
+#endif
+
+/** @brief Size of the header of an R-Memory object, stored at the beginning of its first slot. */
+#define LT_R_MEM_OBJECT_HEADER_SIZE (44)
+
+/**
+ * @brief Statistics of one `lt_r_mem_object_write()` or `lt_r_mem_object_read()`, filled when the call succeeds.
+ *
+ * @note Public members are meant to be configured before the call, zero them when no clock is available.
+ */
+typedef struct lt_r_mem_object_stats_t {
+    /** @public @brief Optional monotonic clock used to measure the duration of the transfer. */
+    uint64_t (*clock_ns)(void *clock_ctx);
+    /** @public @brief Context passed to `clock_ns`. */
+    void *clock_ctx;
+    /** @brief Length of the object in bytes. */
+    uint32_t bytes;
+    /** @brief Number of slots the object spans. */
+    uint16_t slots;
+    /** @brief Number of executed L3 commands. */
+    uint16_t l3_cmds;
+    /** @brief Duration of the call in nanoseconds, measured by `clock_ns` (0 if it is not set). */
+    uint64_t time_ns;
+    /** @brief Throughput in bytes per second (0 if `clock_ns` is not set). */
+    uint32_t bytes_per_s;
+} lt_r_mem_object_stats_t;
+
 //--------------------------------------------------------------------------------------------------------------------//
 /** @brief Maximum number of random bytes requested at once */
 #define TR01_RANDOM_VALUE_GET_LEN_MAX 255
@@ -1115,6 +1305,9 @@ typedef struct lt_config_obj_desc_t {
 /** @brief Number of configuration objects in lt_config_t */
 #define LT_CONFIG_OBJ_CNT 27
 
+/** @brief Value of an R-Config object after `lt_r_config_erase()`. */
+#define LT_CONFIG_OBJ_ERASED 0xFFFFFFFFu
+
 /** @brief Structure to hold all configuration objects */
 typedef struct lt_config_t {
     uint32_t obj[LT_CONFIG_OBJ_CNT];
@@ -196,6 +196,41 @@ void lt_test_rev_ping(lt_handle_t *h);
  */
 void lt_test_rev_r_mem(lt_handle_t *h);
 
+/**
+ * @brief Test the key/value store layered on the last 32 User Data slots of the R-Memory.
+ *
+ * Test steps:
+ *  1. Start Secure Session with pairing key slot 0.
+ *  2. Write garbage into the first slot of the store, erase the others and mount the store.
+ *  3. Check that no key is found and that invalid keys and too long values are refused.
+ *  4. Set and overwrite keys with random values of random length, up to the maximal number of slots per value, until
+ *     the writes wrap around the store several times. Check all values after each write.
+ *  5. Delete a key and check it is not found.
+ *  6. Mount the store again and check all values.
+ *  7. Erase the dirty slots, overwrite a key and check all values.
+ *  8. Erase the slots of the store.
+ *
+ * @param h     Handle for communication with TROPIC01
+ */
+void lt_test_rev_r_mem_kv(lt_handle_t *h);
+
+/**
+ * @brief Test objects spanning several consecutive User Data slots of the R-Memory, in slots 400 to 407.
+ *
+ * Test steps:
+ *  1. Start Secure Session with pairing key slot 0.
+ *  2. Check that objects not fitting into the R-Memory are refused.
+ *  3. Write objects of random length (an empty one and one spanning all slots included), read each back and check
+ *     its length, version, content and the statistics of both calls.
+ *  4. Check that reading into a too small buffer fails and returns the length of the object.
+ *  5. Overwrite the last slot of the object and check that reading fails with `LT_R_MEM_OBJECT_INVALID`.
+ *  6. Erase the first slot of the object and check that reading fails (slot empty).
+ *  7. Erase the slots used by the test.
+ *
+ * @param h     Handle for communication with TROPIC01
+ */
+void lt_test_rev_r_mem_object(lt_handle_t *h);
+
 /**
  * @brief Backs up R-Config, erases it and then restores it.
  *
@@ -209,6 +244,21 @@ void lt_test_rev_r_mem(lt_handle_t *h);
  */
 void lt_test_rev_erase_r_config(lt_handle_t *h);
 
+/**
+ * @brief Test applying R-Config and I-Config changes against a snapshot.
+ *
+ * Test steps:
+ *  1. Start Secure Session with pairing key slot 0 and back up R-Config.
+ *  2. Erase R-Config and take a snapshot of it.
+ *  3. Apply the same R-Config, then one changing erased objects, then one changing a written object and finally the
+ *     backed up one. Each time check the snapshot and the R-Config read back.
+ *  4. Take a snapshot of I-Config, apply the same I-Config and check that bits cleared in the snapshot cannot be set.
+ *  5. Restore R-Config from the backup.
+ *
+ * @param h     Handle for communication with TROPIC01
+ */
+void lt_test_rev_apply_config(lt_handle_t *h);
+
 /**
  * @brief Test Secure Session initialization using handshake request and abortion of the Session.
  *
@@ -0,0 +1,185 @@
+#ifndef LIBTROPIC_KV_H
+#define LIBTROPIC_KV_H
+
+/**
+ * @file libtropic_kv.h
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief Key/value store layered on a range of the User R-Memory slots.
+ *
+ * Each value is stored as a record: a head slot holding the key, the sequence number and the list of the other slots
+ * of the value, followed by up to `LT_KV_SLOTS_PER_VALUE_MAX - 1` continuation slots. A continuation slot starts with
+ * a short header naming its record, so no value bytes are ever taken for a head. Records are never updated in
+ * place. A new record is written into slots erased in advance and the head, written last, makes it valid. The slots
+ * of the old record are only marked for erasing, which is done later in batches by `lt_kv_gc()`, so neither
+ * `lt_kv_set()` nor `lt_kv_get()` waits for an erase while erased slots are available.
+ *
+ * `lt_kv_mount()` reads every slot of the range once and builds an index in RAM, keyed by a hash of the key. Getting
+ * a value then costs one R-Memory read per slot of the value, without any scan.
+ *
+ * All functions need a Secure Session. The store does not lock, calls sharing one `lt_kv_t` have to be serialized.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <stdint.h>
+
+#include "libtropic_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if LT_L3_CMD_R_MEM_DATA_READ && LT_L3_CMD_R_MEM_DATA_WRITE && LT_L3_CMD_R_MEM_DATA_ERASE
+
+#ifndef LT_KV_ENTRIES_MAX
+/** @brief Maximal number of keys in one store. */
+#define LT_KV_ENTRIES_MAX 32
+#endif
+
+#ifndef LT_KV_SLOTS_PER_VALUE_MAX
+/** @brief Maximal number of slots one value may span, the head slot included. */
+#define LT_KV_SLOTS_PER_VALUE_MAX 4
+#endif
+
+/** @brief Maximal length of a key, without the terminating NUL. */
+#define LT_KV_KEY_LEN_MAX 32
+
+/** @brief Index entry of one key. */
+typedef struct lt_kv_entry_t {
+    /** @private @brief Hash of the key. */
+    uint32_t key_hash;
+    /** @private @brief Sequence number of the record. */
+    uint32_t seq;
+    /** @private @brief Length of the value. */
+    uint16_t val_len;
+    /** @private @brief Number of slots in `slots`. */
+    uint8_t slot_cnt;
+    /** @private @brief Slots of the record, the head slot first. */
+    uint16_t slots[LT_KV_SLOTS_PER_VALUE_MAX];
+} lt_kv_entry_t;
+
+/**
+ * @brief State of a key/value store, initialized by `lt_kv_mount()`.
+ *
+ * Every slot of the range is either live (part of an indexed record), erased (ready to be written) or dirty (waiting
+ * for `lt_kv_gc()`).
+ */
+typedef struct lt_kv_t {
+    /** @private @brief First slot of the range. */
+    uint16_t first_slot;
+    /** @private @brief Number of slots in the range. */
+    uint16_t slot_cnt;
+    /** @private @brief Usable size of one slot, taken from the handle. */
+    uint16_t slot_size;
+    /** @private @brief Next slot to try when allocating, relative to `first_slot`. */
+    uint16_t cursor;
+    /** @private @brief Highest sequence number in the store. */
+    uint32_t seq;
+    /** @private @brief Bit per slot, set while the slot is live. */
+    uint8_t live[(TR01_R_MEM_DATA_SLOT_MAX + 8) / 8];
+    /** @private @brief Bit per slot, set while the slot is erased. */
+    uint8_t erased[(TR01_R_MEM_DATA_SLOT_MAX + 8) / 8];
+    /** @private @brief Bit per dirty slot holding a head, these are erased first by `lt_kv_gc()`. */
+    uint8_t dirty_head[(TR01_R_MEM_DATA_SLOT_MAX + 8) / 8];
+    /** @private @brief Number of valid entries in `entries`. */
+    uint8_t entry_cnt;
+    /** @private @brief Index of the keys. */
+    lt_kv_entry_t entries[LT_KV_ENTRIES_MAX];
+} lt_kv_t;
+
+/**
+ * @brief Builds the index of a store kept in slots `first_slot` to `first_slot + slot_cnt - 1`.
+ *
+ * Reads every slot of the range once. Slots of the range holding anything else than a valid record are marked dirty
+ * and erased by the next `lt_kv_gc()`, so the range must not be shared with other data. Allocation continues after
+ * the most recently written record, which spreads the writes over the whole range. A key with several records (an
+ * overwritten value not yet erased) costs one more slot read per record, to check that the records hold the same key.
+ *
+ * @param h           Handle for communication with TROPIC01, after `lt_init()`
+ * @param kv          Store to initialize
+ * @param first_slot  First slot of the range
+ * @param slot_cnt    Number of slots in the range, at least `LT_KV_SLOTS_PER_VALUE_MAX + 1`
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            LT_KV_FULL More than `LT_KV_ENTRIES_MAX` keys are stored in the range
+ * @retval            LT_FAIL The range holds records of two keys with the same hash, which `lt_kv_set()` never writes
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_kv_mount(lt_handle_t *h, lt_kv_t *kv, const uint16_t first_slot, const uint16_t slot_cnt);
+
+/**
+ * @brief Reads the value of a key.
+ *
+ * @param h             Handle for communication with TROPIC01
+ * @param kv            Mounted store
+ * @param key           NUL terminated key
+ * @param val           Buffer to read the value into
+ * @param val_max_size  Size of `val`
+ * @param val_len       Length of the value
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            LT_KV_KEY_NOT_FOUND The key is not in the store
+ * @retval            LT_PARAM_ERR `val` is too small, `val_len` is set to the length of the value
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_kv_get(lt_handle_t *h, lt_kv_t *kv, const char *key, uint8_t *val, const uint16_t val_max_size,
+                   uint16_t *val_len);
+
+/**
+ * @brief Stores a value of a key, replacing the previous one.
+ *
+ * The new record is written into erased slots. The previous record stays valid until the head of the new one is
+ * written, then its slots become dirty. Only when too few slots are erased, dirty ones are erased first.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param kv          Mounted store
+ * @param key         NUL terminated key, `LT_KV_KEY_LEN_MAX` characters at most
+ * @param val         Value
+ * @param val_len     Length of the value, it may span up to `LT_KV_SLOTS_PER_VALUE_MAX` slots
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            LT_KV_FULL No room for the key or the value
+ * @retval            LT_PARAM_ERR The value does not fit into `LT_KV_SLOTS_PER_VALUE_MAX` slots
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_kv_set(lt_handle_t *h, lt_kv_t *kv, const char *key, const uint8_t *val, const uint16_t val_len);
+
+/**
+ * @brief Removes a key.
+ *
+ * Erases the dirty heads and then the head of the key, so no older record of the key can appear at the next mount.
+ * The other slots of the key become dirty.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param kv          Mounted store
+ * @param key         NUL terminated key
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            LT_KV_KEY_NOT_FOUND The key is not in the store
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_kv_delete(lt_handle_t *h, lt_kv_t *kv, const char *key);
+
+/**
+ * @brief Erases dirty slots, so later `lt_kv_set()` calls find them erased. Meant to be called when idle.
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param kv          Mounted store
+ * @param max_cnt     Maximal number of slots to erase, 0 to erase all dirty slots
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            other Function did not execute successully, you might use lt_ret_verbose() to get verbose encoding
+ * of returned value
+ */
+lt_ret_t lt_kv_gc(lt_handle_t *h, lt_kv_t *kv, const uint16_t max_cnt);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LIBTROPIC_KV_H
@@ -88,6 +88,34 @@ lt_ret_t lt_l2_send_encrypted_cmd(lt_l2_state_t *s2, uint8_t *buff, uint16_t buf
  */
 lt_ret_t lt_l2_recv_encrypted_res(lt_l2_state_t *s2, uint8_t *buff, uint16_t max_len);
 
+/**
+ * @brief Callback getting chunks of encrypted L3 response from `lt_l2_recv_encrypted_res_chunks()`.
+ *
+ * @param cb_ctx      Context passed to `lt_l2_recv_encrypted_res_chunks()`
+ * @param chunk       Chunk of the L3 packet, valid only during the call
+ * @param chunk_len   Length of the chunk
+ *
+ * @retval            LT_OK Continue with the next chunk
+ * @retval            other Skip the remaining chunks, the value is returned once the response is received
+ */
+typedef lt_ret_t (*lt_l2_chunk_cb_t)(void *cb_ctx, const uint8_t *chunk, const uint16_t chunk_len);
+
+/**
+ * @brief Receives encrypted L3 response over Layer 2, passing each chunk to a callback as it arrives.
+ *
+ * Lets the caller process the response while receiving it, without copying it into one buffer first.
+ * @note Use only after secure session was established with `lt_session_start()`.
+ *
+ * @param s2          Structure holding l2 state
+ * @param max_len     Maximal length of the whole L3 packet
+ * @param cb          Callback called for each chunk
+ * @param cb_ctx      Context passed to the callback
+ *
+ * @retval            LT_OK Function executed successfully
+ * @retval            other Function did not execute successully, or error returned by the callback
+ */
+lt_ret_t lt_l2_recv_encrypted_res_chunks(lt_l2_state_t *s2, uint16_t max_len, lt_l2_chunk_cb_t cb, void *cb_ctx);
+
 /** @} */  // end of group_l2_functions
 
 #ifdef __cplusplus
@@ -64,6 +64,7 @@ lt_ret_t lt_out__session_start(lt_handle_t *h, const lt_pkey_index_t pkey_index,
 lt_ret_t lt_in__session_start(lt_handle_t *h, const uint8_t *stpub, const lt_pkey_index_t pkey_index,
                               const uint8_t *shipriv, const uint8_t *shipub, lt_host_eph_keys_t *host_eph_keys);
 
+#if LT_L3_CMD_PING
 /**
  * @brief Encodes Ping command payload.
  * @note Used for separate L3 communication, for more information read info at the top
@@ -87,7 +88,9 @@ lt_ret_t lt_out__ping(lt_handle_t *h, const uint8_t *msg_out, const uint16_t msg
  * @return            LT_OK if success, otherwise returns other error code.
  */
 lt_ret_t lt_in__ping(lt_handle_t *h, uint8_t *msg_in, const uint16_t msg_len);
+#endif
 
+#if LT_L3_CMD_PAIRING_KEY_WRITE
 /**
  * @brief Encodes Pairing_Key_Write command payload.
  * @note Used for separate L3 communication, for more information read
@@ -108,7 +111,9 @@ lt_ret_t lt_out__pairing_key_write(lt_handle_t *h, const uint8_t *pairing_pub, c
  * @return            LT_OK if success, otherwise returns other error code.
  */
 lt_ret_t lt_in__pairing_key_write(lt_handle_t *h);
+#endif
 
+#if LT_L3_CMD_PAIRING_KEY_READ
 /**
  * @brief Encodes Pairing_Key_Read command payload.
  * @note Used for separate L3 communication, for more information read info
@@ -130,7 +135,9 @@ lt_ret_t lt_out__pairing_key_read(lt_handle_t *h, const uint8_t slot);
  * @return            LT_OK if success, otherwise returns other error code.
  */
 lt_ret_t lt_in__pairing_key_read(lt_handle_t *h, uint8_t *pubkey);
+#endif
 
+#if LT_L3_CMD_PAIRING_KEY_INVALIDATE
 /**
  * @brief Encodes Pairing_Key_Invalidate command payload.
  * @note Used for separate L3 communication, for more information
@@ -151,7 +158,9 @@ lt_ret_t lt_out__pairing_key_invalidate(lt_handle_t *h, const uint8_t slot);
  * @return            LT_OK if success, otherwise returns other error code.
  */
 lt_ret_t lt_in__pairing_key_invalidate(lt_handle_t *h);
+#endif
 
+#if LT_L3_CMD_R_CONFIG_WRITE
 /**
  * @brief Encodes R_Config_Write command payload.
  * @note Used for separate L3 communication, for more information read info
@@ -173,7 +182,9 @@ lt_ret_t lt_out__r_config_write(lt_handle_t *h, const enum lt_config_obj_addr_t
  * @return            LT_OK if success, otherwise returns other error code.
  */
 lt_ret_t lt_in__r_config_write(lt_handle_t *h);
+#endif
 
+#if LT_L3_CMD_R_CONFIG_READ
 /**
  * @brief Encodes R_Config_Read command payload.
  * @note Used for separate L3 communication, for more information read info at
@@ -195,7 +206,9 @@ lt_ret_t lt_out__r_config_read(lt_handle_t *h, const enum lt_config_obj_addr_t a
  * @return            LT_OK if success, otherwise returns other error code.
  */
 lt_ret_t lt_in__r_config_read(lt_handle_t *h, uint32_t *obj);
+#endif
 
+#if LT_L3_CMD_R_CONFIG_ERASE
 /**
  * @brief Encodes R_Config_Erase command payload.
  * @note Used for separate L3 communication, for more information read info
@@ -215,7 +228,9 @@ lt_ret_t lt_out__r_config_erase(lt_handle_t *h);
  * @return            LT_OK if success, otherwise returns other error code.
  */
 lt_ret_t lt_in__r_config_erase(lt_handle_t *h);
+#endif
 
+#if LT_L3_CMD_I_CONFIG_WRITE
 /**
  * @brief Encodes I_Config_Write command payload.
  * @note Used for separate L3 communication, for more information read info
@@ -237,7 +252,9 @@ lt_ret_t lt_out__i_config_write(lt_handle_t *h, const enum lt_config_obj_addr_t
  * @return            LT_OK if success, otherwise returns other error code.
  */
 lt_ret_t lt_in__i_config_write(lt_handle_t *h);
+#endif
 
+#if LT_L3_CMD_I_CONFIG_READ
 /**
  * @brief Encodes I_Config_Read command payload.
  * @note Used for separate L3 communication, for more information read info at
@@ -259,7 +276,9 @@ lt_ret_t lt_out__i_config_read(lt_handle_t *h, const enum lt_config_obj_addr_t a
  * @return            LT_OK if success, otherwise returns other error code.
  */
 lt_ret_t lt_in__i_config_read(lt_handle_t *h, uint32_t *obj);
+#endif
 
+#if LT_L3_CMD_R_MEM_DATA_WRITE
 /**
  * @brief Encodes R_Mem_Data_Write command payload.
  * @note Used for separate L3 communication, for more information read info
@@ -284,7 +303,9 @@ lt_ret_t lt_out__r_mem_data_write(lt_handle_t *h, const uint16_t udata_slot, con
  * @return            LT_OK if success, otherwise returns other error code.
  */
 lt_ret_t lt_in__r_mem_data_write(lt_handle_t *h);
+#endif
 
+#if LT_L3_CMD_R_MEM_DATA_READ
 /**
  * @brief Encodes R_Mem_Data_Read command payload.
  * @note Used for separate L3 communication, for more information read info
@@ -308,7 +329,9 @@ lt_ret_t lt_out__r_mem_data_read(lt_handle_t *h, const uint16_t udata_slot);
  * @return            LT_OK if success, otherwise returns other error code.
  */
 lt_ret_t lt_in__r_mem_data_read(lt_handle_t *h, uint8_t *data, const uint16_t data_max_size, uint16_t *data_read_size);
+#endif
 
+#if LT_L3_CMD_R_MEM_DATA_ERASE
 /**
  * @brief Encodes R_Mem_Data_Erase command payload.
  * @note Used for separate L3 communication, for more information read info
@@ -329,7 +352,9 @@ lt_ret_t lt_out__r_mem_data_erase(lt_handle_t *h, const uint16_t udata_slot);
  * @return            LT_OK if success, otherwise returns other error code.
  */
 lt_ret_t lt_in__r_mem_data_erase(lt_handle_t *h);
+#endif
 
+#if LT_L3_CMD_RANDOM_VALUE_GET
 /**
  * @brief Encodes Random_Value_Get command payload.
  * @note Used for separate L3 communication, for more information read info
@@ -352,7 +377,9 @@ lt_ret_t lt_out__random_value_get(lt_handle_t *h, const uint16_t rnd_bytes_cnt);
  * @return                  LT_OK if success, otherwise returns other error code.
  */
 lt_ret_t lt_in__random_value_get(lt_handle_t *h, uint8_t *rnd_bytes, const uint16_t rnd_bytes_cnt);
+#endif
 
+#if LT_L3_CMD_ECC_KEY_GENERATE
 /**
  * @brief Encodes ECC_Key_Generate command payload.
  * @note Used for separate L3 communication, for more information read
@@ -374,7 +401,9 @@ lt_ret_t lt_out__ecc_key_generate(lt_handle_t *h, const lt_ecc_slot_t slot, cons
  * @return            LT_OK if success, otherwise returns other error code.
  */
 lt_ret_t lt_in__ecc_key_generate(lt_handle_t *h);
+#endif
 
+#if LT_L3_CMD_ECC_KEY_STORE
 /**
  * @brief Encodes ECC_Key_Store command payload.
  * @note Used for separate L3 communication, for more information read info at
@@ -398,7 +427,9 @@ lt_ret_t lt_out__ecc_key_store(lt_handle_t *h, const lt_ecc_slot_t slot, const l
  * @return            LT_OK if success, otherwise returns other error code.
  */
 lt_ret_t lt_in__ecc_key_store(lt_handle_t *h);
+#endif
 
+#if LT_L3_CMD_ECC_KEY_READ
 /**
  * @brief Encodes ECC_Key_Read command payload.
  * @note Used for separate L3 communication, for more information read info at
@@ -426,7 +457,9 @@ lt_ret_t lt_out__ecc_key_read(lt_handle_t *h, const lt_ecc_slot_t slot);
  */
 lt_ret_t lt_in__ecc_key_read(lt_handle_t *h, uint8_t *key, const uint8_t key_max_size, lt_ecc_curve_type_t *curve,
                              lt_ecc_key_origin_t *origin);
+#endif
 
+#if LT_L3_CMD_ECC_KEY_ERASE
 /**
  * @brief Encodes ECC_Key_Erase command payload.
  * @note Used for separate L3 communication, for more information read info at
@@ -447,7 +480,9 @@ lt_ret_t lt_out__ecc_key_erase(lt_handle_t *h, const lt_ecc_slot_t slot);
  * @return            LT_OK if success, otherwise returns other error code.
  */
 lt_ret_t lt_in__ecc_key_erase(lt_handle_t *h);
+#endif
 
+#if LT_L3_CMD_ECC_ECDSA_SIGN
 /**
  * @brief Encodes ECDSA_Sign command payload.
  * @note Used for separate L3 communication, for more information read info
@@ -471,7 +506,9 @@ lt_ret_t lt_out__ecc_ecdsa_sign(lt_handle_t *h, const lt_ecc_slot_t slot, const
  * @return            LT_OK if success, otherwise returns other error code.
  */
 lt_ret_t lt_in__ecc_ecdsa_sign(lt_handle_t *h, uint8_t *rs);
+#endif
 
+#if LT_L3_CMD_ECC_EDDSA_SIGN
 /**
  * @brief Encodes EDDSA_Sign command payload.
  * @note Used for separate L3 communication, for more information read info
@@ -496,7 +533,9 @@ lt_ret_t lt_out__ecc_eddsa_sign(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, co
  * @return            LT_OK if success, otherwise returns other error code.
  */
 lt_ret_t lt_in__ecc_eddsa_sign(lt_handle_t *h, uint8_t *rs);
+#endif
 
+#if LT_L3_CMD_MCOUNTER_INIT
 /**
  * @brief Encodes MCounter_Init command payload.
  * @note Used for separate L3 communication, for more information read info at
@@ -522,7 +561,9 @@ lt_ret_t lt_out__mcounter_init(lt_handle_t *h, const enum lt_mcounter_index_t mc
  * @return            LT_OK if success, otherwise returns other error code.
  */
 lt_ret_t lt_in__mcounter_init(lt_handle_t *h);
+#endif
 
+#if LT_L3_CMD_MCOUNTER_UPDATE
 /**
  * @brief Encodes MCounter_Update command payload.
  * @note Used for separate L3 communication, for more information
@@ -543,7 +584,9 @@ lt_ret_t lt_out__mcounter_update(lt_handle_t *h, const enum lt_mcounter_index_t
  * @return            LT_OK if success, otherwise returns other error code.
  */
 lt_ret_t lt_in__mcounter_update(lt_handle_t *h);
+#endif
 
+#if LT_L3_CMD_MCOUNTER_GET
 /**
  * @brief Encodes MCounter_Get command payload.
  * @note Used for separate L3 communication, for more information read
@@ -565,7 +608,9 @@ lt_ret_t lt_out__mcounter_get(lt_handle_t *h, const enum lt_mcounter_index_t mco
  * @return            LT_OK if success, otherwise returns other error code.
  */
 lt_ret_t lt_in__mcounter_get(lt_handle_t *h, uint32_t *mcounter_value);
+#endif
 
+#if LT_L3_CMD_MAC_AND_DESTROY
 /**
  * @brief Encodes MAC_And_Destroy command payload.
  * @note Used for separate L3 communication, for more information read info
@@ -588,6 +633,7 @@ lt_ret_t lt_out__mac_and_destroy(lt_handle_t *h, lt_mac_and_destroy_slot_t slot,
  * @return            LT_OK if success, otherwise returns other error code.
  */
 lt_ret_t lt_in__mac_and_destroy(lt_handle_t *h, uint8_t *data_in);
+#endif
 
 /** @} */  // end of group_libtropic_l3
 
@@ -0,0 +1,157 @@
+import argparse
+import csv
+import json
+import os
+import pathlib
+import subprocess
+import sys
+import tempfile
+
+REPO_ROOT = pathlib.Path(__file__).parent.parent.resolve()
+
+# Statistics which can be compared, all of them are in nanoseconds (lower is better).
+STATS = ["min_ns", "p50_ns", "p90_ns", "p99_ns", "max_ns", "mean_ns"]
+
+
+def load_report(path: pathlib.Path) -> dict:
+    """Loads a benchmark report (JSON or CSV) into a dictionary keyed by (op, size)."""
+    results = {}
+    with path.open() as f:
+        if path.suffix == ".csv":
+            rows = list(csv.DictReader(f))
+        else:
+            rows = json.load(f)["results"]
+
+    for row in rows:
+        results[(row["op"], int(row["size"]))] = {stat: float(row[stat]) for stat in STATS}
+    return results
+
+
+def diff_reports(base: dict, head: dict, stat: str, threshold: float) -> int:
+    """Prints a table comparing the two reports and returns the number of regressions above the threshold."""
+    regressions = 0
+
+    print(f"{'op':<24} {'size':>6} {'base ' + stat:>16} {'head ' + stat:>16} {'delta':>9}")
+    print("-" * 75)
+    for key in sorted(set(base) | set(head)):
+        op, size = key
+        if key not in base or key not in head:
+            where = "head" if key in head else "base"
+            print(f"{op:<24} {size:>6} {'(only in ' + where + ')':>43}")
+            continue
+
+        b = base[key][stat]
+        h = head[key][stat]
+        delta = (h - b) / b * 100.0 if b else 0.0
+        mark = ""
+        if delta > threshold:
+            mark = "  REGRESSION"
+            regressions += 1
+        elif delta < -threshold:
+            mark = "  improvement"
+        print(f"{op:<24} {size:>6} {b:>16.0f} {h:>16.0f} {delta:>+8.1f}%{mark}")
+
+    return regressions
+
+
+def run_at_commit(label: str, ref: str, bench: str, cmake_args: list, bench_args: list,
+                  out_dir: pathlib.Path) -> pathlib.Path:
+    """Checks out the given commit into a temporary worktree, builds the benchmark and runs it."""
+    worktree = out_dir / f"worktree_{label}"
+    build_dir = out_dir / f"build_{label}"
+    report = out_dir / f"{bench}_{label}.json"
+
+    subprocess.run(["git", "-C", str(REPO_ROOT), "worktree", "add", "--detach", str(worktree), ref], check=True)
+    try:
+        subprocess.run(
+            ["cmake", "-S", str(worktree / "tropic01_model"), "-B", str(build_dir),
+             "-DLT_BUILD_BENCHMARKS=1", *cmake_args],
+            check=True
+        )
+        subprocess.run(["cmake", "--build", str(build_dir), "--target", bench, "-j", str(os.cpu_count() or 1)],
+                       check=True)
+        subprocess.run([str(build_dir / bench), "-f", "json", "-o", str(report), *bench_args], check=True)
+    finally:
+        subprocess.run(["git", "-C", str(REPO_ROOT), "worktree", "remove", "--force", str(worktree)], check=False)
+
+    return report
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        prog="bench_compare.py",
+        description="Compares results of libtropic benchmarks (tests/benchmarks/) between two reports or two commits."
+    )
+    parser.add_argument(
+        "--stat",
+        help="Statistic to compare (default: p50_ns).",
+        choices=STATS,
+        default="p50_ns"
+    )
+    parser.add_argument(
+        "--threshold",
+        help="Relative change in percent considered a regression/improvement (default: 5).",
+        type=float,
+        default=5.0
+    )
+    parser.add_argument(
+        "--fail-on-regression",
+        help="Exit with non-zero code if a regression above the threshold is found.",
+        action="store_true"
+    )
+
+    subparsers = parser.add_subparsers(dest="mode", required=True)
+
+    parser_reports = subparsers.add_parser("reports", help="Compare two existing reports (JSON or CSV).")
+    parser_reports.add_argument("base", type=pathlib.Path, help="Baseline report.")
+    parser_reports.add_argument("head", type=pathlib.Path, help="Report to compare against the baseline.")
+
+    parser_commits = subparsers.add_parser(
+        "commits",
+        help="Build and run a benchmark at two commits, then compare the reports. "
+             "The model has to be running already when comparing lt_bench_transport."
+    )
+    parser_commits.add_argument("base", help="Baseline commit (any git revision).")
+    parser_commits.add_argument("head", help="Commit to compare against the baseline.")
+    parser_commits.add_argument(
+        "-b", "--bench",
+        help="Benchmark executable to build and run (default: lt_bench_cal).",
+        choices=["lt_bench_cal", "lt_bench_transport", "lt_bench_shm"],
+        default="lt_bench_cal"
+    )
+    parser_commits.add_argument(
+        "-D", dest="cmake_defs",
+        help="CMake definition passed to the model's CMake project, e.g. -D LT_CAL=trezor_crypto. Repeatable.",
+        action="append",
+        default=[]
+    )
+    parser_commits.add_argument(
+        "-o", "--output-dir",
+        help="Directory where the reports are kept (default: temporary directory).",
+        type=pathlib.Path
+    )
+    parser_commits.epilog = "Arguments after '--' are passed to the benchmark executable, e.g. '-- -n 100'."
+
+    # Everything after '--' belongs to the benchmark executable.
+    argv = sys.argv[1:]
+    bench_args = []
+    if "--" in argv:
+        bench_args = argv[argv.index("--") + 1:]
+        argv = argv[:argv.index("--")]
+    args = parser.parse_args(argv)
+
+    if args.mode == "reports":
+        base_path, head_path = args.base, args.head
+    else:
+        out_dir = args.output_dir.resolve() if args.output_dir else pathlib.Path(tempfile.mkdtemp(prefix="lt_bench_"))
+        out_dir.mkdir(parents=True, exist_ok=True)
+        cmake_args = [f"-D{d}" for d in args.cmake_defs]
+        base_path = run_at_commit("base", args.base, args.bench, cmake_args, bench_args, out_dir)
+        head_path = run_at_commit("head", args.head, args.bench, cmake_args, bench_args, out_dir)
+        print(f"Reports saved to {out_dir}")
+
+    regressions = diff_reports(load_report(base_path), load_report(head_path), args.stat, args.threshold)
+    print(f"\n{regressions} regression(s) above {args.threshold}% in {args.stat}.")
+
+    if args.fail_on_regression and regressions:
+        sys.exit(1)
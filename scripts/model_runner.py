@@ -7,8 +7,23 @@ import sys
 import socket
 import os
 
-def wait_for_server_start(host="127.0.0.1", port=28992, retry_interval=0.2, max_attempts=10) -> bool:
+MODEL_HOST = "127.0.0.1"
+# Number of attempts to start the model, another process can take the chosen port before the model binds it.
+MODEL_START_ATTEMPTS = 3
+
+def find_free_port(host=MODEL_HOST) -> int:
+    # Let the OS pick an ephemeral port, the model binds it right after this socket is closed.
+    with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as sock:
+        sock.bind((host, 0))
+        return sock.getsockname()[1]
+
+def wait_for_server_start(
+    process: subprocess.Popen, host=MODEL_HOST, port=28992, retry_interval=0.2, max_attempts=50
+) -> bool:
+    # Give up early if the model exited, e.g. because the port was taken meanwhile.
     for i in range(max_attempts):
+        if process.poll() is not None:
+            return False
         with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as sock:
             sock.settimeout(1.0)
             try:
@@ -19,6 +34,13 @@ def wait_for_server_start(host="127.0.0.1", port=28992, retry_interval=0.2, max_
                 print(f"Waiting on server, attempt #{i+1}")
     return False
 
+def stop_server(process: subprocess.Popen):
+    process.terminate()
+    try:
+        process.wait(timeout=10)
+    except subprocess.TimeoutExpired:
+        process.kill()
+
 if __name__ == "__main__":
     parser = argparse.ArgumentParser(
         prog="model_runner.py",
@@ -84,25 +106,33 @@ if __name__ == "__main__":
     # Disable colors to prevent weird symbols in the .log file
     model_log_cfg["formatters"]["default"]["use_colors"] = False
 
-    model_log_cfg_path = output_path / "model_log_cfg_path.yml"
+    # Each executable has its own logging configuration, other runners may write theirs at the same time.
+    model_log_cfg_path = output_path / f"{exe_name}_model_log_cfg.yml"
     with model_log_cfg_path.open("w") as f:
         yaml.dump(model_log_cfg, f, default_flow_style=False)
-    
-    # Start the model server
-    model_process = subprocess.Popen(
-        [
-            "model_server", "tcp",
-            "-c", str(model_cfg_path),
-            "-l", str(model_log_cfg_path)
-        ],
-        env=os.environ
-    )
 
-    # Wait for model server to start
-    if not wait_for_server_start():
-        print("Server did not start.")
+    # Start the model server on a free port and wait for it (several models run at once with `ctest -j`)
+    for attempt in range(MODEL_START_ATTEMPTS):
+        model_port = find_free_port()
+        model_process = subprocess.Popen(
+            [
+                "model_server", "tcp",
+                "-c", str(model_cfg_path),
+                "-l", str(model_log_cfg_path),
+                "--port", str(model_port)
+            ],
+            env=os.environ
+        )
+        if wait_for_server_start(model_process, port=model_port):
+            break
+        stop_server(model_process)
+        print(f"Server did not start on port {model_port}.")
+    else:
         sys.exit(1)
 
+    # The executable connects to the port given by LT_MODEL_PORT (see tropic01_model/main.c).
+    exe_env = dict(os.environ, LT_MODEL_PORT=str(model_port))
+
     # Run the executable
     ret = 0
     exe_log_path = output_path / f"{exe_name}.log"
@@ -126,16 +156,12 @@ if __name__ == "__main__":
             subprocess.run(
                 args=exe_cmd,
                 stdout=f, stderr=f,
-                env=os.environ,
+                env=exe_env,
                 check=True
             )
         except subprocess.CalledProcessError as e:
             ret = e.returncode
 
     # Clean up
-    model_process.terminate()
-    try:
-        model_process.wait(timeout=10)
-    except subprocess.TimeoutExpired:
-        model_process.kill()
+    stop_server(model_process)
     sys.exit(ret)
\ No newline at end of file
@@ -24,6 +24,7 @@
 #include "lt_asn1_der.h"
 #include "lt_crypto_common.h"
 #include "lt_hkdf.h"
+#include "lt_hex.h"
 #include "lt_l1.h"
 #include "lt_l1_port_wrap.h"
 #include "lt_l2_api_structs.h"
@@ -50,6 +51,13 @@ lt_ret_t lt_init(lt_handle_t *h)
 #if !LT_SEPARATE_L3_BUFF
     h->l3.buff_len = LT_SIZE_OF_L3_BUFF;  // Size of l3 buffer is defined in libtropic_common.h
 #endif
+#if LT_L3_BUFF_POOL
+    // Handles using a pool lease the buffer for each L3 command.
+    if (h->l3.pool) {
+        h->l3.buff = NULL;
+        h->l3.buff_len = h->l3.pool->buff_len;
+    }
+#endif
 
     h->l3.session_status = LT_SECURE_SESSION_OFF;
     ret = lt_l1_init(&h->l2);
@@ -63,8 +71,8 @@ lt_ret_t lt_init(lt_handle_t *h)
         return ret;
     }
 
-    // Prevent usage of insufficient buffer.
-    if (h->l3.buff_len < LT_SIZE_OF_L3_BUFF) {
+    // Prevent usage of insufficient buffer. Commands of variable size check it again when called.
+    if (h->l3.buff_len < LT_L3_BUFF_LEN_MIN) {
         return LT_L3_BUFFER_TOO_SMALL;
     }
 
@@ -83,6 +91,13 @@ lt_ret_t lt_deinit(lt_handle_t *h)
         return LT_PARAM_ERR;
     }
 
+#if LT_R_MEM_CACHE
+    lt_ret_t flush_ret = LT_OK;
+    if (h->l3.r_mem_cache && h->l3.session_status == LT_SECURE_SESSION_ON) {
+        flush_ret = lt_r_mem_cache_flush(h);
+    }
+#endif
+
     lt_l3_invalidate_host_session_data(&h->l3);
 
     lt_ret_t ret = lt_l1_deinit(&h->l2);
@@ -90,8 +105,35 @@ lt_ret_t lt_deinit(lt_handle_t *h)
         return ret;
     }
 
+#if LT_R_MEM_CACHE
+    return flush_ret;
+#else
+    return LT_OK;
+#endif
+}
+
+#if LT_L3_BUFF_POOL
+lt_ret_t lt_l3_buff_pool_init(lt_l3_buff_pool_t *pool, uint8_t *buffs, const size_t buffs_size,
+                              const uint16_t buff_len)
+{
+    if (!pool || !buffs || ((uintptr_t)buffs % 16) || (buff_len % 16) || (buff_len < LT_L3_BUFF_LEN_MIN)) {
+        return LT_PARAM_ERR;
+    }
+
+    size_t count = buffs_size / buff_len;
+    if (count == 0 || count > 32) {
+        return LT_PARAM_ERR;
+    }
+
+    pool->buffs = buffs;
+    pool->buff_len = buff_len;
+    pool->count = (uint8_t)count;
+    pool->in_use = 0;
+    lt_secure_memzero(buffs, count * buff_len);
+
     return LT_OK;
 }
+#endif
 
 lt_ret_t lt_get_tr01_mode(lt_handle_t *h, lt_tr01_mode_t *mode)
 {
@@ -138,6 +180,7 @@ lt_ret_t lt_get_tr01_mode(lt_handle_t *h, lt_tr01_mode_t *mode)
     return LT_L1_CHIP_BUSY;
 }
 
+#if LT_L2_CMD_GET_INFO_CERT_STORE
 lt_ret_t lt_get_info_cert_store(lt_handle_t *h, struct lt_cert_store_t *store)
 {
     if (!h || !store) {
@@ -251,7 +294,9 @@ lt_ret_t lt_get_st_pub(const struct lt_cert_store_t *store, uint8_t *stpub)
 
     return asn1der_find_object(head, len, LT_OBJ_ID_CURVEX25519, stpub, TR01_STPUB_LEN, LT_ASN1DER_CROP_PREFIX);
 }
+#endif
 
+#if LT_L2_CMD_GET_INFO_CHIP_ID
 lt_ret_t lt_get_info_chip_id(lt_handle_t *h, struct lt_chip_id_t *chip_id)
 {
     if (!h || !chip_id) {
@@ -285,6 +330,7 @@ lt_ret_t lt_get_info_chip_id(lt_handle_t *h, struct lt_chip_id_t *chip_id)
 
     return LT_OK;
 }
+#endif
 
 lt_ret_t lt_get_info_riscv_fw_ver(lt_handle_t *h, uint8_t *ver)
 {
@@ -320,6 +366,7 @@ lt_ret_t lt_get_info_riscv_fw_ver(lt_handle_t *h, uint8_t *ver)
     return LT_OK;
 }
 
+#if LT_L2_CMD_GET_INFO_SPECT_FW_VER
 lt_ret_t lt_get_info_spect_fw_ver(lt_handle_t *h, uint8_t *ver)
 {
     if (!h || !ver) {
@@ -353,7 +400,9 @@ lt_ret_t lt_get_info_spect_fw_ver(lt_handle_t *h, uint8_t *ver)
 
     return LT_OK;
 }
+#endif
 
+#if LT_L2_CMD_GET_INFO_FW_BANK
 lt_ret_t lt_get_info_fw_bank(lt_handle_t *h, const lt_bank_id_t bank_id, uint8_t *header,
                              const uint16_t header_max_size, uint16_t *header_read_size)
 {
@@ -399,6 +448,7 @@ lt_ret_t lt_get_info_fw_bank(lt_handle_t *h, const lt_bank_id_t bank_id, uint8_t
 
     return LT_OK;
 }
+#endif
 
 lt_ret_t lt_session_start(lt_handle_t *h, const uint8_t *stpub, const lt_pkey_index_t pkey_index,
                           const uint8_t *shipriv, const uint8_t *shipub)
@@ -436,6 +486,14 @@ lt_ret_t lt_session_abort(lt_handle_t *h)
         return LT_PARAM_ERR;
     }
 
+#if LT_R_MEM_CACHE
+    // The session is aborted even if writing the cache fails, the error is returned at the end.
+    lt_ret_t flush_ret = LT_OK;
+    if (h->l3.r_mem_cache && h->l3.session_status == LT_SECURE_SESSION_ON) {
+        flush_ret = lt_r_mem_cache_flush(h);
+    }
+#endif
+
     lt_l3_invalidate_host_session_data(&h->l3);
 
     // Setup a request pointer to l2 buffer, which is placed in handle
@@ -459,7 +517,11 @@ lt_ret_t lt_session_abort(lt_handle_t *h)
         return LT_L2_RSP_LEN_ERROR;
     }
 
+#if LT_R_MEM_CACHE
+    return flush_ret;
+#else
     return LT_OK;
+#endif
 }
 
 lt_ret_t lt_sleep(lt_handle_t *h, const uint8_t sleep_kind)
@@ -785,6 +847,7 @@ lt_ret_t lt_get_log_req(lt_handle_t *h, uint8_t *log_msg, const uint16_t log_msg
     return LT_OK;
 }
 
+#if LT_L3_CMD_PING
 lt_ret_t lt_ping(lt_handle_t *h, const uint8_t *msg_out, uint8_t *msg_in, const uint16_t msg_len)
 {
     if (!h || !msg_out || !msg_in || (msg_len > TR01_PING_LEN_MAX)) {
@@ -801,17 +864,21 @@ lt_ret_t lt_ping(lt_handle_t *h, const uint8_t *msg_out, uint8_t *msg_in, const
 
     ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
-    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff, lt_min(h->l3.buff_len, TR01_L3_PING_RES_PACKET_SIZE_MAX));
+    ret = lt_l3_recv_response(&h->l2, &h->l3, lt_min(h->l3.buff_len, TR01_L3_PING_RES_PACKET_SIZE_MAX));
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
     return lt_in__ping(h, msg_in, msg_len);
 }
+#endif
 
+#if LT_L3_CMD_PAIRING_KEY_WRITE
 lt_ret_t lt_pairing_key_write(lt_handle_t *h, const uint8_t *pairing_pub, const uint8_t slot)
 {
     if (!h || !pairing_pub || (slot > 3)) {
@@ -828,18 +895,21 @@ lt_ret_t lt_pairing_key_write(lt_handle_t *h, const uint8_t *pairing_pub, const
 
     ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
-    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff,
-                                   lt_min(h->l3.buff_len, TR01_L3_PAIRING_KEY_WRITE_RES_PACKET_SIZE));
+    ret = lt_l3_recv_response(&h->l2, &h->l3, lt_min(h->l3.buff_len, TR01_L3_PAIRING_KEY_WRITE_RES_PACKET_SIZE));
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
     return lt_in__pairing_key_write(h);
 }
+#endif
 
+#if LT_L3_CMD_PAIRING_KEY_READ
 lt_ret_t lt_pairing_key_read(lt_handle_t *h, uint8_t *pairing_pub, const uint8_t slot)
 {
     if (!h || !pairing_pub || (slot > 3)) {
@@ -856,18 +926,21 @@ lt_ret_t lt_pairing_key_read(lt_handle_t *h, uint8_t *pairing_pub, const uint8_t
 
     ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
-    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff,
-                                   lt_min(h->l3.buff_len, TR01_L3_PAIRING_KEY_READ_RES_PACKET_SIZE));
+    ret = lt_l3_recv_response(&h->l2, &h->l3, lt_min(h->l3.buff_len, TR01_L3_PAIRING_KEY_READ_RES_PACKET_SIZE));
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
     return lt_in__pairing_key_read(h, pairing_pub);
 }
+#endif
 
+#if LT_L3_CMD_PAIRING_KEY_INVALIDATE
 lt_ret_t lt_pairing_key_invalidate(lt_handle_t *h, const uint8_t slot)
 {
     if (!h || (slot > 3)) {
@@ -884,18 +957,21 @@ lt_ret_t lt_pairing_key_invalidate(lt_handle_t *h, const uint8_t slot)
 
     ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
-    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff,
-                                   lt_min(h->l3.buff_len, TR01_L3_PAIRING_KEY_INVALIDATE_RES_PACKET_SIZE));
+    ret = lt_l3_recv_response(&h->l2, &h->l3, lt_min(h->l3.buff_len, TR01_L3_PAIRING_KEY_INVALIDATE_RES_PACKET_SIZE));
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
     return lt_in__pairing_key_invalidate(h);
 }
+#endif
 
+#if LT_L3_CMD_R_CONFIG_WRITE
 lt_ret_t lt_r_config_write(lt_handle_t *h, const enum lt_config_obj_addr_t addr, const uint32_t obj)
 {
     if (!h) {
@@ -912,17 +988,21 @@ lt_ret_t lt_r_config_write(lt_handle_t *h, const enum lt_config_obj_addr_t addr,
 
     ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
-    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff, lt_min(h->l3.buff_len, TR01_L3_R_CONFIG_WRITE_RES_PACKET_SIZE));
+    ret = lt_l3_recv_response(&h->l2, &h->l3, lt_min(h->l3.buff_len, TR01_L3_R_CONFIG_WRITE_RES_PACKET_SIZE));
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
     return lt_in__r_config_write(h);
 }
+#endif
 
+#if LT_L3_CMD_R_CONFIG_READ
 lt_ret_t lt_r_config_read(lt_handle_t *h, const enum lt_config_obj_addr_t addr, uint32_t *obj)
 {
     if (!h || !obj) {
@@ -939,17 +1019,21 @@ lt_ret_t lt_r_config_read(lt_handle_t *h, const enum lt_config_obj_addr_t addr,
 
     ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
-    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff, lt_min(h->l3.buff_len, TR01_L3_R_CONFIG_READ_RES_PACKET_SIZE));
+    ret = lt_l3_recv_response(&h->l2, &h->l3, lt_min(h->l3.buff_len, TR01_L3_R_CONFIG_READ_RES_PACKET_SIZE));
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
     return lt_in__r_config_read(h, obj);
 }
+#endif
 
+#if LT_L3_CMD_R_CONFIG_ERASE
 lt_ret_t lt_r_config_erase(lt_handle_t *h)
 {
     if (!h) {
@@ -966,17 +1050,21 @@ lt_ret_t lt_r_config_erase(lt_handle_t *h)
 
     ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
-    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff, lt_min(h->l3.buff_len, TR01_L3_R_CONFIG_ERASE_RES_PACKET_SIZE));
+    ret = lt_l3_recv_response(&h->l2, &h->l3, lt_min(h->l3.buff_len, TR01_L3_R_CONFIG_ERASE_RES_PACKET_SIZE));
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
     return lt_in__r_config_erase(h);
 }
+#endif
 
+#if LT_L3_CMD_I_CONFIG_WRITE
 lt_ret_t lt_i_config_write(lt_handle_t *h, const enum lt_config_obj_addr_t addr, const uint8_t bit_index)
 {
     if (!h || (bit_index > 31)) {
@@ -993,17 +1081,21 @@ lt_ret_t lt_i_config_write(lt_handle_t *h, const enum lt_config_obj_addr_t addr,
 
     ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
-    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff, lt_min(h->l3.buff_len, TR01_L3_I_CONFIG_WRITE_RES_PACKET_SIZE));
+    ret = lt_l3_recv_response(&h->l2, &h->l3, lt_min(h->l3.buff_len, TR01_L3_I_CONFIG_WRITE_RES_PACKET_SIZE));
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
     return lt_in__i_config_write(h);
 }
+#endif
 
+#if LT_L3_CMD_I_CONFIG_READ
 lt_ret_t lt_i_config_read(lt_handle_t *h, const enum lt_config_obj_addr_t addr, uint32_t *obj)
 {
     if (!h || !obj) {
@@ -1020,17 +1112,96 @@ lt_ret_t lt_i_config_read(lt_handle_t *h, const enum lt_config_obj_addr_t addr,
 
     ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
-    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff, lt_min(h->l3.buff_len, TR01_L3_I_CONFIG_READ_RES_PACKET_SIZE));
+    ret = lt_l3_recv_response(&h->l2, &h->l3, lt_min(h->l3.buff_len, TR01_L3_I_CONFIG_READ_RES_PACKET_SIZE));
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
     return lt_in__i_config_read(h, obj);
 }
+#endif
+
+#if LT_R_MEM_CACHE
+/** @brief Returns the line holding the slot, NULL if the slot is not cached. */
+static lt_r_mem_cache_line_t *lt_r_mem_cache_find(lt_r_mem_cache_t *cache, const uint16_t udata_slot)
+{
+    for (uint8_t i = 0; i < cache->count; i++) {
+        if (cache->lines[i].used && cache->lines[i].slot == udata_slot) {
+            return &cache->lines[i];
+        }
+    }
+
+    return NULL;
+}
+
+/** @brief Drops the slot from the cache of the handle, if any. */
+static void lt_r_mem_cache_drop(lt_handle_t *h, const uint16_t udata_slot)
+{
+    if (!h->l3.r_mem_cache) {
+        return;
+    }
+
+    lt_r_mem_cache_line_t *line = lt_r_mem_cache_find(h->l3.r_mem_cache, udata_slot);
+    if (line && !line->flushing) {
+        lt_secure_memzero(line, sizeof(lt_r_mem_cache_line_t));
+    }
+}
+
+/** @brief Writes a dirty line into the R-Memory, as one erase and one write. */
+static lt_ret_t lt_r_mem_cache_line_flush(lt_handle_t *h, lt_r_mem_cache_line_t *line)
+{
+    if (!line->dirty) {
+        return LT_OK;
+    }
+
+    // A session-breaking error zeroes the line meanwhile, together with the flag, and the line stays free.
+    line->flushing = true;
+    lt_ret_t ret = lt_r_mem_data_erase(h, line->slot);
+    if (ret == LT_OK) {
+        ret = lt_r_mem_data_write(h, line->slot, line->data, line->len);
+    }
+    if (!line->flushing) {
+        return ret;
+    }
+    line->flushing = false;
+    if (ret != LT_OK) {
+        return ret;
+    }
+    line->dirty = false;
+
+    return LT_OK;
+}
+
+/** @brief Takes a line for the slot: a free one, or the least recently used one after writing it if dirty. */
+static lt_ret_t lt_r_mem_cache_alloc(lt_handle_t *h, const uint16_t udata_slot, lt_r_mem_cache_line_t **line)
+{
+    lt_r_mem_cache_t *cache = h->l3.r_mem_cache;
+    lt_r_mem_cache_line_t *victim = &cache->lines[0];
+
+    for (uint8_t i = 0; i < cache->count && victim->used; i++) {
+        if (cache->lines[i].used < victim->used) {
+            victim = &cache->lines[i];
+        }
+    }
+
+    lt_ret_t ret = lt_r_mem_cache_line_flush(h, victim);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    lt_secure_memzero(victim, sizeof(lt_r_mem_cache_line_t));
+    victim->slot = udata_slot;
+    *line = victim;
+
+    return LT_OK;
+}
+#endif
 
+#if LT_L3_CMD_R_MEM_DATA_WRITE
 lt_ret_t lt_r_mem_data_write(lt_handle_t *h, const uint16_t udata_slot, const uint8_t *data, const uint16_t data_size)
 {
     if (!h || !data || data_size < TR01_R_MEM_DATA_SIZE_MIN || data_size > h->tr01_attrs.r_mem_udata_slot_size_max
@@ -1040,6 +1211,9 @@ lt_ret_t lt_r_mem_data_write(lt_handle_t *h, const uint16_t udata_slot, const ui
     if (h->l3.session_status != LT_SECURE_SESSION_ON) {
         return LT_HOST_NO_SESSION;
     }
+#if LT_R_MEM_CACHE
+    lt_r_mem_cache_drop(h, udata_slot);
+#endif
 
     lt_ret_t ret = lt_out__r_mem_data_write(h, udata_slot, data, data_size);
     if (ret != LT_OK) {
@@ -1048,28 +1222,25 @@ lt_ret_t lt_r_mem_data_write(lt_handle_t *h, const uint16_t udata_slot, const ui
 
     ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
-    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff,
-                                   lt_min(h->l3.buff_len, TR01_L3_R_MEM_DATA_WRITE_RES_PACKET_SIZE));
+    ret = lt_l3_recv_response(&h->l2, &h->l3, lt_min(h->l3.buff_len, TR01_L3_R_MEM_DATA_WRITE_RES_PACKET_SIZE));
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
     return lt_in__r_mem_data_write(h);
 }
+#endif
 
-lt_ret_t lt_r_mem_data_read(lt_handle_t *h, const uint16_t udata_slot, uint8_t *data, const uint16_t data_max_size,
-                            uint16_t *data_read_size)
+#if LT_L3_CMD_R_MEM_DATA_READ
+/** @brief Reads the slot by the R_Mem_Data_Read L3 command, parameters as of `lt_r_mem_data_read()`. */
+static lt_ret_t lt_r_mem_data_read_l3(lt_handle_t *h, const uint16_t udata_slot, uint8_t *data,
+                                      const uint16_t data_max_size, uint16_t *data_read_size)
 {
-    if (!h || !data || !data_read_size || (udata_slot > TR01_R_MEM_DATA_SLOT_MAX)) {
-        return LT_PARAM_ERR;
-    }
-    if (h->l3.session_status != LT_SECURE_SESSION_ON) {
-        return LT_HOST_NO_SESSION;
-    }
-
     lt_ret_t ret = lt_out__r_mem_data_read(h, udata_slot);
     if (ret != LT_OK) {
         return ret;
@@ -1077,270 +1248,750 @@ lt_ret_t lt_r_mem_data_read(lt_handle_t *h, const uint16_t udata_slot, uint8_t *
 
     ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
-    ret = lt_l2_recv_encrypted_res(
-        &h->l2, h->l3.buff,
+    ret = lt_l3_recv_response(
+        &h->l2, &h->l3,
         lt_min(h->l3.buff_len, TR01_L3_SIZE_SIZE + TR01_L3_RESULT_SIZE
                                    + (TR01_L3_R_MEM_DATA_READ_PADDING_SIZE + h->tr01_attrs.r_mem_udata_slot_size_max)
                                    + TR01_L3_TAG_SIZE));
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
     return lt_in__r_mem_data_read(h, data, data_max_size, data_read_size);
 }
 
-lt_ret_t lt_r_mem_data_erase(lt_handle_t *h, const uint16_t udata_slot)
+lt_ret_t lt_r_mem_data_read(lt_handle_t *h, const uint16_t udata_slot, uint8_t *data, const uint16_t data_max_size,
+                            uint16_t *data_read_size)
 {
-    if (!h || (udata_slot > TR01_R_MEM_DATA_SLOT_MAX)) {
+    if (!h || !data || !data_read_size || (udata_slot > TR01_R_MEM_DATA_SLOT_MAX)) {
         return LT_PARAM_ERR;
     }
     if (h->l3.session_status != LT_SECURE_SESSION_ON) {
         return LT_HOST_NO_SESSION;
     }
+#if LT_R_MEM_CACHE
+    if (h->l3.r_mem_cache) {
+        lt_r_mem_cache_t *cache = h->l3.r_mem_cache;
+        lt_r_mem_cache_line_t *line = lt_r_mem_cache_find(cache, udata_slot);
+        if (!line) {
+            lt_ret_t ret = lt_r_mem_cache_alloc(h, udata_slot, &line);
+            if (ret != LT_OK) {
+                return ret;
+            }
+            ret = lt_r_mem_data_read_l3(h, udata_slot, line->data, sizeof(line->data), &line->len);
+            if (ret != LT_OK && ret != LT_L3_R_MEM_DATA_READ_SLOT_EMPTY) {
+                lt_secure_memzero(line, sizeof(lt_r_mem_cache_line_t));
+                return ret;
+            }
+        }
+        line->used = ++cache->tick;
 
-    lt_ret_t ret = lt_out__r_mem_data_erase(h, udata_slot);
-    if (ret != LT_OK) {
-        return ret;
-    }
-
-    ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
-    if (ret != LT_OK) {
-        return ret;
-    }
+        *data_read_size = line->len;
+        if (!line->len) {
+            return LT_L3_R_MEM_DATA_READ_SLOT_EMPTY;
+        }
+        if (data_max_size < line->len) {
+            return LT_PARAM_ERR;
+        }
+        memcpy(data, line->data, line->len);
 
-    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff,
-                                   lt_min(h->l3.buff_len, TR01_L3_R_MEM_DATA_ERASE_RES_PACKET_SIZE));
-    if (ret != LT_OK) {
-        return ret;
+        return LT_OK;
     }
+#endif
 
-    return lt_in__r_mem_data_erase(h);
+    return lt_r_mem_data_read_l3(h, udata_slot, data, data_max_size, data_read_size);
 }
+#endif
 
-lt_ret_t lt_random_value_get(lt_handle_t *h, uint8_t *rnd_bytes, const uint16_t rnd_bytes_cnt)
+#if LT_L3_CMD_R_MEM_DATA_ERASE
+lt_ret_t lt_r_mem_data_erase(lt_handle_t *h, const uint16_t udata_slot)
 {
-    if (!h || !rnd_bytes || (rnd_bytes_cnt > TR01_RANDOM_VALUE_GET_LEN_MAX)) {
+    if (!h || (udata_slot > TR01_R_MEM_DATA_SLOT_MAX)) {
         return LT_PARAM_ERR;
     }
     if (h->l3.session_status != LT_SECURE_SESSION_ON) {
         return LT_HOST_NO_SESSION;
     }
+#if LT_R_MEM_CACHE
+    lt_r_mem_cache_drop(h, udata_slot);
+#endif
 
-    lt_ret_t ret = lt_out__random_value_get(h, rnd_bytes_cnt);
+    lt_ret_t ret = lt_out__r_mem_data_erase(h, udata_slot);
     if (ret != LT_OK) {
         return ret;
     }
 
     ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
-    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff,
-                                   lt_min(h->l3.buff_len, TR01_L3_RANDOM_VALUE_GET_RES_PACKET_SIZE_MAX));
+    ret = lt_l3_recv_response(&h->l2, &h->l3, lt_min(h->l3.buff_len, TR01_L3_R_MEM_DATA_ERASE_RES_PACKET_SIZE));
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
-    return lt_in__random_value_get(h, rnd_bytes, rnd_bytes_cnt);
+    return lt_in__r_mem_data_erase(h);
 }
+#endif
 
-lt_ret_t lt_ecc_key_generate(lt_handle_t *h, const lt_ecc_slot_t slot, const lt_ecc_curve_type_t curve)
+#if LT_R_MEM_CACHE
+lt_ret_t lt_r_mem_cache_init(lt_r_mem_cache_t *cache, lt_r_mem_cache_line_t *lines, const uint8_t count)
 {
-    if (!h || (slot > TR01_ECC_SLOT_31) || ((curve != TR01_CURVE_P256) && (curve != TR01_CURVE_ED25519))) {
+    if (!cache || !lines || !count) {
         return LT_PARAM_ERR;
     }
-    if (h->l3.session_status != LT_SECURE_SESSION_ON) {
-        return LT_HOST_NO_SESSION;
-    }
-
-    lt_ret_t ret = lt_out__ecc_key_generate(h, slot, curve);
-    if (ret != LT_OK) {
-        return ret;
-    }
-
-    ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
-    if (ret != LT_OK) {
-        return ret;
-    }
 
-    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff,
-                                   lt_min(h->l3.buff_len, TR01_L3_ECC_KEY_GENERATE_RES_PACKET_SIZE));
-    if (ret != LT_OK) {
-        return ret;
-    }
+    cache->lines = lines;
+    cache->count = count;
+    cache->tick = 0;
+    lt_secure_memzero(lines, count * sizeof(lt_r_mem_cache_line_t));
 
-    return lt_in__ecc_key_generate(h);
+    return LT_OK;
 }
 
-lt_ret_t lt_ecc_key_store(lt_handle_t *h, const lt_ecc_slot_t slot, const lt_ecc_curve_type_t curve, const uint8_t *key)
+lt_ret_t lt_r_mem_cache_write(lt_handle_t *h, const uint16_t udata_slot, const uint8_t *data, const uint16_t data_size)
 {
-    if (!h || (slot > TR01_ECC_SLOT_31) || ((curve != TR01_CURVE_P256) && (curve != TR01_CURVE_ED25519)) || !key) {
+    if (!h || !h->l3.r_mem_cache || !data || data_size < TR01_R_MEM_DATA_SIZE_MIN
+        || data_size > h->tr01_attrs.r_mem_udata_slot_size_max || (udata_slot > TR01_R_MEM_DATA_SLOT_MAX)) {
         return LT_PARAM_ERR;
     }
     if (h->l3.session_status != LT_SECURE_SESSION_ON) {
         return LT_HOST_NO_SESSION;
     }
-    lt_ret_t ret = lt_out__ecc_key_store(h, slot, curve, key);
-    if (ret != LT_OK) {
-        return ret;
-    }
 
-    ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
-    if (ret != LT_OK) {
-        return ret;
+    lt_r_mem_cache_t *cache = h->l3.r_mem_cache;
+    lt_r_mem_cache_line_t *line = lt_r_mem_cache_find(cache, udata_slot);
+    if (!line) {
+        lt_ret_t ret = lt_r_mem_cache_alloc(h, udata_slot, &line);
+        if (ret != LT_OK) {
+            return ret;
+        }
     }
 
-    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff, lt_min(h->l3.buff_len, TR01_L3_ECC_KEY_STORE_RES_PACKET_SIZE));
-    if (ret != LT_OK) {
-        return ret;
-    }
+    memcpy(line->data, data, data_size);
+    line->len = data_size;
+    line->dirty = true;
+    line->used = ++cache->tick;
 
-    return lt_in__ecc_key_store(h);
+    return LT_OK;
 }
 
-lt_ret_t lt_ecc_key_read(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, uint8_t *key, const uint8_t key_max_size,
-                         lt_ecc_curve_type_t *curve, lt_ecc_key_origin_t *origin)
+lt_ret_t lt_r_mem_cache_flush(lt_handle_t *h)
 {
-    if (!h || (ecc_slot > TR01_ECC_SLOT_31) || !key || !curve || !origin) {
+    if (!h || !h->l3.r_mem_cache) {
         return LT_PARAM_ERR;
     }
     if (h->l3.session_status != LT_SECURE_SESSION_ON) {
         return LT_HOST_NO_SESSION;
     }
 
-    lt_ret_t ret = lt_out__ecc_key_read(h, ecc_slot);
-    if (ret != LT_OK) {
-        return ret;
+    lt_r_mem_cache_t *cache = h->l3.r_mem_cache;
+    for (uint8_t i = 0; i < cache->count; i++) {
+        if (cache->lines[i].used) {
+            lt_ret_t ret = lt_r_mem_cache_line_flush(h, &cache->lines[i]);
+            if (ret != LT_OK) {
+                return ret;
+            }
+        }
     }
 
-    ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
-    if (ret != LT_OK) {
-        return ret;
-    }
+    return LT_OK;
+}
+#endif
 
-    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff,
-                                   lt_min(h->l3.buff_len, TR01_L3_ECC_KEY_READ_RES_PACKET_SIZE_MAX));
-    if (ret != LT_OK) {
-        return ret;
+#if LT_L3_CMD_R_MEM_DATA_READ || (LT_L3_CMD_R_MEM_DATA_WRITE && LT_L3_CMD_R_MEM_DATA_ERASE)
+/** @brief Value of `lt_r_mem_object_hdr_t.magic`. */
+#define LT_R_MEM_OBJECT_MAGIC 0x4f52
+
+/** @brief Header of an R-Memory object, followed by the beginning of the object in the first slot. */
+struct lt_r_mem_object_hdr_t {
+    uint16_t magic;
+    /** Number of slots of the object, the first one included. */
+    uint16_t slot_cnt;
+    uint32_t len;
+    uint32_t version;
+    /** SHA-256 of the object. */
+    uint8_t sha256[LT_SHA256_DIGEST_LENGTH];
+} __attribute__((packed));
+
+LT_STATIC_ASSERT(sizeof(struct lt_r_mem_object_hdr_t) == LT_R_MEM_OBJECT_HEADER_SIZE)
+
+/** @brief Returns the number of slots an object of `obj_len` bytes spans, 0 if it does not fit into the R-Memory. */
+static uint16_t lt_r_mem_object_slot_cnt(const uint16_t slot_size, const uint16_t first_slot, const uint32_t obj_len)
+{
+    const uint32_t slots_left = TR01_R_MEM_DATA_SLOT_MAX + 1 - first_slot;
+
+    if (slot_size <= LT_R_MEM_OBJECT_HEADER_SIZE || obj_len > slots_left * slot_size - LT_R_MEM_OBJECT_HEADER_SIZE) {
+        return 0;
     }
 
-    return lt_in__ecc_key_read(h, key, key_max_size, curve, origin);
+    return (uint16_t)((LT_R_MEM_OBJECT_HEADER_SIZE + obj_len + slot_size - 1) / slot_size);
 }
 
-lt_ret_t lt_ecc_key_erase(lt_handle_t *h, const lt_ecc_slot_t ecc_slot)
+/** @brief Returns the offset of the part of the object stored in the slot `i` of the object. */
+static uint32_t lt_r_mem_object_chunk_off(const uint16_t slot_size, const uint16_t i)
 {
-    if (!h || (ecc_slot > TR01_ECC_SLOT_31)) {
-        return LT_PARAM_ERR;
-    }
-    if (h->l3.session_status != LT_SECURE_SESSION_ON) {
-        return LT_HOST_NO_SESSION;
-    }
+    return i ? (uint32_t)i * slot_size - LT_R_MEM_OBJECT_HEADER_SIZE : 0;
+}
 
-    lt_ret_t ret = lt_out__ecc_key_erase(h, ecc_slot);
+/** @brief Returns the length of the part of the object stored in the slot `i` of the object. */
+static uint16_t lt_r_mem_object_chunk_len(const uint16_t slot_size, const uint32_t obj_len, const uint16_t i)
+{
+    const uint16_t cap = i ? slot_size : slot_size - LT_R_MEM_OBJECT_HEADER_SIZE;
+
+    return (uint16_t)lt_min(cap, obj_len - lt_r_mem_object_chunk_off(slot_size, i));
+}
+
+/**
+ * @brief Sends the L3 command prepared in the L3 buffer and receives its response, hashing `hash_data` while the chip
+ * executes the command.
+ *
+ * The L3 buffer is released on failure, the response is left for the `lt_in__*()` function otherwise. A failure of
+ * the hashing is returned in `hash_ret`, so the response is still received and the Secure Session stays in sync.
+ */
+static lt_ret_t lt_r_mem_object_exec(lt_handle_t *h, const uint16_t res_max_len, const uint8_t *hash_data,
+                                     const uint16_t hash_len, lt_ret_t *hash_ret)
+{
+    lt_ret_t ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
-    ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
-    if (ret != LT_OK) {
-        return ret;
+    if (hash_len && *hash_ret == LT_OK) {
+        *hash_ret = lt_sha256_update(h->l3.crypto_ctx, hash_data, hash_len);
     }
 
-    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff, lt_min(h->l3.buff_len, TR01_L3_ECC_KEY_ERASE_RES_PACKET_SIZE));
+    ret = lt_l3_recv_response(&h->l2, &h->l3, lt_min(h->l3.buff_len, res_max_len));
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
-    return lt_in__ecc_key_erase(h);
+    return LT_OK;
 }
 
-lt_ret_t lt_ecc_ecdsa_sign(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, const uint8_t *msg, const uint32_t msg_len,
-                           uint8_t *rs)
+/** @brief Fills `stats` after a successful transfer of `obj_len` bytes in `slot_cnt` slots. */
+static void lt_r_mem_object_stats_fill(lt_r_mem_object_stats_t *stats, const uint64_t start_ns, const uint32_t obj_len,
+                                       const uint16_t slot_cnt, const uint16_t l3_cmds)
 {
-    if (!h || !msg || !rs || (ecc_slot > TR01_ECC_SLOT_31)) {
-        return LT_PARAM_ERR;
-    }
-    if (h->l3.session_status != LT_SECURE_SESSION_ON) {
-        return LT_HOST_NO_SESSION;
+    stats->bytes = obj_len;
+    stats->slots = slot_cnt;
+    stats->l3_cmds = l3_cmds;
+    stats->time_ns = 0;
+    stats->bytes_per_s = 0;
+    if (stats->clock_ns) {
+        stats->time_ns = stats->clock_ns(stats->clock_ctx) - start_ns;
+        if (stats->time_ns) {
+            stats->bytes_per_s = (uint32_t)((uint64_t)obj_len * 1000000000u / stats->time_ns);
+        }
     }
+}
+#endif
 
-    lt_ret_t ret = lt_out__ecc_ecdsa_sign(h, ecc_slot, msg, msg_len);
+#if LT_L3_CMD_R_MEM_DATA_WRITE && LT_L3_CMD_R_MEM_DATA_ERASE
+/** @brief Erases the slot, hashing `hash_data` meanwhile. */
+static lt_ret_t lt_r_mem_object_erase_slot(lt_handle_t *h, const uint16_t udata_slot, const uint8_t *hash_data,
+                                           const uint16_t hash_len, lt_ret_t *hash_ret)
+{
+    lt_ret_t ret = lt_out__r_mem_data_erase(h, udata_slot);
     if (ret != LT_OK) {
         return ret;
     }
-
-    ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
+    ret = lt_r_mem_object_exec(h, TR01_L3_R_MEM_DATA_ERASE_RES_PACKET_SIZE, hash_data, hash_len, hash_ret);
     if (ret != LT_OK) {
         return ret;
     }
 
-    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff, lt_min(h->l3.buff_len, TR01_L3_ECDSA_SIGN_RES_PACKET_SIZE));
+    return lt_in__r_mem_data_erase(h);
+}
+
+/** @brief Writes the erased slot. */
+static lt_ret_t lt_r_mem_object_write_slot(lt_handle_t *h, const uint16_t udata_slot, const uint8_t *data,
+                                           const uint16_t data_size)
+{
+    lt_ret_t hash_ret = LT_OK;
+
+    lt_ret_t ret = lt_out__r_mem_data_write(h, udata_slot, data, data_size);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    ret = lt_r_mem_object_exec(h, TR01_L3_R_MEM_DATA_WRITE_RES_PACKET_SIZE, NULL, 0, &hash_ret);
     if (ret != LT_OK) {
         return ret;
     }
 
-    return lt_in__ecc_ecdsa_sign(h, rs);
+    return lt_in__r_mem_data_write(h);
 }
 
-lt_ret_t lt_ecc_eddsa_sign(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, const uint8_t *msg, const uint16_t msg_len,
-                           uint8_t *rs)
+lt_ret_t lt_r_mem_object_write(lt_handle_t *h, const uint16_t first_slot, const uint8_t *obj, const uint32_t obj_len,
+                               const uint32_t version, lt_r_mem_object_stats_t *stats)
 {
-    if (!h || !msg || !rs || (msg_len > TR01_L3_EDDSA_SIGN_CMD_MSG_LEN_MAX) || (ecc_slot > TR01_ECC_SLOT_31)) {
+    if (!h || (!obj && obj_len) || (first_slot > TR01_R_MEM_DATA_SLOT_MAX)) {
         return LT_PARAM_ERR;
     }
     if (h->l3.session_status != LT_SECURE_SESSION_ON) {
         return LT_HOST_NO_SESSION;
     }
 
-    lt_ret_t ret = lt_out__ecc_eddsa_sign(h, ecc_slot, msg, msg_len);
-    if (ret != LT_OK) {
-        return ret;
+    const uint16_t slot_size = h->tr01_attrs.r_mem_udata_slot_size_max;
+    const uint16_t slot_cnt = lt_r_mem_object_slot_cnt(slot_size, first_slot, obj_len);
+    if (!slot_cnt) {
+        return LT_PARAM_ERR;
     }
 
-    ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
-    if (ret != LT_OK) {
-        return ret;
+    const uint64_t start_ns = (stats && stats->clock_ns) ? stats->clock_ns(stats->clock_ctx) : 0;
+#if LT_R_MEM_CACHE
+    for (uint16_t i = 0; i < slot_cnt; i++) {
+        lt_r_mem_cache_drop(h, first_slot + i);
     }
+#endif
 
-    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff, lt_min(h->l3.buff_len, TR01_L3_EDDSA_SIGN_RES_PACKET_SIZE));
-    if (ret != LT_OK) {
-        return ret;
+    lt_ret_t hash_ret = lt_sha256_init(h->l3.crypto_ctx);
+    if (hash_ret == LT_OK) {
+        hash_ret = lt_sha256_start(h->l3.crypto_ctx);
     }
 
-    return lt_in__ecc_eddsa_sign(h, rs);
-}
+    // The first slot is erased first and written last, so an interrupted write leaves no object instead of a torn
+    // one. Each part of the object is hashed while the erase of its slot executes.
+    lt_ret_t ret
+        = lt_r_mem_object_erase_slot(h, first_slot, obj, lt_r_mem_object_chunk_len(slot_size, obj_len, 0), &hash_ret);
+    for (uint16_t i = 1; i < slot_cnt && ret == LT_OK; i++) {
+        const uint8_t *chunk = obj + lt_r_mem_object_chunk_off(slot_size, i);
+        const uint16_t chunk_len = lt_r_mem_object_chunk_len(slot_size, obj_len, i);
 
-lt_ret_t lt_mcounter_init(lt_handle_t *h, const enum lt_mcounter_index_t mcounter_index, const uint32_t mcounter_value)
-{
-    if (!h || (mcounter_index > TR01_MCOUNTER_INDEX_15) || mcounter_value > TR01_MCOUNTER_VALUE_MAX) {
-        return LT_PARAM_ERR;
-    }
-    if (h->l3.session_status != LT_SECURE_SESSION_ON) {
-        return LT_HOST_NO_SESSION;
+        ret = lt_r_mem_object_erase_slot(h, first_slot + i, chunk, chunk_len, &hash_ret);
+        if (ret == LT_OK) {
+            ret = lt_r_mem_object_write_slot(h, first_slot + i, chunk, chunk_len);
+        }
     }
-
-    lt_ret_t ret = lt_out__mcounter_init(h, mcounter_index, mcounter_value);
     if (ret != LT_OK) {
         return ret;
     }
 
-    ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
-    if (ret != LT_OK) {
-        return ret;
+    uint8_t buff[TR01_R_MEM_DATA_SIZE_MAX];
+    struct lt_r_mem_object_hdr_t *hdr = (struct lt_r_mem_object_hdr_t *)buff;
+    if (hash_ret == LT_OK) {
+        hash_ret = lt_sha256_finish(h->l3.crypto_ctx, hdr->sha256);
+    }
+    if (hash_ret != LT_OK) {
+        return hash_ret;
+    }
+    hdr->magic = LT_R_MEM_OBJECT_MAGIC;
+    hdr->slot_cnt = slot_cnt;
+    hdr->len = obj_len;
+    hdr->version = version;
+    const uint16_t first_len = lt_r_mem_object_chunk_len(slot_size, obj_len, 0);
+    if (first_len) {
+        memcpy(buff + LT_R_MEM_OBJECT_HEADER_SIZE, obj, first_len);
     }
 
-    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff, lt_min(h->l3.buff_len, TR01_L3_MCOUNTER_INIT_RES_PACKET_SIZE));
+    ret = lt_r_mem_object_write_slot(h, first_slot, buff, LT_R_MEM_OBJECT_HEADER_SIZE + first_len);
+    lt_secure_memzero(buff, sizeof(buff));
     if (ret != LT_OK) {
         return ret;
     }
 
+    if (stats) {
+        lt_r_mem_object_stats_fill(stats, start_ns, obj_len, slot_cnt, 2 * slot_cnt);
+    }
+
+    return LT_OK;
+}
+#endif
+
+#if LT_L3_CMD_R_MEM_DATA_READ
+/** @brief Reads the slot, hashing `hash_data` meanwhile. */
+static lt_ret_t lt_r_mem_object_read_slot(lt_handle_t *h, const uint16_t udata_slot, uint8_t *data,
+                                          const uint16_t data_max_size, uint16_t *data_read_size,
+                                          const uint8_t *hash_data, const uint16_t hash_len, lt_ret_t *hash_ret)
+{
+    lt_ret_t ret = lt_out__r_mem_data_read(h, udata_slot);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    ret = lt_r_mem_object_exec(h,
+                               TR01_L3_SIZE_SIZE + TR01_L3_RESULT_SIZE + TR01_L3_R_MEM_DATA_READ_PADDING_SIZE
+                                   + h->tr01_attrs.r_mem_udata_slot_size_max + TR01_L3_TAG_SIZE,
+                               hash_data, hash_len, hash_ret);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    return lt_in__r_mem_data_read(h, data, data_max_size, data_read_size);
+}
+
+lt_ret_t lt_r_mem_object_read(lt_handle_t *h, const uint16_t first_slot, uint8_t *obj, const uint32_t obj_max_size,
+                              uint32_t *obj_len, uint32_t *version, lt_r_mem_object_stats_t *stats)
+{
+    if (!h || (!obj && obj_max_size) || !obj_len || !version || (first_slot > TR01_R_MEM_DATA_SLOT_MAX)) {
+        return LT_PARAM_ERR;
+    }
+    if (h->l3.session_status != LT_SECURE_SESSION_ON) {
+        return LT_HOST_NO_SESSION;
+    }
+
+    const uint16_t slot_size = h->tr01_attrs.r_mem_udata_slot_size_max;
+    const uint64_t start_ns = (stats && stats->clock_ns) ? stats->clock_ns(stats->clock_ctx) : 0;
+    lt_ret_t ret;
+#if LT_R_MEM_CACHE
+    // The object is read from the R-Memory, slots replaced only in the cache have to get there first.
+    if (h->l3.r_mem_cache) {
+        ret = lt_r_mem_cache_flush(h);
+        if (ret != LT_OK) {
+            return ret;
+        }
+    }
+#endif
+
+    uint8_t buff[TR01_R_MEM_DATA_SIZE_MAX];
+    struct lt_r_mem_object_hdr_t *hdr = (struct lt_r_mem_object_hdr_t *)buff;
+    lt_ret_t hash_ret = LT_OK;
+    uint16_t read_size;
+
+    ret = lt_r_mem_object_read_slot(h, first_slot, buff, sizeof(buff), &read_size, NULL, 0, &hash_ret);
+    if (ret != LT_OK) {
+        lt_secure_memzero(buff, sizeof(buff));
+        return ret;
+    }
+    if (read_size < LT_R_MEM_OBJECT_HEADER_SIZE || hdr->magic != LT_R_MEM_OBJECT_MAGIC
+        || hdr->slot_cnt != lt_r_mem_object_slot_cnt(slot_size, first_slot, hdr->len)
+        || read_size != LT_R_MEM_OBJECT_HEADER_SIZE + lt_r_mem_object_chunk_len(slot_size, hdr->len, 0)) {
+        LT_LOG_ERROR("Slot %" PRIu16 " does not hold a header of an object", first_slot);
+        lt_secure_memzero(buff, sizeof(buff));
+        return LT_R_MEM_OBJECT_INVALID;
+    }
+
+    const uint32_t len = hdr->len;
+    const uint16_t slot_cnt = hdr->slot_cnt;
+    uint8_t sha256[LT_SHA256_DIGEST_LENGTH];
+    memcpy(sha256, hdr->sha256, sizeof(sha256));
+    *obj_len = len;
+    *version = hdr->version;
+    if (obj_max_size < len) {
+        lt_secure_memzero(buff, sizeof(buff));
+        return LT_PARAM_ERR;
+    }
+    if (read_size > LT_R_MEM_OBJECT_HEADER_SIZE) {
+        memcpy(obj, buff + LT_R_MEM_OBJECT_HEADER_SIZE, read_size - LT_R_MEM_OBJECT_HEADER_SIZE);
+    }
+    lt_secure_memzero(buff, sizeof(buff));
+
+    hash_ret = lt_sha256_init(h->l3.crypto_ctx);
+    if (hash_ret == LT_OK) {
+        hash_ret = lt_sha256_start(h->l3.crypto_ctx);
+    }
+
+    // Each part of the object is hashed while the next slot is being read.
+    for (uint16_t i = 1; i < slot_cnt; i++) {
+        const uint32_t off = lt_r_mem_object_chunk_off(slot_size, i);
+        const uint16_t chunk_len = lt_r_mem_object_chunk_len(slot_size, len, i);
+        const uint32_t prev_off = lt_r_mem_object_chunk_off(slot_size, i - 1);
+
+        ret = lt_r_mem_object_read_slot(h, first_slot + i, obj + off, (uint16_t)lt_min(slot_size, len - off),
+                                        &read_size, obj + prev_off, (uint16_t)(off - prev_off), &hash_ret);
+        // An empty slot or one not holding exactly its part of the object (more data fails with LT_PARAM_ERR) means
+        // the object was overwritten in part.
+        if (ret == LT_L3_R_MEM_DATA_READ_SLOT_EMPTY || ret == LT_PARAM_ERR
+            || (ret == LT_OK && read_size != chunk_len)) {
+            ret = LT_R_MEM_OBJECT_INVALID;
+        }
+        if (ret != LT_OK) {
+            lt_secure_memzero(obj, len);
+            return ret;
+        }
+    }
+
+    const uint32_t last_off = lt_r_mem_object_chunk_off(slot_size, slot_cnt - 1);
+    if (hash_ret == LT_OK && len > last_off) {
+        hash_ret = lt_sha256_update(h->l3.crypto_ctx, obj + last_off, len - last_off);
+    }
+    uint8_t digest[LT_SHA256_DIGEST_LENGTH];
+    if (hash_ret == LT_OK) {
+        hash_ret = lt_sha256_finish(h->l3.crypto_ctx, digest);
+    }
+    if (hash_ret != LT_OK) {
+        lt_secure_memzero(obj, len);
+        return hash_ret;
+    }
+
+    uint8_t diff = 0;
+    for (size_t i = 0; i < sizeof(digest); i++) {
+        diff |= digest[i] ^ sha256[i];
+    }
+    if (diff) {
+        LT_LOG_ERROR("SHA-256 of the object in slot %" PRIu16 " does not match", first_slot);
+        lt_secure_memzero(obj, len);
+        return LT_R_MEM_OBJECT_INVALID;
+    }
+
+    if (stats) {
+        lt_r_mem_object_stats_fill(stats, start_ns, len, slot_cnt, slot_cnt);
+    }
+
+    return LT_OK;
+}
+#endif
+
+#if LT_L3_CMD_RANDOM_VALUE_GET
+lt_ret_t lt_random_value_get(lt_handle_t *h, uint8_t *rnd_bytes, const uint16_t rnd_bytes_cnt)
+{
+    if (!h || !rnd_bytes || (rnd_bytes_cnt > TR01_RANDOM_VALUE_GET_LEN_MAX)) {
+        return LT_PARAM_ERR;
+    }
+    if (h->l3.session_status != LT_SECURE_SESSION_ON) {
+        return LT_HOST_NO_SESSION;
+    }
+
+    lt_ret_t ret = lt_out__random_value_get(h, rnd_bytes_cnt);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
+    if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
+        return ret;
+    }
+
+    ret = lt_l3_recv_response(&h->l2, &h->l3, lt_min(h->l3.buff_len, TR01_L3_RANDOM_VALUE_GET_RES_PACKET_SIZE_MAX));
+    if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
+        return ret;
+    }
+
+    return lt_in__random_value_get(h, rnd_bytes, rnd_bytes_cnt);
+}
+#endif
+
+#if LT_L3_CMD_ECC_KEY_GENERATE
+lt_ret_t lt_ecc_key_generate(lt_handle_t *h, const lt_ecc_slot_t slot, const lt_ecc_curve_type_t curve)
+{
+    if (!h || (slot > TR01_ECC_SLOT_31) || ((curve != TR01_CURVE_P256) && (curve != TR01_CURVE_ED25519))) {
+        return LT_PARAM_ERR;
+    }
+    if (h->l3.session_status != LT_SECURE_SESSION_ON) {
+        return LT_HOST_NO_SESSION;
+    }
+
+    lt_ret_t ret = lt_out__ecc_key_generate(h, slot, curve);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
+    if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
+        return ret;
+    }
+
+    ret = lt_l3_recv_response(&h->l2, &h->l3, lt_min(h->l3.buff_len, TR01_L3_ECC_KEY_GENERATE_RES_PACKET_SIZE));
+    if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
+        return ret;
+    }
+
+    return lt_in__ecc_key_generate(h);
+}
+#endif
+
+#if LT_L3_CMD_ECC_KEY_STORE
+lt_ret_t lt_ecc_key_store(lt_handle_t *h, const lt_ecc_slot_t slot, const lt_ecc_curve_type_t curve, const uint8_t *key)
+{
+    if (!h || (slot > TR01_ECC_SLOT_31) || ((curve != TR01_CURVE_P256) && (curve != TR01_CURVE_ED25519)) || !key) {
+        return LT_PARAM_ERR;
+    }
+    if (h->l3.session_status != LT_SECURE_SESSION_ON) {
+        return LT_HOST_NO_SESSION;
+    }
+    lt_ret_t ret = lt_out__ecc_key_store(h, slot, curve, key);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
+    if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
+        return ret;
+    }
+
+    ret = lt_l3_recv_response(&h->l2, &h->l3, lt_min(h->l3.buff_len, TR01_L3_ECC_KEY_STORE_RES_PACKET_SIZE));
+    if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
+        return ret;
+    }
+
+    return lt_in__ecc_key_store(h);
+}
+#endif
+
+#if LT_L3_CMD_ECC_KEY_READ
+lt_ret_t lt_ecc_key_read(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, uint8_t *key, const uint8_t key_max_size,
+                         lt_ecc_curve_type_t *curve, lt_ecc_key_origin_t *origin)
+{
+    if (!h || (ecc_slot > TR01_ECC_SLOT_31) || !key || !curve || !origin) {
+        return LT_PARAM_ERR;
+    }
+    if (h->l3.session_status != LT_SECURE_SESSION_ON) {
+        return LT_HOST_NO_SESSION;
+    }
+
+    lt_ret_t ret = lt_out__ecc_key_read(h, ecc_slot);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
+    if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
+        return ret;
+    }
+
+    ret = lt_l3_recv_response(&h->l2, &h->l3, lt_min(h->l3.buff_len, TR01_L3_ECC_KEY_READ_RES_PACKET_SIZE_MAX));
+    if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
+        return ret;
+    }
+
+    return lt_in__ecc_key_read(h, key, key_max_size, curve, origin);
+}
+#endif
+
+#if LT_L3_CMD_ECC_KEY_ERASE
+lt_ret_t lt_ecc_key_erase(lt_handle_t *h, const lt_ecc_slot_t ecc_slot)
+{
+    if (!h || (ecc_slot > TR01_ECC_SLOT_31)) {
+        return LT_PARAM_ERR;
+    }
+    if (h->l3.session_status != LT_SECURE_SESSION_ON) {
+        return LT_HOST_NO_SESSION;
+    }
+
+    lt_ret_t ret = lt_out__ecc_key_erase(h, ecc_slot);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
+    if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
+        return ret;
+    }
+
+    ret = lt_l3_recv_response(&h->l2, &h->l3, lt_min(h->l3.buff_len, TR01_L3_ECC_KEY_ERASE_RES_PACKET_SIZE));
+    if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
+        return ret;
+    }
+
+    return lt_in__ecc_key_erase(h);
+}
+#endif
+
+#if LT_L3_CMD_ECC_ECDSA_SIGN
+lt_ret_t lt_ecc_ecdsa_sign(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, const uint8_t *msg, const uint32_t msg_len,
+                           uint8_t *rs)
+{
+    if (!h || !msg || !rs || (ecc_slot > TR01_ECC_SLOT_31)) {
+        return LT_PARAM_ERR;
+    }
+    if (h->l3.session_status != LT_SECURE_SESSION_ON) {
+        return LT_HOST_NO_SESSION;
+    }
+
+    lt_ret_t ret = lt_out__ecc_ecdsa_sign(h, ecc_slot, msg, msg_len);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
+    if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
+        return ret;
+    }
+
+    ret = lt_l3_recv_response(&h->l2, &h->l3, lt_min(h->l3.buff_len, TR01_L3_ECDSA_SIGN_RES_PACKET_SIZE));
+    if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
+        return ret;
+    }
+
+    return lt_in__ecc_ecdsa_sign(h, rs);
+}
+#endif
+
+#if LT_L3_CMD_ECC_EDDSA_SIGN
+lt_ret_t lt_ecc_eddsa_sign(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, const uint8_t *msg, const uint16_t msg_len,
+                           uint8_t *rs)
+{
+    if (!h || !msg || !rs || (msg_len > TR01_L3_EDDSA_SIGN_CMD_MSG_LEN_MAX) || (ecc_slot > TR01_ECC_SLOT_31)) {
+        return LT_PARAM_ERR;
+    }
+    if (h->l3.session_status != LT_SECURE_SESSION_ON) {
+        return LT_HOST_NO_SESSION;
+    }
+
+    lt_ret_t ret = lt_out__ecc_eddsa_sign(h, ecc_slot, msg, msg_len);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
+    if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
+        return ret;
+    }
+
+    ret = lt_l3_recv_response(&h->l2, &h->l3, lt_min(h->l3.buff_len, TR01_L3_EDDSA_SIGN_RES_PACKET_SIZE));
+    if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
+        return ret;
+    }
+
+    return lt_in__ecc_eddsa_sign(h, rs);
+}
+#endif
+
+#if LT_L3_CMD_MCOUNTER_INIT
+lt_ret_t lt_mcounter_init(lt_handle_t *h, const enum lt_mcounter_index_t mcounter_index, const uint32_t mcounter_value)
+{
+    if (!h || (mcounter_index > TR01_MCOUNTER_INDEX_15) || mcounter_value > TR01_MCOUNTER_VALUE_MAX) {
+        return LT_PARAM_ERR;
+    }
+    if (h->l3.session_status != LT_SECURE_SESSION_ON) {
+        return LT_HOST_NO_SESSION;
+    }
+
+    lt_ret_t ret = lt_out__mcounter_init(h, mcounter_index, mcounter_value);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
+    if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
+        return ret;
+    }
+
+    ret = lt_l3_recv_response(&h->l2, &h->l3, lt_min(h->l3.buff_len, TR01_L3_MCOUNTER_INIT_RES_PACKET_SIZE));
+    if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
+        return ret;
+    }
+
     return lt_in__mcounter_init(h);
 }
+#endif
 
+#if LT_L3_CMD_MCOUNTER_UPDATE
 lt_ret_t lt_mcounter_update(lt_handle_t *h, const enum lt_mcounter_index_t mcounter_index)
 {
     if (!h || (mcounter_index > TR01_MCOUNTER_INDEX_15)) {
@@ -1357,17 +2008,21 @@ lt_ret_t lt_mcounter_update(lt_handle_t *h, const enum lt_mcounter_index_t mcoun
 
     ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
-    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff, lt_min(h->l3.buff_len, TR01_L3_MCOUNTER_UPDATE_RES_PACKET_SIZE));
+    ret = lt_l3_recv_response(&h->l2, &h->l3, lt_min(h->l3.buff_len, TR01_L3_MCOUNTER_UPDATE_RES_PACKET_SIZE));
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
     return lt_in__mcounter_update(h);
 }
+#endif
 
+#if LT_L3_CMD_MCOUNTER_GET
 lt_ret_t lt_mcounter_get(lt_handle_t *h, const enum lt_mcounter_index_t mcounter_index, uint32_t *mcounter_value)
 {
     if (!h || (mcounter_index > TR01_MCOUNTER_INDEX_15) || !mcounter_value) {
@@ -1384,17 +2039,21 @@ lt_ret_t lt_mcounter_get(lt_handle_t *h, const enum lt_mcounter_index_t mcounter
 
     ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
-    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff, lt_min(h->l3.buff_len, TR01_L3_MCOUNTER_GET_RES_PACKET_SIZE));
+    ret = lt_l3_recv_response(&h->l2, &h->l3, lt_min(h->l3.buff_len, TR01_L3_MCOUNTER_GET_RES_PACKET_SIZE));
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
     return lt_in__mcounter_get(h, mcounter_value);
 }
+#endif
 
+#if LT_L3_CMD_MAC_AND_DESTROY
 lt_ret_t lt_mac_and_destroy(lt_handle_t *h, const lt_mac_and_destroy_slot_t slot, const uint8_t *data_out,
                             uint8_t *data_in)
 {
@@ -1412,16 +2071,19 @@ lt_ret_t lt_mac_and_destroy(lt_handle_t *h, const lt_mac_and_destroy_slot_t slot
 
     ret = lt_l2_send_encrypted_cmd(&h->l2, h->l3.buff, h->l3.buff_len);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
-    ret = lt_l2_recv_encrypted_res(&h->l2, h->l3.buff, lt_min(h->l3.buff_len, TR01_L3_MAC_AND_DESTROY_RES_PACKET_SIZE));
+    ret = lt_l3_recv_response(&h->l2, &h->l3, lt_min(h->l3.buff_len, TR01_L3_MAC_AND_DESTROY_RES_PACKET_SIZE));
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
     return lt_in__mac_and_destroy(h, data_in);
 }
+#endif
 
 static const char *lt_ret_strs[] = {"LT_OK",
                                     "LT_FAIL",
@@ -1469,7 +2131,11 @@ static const char *lt_ret_strs[] = {"LT_OK",
                                     "LT_CERT_STORE_INVALID",
                                     "LT_CERT_UNSUPPORTED",
                                     "LT_CERT_ITEM_NOT_FOUND",
-                                    "LT_NONCE_OVERFLOW"};
+                                    "LT_NONCE_OVERFLOW",
+                                    "LT_L3_BUFF_POOL_EMPTY",
+                                    "LT_KV_KEY_NOT_FOUND",
+                                    "LT_KV_FULL",
+                                    "LT_R_MEM_OBJECT_INVALID"};
 
 const char *lt_ret_verbose(lt_ret_t ret)
 {
@@ -1510,6 +2176,7 @@ struct lt_config_obj_desc_t cfg_desc_table[LT_CONFIG_OBJ_CNT]
        {"TR01_CFG_UAP_MCOUNTER_UPDATE        ", TR01_CFG_UAP_MCOUNTER_UPDATE_ADDR},
        {"TR01_CFG_UAP_MAC_AND_DESTROY        ", TR01_CFG_UAP_MAC_AND_DESTROY_ADDR}};
 
+#if LT_L3_CMD_R_CONFIG_READ
 lt_ret_t lt_read_whole_R_config(lt_handle_t *h, struct lt_config_t *config)
 {
     if (!h || !config) {
@@ -1527,7 +2194,9 @@ lt_ret_t lt_read_whole_R_config(lt_handle_t *h, struct lt_config_t *config)
 
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_R_CONFIG_WRITE
 lt_ret_t lt_write_whole_R_config(lt_handle_t *h, const struct lt_config_t *config)
 {
     if (!h || !config) {
@@ -1545,7 +2214,9 @@ lt_ret_t lt_write_whole_R_config(lt_handle_t *h, const struct lt_config_t *confi
 
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_I_CONFIG_READ
 lt_ret_t lt_read_whole_I_config(lt_handle_t *h, struct lt_config_t *config)
 {
     if (!h || !config) {
@@ -1563,7 +2234,9 @@ lt_ret_t lt_read_whole_I_config(lt_handle_t *h, struct lt_config_t *config)
 
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_I_CONFIG_WRITE
 lt_ret_t lt_write_whole_I_config(lt_handle_t *h, const struct lt_config_t *config)
 {
     if (!h || !config) {
@@ -1589,7 +2262,82 @@ lt_ret_t lt_write_whole_I_config(lt_handle_t *h, const struct lt_config_t *confi
 
     return LT_OK;
 }
+#endif
+
+#if LT_L3_CMD_R_CONFIG_WRITE && LT_L3_CMD_R_CONFIG_ERASE
+lt_ret_t lt_apply_R_config(lt_handle_t *h, const struct lt_config_t *config, struct lt_config_t *snapshot)
+{
+    if (!h || !config || !snapshot) {
+        return LT_PARAM_ERR;
+    }
+
+    lt_ret_t ret;
+    bool erase = false;
+
+    // Only an erased object can be written, changing a written one needs the whole R-Config erased.
+    for (uint8_t i = 0; i < LT_CONFIG_OBJ_CNT; i++) {
+        if (config->obj[i] != snapshot->obj[i] && snapshot->obj[i] != LT_CONFIG_OBJ_ERASED) {
+            erase = true;
+        }
+    }
+
+    if (erase) {
+        ret = lt_r_config_erase(h);
+        if (ret != LT_OK) {
+            return ret;
+        }
+        memset(snapshot->obj, 0xff, sizeof(snapshot->obj));
+    }
+
+    for (uint8_t i = 0; i < LT_CONFIG_OBJ_CNT; i++) {
+        if (config->obj[i] != snapshot->obj[i]) {
+            ret = lt_r_config_write(h, cfg_desc_table[i].addr, config->obj[i]);
+            if (ret != LT_OK) {
+                return ret;
+            }
+            snapshot->obj[i] = config->obj[i];
+        }
+    }
+
+    return LT_OK;
+}
+#endif
+
+#if LT_L3_CMD_I_CONFIG_WRITE
+lt_ret_t lt_apply_I_config(lt_handle_t *h, const struct lt_config_t *config, struct lt_config_t *snapshot)
+{
+    if (!h || !config || !snapshot) {
+        return LT_PARAM_ERR;
+    }
+
+    // Cleared bits cannot be set again, refuse before anything is written.
+    for (uint8_t i = 0; i < LT_CONFIG_OBJ_CNT; i++) {
+        if (config->obj[i] & ~snapshot->obj[i]) {
+            LT_LOG_ERROR("Cannot set cleared bits 0x%08" PRIx32 " of %s", config->obj[i] & ~snapshot->obj[i],
+                         cfg_desc_table[i].desc);
+            return LT_PARAM_ERR;
+        }
+    }
+
+    lt_ret_t ret;
+
+    for (uint8_t i = 0; i < LT_CONFIG_OBJ_CNT; i++) {
+        for (uint8_t j = 0; j <= 31; j++) {
+            if (FIELD_GET(BIT(j), snapshot->obj[i] & ~config->obj[i])) {
+                ret = lt_i_config_write(h, cfg_desc_table[i].addr, j);
+                if (ret != LT_OK) {
+                    return ret;
+                }
+                snapshot->obj[i] &= ~BIT(j);
+            }
+        }
+    }
+
+    return LT_OK;
+}
+#endif
 
+#if LT_L2_CMD_GET_INFO_CERT_STORE
 lt_ret_t lt_verify_chip_and_start_secure_session(lt_handle_t *h, const uint8_t *shipriv, const uint8_t *shipub,
                                                  const lt_pkey_index_t pkey_index)
 {
@@ -1599,12 +2347,14 @@ lt_ret_t lt_verify_chip_and_start_secure_session(lt_handle_t *h, const uint8_t *
 
     lt_ret_t ret = LT_FAIL;
 
+#if LT_L2_CMD_GET_INFO_CHIP_ID
     // This is not used here, but let's read it anyway
     struct lt_chip_id_t chip_id = {0};
     ret = lt_get_info_chip_id(h, &chip_id);
     if (ret != LT_OK) {
         return ret;
     }
+#endif
 
     // This is not used in this example, but let's read it anyway
     uint8_t riscv_fw_ver[TR01_L2_GET_INFO_RISCV_FW_SIZE] = {0};
@@ -1613,12 +2363,14 @@ lt_ret_t lt_verify_chip_and_start_secure_session(lt_handle_t *h, const uint8_t *
         return ret;
     }
 
+#if LT_L2_CMD_GET_INFO_SPECT_FW_VER
     // This is not used in this example, but let's read it anyway
     uint8_t spect_fw_ver[TR01_L2_GET_INFO_SPECT_FW_SIZE] = {0};
     ret = lt_get_info_spect_fw_ver(h, spect_fw_ver);
     if (ret != LT_OK) {
         return ret;
     }
+#endif
 
     // Read certificate store
     uint8_t cert_ese[TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE] = {0};
@@ -1651,6 +2403,7 @@ lt_ret_t lt_verify_chip_and_start_secure_session(lt_handle_t *h, const uint8_t *
 
     return LT_OK;
 }
+#endif
 
 lt_ret_t lt_print_bytes(const uint8_t *bytes, const size_t bytes_cnt, char *out_buf, const size_t out_buf_size)
 {
@@ -1662,15 +2415,7 @@ lt_ret_t lt_print_bytes(const uint8_t *bytes, const size_t bytes_cnt, char *out_
         return LT_FAIL;
     }
 
-    for (size_t i = 0; i < bytes_cnt; i++) {
-        size_t remaining = out_buf_size - (i * 2);
-        int written = snprintf(&out_buf[i * 2], remaining, "%02" PRIX8, bytes[i]);
-        // Verify snprintf succeeded and didn't truncate
-        // (should never happen given precondition check, but defensive)
-        if (written < 0 || (size_t)written >= remaining) {
-            return LT_FAIL;
-        }
-    }
+    lt_hex_encode(bytes, bytes_cnt, out_buf);
     out_buf[bytes_cnt * 2] = '\0';
 
     return LT_OK;
@@ -1849,50 +2594,285 @@ lt_ret_t lt_print_chip_id(const struct lt_chip_id_t *chip_id, int (*print_func)(
     return LT_OK;
 }
 
-lt_ret_t lt_do_mutable_fw_update(lt_handle_t *h, const uint8_t *update_data, const uint16_t update_data_size,
-                                 const lt_bank_id_t bank_id)
+/** @brief Reader of an update image in memory, used by `lt_do_mutable_fw_update()`. */
+struct lt_fw_update_mem_reader_t {
+    const uint8_t *data; /**< Update image */
+    uint16_t size;       /**< Size of the update image */
+    uint16_t pos;        /**< Number of bytes already read */
+};
+
+static lt_ret_t lt_fw_update_mem_read(void *ctx, uint8_t *buff, const uint16_t len, uint16_t *read_len)
 {
-#ifdef ABAB
-    if (!h || !update_data || update_data_size > TR01_MUTABLE_FW_UPDATE_SIZE_MAX
-        || ((bank_id != TR01_FW_BANK_FW1) && (bank_id != TR01_FW_BANK_FW2) && (bank_id != TR01_FW_BANK_SPECT1)
-            && (bank_id != TR01_FW_BANK_SPECT2))) {
-        return LT_PARAM_ERR;
+    struct lt_fw_update_mem_reader_t *mem = (struct lt_fw_update_mem_reader_t *)ctx;
+
+    uint16_t n = mem->size - mem->pos;
+    if (n > len) {
+        n = len;
     }
-    lt_ret_t ret = lt_mutable_fw_erase(h, bank_id);
+    memcpy(buff, mem->data + mem->pos, n);
+    mem->pos += n;
+    *read_len = n;
+
+    return LT_OK;
+}
+
+/** @brief Firmware update in progress. */
+struct lt_fw_update_job_t {
+    lt_fw_update_reader_t reader;           /**< Reader of the update image */
+    void *reader_ctx;                       /**< Context passed to `reader` */
+    lt_fw_update_progress_t *progress;      /**< Checkpoint of the update */
+    lt_fw_update_progress_cb_t progress_cb; /**< Optional progress callback */
+    void *progress_ctx;                     /**< Context passed to `progress_cb` */
+    bool resumed;                           /**< The next chunk continues an update interrupted by a previous call */
+};
+
+/** @brief Reads exactly `len` bytes of the update image, the image is malformed if it ends sooner. */
+static lt_ret_t lt_fw_update_read_exact(struct lt_fw_update_job_t *job, uint8_t *buff, const uint16_t len)
+{
+    uint16_t read_len = 0;
+    lt_ret_t ret = job->reader(job->reader_ctx, buff, len, &read_len);
     if (ret != LT_OK) {
         return ret;
     }
+    if (read_len != len) {
+        return LT_PARAM_ERR;
+    }
+
+    return LT_OK;
+}
+
+/** @brief Reads the already acknowledged part of the update image, using the L2 buffer as a scratch buffer. */
+static lt_ret_t lt_fw_update_skip_acked(lt_handle_t *h, struct lt_fw_update_job_t *job)
+{
+    uint32_t remaining = job->progress->bytes_acked;
+
+    while (remaining) {
+        const uint16_t len = remaining > sizeof(h->l2.buff) ? sizeof(h->l2.buff) : (uint16_t)remaining;
+        lt_ret_t ret = lt_fw_update_read_exact(job, h->l2.buff, len);
+        if (ret != LT_OK) {
+            return ret;
+        }
+        remaining -= len;
+    }
+
+    return LT_OK;
+}
+
+static void lt_fw_update_notify(const struct lt_fw_update_job_t *job)
+{
+    if (job->progress_cb) {
+        job->progress_cb(job->progress_ctx, job->progress);
+    }
+}
+
+/** @brief Sends the update chunk prepared in the L2 buffer and checkpoints it once TROPIC01 acknowledges it. */
+static lt_ret_t lt_fw_update_send_chunk(lt_handle_t *h, struct lt_fw_update_job_t *job, const uint16_t chunk_size)
+{
+    // Setup a request pointer to l2 buffer with response data
+    struct lt_l2_mutable_fw_update_rsp_t *p_l2_resp = (struct lt_l2_mutable_fw_update_rsp_t *)h->l2.buff;
+
+    lt_ret_t ret = lt_l2_send(&h->l2);
+    if (ret == LT_OK) {
+        ret = lt_l2_receive(&h->l2);
+    }
+    if (ret == LT_OK && TR01_L2_MUTABLE_FW_UPDATE_RSP_LEN != (p_l2_resp->rsp_len)) {
+        ret = LT_L2_RSP_LEN_ERROR;
+    }
 
-    ret = lt_mutable_fw_update(h, update_data, update_data_size, bank_id);
     if (ret != LT_OK) {
+        // TROPIC01 does not continue the interrupted update, the next attempt starts over.
+        if (job->resumed && ret == LT_L2_GEN_ERR) {
+            memset(job->progress, 0, sizeof(*job->progress));
+            lt_fw_update_notify(job);
+        }
         return ret;
     }
 
+    job->resumed = false;
+    job->progress->chunks_acked++;
+    job->progress->bytes_acked += chunk_size;
+    lt_fw_update_notify(job);
+
+    return LT_OK;
+}
+
+#ifdef ABAB
+/** @brief Number of firmware bytes written by one Mutable_FW_Update request. */
+#define LT_FW_UPDATE_ABAB_CHUNK_SIZE 128
+
+/** @brief Writes the raw firmware from the reader to the (already erased) bank, from the checkpoint on. */
+static lt_ret_t lt_mutable_fw_update_stream(lt_handle_t *h, struct lt_fw_update_job_t *job, const lt_bank_id_t bank_id)
+{
+    // Setup a request pointer to l2 buffer, which is placed in handle
+    struct lt_l2_mutable_fw_update_req_t *p_l2_req = (struct lt_l2_mutable_fw_update_req_t *)h->l2.buff;
+
+    uint16_t read_len = LT_FW_UPDATE_ABAB_CHUNK_SIZE;
+
+    // The image ends with the first piece shorter than the chunk size.
+    while (read_len == LT_FW_UPDATE_ABAB_CHUNK_SIZE) {
+        // The data are read straight into the request, the header is filled after that.
+        lt_ret_t ret = job->reader(job->reader_ctx, p_l2_req->data, LT_FW_UPDATE_ABAB_CHUNK_SIZE, &read_len);
+        if (ret != LT_OK) {
+            return ret;
+        }
+        if (read_len > LT_FW_UPDATE_ABAB_CHUNK_SIZE
+            || job->progress->bytes_acked + read_len > TR01_MUTABLE_FW_UPDATE_SIZE_MAX) {
+            return LT_PARAM_ERR;
+        }
+        if (read_len == 0) {
+            break;
+        }
+
+        p_l2_req->req_id = TR01_L2_MUTABLE_FW_UPDATE_REQ_ID;
+        p_l2_req->req_len = TR01_L2_MUTABLE_FW_UPDATE_REQ_LEN_MIN + read_len;
+        p_l2_req->bank_id = bank_id;
+        p_l2_req->offset = (uint16_t)job->progress->bytes_acked;
+
+        ret = lt_fw_update_send_chunk(h, job, read_len);
+        if (ret != LT_OK) {
+            return ret;
+        }
+    }
+
+    return LT_OK;
+}
 #elif ACAB
-    LT_UNUSED(bank_id);  // bank_id is not used with ACAB, chip handles banks on its own
-    if (!h || !update_data || update_data_size > TR01_MUTABLE_FW_UPDATE_SIZE_MAX) {
+/** @brief Sends the update request and the update data chunks from the reader, from the checkpoint on. */
+static lt_ret_t lt_mutable_fw_update_stream(lt_handle_t *h, struct lt_fw_update_job_t *job)
+{
+    // Setup a request pointer to l2 buffer, which is placed in handle
+    struct lt_l2_mutable_fw_update_req_t *p_l2_req = (struct lt_l2_mutable_fw_update_req_t *)h->l2.buff;
+    // Setup a request pointer to l2 buffer with data request
+    struct lt_l2_mutable_fw_update_data_req_t *p2_l2_req = (struct lt_l2_mutable_fw_update_data_req_t *)h->l2.buff;
+
+    // Every chunk of the image (the update request first) is its L2 Request without the request ID and CRC, so it is
+    // read straight into the L2 buffer: the length byte first, then the rest.
+    lt_ret_t ret;
+    if (job->progress->chunks_acked == 0) {
+        ret = lt_fw_update_read_exact(job, &p_l2_req->req_len, 1);
+        if (ret != LT_OK) {
+            return ret;
+        }
+        if (p_l2_req->req_len != TR01_L2_MUTABLE_FW_UPDATE_REQ_LEN) {
+            return LT_PARAM_ERR;
+        }
+        ret = lt_fw_update_read_exact(job, p_l2_req->signature, TR01_L2_MUTABLE_FW_UPDATE_REQ_LEN);
+        if (ret != LT_OK) {
+            return ret;
+        }
+
+        p_l2_req->req_id = TR01_L2_MUTABLE_FW_UPDATE_REQ_ID;
+        ret = lt_fw_update_send_chunk(h, job, 1U + TR01_L2_MUTABLE_FW_UPDATE_REQ_LEN);
+        if (ret != LT_OK) {
+            return ret;
+        }
+    }
+
+    while (true) {
+        // Next update data chunk, the image ends where a length byte would be.
+        uint16_t read_len = 0;
+        ret = job->reader(job->reader_ctx, &p2_l2_req->req_len, 1, &read_len);
+        if (ret != LT_OK) {
+            return ret;
+        }
+        if (read_len == 0) {
+            break;
+        }
+
+        const uint16_t chunk_len = p2_l2_req->req_len;
+        if (read_len != 1 || job->progress->bytes_acked + 1U + chunk_len > TR01_MUTABLE_FW_UPDATE_SIZE_MAX) {
+            return LT_PARAM_ERR;
+        }
+        ret = lt_fw_update_read_exact(job, &p2_l2_req->req_len + 1, chunk_len);
+        if (ret != LT_OK) {
+            return ret;
+        }
+
+        p2_l2_req->req_id = TR01_L2_MUTABLE_FW_UPDATE_DATA_REQ;
+        ret = lt_fw_update_send_chunk(h, job, 1U + chunk_len);
+        if (ret != LT_OK) {
+            return ret;
+        }
+    }
+
+    // Image with the update request only.
+    if (job->progress->chunks_acked < 2) {
         return LT_PARAM_ERR;
     }
 
-    // send the update 'request'
-    lt_ret_t ret = lt_mutable_fw_update(h, update_data);
-    if (ret != LT_OK) {
-        return ret;
+    return LT_OK;
+}
+#else
+#error "Undefined silicon revision. Please define either ABAB or ACAB."
+#endif
+
+lt_ret_t lt_do_mutable_fw_update(lt_handle_t *h, const uint8_t *update_data, const uint16_t update_data_size,
+                                 const lt_bank_id_t bank_id)
+{
+    if (!update_data || update_data_size > TR01_MUTABLE_FW_UPDATE_SIZE_MAX) {
+        return LT_PARAM_ERR;
     }
 
-    // send the rest - update 'data'
-    ret = lt_mutable_fw_update_data(h, update_data, update_data_size);
+    struct lt_fw_update_mem_reader_t mem = {.data = update_data, .size = update_data_size, .pos = 0};
+
+    return lt_do_mutable_fw_update_stream(h, lt_fw_update_mem_read, &mem, bank_id);
+}
+
+lt_ret_t lt_do_mutable_fw_update_stream(lt_handle_t *h, lt_fw_update_reader_t reader, void *reader_ctx,
+                                        const lt_bank_id_t bank_id)
+{
+    lt_fw_update_progress_t progress = {0};
+
+    return lt_do_mutable_fw_update_resumable(h, reader, reader_ctx, bank_id, &progress, NULL, NULL);
+}
+
+lt_ret_t lt_do_mutable_fw_update_resumable(lt_handle_t *h, lt_fw_update_reader_t reader, void *reader_ctx,
+                                           const lt_bank_id_t bank_id, lt_fw_update_progress_t *progress,
+                                           lt_fw_update_progress_cb_t progress_cb, void *progress_ctx)
+{
+#ifdef ABAB
+    if (!h || !reader || !progress
+        || ((bank_id != TR01_FW_BANK_FW1) && (bank_id != TR01_FW_BANK_FW2) && (bank_id != TR01_FW_BANK_SPECT1)
+            && (bank_id != TR01_FW_BANK_SPECT2))) {
+        return LT_PARAM_ERR;
+    }
+#elif ACAB
+    LT_UNUSED(bank_id);  // bank_id is not used with ACAB, chip handles banks on its own
+    if (!h || !reader || !progress) {
+        return LT_PARAM_ERR;
+    }
+#else
+#error "Undefined silicon revision. Please define either ABAB or ACAB."
+#endif
+
+    struct lt_fw_update_job_t job = {.reader = reader,
+                                     .reader_ctx = reader_ctx,
+                                     .progress = progress,
+                                     .progress_cb = progress_cb,
+                                     .progress_ctx = progress_ctx,
+                                     .resumed = progress->chunks_acked != 0};
+
+    lt_ret_t ret = LT_OK;
+    if (job.resumed) {
+        ret = lt_fw_update_skip_acked(h, &job);
+    }
+#ifdef ABAB
+    else {
+        ret = lt_mutable_fw_erase(h, bank_id);
+    }
+#endif
     if (ret != LT_OK) {
         return ret;
     }
 
+#ifdef ABAB
+    return lt_mutable_fw_update_stream(h, &job, bank_id);
 #else
-#error "Undefined silicon revision. Please define either ABAB or ACAB."
+    return lt_mutable_fw_update_stream(h, &job);
 #endif
-
-    return LT_OK;
 }
 
+#if LT_L2_CMD_GET_INFO_FW_BANK
 lt_ret_t lt_print_fw_header(lt_handle_t *h, const lt_bank_id_t bank_id, int (*print_func)(const char *format, ...))
 {
     if (!h || !print_func) {
@@ -1970,3 +2950,4 @@ lt_ret_t lt_print_fw_header(lt_handle_t *h, const lt_bank_id_t bank_id, int (*pr
     return LT_OK;
 }
 #endif
+#endif
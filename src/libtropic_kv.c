@@ -0,0 +1,669 @@
+/**
+ * @file libtropic_kv.c
+ * @brief Key/value store layered on a range of the User R-Memory slots.
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include "libtropic_kv.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_logging.h"
+#include "libtropic_macros.h"
+#include "lt_crc16.h"
+#include "lt_secure_memzero.h"
+
+#if LT_L3_CMD_R_MEM_DATA_READ && LT_L3_CMD_R_MEM_DATA_WRITE && LT_L3_CMD_R_MEM_DATA_ERASE
+
+/** @brief Value of `lt_kv_head_t.magic`. */
+#define LT_KV_MAGIC 0x564b
+/** @brief Value of `lt_kv_cont_t.magic`. */
+#define LT_KV_CONT_MAGIC 0x434b
+
+/**
+ * @brief Header of the head slot of a record.
+ *
+ * Followed by `slot_cnt - 1` continuation slot numbers, the key and the beginning of the value.
+ */
+struct lt_kv_head_t {
+    uint16_t magic;
+    /** CRC16 of the slot content following this field. */
+    uint16_t crc;
+    uint32_t seq;
+    uint32_t key_hash;
+    uint16_t val_len;
+    uint8_t key_len;
+    uint8_t slot_cnt;
+} __attribute__((packed));
+
+/**
+ * @brief Header of a continuation slot of a record, followed by the next part of the value.
+ *
+ * No value byte is ever at the beginning of a slot, so a value holding an image of a head cannot pass for one.
+ */
+struct lt_kv_cont_t {
+    uint16_t magic;
+    /** Sequence number of the record owning the slot. */
+    uint32_t seq;
+    /** Hash of the key of the record owning the slot. */
+    uint32_t key_hash;
+} __attribute__((packed));
+
+static bool bit_get(const uint8_t *map, const uint16_t i) { return map[i / 8] & (1u << (i % 8)); }
+
+static void bit_set(uint8_t *map, const uint16_t i) { map[i / 8] |= (uint8_t)(1u << (i % 8)); }
+
+static void bit_clr(uint8_t *map, const uint16_t i) { map[i / 8] &= (uint8_t)~(1u << (i % 8)); }
+
+/** @brief FNV-1a hash of the key. */
+static uint32_t key_hash(const uint8_t *key, const size_t key_len)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < key_len; i++) {
+        hash = (hash ^ key[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+/** @brief Number of value bytes fitting into the head slot of a record spanning `slot_cnt` slots. */
+static uint16_t head_cap(const lt_kv_t *kv, const uint8_t slot_cnt, const uint8_t key_len)
+{
+    return kv->slot_size - sizeof(struct lt_kv_head_t) - (slot_cnt - 1) * sizeof(uint16_t) - key_len;
+}
+
+/** @brief Number of value bytes fitting into a continuation slot. */
+static uint16_t cont_cap(const lt_kv_t *kv) { return kv->slot_size - sizeof(struct lt_kv_cont_t); }
+
+/** @brief Number of slots needed for a value, 0 if it does not fit into `LT_KV_SLOTS_PER_VALUE_MAX` slots. */
+static uint8_t slots_needed(const lt_kv_t *kv, const uint16_t val_len, const uint8_t key_len)
+{
+    for (uint8_t n = 1; n <= LT_KV_SLOTS_PER_VALUE_MAX; n++) {
+        if ((uint32_t)head_cap(kv, n, key_len) + (uint32_t)(n - 1) * cont_cap(kv) >= val_len) {
+            return n;
+        }
+    }
+
+    return 0;
+}
+
+static lt_kv_entry_t *find_entry(lt_kv_t *kv, const uint32_t hash)
+{
+    for (uint8_t i = 0; i < kv->entry_cnt; i++) {
+        if (kv->entries[i].key_hash == hash) {
+            return &kv->entries[i];
+        }
+    }
+
+    return NULL;
+}
+
+static void remove_entry(lt_kv_t *kv, lt_kv_entry_t *entry)
+{
+    *entry = kv->entries[--kv->entry_cnt];
+}
+
+/** @brief Marks the slots of a record dirty, they are erased by `lt_kv_gc()`. */
+static void mark_dirty(lt_kv_t *kv, const lt_kv_entry_t *entry)
+{
+    for (uint8_t i = 0; i < entry->slot_cnt; i++) {
+        bit_clr(kv->live, entry->slots[i] - kv->first_slot);
+    }
+    bit_set(kv->dirty_head, entry->slots[0] - kv->first_slot);
+}
+
+/**
+ * @brief Checks the head slot content, returns its header or NULL if the content is not a valid head.
+ *
+ * @param kv    Store
+ * @param buff  Content of the slot
+ * @param len   Length of the content
+ */
+static const struct lt_kv_head_t *parse_head(const lt_kv_t *kv, const uint8_t *buff, const uint16_t len)
+{
+    const struct lt_kv_head_t *head = (const struct lt_kv_head_t *)buff;
+
+    if (len < sizeof(struct lt_kv_head_t) || head->magic != LT_KV_MAGIC || head->slot_cnt < 1
+        || head->slot_cnt > LT_KV_SLOTS_PER_VALUE_MAX || head->key_len < 1 || head->key_len > LT_KV_KEY_LEN_MAX) {
+        return NULL;
+    }
+    if (crc16(buff + 4, (int16_t)(len - 4)) != head->crc) {
+        return NULL;
+    }
+
+    const uint8_t *key = buff + sizeof(struct lt_kv_head_t) + (head->slot_cnt - 1) * sizeof(uint16_t);
+    if (key + head->key_len > buff + len || key_hash(key, head->key_len) != head->key_hash) {
+        return NULL;
+    }
+    // The record has to use the least number of slots, the value its whole length.
+    if (slots_needed(kv, head->val_len, head->key_len) != head->slot_cnt
+        || (uint16_t)(buff + len - key - head->key_len)
+               != lt_min(head->val_len, head_cap(kv, head->slot_cnt, head->key_len))) {
+        return NULL;
+    }
+
+    return head;
+}
+
+/**
+ * @brief Reads the head slot of an indexed record and checks that it holds the given key.
+ *
+ * @param h        Handle for communication with TROPIC01
+ * @param kv       Store
+ * @param entry    Index entry of the record
+ * @param key      Key
+ * @param key_len  Length of the key
+ * @param buff     Buffer of `TR01_R_MEM_DATA_SIZE_MAX` bytes for the slot content
+ * @param data     Set to the beginning of the value in `buff`
+ *
+ * @retval         LT_OK The head holds the key
+ * @retval         LT_KV_KEY_NOT_FOUND The head holds another key with the same hash
+ * @retval         other The head could not be read or is not valid
+ */
+static lt_ret_t read_head(lt_handle_t *h, const lt_kv_t *kv, const lt_kv_entry_t *entry, const char *key,
+                          const uint8_t key_len, uint8_t *buff, const uint8_t **data)
+{
+    uint16_t len;
+    lt_ret_t ret = lt_r_mem_data_read(h, entry->slots[0], buff, TR01_R_MEM_DATA_SIZE_MAX, &len);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    const struct lt_kv_head_t *head = parse_head(kv, buff, len);
+    if (!head || head->seq != entry->seq || head->key_hash != entry->key_hash) {
+        LT_LOG_ERROR("R-Mem slot %u does not hold the expected KV record", entry->slots[0]);
+        return LT_FAIL;
+    }
+
+    const uint8_t *p_key = buff + sizeof(struct lt_kv_head_t) + (head->slot_cnt - 1) * sizeof(uint16_t);
+    if (head->key_len != key_len || memcmp(p_key, key, key_len)) {
+        return LT_KV_KEY_NOT_FOUND;
+    }
+    *data = p_key + key_len;
+
+    return LT_OK;
+}
+
+/**
+ * @brief Checks that an indexed record holds the key of the head in `buff`.
+ *
+ * @param h      Handle for communication with TROPIC01
+ * @param kv     Store
+ * @param entry  Index entry of the record
+ * @param buff   Content of a valid head slot, overwritten with the head of the record
+ *
+ * @retval       LT_OK Both hold the same key
+ * @retval       LT_KV_KEY_NOT_FOUND The keys differ, only their hashes are the same
+ * @retval       other The head of the record could not be read or is not valid
+ */
+static lt_ret_t check_same_key(lt_handle_t *h, const lt_kv_t *kv, const lt_kv_entry_t *entry, uint8_t *buff)
+{
+    const struct lt_kv_head_t *head = (const struct lt_kv_head_t *)buff;
+    const uint8_t key_len = head->key_len;
+    uint8_t key[LT_KV_KEY_LEN_MAX];
+    const uint8_t *data;
+
+    memcpy(key, buff + sizeof(struct lt_kv_head_t) + (head->slot_cnt - 1) * sizeof(uint16_t), key_len);
+    lt_ret_t ret = read_head(h, kv, entry, (const char *)key, key_len, buff, &data);
+    lt_secure_memzero(key, sizeof(key));
+
+    return ret;
+}
+
+static lt_ret_t erase_slot(lt_handle_t *h, lt_kv_t *kv, const uint16_t rel)
+{
+    lt_ret_t ret = lt_r_mem_data_erase(h, kv->first_slot + rel);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    bit_set(kv->erased, rel);
+    bit_clr(kv->dirty_head, rel);
+
+    return LT_OK;
+}
+
+/**
+ * @brief Erases dirty slots until `*cnt` reaches `max_cnt` (unless it is 0).
+ *
+ * @param h           Handle for communication with TROPIC01
+ * @param kv          Store
+ * @param heads_only  Erase only the dirty heads
+ * @param max_cnt     Maximal number of erased slots
+ * @param cnt         Number of erased slots, incremented
+ */
+static lt_ret_t gc_pass(lt_handle_t *h, lt_kv_t *kv, const bool heads_only, const uint16_t max_cnt, uint16_t *cnt)
+{
+    for (uint16_t rel = 0; rel < kv->slot_cnt && (!max_cnt || *cnt < max_cnt); rel++) {
+        if (bit_get(kv->erased, rel) || bit_get(kv->live, rel) || (heads_only && !bit_get(kv->dirty_head, rel))) {
+            continue;
+        }
+        lt_ret_t ret = erase_slot(h, kv, rel);
+        if (ret != LT_OK) {
+            return ret;
+        }
+        (*cnt)++;
+    }
+
+    return LT_OK;
+}
+
+/**
+ * @brief Picks erased slots for a new record, starting at the cursor so the writes rotate over the range.
+ *
+ * Erases dirty slots only when too few slots are erased.
+ */
+static lt_ret_t alloc_slots(lt_handle_t *h, lt_kv_t *kv, const uint8_t cnt, uint16_t *slots)
+{
+    uint16_t erased_cnt = 0, dirty_cnt = 0;
+    for (uint16_t i = 0; i < kv->slot_cnt; i++) {
+        if (bit_get(kv->erased, i)) {
+            erased_cnt++;
+        }
+        else if (!bit_get(kv->live, i)) {
+            dirty_cnt++;
+        }
+    }
+
+    if (erased_cnt + dirty_cnt < cnt) {
+        return LT_KV_FULL;
+    }
+    if (erased_cnt < cnt) {
+        lt_ret_t ret = lt_kv_gc(h, kv, cnt - erased_cnt);
+        if (ret != LT_OK) {
+            return ret;
+        }
+    }
+
+    uint8_t found = 0;
+    const uint16_t start = kv->cursor;
+    for (uint16_t i = 0; found < cnt; i++) {
+        uint16_t rel = (start + i) % kv->slot_cnt;
+        if (bit_get(kv->erased, rel)) {
+            slots[found++] = kv->first_slot + rel;
+            kv->cursor = (rel + 1) % kv->slot_cnt;
+        }
+    }
+
+    return LT_OK;
+}
+
+/** @brief Writes one slot of a new record, the slot is not erased anymore even if the write fails. */
+static lt_ret_t write_slot(lt_handle_t *h, lt_kv_t *kv, const uint16_t slot, const uint8_t *data, const uint16_t len)
+{
+    bit_clr(kv->erased, slot - kv->first_slot);
+
+    return lt_r_mem_data_write(h, slot, data, len);
+}
+
+/** @brief Checks the key and returns its length, 0 if it is not valid. */
+static uint8_t check_key(const char *key)
+{
+    uint8_t key_len = 0;
+    while (key[key_len]) {
+        if (++key_len > LT_KV_KEY_LEN_MAX) {
+            return 0;
+        }
+    }
+
+    return key_len;
+}
+
+lt_ret_t lt_kv_mount(lt_handle_t *h, lt_kv_t *kv, const uint16_t first_slot, const uint16_t slot_cnt)
+{
+    if (!h || !kv || slot_cnt < LT_KV_SLOTS_PER_VALUE_MAX + 1 || first_slot > TR01_R_MEM_DATA_SLOT_MAX
+        || slot_cnt > TR01_R_MEM_DATA_SLOT_MAX + 1 - first_slot || !h->tr01_attrs.r_mem_udata_slot_size_max) {
+        return LT_PARAM_ERR;
+    }
+
+    memset(kv, 0, sizeof(lt_kv_t));
+    kv->first_slot = first_slot;
+    kv->slot_cnt = slot_cnt;
+    kv->slot_size = h->tr01_attrs.r_mem_udata_slot_size_max;
+
+    // Bit per slot holding a continuation header, only these can be claimed by a head.
+    uint8_t cont[(TR01_R_MEM_DATA_SLOT_MAX + 8) / 8] = {0};
+    uint8_t buff[TR01_R_MEM_DATA_SIZE_MAX];
+    for (uint16_t rel = 0; rel < slot_cnt; rel++) {
+        uint16_t len;
+        lt_ret_t ret = lt_r_mem_data_read(h, first_slot + rel, buff, sizeof(buff), &len);
+        if (ret == LT_L3_R_MEM_DATA_READ_SLOT_EMPTY) {
+            bit_set(kv->erased, rel);
+            continue;
+        }
+        if (ret != LT_OK) {
+            return ret;
+        }
+
+        // Anything else than a head is dirty unless a head claims it below.
+        const struct lt_kv_head_t *p_head = parse_head(kv, buff, len);
+        if (!p_head) {
+            if (len > sizeof(struct lt_kv_cont_t) && ((const struct lt_kv_cont_t *)buff)->magic == LT_KV_CONT_MAGIC) {
+                bit_set(cont, rel);
+            }
+            continue;
+        }
+        // Kept aside, buff is reused when the key has another head.
+        const struct lt_kv_head_t head = *p_head;
+        if (head.seq > kv->seq) {
+            kv->seq = head.seq;
+        }
+
+        lt_kv_entry_t *entry = find_entry(kv, head.key_hash);
+        if (entry) {
+            uint16_t cont_slots[LT_KV_SLOTS_PER_VALUE_MAX - 1];
+            memcpy(cont_slots, buff + sizeof(struct lt_kv_head_t), (head.slot_cnt - 1) * sizeof(uint16_t));
+
+            // lt_kv_set() never writes two keys with the same hash, finding them means the store is corrupted.
+            ret = check_same_key(h, kv, entry, buff);
+            if (ret == LT_KV_KEY_NOT_FOUND) {
+                LT_LOG_ERROR("KV records in R-Mem slots %u and %u hold different keys with the same hash",
+                             entry->slots[0], first_slot + rel);
+                return LT_FAIL;
+            }
+            if (ret != LT_OK) {
+                return ret;
+            }
+            if (entry->seq > head.seq) {
+                bit_set(kv->dirty_head, rel);
+                continue;
+            }
+            bit_set(kv->dirty_head, entry->slots[0] - first_slot);
+            memcpy(&entry->slots[1], cont_slots, (head.slot_cnt - 1) * sizeof(uint16_t));
+        }
+        else {
+            if (kv->entry_cnt == LT_KV_ENTRIES_MAX) {
+                LT_LOG_ERROR("More than %d keys in the KV store", LT_KV_ENTRIES_MAX);
+                return LT_KV_FULL;
+            }
+            entry = &kv->entries[kv->entry_cnt++];
+            memcpy(&entry->slots[1], buff + sizeof(struct lt_kv_head_t), (head.slot_cnt - 1) * sizeof(uint16_t));
+        }
+
+        entry->key_hash = head.key_hash;
+        entry->seq = head.seq;
+        entry->val_len = head.val_len;
+        entry->slot_cnt = head.slot_cnt;
+        entry->slots[0] = first_slot + rel;
+    }
+    lt_secure_memzero(buff, sizeof(buff));
+
+    // Newest records first, so of two records claiming the same continuation slot the older one is dropped.
+    for (uint8_t i = 1; i < kv->entry_cnt; i++) {
+        lt_kv_entry_t entry = kv->entries[i];
+        uint8_t j = i;
+        for (; j > 0 && kv->entries[j - 1].seq < entry.seq; j--) {
+            kv->entries[j] = kv->entries[j - 1];
+        }
+        kv->entries[j] = entry;
+    }
+
+    // Heads first, a slot claimed by a record must hold a continuation header and must not be a part of a newer record.
+    for (uint8_t i = 0; i < kv->entry_cnt; i++) {
+        bit_set(kv->live, kv->entries[i].slots[0] - first_slot);
+    }
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < kv->entry_cnt; i++) {
+        const lt_kv_entry_t *entry = &kv->entries[i];
+        bool valid = true;
+        for (uint8_t j = 1; j < entry->slot_cnt; j++) {
+            uint16_t rel = entry->slots[j] - first_slot;
+            if (entry->slots[j] < first_slot || rel >= slot_cnt || !bit_get(cont, rel) || bit_get(kv->live, rel)) {
+                valid = false;
+                break;
+            }
+        }
+        if (!valid) {
+            LT_LOG_WARN("KV record in R-Mem slot %u is broken, dropping it", entry->slots[0]);
+            bit_clr(kv->live, entry->slots[0] - first_slot);
+            bit_set(kv->dirty_head, entry->slots[0] - first_slot);
+            continue;
+        }
+        for (uint8_t j = 1; j < entry->slot_cnt; j++) {
+            bit_set(kv->live, entry->slots[j] - first_slot);
+        }
+        kv->entries[kept++] = *entry;
+    }
+    kv->entry_cnt = kept;
+
+    // Continue allocating after the newest record.
+    const lt_kv_entry_t *newest = NULL;
+    for (uint8_t i = 0; i < kv->entry_cnt; i++) {
+        if (!newest || kv->entries[i].seq > newest->seq) {
+            newest = &kv->entries[i];
+        }
+    }
+    if (newest) {
+        kv->cursor = (newest->slots[newest->slot_cnt - 1] - first_slot + 1) % slot_cnt;
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_kv_get(lt_handle_t *h, lt_kv_t *kv, const char *key, uint8_t *val, const uint16_t val_max_size,
+                   uint16_t *val_len)
+{
+    if (!h || !kv || !key || !val || !val_len) {
+        return LT_PARAM_ERR;
+    }
+    uint8_t key_len = check_key(key);
+    if (!key_len) {
+        return LT_PARAM_ERR;
+    }
+
+    const lt_kv_entry_t *entry = find_entry(kv, key_hash((const uint8_t *)key, key_len));
+    if (!entry) {
+        return LT_KV_KEY_NOT_FOUND;
+    }
+    if (val_max_size < entry->val_len) {
+        *val_len = entry->val_len;
+        return LT_PARAM_ERR;
+    }
+
+    uint8_t buff[TR01_R_MEM_DATA_SIZE_MAX];
+    const uint8_t *data;
+    uint16_t off = lt_min(entry->val_len, head_cap(kv, entry->slot_cnt, key_len));
+    lt_ret_t ret = read_head(h, kv, entry, key, key_len, buff, &data);
+    if (ret == LT_OK) {
+        memcpy(val, data, off);
+    }
+
+    for (uint8_t i = 1; i < entry->slot_cnt && ret == LT_OK; i++) {
+        uint16_t len;
+        ret = lt_r_mem_data_read(h, entry->slots[i], buff, sizeof(buff), &len);
+        if (ret != LT_OK) {
+            break;
+        }
+        const struct lt_kv_cont_t *cont = (const struct lt_kv_cont_t *)buff;
+        uint16_t part_len = lt_min(cont_cap(kv), entry->val_len - off);
+        if (len != sizeof(struct lt_kv_cont_t) + part_len || cont->magic != LT_KV_CONT_MAGIC
+            || cont->seq != entry->seq || cont->key_hash != entry->key_hash) {
+            LT_LOG_ERROR("R-Mem slot %u does not hold the expected KV record", entry->slots[i]);
+            ret = LT_FAIL;
+            break;
+        }
+        memcpy(val + off, buff + sizeof(struct lt_kv_cont_t), part_len);
+        off += part_len;
+    }
+    lt_secure_memzero(buff, sizeof(buff));
+    if (ret != LT_OK) {
+        return ret;
+    }
+    *val_len = entry->val_len;
+
+    return LT_OK;
+}
+
+lt_ret_t lt_kv_set(lt_handle_t *h, lt_kv_t *kv, const char *key, const uint8_t *val, const uint16_t val_len)
+{
+    if (!h || !kv || !key || (!val && val_len)) {
+        return LT_PARAM_ERR;
+    }
+    uint8_t key_len = check_key(key);
+    if (!key_len) {
+        return LT_PARAM_ERR;
+    }
+    uint8_t slot_cnt = slots_needed(kv, val_len, key_len);
+    if (!slot_cnt) {
+        return LT_PARAM_ERR;
+    }
+
+    uint32_t hash = key_hash((const uint8_t *)key, key_len);
+    lt_kv_entry_t *entry = find_entry(kv, hash);
+    uint8_t buff[TR01_R_MEM_DATA_SIZE_MAX];
+    lt_ret_t ret;
+
+    if (entry) {
+        const uint8_t *data;
+        ret = read_head(h, kv, entry, key, key_len, buff, &data);
+        if (ret == LT_KV_KEY_NOT_FOUND) {
+            LT_LOG_ERROR("Key '%s' collides with another key of the KV store", key);
+            return LT_KV_FULL;
+        }
+        if (ret != LT_OK) {
+            return ret;
+        }
+    }
+    else if (kv->entry_cnt == LT_KV_ENTRIES_MAX) {
+        return LT_KV_FULL;
+    }
+
+    uint16_t slots[LT_KV_SLOTS_PER_VALUE_MAX];
+    ret = alloc_slots(h, kv, slot_cnt, slots);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    // Consumed even if a write fails, the head may have reached the slot and must not share its seq with the next one
+    // written.
+    const uint32_t seq = ++kv->seq;
+
+    // Continuation slots first, the head makes the record valid.
+    uint16_t off = lt_min(val_len, head_cap(kv, slot_cnt, key_len));
+    for (uint8_t i = 1; i < slot_cnt; i++) {
+        struct lt_kv_cont_t *cont = (struct lt_kv_cont_t *)buff;
+        uint16_t len = lt_min(cont_cap(kv), val_len - off);
+        cont->magic = LT_KV_CONT_MAGIC;
+        cont->seq = seq;
+        cont->key_hash = hash;
+        memcpy(buff + sizeof(struct lt_kv_cont_t), val + off, len);
+        ret = write_slot(h, kv, slots[i], buff, sizeof(struct lt_kv_cont_t) + len);
+        if (ret != LT_OK) {
+            lt_secure_memzero(buff, sizeof(buff));
+            return ret;
+        }
+        off += len;
+    }
+
+    struct lt_kv_head_t *head = (struct lt_kv_head_t *)buff;
+    head->magic = LT_KV_MAGIC;
+    head->seq = seq;
+    head->key_hash = hash;
+    head->val_len = val_len;
+    head->key_len = key_len;
+    head->slot_cnt = slot_cnt;
+    uint8_t *p = buff + sizeof(struct lt_kv_head_t);
+    memcpy(p, &slots[1], (slot_cnt - 1) * sizeof(uint16_t));
+    p += (slot_cnt - 1) * sizeof(uint16_t);
+    memcpy(p, key, key_len);
+    p += key_len;
+    off = lt_min(val_len, head_cap(kv, slot_cnt, key_len));
+    if (off) {
+        memcpy(p, val, off);
+    }
+    p += off;
+    head->crc = crc16(buff + 4, (int16_t)(p - buff - 4));
+
+    ret = write_slot(h, kv, slots[0], buff, (uint16_t)(p - buff));
+    lt_secure_memzero(buff, sizeof(buff));
+    if (ret != LT_OK) {
+        // The head may have been written, it must not outlive the previous record at the next mount.
+        bit_set(kv->dirty_head, slots[0] - kv->first_slot);
+        return ret;
+    }
+
+    if (entry) {
+        mark_dirty(kv, entry);
+    }
+    else {
+        entry = &kv->entries[kv->entry_cnt++];
+    }
+    entry->key_hash = hash;
+    entry->seq = seq;
+    entry->val_len = val_len;
+    entry->slot_cnt = slot_cnt;
+    memcpy(entry->slots, slots, slot_cnt * sizeof(uint16_t));
+    for (uint8_t i = 0; i < slot_cnt; i++) {
+        bit_set(kv->live, slots[i] - kv->first_slot);
+    }
+
+    return LT_OK;
+}
+
+lt_ret_t lt_kv_delete(lt_handle_t *h, lt_kv_t *kv, const char *key)
+{
+    if (!h || !kv || !key) {
+        return LT_PARAM_ERR;
+    }
+    uint8_t key_len = check_key(key);
+    if (!key_len) {
+        return LT_PARAM_ERR;
+    }
+
+    lt_kv_entry_t *entry = find_entry(kv, key_hash((const uint8_t *)key, key_len));
+    if (!entry) {
+        return LT_KV_KEY_NOT_FOUND;
+    }
+
+    uint8_t buff[TR01_R_MEM_DATA_SIZE_MAX];
+    const uint8_t *data;
+    lt_ret_t ret = read_head(h, kv, entry, key, key_len, buff, &data);
+    lt_secure_memzero(buff, sizeof(buff));
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    // An older head of the key would become valid again once the current one is erased.
+    for (uint16_t rel = 0; rel < kv->slot_cnt; rel++) {
+        if (bit_get(kv->dirty_head, rel)) {
+            ret = erase_slot(h, kv, rel);
+            if (ret != LT_OK) {
+                return ret;
+            }
+        }
+    }
+
+    uint16_t head_rel = entry->slots[0] - kv->first_slot;
+    ret = erase_slot(h, kv, head_rel);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    mark_dirty(kv, entry);
+    bit_clr(kv->dirty_head, head_rel);
+    remove_entry(kv, entry);
+
+    return LT_OK;
+}
+
+lt_ret_t lt_kv_gc(lt_handle_t *h, lt_kv_t *kv, const uint16_t max_cnt)
+{
+    if (!h || !kv) {
+        return LT_PARAM_ERR;
+    }
+
+    // Heads first, see lt_kv_delete().
+    uint16_t cnt = 0;
+    lt_ret_t ret = gc_pass(h, kv, true, max_cnt, &cnt);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    return gc_pass(h, kv, false, max_cnt, &cnt);
+}
+
+#endif
@@ -58,6 +58,22 @@ lt_ret_t lt_l2_resend_response(lt_l2_state_t *s2)
     return lt_l2_frame_check(s2->buff);
 }
 
+/**
+ * @brief Requests the last L2 Response again (up to three times) if it was received with a wrong CRC.
+ *
+ * @param s2   Structure holding l2 state
+ * @param ret  Result of the check of the received frame
+ * @return     `ret` if the frame was not corrupted, otherwise the result of the check of the resent frame.
+ */
+static lt_ret_t lt_l2_resend_corrupted(lt_l2_state_t *s2, lt_ret_t ret)
+{
+    for (int i = 0; (i < 3) && (ret == LT_L2_IN_CRC_ERR); i++) {
+        ret = lt_l2_resend_response(s2);
+    }
+
+    return ret;
+}
+
 lt_ret_t lt_l2_receive(lt_l2_state_t *s2)
 {
     if (!s2) {
@@ -80,7 +96,7 @@ lt_ret_t lt_l2_receive(lt_l2_state_t *s2)
 
     ret = lt_l2_frame_check(s2->buff);
 
-    if ((ret == LT_L2_CRC_ERR) || (ret == LT_L2_GEN_ERR)) {
+    if ((ret == LT_L2_IN_CRC_ERR) || (ret == LT_L2_CRC_ERR) || (ret == LT_L2_GEN_ERR)) {
         // There was an error when checking received data.
         // Let's consider that length byte is correct, but CRC is not.
         // We try three times to resend the last response.
@@ -162,7 +178,7 @@ lt_ret_t lt_l2_send_encrypted_cmd(lt_l2_state_t *s2, uint8_t *buff, uint16_t buf
         }
 
         // Check status byte of this frame
-        ret = lt_l2_frame_check(s2->buff);
+        ret = lt_l2_resend_corrupted(s2, lt_l2_frame_check(s2->buff));
         if (ret != LT_OK && ret != LT_L2_REQ_CONT) {
             return ret;
         }
@@ -171,11 +187,39 @@ lt_ret_t lt_l2_send_encrypted_cmd(lt_l2_state_t *s2, uint8_t *buff, uint16_t buf
     return LT_OK;
 }
 
+/** @brief Destination of the chunks copied by `lt_l2_recv_encrypted_res()`. */
+struct lt_l2_copy_ctx_t {
+    uint8_t *buff;
+    uint16_t offset;
+};
+
+/** @brief Copies chunk of the L3 packet after the previous one. */
+static lt_ret_t lt_l2_copy_chunk(void *cb_ctx, const uint8_t *chunk, const uint16_t chunk_len)
+{
+    struct lt_l2_copy_ctx_t *copy = (struct lt_l2_copy_ctx_t *)cb_ctx;
+
+    memcpy(copy->buff + copy->offset, chunk, chunk_len);
+    copy->offset += chunk_len;
+
+    return LT_OK;
+}
+
 lt_ret_t lt_l2_recv_encrypted_res(lt_l2_state_t *s2, uint8_t *buff, uint16_t max_len)
+{
+    if (!buff) {
+        return LT_PARAM_ERR;
+    }
+
+    struct lt_l2_copy_ctx_t copy = {.buff = buff, .offset = 0};
+
+    return lt_l2_recv_encrypted_res_chunks(s2, max_len, lt_l2_copy_chunk, &copy);
+}
+
+lt_ret_t lt_l2_recv_encrypted_res_chunks(lt_l2_state_t *s2, uint16_t max_len, lt_l2_chunk_cb_t cb, void *cb_ctx)
 {
     if (!s2
         // Max len must be definitively smaller than size of l3 buffer
-        || max_len > TR01_L3_PACKET_MAX_SIZE || !buff) {
+        || max_len > TR01_L3_PACKET_MAX_SIZE || !cb) {
         return LT_PARAM_ERR;
     }
 
@@ -183,10 +227,12 @@ lt_ret_t lt_l2_recv_encrypted_res(lt_l2_state_t *s2, uint8_t *buff, uint16_t max
     // Setup a response pointer to l2 buffer, which is placed in handle
     struct lt_l2_encrypted_cmd_rsp_t *resp = (struct lt_l2_encrypted_cmd_rsp_t *)s2->buff;
 
-    // Position into l3 buffer where processed l2 chunk will be copied into
+    // Position in l3 packet where the processed l2 chunk belongs
     uint16_t offset = 0;
     // Tropic can respond with various lengths of chunks, this loop should be limited
     uint16_t loops = 0;
+    // First error returned by the callback, the remaining chunks are still read to finish the response
+    lt_ret_t cb_ret = LT_OK;
 
     do {
         /* Get one l2 frame of a device's response */
@@ -195,24 +241,29 @@ lt_ret_t lt_l2_recv_encrypted_res(lt_l2_state_t *s2, uint8_t *buff, uint16_t max
             return ret;
         }
 
+        // Check status byte of this frame
+        ret = lt_l2_resend_corrupted(s2, lt_l2_frame_check(s2->buff));
+
         // Prevent receiving more data then is compiled size of l3 buffer
         if (offset + resp->rsp_len > max_len) {
             return LT_L2_RSP_LEN_ERROR;
         }
 
-        // Check status byte of this frame
-        ret = lt_l2_frame_check(s2->buff);
         switch (ret) {
             case LT_L2_RES_CONT:
-                // Copy content of l2 into certain offset of l3 buffer
-                memcpy(buff + offset, (struct l2_encrypted_rsp_t *)resp->l3_chunk, resp->rsp_len);
+                // Pass content of l2 chunk on
+                if (cb_ret == LT_OK) {
+                    cb_ret = cb(cb_ctx, resp->l3_chunk, resp->rsp_len);
+                }
                 offset += resp->rsp_len;
                 loops++;
                 break;
             case LT_OK:
-                // This was last l2 frame of l3 packet, copy it and return
-                memcpy(buff + offset, (struct l2_encrypted_rsp_t *)resp->l3_chunk, resp->rsp_len);
-                return LT_OK;
+                // This was last l2 frame of l3 packet, pass it on and return
+                if (cb_ret == LT_OK) {
+                    cb_ret = cb(cb_ctx, resp->l3_chunk, resp->rsp_len);
+                }
+                return cb_ret;
             default:
                 // Any other L2 packet's status is not expected
                 return ret;
@@ -272,6 +272,7 @@ exit:
     return ret;
 }
 
+#if LT_L3_CMD_PING
 lt_ret_t lt_out__ping(lt_handle_t *h, const uint8_t *msg_out, const uint16_t msg_len)
 {
     if (!h || !msg_out || (msg_len > TR01_PING_LEN_MAX)) {
@@ -281,6 +282,17 @@ lt_ret_t lt_out__ping(lt_handle_t *h, const uint8_t *msg_out, const uint16_t msg
         return LT_HOST_NO_SESSION;
     }
 
+    lt_ret_t ret = lt_l3_check_buff_len(&h->l3, msg_len + TR01_L3_PING_CMD_SIZE_MIN,
+                                        TR01_L3_RESULT_SIZE + msg_len);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_l3_buff_lease(&h->l3);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     // Pointer to access l3 buffer when it contains command data
     struct lt_l3_ping_cmd_t *p_l3_cmd = (struct lt_l3_ping_cmd_t *)h->l3.buff;
 
@@ -303,6 +315,7 @@ lt_ret_t lt_in__ping(lt_handle_t *h, uint8_t *msg_in, const uint16_t msg_len)
 
     lt_ret_t ret = lt_l3_decrypt_response(&h->l3);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
@@ -317,9 +330,13 @@ lt_ret_t lt_in__ping(lt_handle_t *h, uint8_t *msg_in, const uint16_t msg_len)
 
     memcpy(msg_in, p_l3_res->data_out, msg_len);
 
+    lt_l3_buff_release(&h->l3);
+
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_PAIRING_KEY_WRITE
 lt_ret_t lt_out__pairing_key_write(lt_handle_t *h, const uint8_t *pairing_pub, const uint8_t slot)
 {
     if (!h || !pairing_pub || (slot > 3)) {
@@ -329,6 +346,11 @@ lt_ret_t lt_out__pairing_key_write(lt_handle_t *h, const uint8_t *pairing_pub, c
         return LT_HOST_NO_SESSION;
     }
 
+    lt_ret_t ret = lt_l3_buff_lease(&h->l3);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     // Pointer to access l3 buffer when it contains command data
     struct lt_l3_pairing_key_write_cmd_t *p_l3_cmd = (struct lt_l3_pairing_key_write_cmd_t *)h->l3.buff;
 
@@ -352,6 +374,7 @@ lt_ret_t lt_in__pairing_key_write(lt_handle_t *h)
 
     lt_ret_t ret = lt_l3_decrypt_response(&h->l3);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
@@ -364,9 +387,13 @@ lt_ret_t lt_in__pairing_key_write(lt_handle_t *h)
         return LT_L3_RES_SIZE_ERROR;
     }
 
+    lt_l3_buff_release(&h->l3);
+
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_PAIRING_KEY_READ
 lt_ret_t lt_out__pairing_key_read(lt_handle_t *h, const uint8_t slot)
 {
     if (!h || (slot > 3)) {
@@ -376,6 +403,11 @@ lt_ret_t lt_out__pairing_key_read(lt_handle_t *h, const uint8_t slot)
         return LT_HOST_NO_SESSION;
     }
 
+    lt_ret_t ret = lt_l3_buff_lease(&h->l3);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     // Pointer to access l3 buffer when it contains command data
     struct lt_l3_pairing_key_read_cmd_t *p_l3_cmd = (struct lt_l3_pairing_key_read_cmd_t *)h->l3.buff;
 
@@ -398,6 +430,7 @@ lt_ret_t lt_in__pairing_key_read(lt_handle_t *h, uint8_t *pubkey)
 
     lt_ret_t ret = lt_l3_decrypt_response(&h->l3);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
@@ -412,9 +445,13 @@ lt_ret_t lt_in__pairing_key_read(lt_handle_t *h, uint8_t *pubkey)
 
     memcpy(pubkey, p_l3_res->s_hipub, TR01_SHIPUB_LEN);
 
+    lt_l3_buff_release(&h->l3);
+
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_PAIRING_KEY_INVALIDATE
 lt_ret_t lt_out__pairing_key_invalidate(lt_handle_t *h, const uint8_t slot)
 {
     if (!h || (slot > 3)) {
@@ -424,6 +461,11 @@ lt_ret_t lt_out__pairing_key_invalidate(lt_handle_t *h, const uint8_t slot)
         return LT_HOST_NO_SESSION;
     }
 
+    lt_ret_t ret = lt_l3_buff_lease(&h->l3);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     // Pointer to access l3 buffer when it contains command data
     struct lt_l3_pairing_key_invalidate_cmd_t *p_l3_cmd = (struct lt_l3_pairing_key_invalidate_cmd_t *)h->l3.buff;
 
@@ -447,6 +489,7 @@ lt_ret_t lt_in__pairing_key_invalidate(lt_handle_t *h)
 
     lt_ret_t ret = lt_l3_decrypt_response(&h->l3);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
@@ -459,9 +502,13 @@ lt_ret_t lt_in__pairing_key_invalidate(lt_handle_t *h)
         return LT_L3_RES_SIZE_ERROR;
     }
 
+    lt_l3_buff_release(&h->l3);
+
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_R_CONFIG_WRITE || LT_L3_CMD_R_CONFIG_READ || LT_L3_CMD_I_CONFIG_WRITE || LT_L3_CMD_I_CONFIG_READ
 static bool conf_addr_valid(enum lt_config_obj_addr_t addr)
 {
     bool valid = false;
@@ -498,7 +545,9 @@ static bool conf_addr_valid(enum lt_config_obj_addr_t addr)
     }
     return valid;
 }
+#endif
 
+#if LT_L3_CMD_R_CONFIG_WRITE
 lt_ret_t lt_out__r_config_write(lt_handle_t *h, const enum lt_config_obj_addr_t addr, const uint32_t obj)
 {
     if (!h || !conf_addr_valid(addr)) {
@@ -508,6 +557,11 @@ lt_ret_t lt_out__r_config_write(lt_handle_t *h, const enum lt_config_obj_addr_t
         return LT_HOST_NO_SESSION;
     }
 
+    lt_ret_t ret = lt_l3_buff_lease(&h->l3);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     // Setup a pointer to l3 buffer, which is placed in handle
     struct lt_l3_r_config_write_cmd_t *p_l3_cmd = (struct lt_l3_r_config_write_cmd_t *)h->l3.buff;
 
@@ -531,6 +585,7 @@ lt_ret_t lt_in__r_config_write(lt_handle_t *h)
 
     lt_ret_t ret = lt_l3_decrypt_response(&h->l3);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
@@ -543,9 +598,13 @@ lt_ret_t lt_in__r_config_write(lt_handle_t *h)
         return LT_L3_RES_SIZE_ERROR;
     }
 
+    lt_l3_buff_release(&h->l3);
+
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_R_CONFIG_READ
 lt_ret_t lt_out__r_config_read(lt_handle_t *h, const enum lt_config_obj_addr_t addr)
 {
     if (!h || !conf_addr_valid(addr)) {
@@ -555,6 +614,11 @@ lt_ret_t lt_out__r_config_read(lt_handle_t *h, const enum lt_config_obj_addr_t a
         return LT_HOST_NO_SESSION;
     }
 
+    lt_ret_t ret = lt_l3_buff_lease(&h->l3);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     // Setup a pointer to l3 buffer, which is placed in handle
     struct lt_l3_r_config_read_cmd_t *p_l3_cmd = (struct lt_l3_r_config_read_cmd_t *)h->l3.buff;
 
@@ -577,6 +641,7 @@ lt_ret_t lt_in__r_config_read(lt_handle_t *h, uint32_t *obj)
 
     lt_ret_t ret = lt_l3_decrypt_response(&h->l3);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
@@ -591,9 +656,13 @@ lt_ret_t lt_in__r_config_read(lt_handle_t *h, uint32_t *obj)
 
     *obj = p_l3_res->value;
 
+    lt_l3_buff_release(&h->l3);
+
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_R_CONFIG_ERASE
 lt_ret_t lt_out__r_config_erase(lt_handle_t *h)
 {
     if (!h) {
@@ -603,6 +672,11 @@ lt_ret_t lt_out__r_config_erase(lt_handle_t *h)
         return LT_HOST_NO_SESSION;
     }
 
+    lt_ret_t ret = lt_l3_buff_lease(&h->l3);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     // Setup a pointer to l3 buffer, which is placed in handle
     struct lt_l3_r_config_erase_cmd_t *p_l3_cmd = (struct lt_l3_r_config_erase_cmd_t *)h->l3.buff;
 
@@ -624,6 +698,7 @@ lt_ret_t lt_in__r_config_erase(lt_handle_t *h)
 
     lt_ret_t ret = lt_l3_decrypt_response(&h->l3);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
@@ -636,9 +711,13 @@ lt_ret_t lt_in__r_config_erase(lt_handle_t *h)
         return LT_L3_RES_SIZE_ERROR;
     }
 
+    lt_l3_buff_release(&h->l3);
+
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_I_CONFIG_WRITE
 lt_ret_t lt_out__i_config_write(lt_handle_t *h, const enum lt_config_obj_addr_t addr, const uint8_t bit_index)
 {
     if (!h || !conf_addr_valid(addr) || (bit_index > 31)) {
@@ -648,6 +727,11 @@ lt_ret_t lt_out__i_config_write(lt_handle_t *h, const enum lt_config_obj_addr_t
         return LT_HOST_NO_SESSION;
     }
 
+    lt_ret_t ret = lt_l3_buff_lease(&h->l3);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     // Setup a pointer to l3 buffer, which is placed in handle
     struct lt_l3_i_config_write_cmd_t *p_l3_cmd = (struct lt_l3_i_config_write_cmd_t *)h->l3.buff;
 
@@ -671,6 +755,7 @@ lt_ret_t lt_in__i_config_write(lt_handle_t *h)
 
     lt_ret_t ret = lt_l3_decrypt_response(&h->l3);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
@@ -683,9 +768,13 @@ lt_ret_t lt_in__i_config_write(lt_handle_t *h)
         return LT_L3_RES_SIZE_ERROR;
     }
 
+    lt_l3_buff_release(&h->l3);
+
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_I_CONFIG_READ
 lt_ret_t lt_out__i_config_read(lt_handle_t *h, const enum lt_config_obj_addr_t addr)
 {
     if (!h || !conf_addr_valid(addr)) {
@@ -695,6 +784,11 @@ lt_ret_t lt_out__i_config_read(lt_handle_t *h, const enum lt_config_obj_addr_t a
         return LT_HOST_NO_SESSION;
     }
 
+    lt_ret_t ret = lt_l3_buff_lease(&h->l3);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     // Setup a pointer to l3 buffer, which is placed in handle
     struct lt_l3_i_config_read_cmd_t *p_l3_cmd = (struct lt_l3_i_config_read_cmd_t *)h->l3.buff;
 
@@ -717,6 +811,7 @@ lt_ret_t lt_in__i_config_read(lt_handle_t *h, uint32_t *obj)
 
     lt_ret_t ret = lt_l3_decrypt_response(&h->l3);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
@@ -731,9 +826,13 @@ lt_ret_t lt_in__i_config_read(lt_handle_t *h, uint32_t *obj)
 
     *obj = p_l3_res->value;
 
+    lt_l3_buff_release(&h->l3);
+
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_R_MEM_DATA_WRITE
 lt_ret_t lt_out__r_mem_data_write(lt_handle_t *h, const uint16_t udata_slot, const uint8_t *data,
                                   const uint16_t data_size)
 {
@@ -745,6 +844,16 @@ lt_ret_t lt_out__r_mem_data_write(lt_handle_t *h, const uint16_t udata_slot, con
         return LT_HOST_NO_SESSION;
     }
 
+    lt_ret_t ret = lt_l3_check_buff_len(&h->l3, data_size + 4, TR01_L3_R_MEM_DATA_WRITE_RES_SIZE);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_l3_buff_lease(&h->l3);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     // Pointer to access l3 buffer when it contains command data
     struct lt_l3_r_mem_data_write_cmd_t *p_l3_cmd = (struct lt_l3_r_mem_data_write_cmd_t *)h->l3.buff;
 
@@ -768,6 +877,7 @@ lt_ret_t lt_in__r_mem_data_write(lt_handle_t *h)
 
     lt_ret_t ret = lt_l3_decrypt_response(&h->l3);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
@@ -780,9 +890,13 @@ lt_ret_t lt_in__r_mem_data_write(lt_handle_t *h)
         return LT_L3_RES_SIZE_ERROR;
     }
 
+    lt_l3_buff_release(&h->l3);
+
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_R_MEM_DATA_READ
 lt_ret_t lt_out__r_mem_data_read(lt_handle_t *h, const uint16_t udata_slot)
 {
     if (!h || (udata_slot > TR01_R_MEM_DATA_SLOT_MAX)) {
@@ -792,6 +906,19 @@ lt_ret_t lt_out__r_mem_data_read(lt_handle_t *h, const uint16_t udata_slot)
         return LT_HOST_NO_SESSION;
     }
 
+    // The result carries the whole slot, its largest size depends on the FW of the chip.
+    lt_ret_t ret = lt_l3_check_buff_len(
+        &h->l3, TR01_L3_R_MEM_DATA_READ_CMD_SIZE,
+        TR01_L3_RESULT_SIZE + TR01_L3_R_MEM_DATA_READ_PADDING_SIZE + h->tr01_attrs.r_mem_udata_slot_size_max);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_l3_buff_lease(&h->l3);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     // Pointer to access l3 buffer when it contains command data
     struct lt_l3_r_mem_data_read_cmd_t *p_l3_cmd = (struct lt_l3_r_mem_data_read_cmd_t *)h->l3.buff;
 
@@ -814,6 +941,7 @@ lt_ret_t lt_in__r_mem_data_read(lt_handle_t *h, uint8_t *data, const uint16_t da
 
     lt_ret_t ret = lt_l3_decrypt_response(&h->l3);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
@@ -832,19 +960,25 @@ lt_ret_t lt_in__r_mem_data_read(lt_handle_t *h, uint8_t *data, const uint16_t da
 
     // Check if slot is not empty
     if (*data_read_size == 0) {
+        lt_l3_buff_release(&h->l3);
         return LT_L3_R_MEM_DATA_READ_SLOT_EMPTY;
     }
 
     // Check if the output buffer for the read data is big enough
     if (data_max_size < *data_read_size) {
+        lt_l3_buff_release(&h->l3);
         return LT_PARAM_ERR;
     }
 
     memcpy(data, p_l3_res->data, *data_read_size);
 
+    lt_l3_buff_release(&h->l3);
+
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_R_MEM_DATA_ERASE
 lt_ret_t lt_out__r_mem_data_erase(lt_handle_t *h, const uint16_t udata_slot)
 {
     if (!h || (udata_slot > TR01_R_MEM_DATA_SLOT_MAX)) {
@@ -854,6 +988,11 @@ lt_ret_t lt_out__r_mem_data_erase(lt_handle_t *h, const uint16_t udata_slot)
         return LT_HOST_NO_SESSION;
     }
 
+    lt_ret_t ret = lt_l3_buff_lease(&h->l3);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     // Pointer to access l3 buffer when it contains command data
     struct lt_l3_r_mem_data_erase_cmd_t *p_l3_cmd = (struct lt_l3_r_mem_data_erase_cmd_t *)h->l3.buff;
 
@@ -876,6 +1015,7 @@ lt_ret_t lt_in__r_mem_data_erase(lt_handle_t *h)
 
     lt_ret_t ret = lt_l3_decrypt_response(&h->l3);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
@@ -888,9 +1028,13 @@ lt_ret_t lt_in__r_mem_data_erase(lt_handle_t *h)
         return LT_L3_RES_SIZE_ERROR;
     }
 
+    lt_l3_buff_release(&h->l3);
+
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_RANDOM_VALUE_GET
 lt_ret_t lt_out__random_value_get(lt_handle_t *h, const uint16_t rnd_bytes_cnt)
 {
     if ((rnd_bytes_cnt > TR01_RANDOM_VALUE_GET_LEN_MAX) || !h) {
@@ -900,6 +1044,17 @@ lt_ret_t lt_out__random_value_get(lt_handle_t *h, const uint16_t rnd_bytes_cnt)
         return LT_HOST_NO_SESSION;
     }
 
+    lt_ret_t ret = lt_l3_check_buff_len(&h->l3, TR01_L3_RANDOM_VALUE_GET_CMD_SIZE,
+                                        TR01_L3_RANDOM_VALUE_GET_RES_SIZE_MIN + rnd_bytes_cnt);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_l3_buff_lease(&h->l3);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     // Pointer to access l3 buffer when it contains command data
     struct lt_l3_random_value_get_cmd_t *p_l3_cmd = (struct lt_l3_random_value_get_cmd_t *)h->l3.buff;
 
@@ -922,6 +1077,7 @@ lt_ret_t lt_in__random_value_get(lt_handle_t *h, uint8_t *rnd_bytes, const uint1
 
     lt_ret_t ret = lt_l3_decrypt_response(&h->l3);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
@@ -940,9 +1096,13 @@ lt_ret_t lt_in__random_value_get(lt_handle_t *h, uint8_t *rnd_bytes, const uint1
     // parameter. Note: p_l3_res->res_size could be used as well if we subtract TR01_L3_RANDOM_VALUE_GET_RES_SIZE_MIN.
     memcpy(rnd_bytes, p_l3_res->random_data, rnd_bytes_cnt);
 
+    lt_l3_buff_release(&h->l3);
+
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_ECC_KEY_GENERATE
 lt_ret_t lt_out__ecc_key_generate(lt_handle_t *h, const lt_ecc_slot_t slot, const lt_ecc_curve_type_t curve)
 {
     if (!h || (slot > TR01_ECC_SLOT_31) || ((curve != TR01_CURVE_P256) && (curve != TR01_CURVE_ED25519))) {
@@ -952,6 +1112,11 @@ lt_ret_t lt_out__ecc_key_generate(lt_handle_t *h, const lt_ecc_slot_t slot, cons
         return LT_HOST_NO_SESSION;
     }
 
+    lt_ret_t ret = lt_l3_buff_lease(&h->l3);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     // Pointer to access l3 buffer when it contains command data
     struct lt_l3_ecc_key_generate_cmd_t *p_l3_cmd = (struct lt_l3_ecc_key_generate_cmd_t *)h->l3.buff;
 
@@ -972,6 +1137,7 @@ lt_ret_t lt_in__ecc_key_generate(lt_handle_t *h)
 
     lt_ret_t ret = lt_l3_decrypt_response(&h->l3);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
@@ -984,9 +1150,13 @@ lt_ret_t lt_in__ecc_key_generate(lt_handle_t *h)
         return LT_L3_RES_SIZE_ERROR;
     }
 
+    lt_l3_buff_release(&h->l3);
+
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_ECC_KEY_STORE
 lt_ret_t lt_out__ecc_key_store(lt_handle_t *h, const lt_ecc_slot_t slot, const lt_ecc_curve_type_t curve,
                                const uint8_t *key)
 {
@@ -997,6 +1167,11 @@ lt_ret_t lt_out__ecc_key_store(lt_handle_t *h, const lt_ecc_slot_t slot, const l
         return LT_HOST_NO_SESSION;
     }
 
+    lt_ret_t ret = lt_l3_buff_lease(&h->l3);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     // Pointer to access l3 buffer when it contains command data
     struct lt_l3_ecc_key_store_cmd_t *p_l3_cmd = (struct lt_l3_ecc_key_store_cmd_t *)h->l3.buff;
 
@@ -1021,6 +1196,7 @@ lt_ret_t lt_in__ecc_key_store(lt_handle_t *h)
 
     lt_ret_t ret = lt_l3_decrypt_response(&h->l3);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
@@ -1033,9 +1209,13 @@ lt_ret_t lt_in__ecc_key_store(lt_handle_t *h)
         return LT_L3_RES_SIZE_ERROR;
     }
 
+    lt_l3_buff_release(&h->l3);
+
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_ECC_KEY_READ
 // lt_ret_t lt_ecc_key_read(lt_handle_t *h, const lt_ecc_slot_t slot, uint8_t *key, const uint8_t keylen,
 // lt_ecc_curve_type_t *curve, lt_ecc_key_origin_t *origin)
 lt_ret_t lt_out__ecc_key_read(lt_handle_t *h, const lt_ecc_slot_t slot)
@@ -1047,6 +1227,11 @@ lt_ret_t lt_out__ecc_key_read(lt_handle_t *h, const lt_ecc_slot_t slot)
         return LT_HOST_NO_SESSION;
     }
 
+    lt_ret_t ret = lt_l3_buff_lease(&h->l3);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     // Pointer to access l3 buffer when it contains command data
     struct lt_l3_ecc_key_read_cmd_t *p_l3_cmd = (struct lt_l3_ecc_key_read_cmd_t *)h->l3.buff;
 
@@ -1070,6 +1255,7 @@ lt_ret_t lt_in__ecc_key_read(lt_handle_t *h, uint8_t *key, const uint8_t key_max
 
     lt_ret_t ret = lt_l3_decrypt_response(&h->l3);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
@@ -1088,6 +1274,7 @@ lt_ret_t lt_in__ecc_key_read(lt_handle_t *h, uint8_t *key, const uint8_t key_max
 
         // Check if the output buffer for the key is big enough
         if (key_max_size < TR01_CURVE_ED25519_PUBKEY_LEN) {
+            lt_l3_buff_release(&h->l3);
             return LT_PARAM_ERR;
         }
 
@@ -1102,6 +1289,7 @@ lt_ret_t lt_in__ecc_key_read(lt_handle_t *h, uint8_t *key, const uint8_t key_max
 
         // Check if the output buffer for the key is big enough
         if (key_max_size < TR01_CURVE_P256_PUBKEY_LEN) {
+            lt_l3_buff_release(&h->l3);
             return LT_PARAM_ERR;
         }
 
@@ -1109,17 +1297,22 @@ lt_ret_t lt_in__ecc_key_read(lt_handle_t *h, uint8_t *key, const uint8_t key_max
     }
     else {
         // Unknown curve type.
+        lt_l3_buff_release(&h->l3);
         return LT_FAIL;
     }
 
     *curve = p_l3_res->curve;
     *origin = p_l3_res->origin;
 
+    lt_l3_buff_release(&h->l3);
+
     return LT_OK;
 }
+#endif
 
 // lt_ret_t lt_ecc_key_erase(lt_handle_t *h, const lt_ecc_slot_t slot)
 
+#if LT_L3_CMD_ECC_KEY_ERASE
 lt_ret_t lt_out__ecc_key_erase(lt_handle_t *h, const lt_ecc_slot_t slot)
 {
     if (!h || (slot > TR01_ECC_SLOT_31)) {
@@ -1129,6 +1322,11 @@ lt_ret_t lt_out__ecc_key_erase(lt_handle_t *h, const lt_ecc_slot_t slot)
         return LT_HOST_NO_SESSION;
     }
 
+    lt_ret_t ret = lt_l3_buff_lease(&h->l3);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     // Setup a pointer to l3 buffer, which is placed in handle
     struct lt_l3_ecc_key_erase_cmd_t *p_l3_cmd = (struct lt_l3_ecc_key_erase_cmd_t *)h->l3.buff;
 
@@ -1151,6 +1349,7 @@ lt_ret_t lt_in__ecc_key_erase(lt_handle_t *h)
 
     lt_ret_t ret = lt_l3_decrypt_response(&h->l3);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
@@ -1163,9 +1362,13 @@ lt_ret_t lt_in__ecc_key_erase(lt_handle_t *h)
         return LT_L3_RES_SIZE_ERROR;
     }
 
+    lt_l3_buff_release(&h->l3);
+
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_ECC_ECDSA_SIGN
 lt_ret_t lt_out__ecc_ecdsa_sign(lt_handle_t *h, const lt_ecc_slot_t slot, const uint8_t *msg, const uint32_t msg_len)
 {
     if (!h || (slot > TR01_ECC_SLOT_31) || !msg) {
@@ -1196,6 +1399,11 @@ lt_ret_t lt_out__ecc_ecdsa_sign(lt_handle_t *h, const lt_ecc_slot_t slot, const
         return ret;
     }
 
+    ret = lt_l3_buff_lease(&h->l3);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     // Pointer to access l3 buffer when it contains command data
     struct lt_l3_ecdsa_sign_cmd_t *p_l3_cmd = (struct lt_l3_ecdsa_sign_cmd_t *)h->l3.buff;
 
@@ -1219,6 +1427,7 @@ lt_ret_t lt_in__ecc_ecdsa_sign(lt_handle_t *h, uint8_t *rs)
 
     lt_ret_t ret = lt_l3_decrypt_response(&h->l3);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
@@ -1234,9 +1443,13 @@ lt_ret_t lt_in__ecc_ecdsa_sign(lt_handle_t *h, uint8_t *rs)
     memcpy(rs, p_l3_res->r, sizeof(p_l3_res->r));
     memcpy(rs + sizeof(p_l3_res->r), p_l3_res->s, sizeof(p_l3_res->s));
 
+    lt_l3_buff_release(&h->l3);
+
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_ECC_EDDSA_SIGN
 lt_ret_t lt_out__ecc_eddsa_sign(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, const uint8_t *msg,
                                 const uint16_t msg_len)
 {
@@ -1247,6 +1460,16 @@ lt_ret_t lt_out__ecc_eddsa_sign(lt_handle_t *h, const lt_ecc_slot_t ecc_slot, co
         return LT_HOST_NO_SESSION;
     }
 
+    lt_ret_t ret = lt_l3_check_buff_len(&h->l3, TR01_L3_EDDSA_SIGN_CMD_SIZE_MIN + msg_len, TR01_L3_EDDSA_SIGN_RES_SIZE);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_l3_buff_lease(&h->l3);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     // Pointer to access l3 buffer when it contains command data
     struct lt_l3_eddsa_sign_cmd_t *p_l3_cmd = (struct lt_l3_eddsa_sign_cmd_t *)h->l3.buff;
 
@@ -1270,6 +1493,7 @@ lt_ret_t lt_in__ecc_eddsa_sign(lt_handle_t *h, uint8_t *rs)
 
     lt_ret_t ret = lt_l3_decrypt_response(&h->l3);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
@@ -1285,9 +1509,13 @@ lt_ret_t lt_in__ecc_eddsa_sign(lt_handle_t *h, uint8_t *rs)
     memcpy(rs, p_l3_res->r, sizeof(p_l3_res->r));
     memcpy(rs + sizeof(p_l3_res->r), p_l3_res->s, sizeof(p_l3_res->s));
 
+    lt_l3_buff_release(&h->l3);
+
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_MCOUNTER_INIT
 lt_ret_t lt_out__mcounter_init(lt_handle_t *h, const enum lt_mcounter_index_t mcounter_index,
                                const uint32_t mcounter_value)
 {
@@ -1298,6 +1526,11 @@ lt_ret_t lt_out__mcounter_init(lt_handle_t *h, const enum lt_mcounter_index_t mc
         return LT_HOST_NO_SESSION;
     }
 
+    lt_ret_t ret = lt_l3_buff_lease(&h->l3);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     // Setup a pointer to l3 buffer, which is placed in handle
     struct lt_l3_mcounter_init_cmd_t *p_l3_cmd = (struct lt_l3_mcounter_init_cmd_t *)h->l3.buff;
 
@@ -1321,6 +1554,7 @@ lt_ret_t lt_in__mcounter_init(lt_handle_t *h)
 
     lt_ret_t ret = lt_l3_decrypt_response(&h->l3);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
@@ -1333,9 +1567,13 @@ lt_ret_t lt_in__mcounter_init(lt_handle_t *h)
         return LT_L3_RES_SIZE_ERROR;
     }
 
+    lt_l3_buff_release(&h->l3);
+
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_MCOUNTER_UPDATE
 lt_ret_t lt_out__mcounter_update(lt_handle_t *h, const enum lt_mcounter_index_t mcounter_index)
 {
     if (!h || (mcounter_index > TR01_MCOUNTER_INDEX_15)) {
@@ -1345,6 +1583,11 @@ lt_ret_t lt_out__mcounter_update(lt_handle_t *h, const enum lt_mcounter_index_t
         return LT_HOST_NO_SESSION;
     }
 
+    lt_ret_t ret = lt_l3_buff_lease(&h->l3);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     // Setup a pointer to l3 buffer, which is placed in handle
     struct lt_l3_mcounter_update_cmd_t *p_l3_cmd = (struct lt_l3_mcounter_update_cmd_t *)h->l3.buff;
 
@@ -1367,6 +1610,7 @@ lt_ret_t lt_in__mcounter_update(lt_handle_t *h)
 
     lt_ret_t ret = lt_l3_decrypt_response(&h->l3);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
@@ -1379,9 +1623,13 @@ lt_ret_t lt_in__mcounter_update(lt_handle_t *h)
         return LT_L3_RES_SIZE_ERROR;
     }
 
+    lt_l3_buff_release(&h->l3);
+
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_MCOUNTER_GET
 lt_ret_t lt_out__mcounter_get(lt_handle_t *h, const enum lt_mcounter_index_t mcounter_index)
 {
     if (!h || (mcounter_index > TR01_MCOUNTER_INDEX_15)) {
@@ -1391,6 +1639,11 @@ lt_ret_t lt_out__mcounter_get(lt_handle_t *h, const enum lt_mcounter_index_t mco
         return LT_HOST_NO_SESSION;
     }
 
+    lt_ret_t ret = lt_l3_buff_lease(&h->l3);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     // Setup a pointer to l3 buffer, which is placed in handle
     struct lt_l3_mcounter_get_cmd_t *p_l3_cmd = (struct lt_l3_mcounter_get_cmd_t *)h->l3.buff;
 
@@ -1413,6 +1666,7 @@ lt_ret_t lt_in__mcounter_get(lt_handle_t *h, uint32_t *mcounter_value)
 
     lt_ret_t ret = lt_l3_decrypt_response(&h->l3);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
@@ -1427,9 +1681,13 @@ lt_ret_t lt_in__mcounter_get(lt_handle_t *h, uint32_t *mcounter_value)
 
     *mcounter_value = p_l3_res->mcounter_val;
 
+    lt_l3_buff_release(&h->l3);
+
     return LT_OK;
 }
+#endif
 
+#if LT_L3_CMD_MAC_AND_DESTROY
 lt_ret_t lt_out__mac_and_destroy(lt_handle_t *h, lt_mac_and_destroy_slot_t slot, const uint8_t *data_out)
 {
     if (!h || !data_out || slot > TR01_MAC_AND_DESTROY_SLOT_127) {
@@ -1439,6 +1697,11 @@ lt_ret_t lt_out__mac_and_destroy(lt_handle_t *h, lt_mac_and_destroy_slot_t slot,
         return LT_HOST_NO_SESSION;
     }
 
+    lt_ret_t ret = lt_l3_buff_lease(&h->l3);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
     // Setup a pointer to l3 buffer, which is placed in handle
     struct lt_l3_mac_and_destroy_cmd_t *p_l3_cmd = (struct lt_l3_mac_and_destroy_cmd_t *)h->l3.buff;
 
@@ -1462,6 +1725,7 @@ lt_ret_t lt_in__mac_and_destroy(lt_handle_t *h, uint8_t *data_in)
 
     lt_ret_t ret = lt_l3_decrypt_response(&h->l3);
     if (ret != LT_OK) {
+        lt_l3_buff_release(&h->l3);
         return ret;
     }
 
@@ -1476,5 +1740,8 @@ lt_ret_t lt_in__mac_and_destroy(lt_handle_t *h, uint8_t *data_in)
 
     memcpy(data_in, p_l3_res->data_out, TR01_MAC_AND_DESTROY_DATA_SIZE);
 
+    lt_l3_buff_release(&h->l3);
+
     return LT_OK;
 }
+#endif
@@ -73,6 +73,53 @@ lt_ret_t lt_aesgcm_decrypt(void *ctx, const uint8_t *iv, const uint32_t iv_len,
                            const uint32_t add_len, const uint8_t *ciphertext, const uint32_t ciphertext_len,
                            uint8_t *plaintext, const uint32_t plaintext_len) __attribute__((warn_unused_result));
 
+/**
+ * @brief Starts decrypting a message received in parts, expects initialized context with valid keys.
+ * @note Starting a new message drops the one in progress, if any.
+ * @note Needed only with `LT_L3_STREAM_DECRYPT`, implemented only by the trezor_crypto CAL.
+ *
+ * @param ctx               AES-GCM context structure
+ * @param iv                The initialisation vector
+ * @param iv_len            Length of the initialization vector
+ * @param add               Additional data
+ * @param add_len           Length of additional data
+ * @return                  LT_OK if success, otherwise returns other error code.
+ */
+lt_ret_t lt_aesgcm_decrypt_start(void *ctx, const uint8_t *iv, const uint32_t iv_len, const uint8_t *add,
+                                 const uint32_t add_len) __attribute__((warn_unused_result));
+
+/**
+ * @brief Decrypts next part of the message started by `lt_aesgcm_decrypt_start()`.
+ * @note The plaintext is not authenticated until `lt_aesgcm_decrypt_finish()` succeeds. The output may lag behind the
+ *       input by less than one AES block, `plaintext_size` has to allow for that.
+ *
+ * @param ctx               AES-GCM context structure
+ * @param ciphertext        Part of the ciphertext (without tag)
+ * @param ciphertext_len    Length of the part
+ * @param plaintext         Buffer to store plaintext
+ * @param plaintext_size    Size of the plaintext buffer
+ * @param plaintext_len     Number of plaintext bytes stored
+ * @return                  LT_OK if success, otherwise returns other error code.
+ */
+lt_ret_t lt_aesgcm_decrypt_update(void *ctx, const uint8_t *ciphertext, const uint32_t ciphertext_len,
+                                  uint8_t *plaintext, const uint32_t plaintext_size, uint32_t *plaintext_len)
+    __attribute__((warn_unused_result));
+
+/**
+ * @brief Verifies tag of the message decrypted by `lt_aesgcm_decrypt_update()` and stores the rest of plaintext.
+ *
+ * @param ctx               AES-GCM context structure
+ * @param tag               Tag of the message
+ * @param tag_len           Length of the tag
+ * @param plaintext         Buffer to store the rest of plaintext
+ * @param plaintext_size    Size of the plaintext buffer
+ * @param plaintext_len     Number of plaintext bytes stored
+ * @return                  LT_OK if the tag matches, otherwise returns other error code.
+ */
+lt_ret_t lt_aesgcm_decrypt_finish(void *ctx, const uint8_t *tag, const uint32_t tag_len, uint8_t *plaintext,
+                                  const uint32_t plaintext_size, uint32_t *plaintext_len)
+    __attribute__((warn_unused_result));
+
 /**
  * @brief Deinitializes AES-GCM encryption context.
  *
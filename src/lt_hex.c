@@ -0,0 +1,62 @@
+/**
+ * @file lt_hex.c
+ * @brief Table-driven hex encoding and decoding of byte buffers, shared by libtropic and the HALs.
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include "lt_hex.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "libtropic_common.h"
+
+/** @brief Hex digits indexed by nibble value. */
+static const char lt_hex_digits[16] = {'0', '1', '2', '3', '4', '5', '6', '7',
+                                       '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
+
+/** @brief Nibble values indexed by character, 0xff for characters which are not hex digits. */
+static const uint8_t lt_hex_nibble[256] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+
+void lt_hex_encode(const uint8_t *bytes, const size_t bytes_cnt, char *out)
+{
+    for (size_t i = 0; i < bytes_cnt; i++) {
+        out[2 * i] = lt_hex_digits[bytes[i] >> 4];
+        out[2 * i + 1] = lt_hex_digits[bytes[i] & 0x0f];
+    }
+}
+
+lt_ret_t lt_hex_decode(const char *hex, const size_t bytes_cnt, uint8_t *out)
+{
+    // Invalid characters are collected in one accumulator instead of a branch per character; any of them sets the
+    // upper nibble.
+    uint8_t invalid = 0;
+
+    for (size_t i = 0; i < bytes_cnt; i++) {
+        const uint8_t hi = lt_hex_nibble[(uint8_t)hex[2 * i]];
+        const uint8_t lo = lt_hex_nibble[(uint8_t)hex[2 * i + 1]];
+        invalid |= hi | lo;
+        out[i] = (uint8_t)((hi << 4) | (lo & 0x0f));
+    }
+
+    return (invalid & 0xf0) ? LT_FAIL : LT_OK;
+}
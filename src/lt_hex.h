@@ -0,0 +1,48 @@
+#ifndef LT_HEX_H
+#define LT_HEX_H
+
+/**
+ * @file lt_hex.h
+ * @brief Table-driven hex encoding and decoding of byte buffers, shared by libtropic and the HALs.
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "libtropic_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Encodes bytes as uppercase hex characters (two per byte, the same as `printf("%02X")`).
+ * @note The output is not terminated by '\0'.
+ *
+ * @param bytes      Bytes to encode
+ * @param bytes_cnt  Number of bytes to encode
+ * @param out        Output buffer for at least `2 * bytes_cnt` characters
+ */
+void lt_hex_encode(const uint8_t *bytes, const size_t bytes_cnt, char *out);
+
+/**
+ * @brief Decodes hex characters (upper or lower case, two per byte) to bytes.
+ * @note The output is written even if the input is invalid, its content is then undefined.
+ *
+ * @param hex        Hex characters to decode, at least `2 * bytes_cnt` of them
+ * @param bytes_cnt  Number of bytes to decode
+ * @param out        Output buffer for at least `bytes_cnt` bytes
+ *
+ * @retval           LT_OK All the characters were valid hex digits
+ * @retval           LT_FAIL Some of the characters were not hex digits
+ */
+lt_ret_t lt_hex_decode(const char *hex, const size_t bytes_cnt, uint8_t *out) __attribute__((warn_unused_result));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LT_HEX_H
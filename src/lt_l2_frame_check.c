@@ -32,11 +32,19 @@ lt_ret_t lt_l2_frame_check(const uint8_t *frame)
             }
             return LT_OK;
 
-        // L2 statuses returned by Tropic chip are handled here
+        // Frames of chunked L3 packets carry data as well, so check their crc too
         case TR01_L2_STATUS_REQUEST_CONT:
+            if (frame_crc != crc16(frame + 1, len + 2)) {
+                return LT_L2_IN_CRC_ERR;
+            }
             return LT_L2_REQ_CONT;
         case TR01_L2_STATUS_RESULT_CONT:
+            if (frame_crc != crc16(frame + 1, len + 2)) {
+                return LT_L2_IN_CRC_ERR;
+            }
             return LT_L2_RES_CONT;
+
+        // L2 statuses returned by Tropic chip are handled here
         case TR01_L2_STATUS_HSK_ERR:
             return LT_L2_HSK_ERR;
         case TR01_L2_STATUS_NO_SESSION:
@@ -8,6 +8,7 @@
 
 #include "lt_l3_process.h"
 
+#include <inttypes.h>
 #include <limits.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -16,6 +17,7 @@
 #include "libtropic_common.h"
 #include "libtropic_l2.h"
 #include "libtropic_logging.h"
+#include "libtropic_macros.h"
 #include "lt_aesgcm.h"
 #include "lt_crypto_common.h"
 #include "lt_l1.h"
@@ -44,6 +46,89 @@ static lt_ret_t lt_l3_nonce_increase(uint8_t *nonce)
     return LT_OK;
 }
 
+lt_ret_t lt_l3_check_buff_len(const lt_l3_state_t *s3, const uint16_t cmd_size, const uint16_t res_size_max)
+{
+    uint16_t size_max = cmd_size > res_size_max ? cmd_size : res_size_max;
+
+    if ((uint32_t)TR01_L3_SIZE_SIZE + size_max + TR01_L3_TAG_SIZE > s3->buff_len) {
+        LT_LOG_ERROR("L3 packet of %" PRIu16 " B does not fit L3 buffer of %" PRIu16 " B",
+                     (uint16_t)(TR01_L3_SIZE_SIZE + size_max + TR01_L3_TAG_SIZE), s3->buff_len);
+        return LT_L3_BUFFER_TOO_SMALL;
+    }
+
+    return LT_OK;
+}
+
+/** @brief Translates RESULT field of L3 result to lt_ret_t. */
+static lt_ret_t lt_l3_result_to_ret(const uint8_t result)
+{
+    switch (result) {
+        case TR01_L3_RESULT_FAIL:
+            return LT_L3_FAIL;
+        case TR01_L3_RESULT_UNAUTHORIZED:
+            return LT_L3_UNAUTHORIZED;
+        case TR01_L3_RESULT_INVALID_CMD:
+            return LT_L3_INVALID_CMD;
+        case TR01_L3_RESULT_OK:
+            return LT_OK;
+        case TR01_L3_RESULT_SLOT_EMPTY:
+            return LT_L3_SLOT_EMPTY;
+        case TR01_L3_RESULT_SLOT_INVALID:
+            return LT_L3_SLOT_INVALID;
+        case TR01_L3_RESULT_INVALID_KEY:
+            return LT_L3_INVALID_KEY;
+        case TR01_L3_RESULT_SLOT_NOT_EMPTY:
+            return LT_L3_SLOT_NOT_EMPTY;
+        case TR01_L3_RESULT_SLOT_EXPIRED:
+            return LT_L3_SLOT_EXPIRED;
+        case TR01_L3_RESULT_UPDATE_ERR:
+            return LT_L3_UPDATE_ERR;
+        case TR01_L3_RESULT_COUNTER_INVALID:
+            return LT_L3_COUNTER_INVALID;
+        case TR01_L3_RESULT_HARDWARE_FAIL:
+            return LT_L3_HARDWARE_FAIL;
+        default:
+            return LT_L3_RESULT_UNKNOWN;
+    }
+}
+
+#if LT_L3_BUFF_POOL
+lt_ret_t lt_l3_buff_lease(lt_l3_state_t *s3)
+{
+    lt_l3_buff_pool_t *pool = s3->pool;
+
+    // A buffer leased by a command which failed before its lt_in__*() is reused.
+    if (!pool || s3->buff) {
+        return LT_OK;
+    }
+
+    for (uint8_t i = 0; i < pool->count; i++) {
+        uint32_t bit = UINT32_C(1) << i;
+        if (!(__atomic_fetch_or(&pool->in_use, bit, __ATOMIC_ACQUIRE) & bit)) {
+            s3->buff = pool->buffs + (size_t)i * pool->buff_len;
+            return LT_OK;
+        }
+    }
+
+    return LT_L3_BUFF_POOL_EMPTY;
+}
+
+void lt_l3_buff_release(lt_l3_state_t *s3)
+{
+    lt_l3_buff_pool_t *pool = s3->pool;
+
+    if (!pool || !s3->buff) {
+        return;
+    }
+
+    uint32_t bit = UINT32_C(1) << ((size_t)(s3->buff - pool->buffs) / pool->buff_len);
+
+    lt_secure_memzero(s3->buff, pool->buff_len);
+    s3->buff = NULL;
+    __atomic_fetch_and(&pool->in_use, ~bit, __ATOMIC_RELEASE);
+}
+#endif
+
 void lt_l3_invalidate_host_session_data(lt_l3_state_t *s3)
 {
     s3->session_status = LT_SECURE_SESSION_OFF;
@@ -56,6 +141,22 @@ void lt_l3_invalidate_host_session_data(lt_l3_state_t *s3)
         LT_LOG_ERROR("lt_crypto_ctx_deinit() failed, ret=%d", ret);
     }
 
+#if LT_L3_STREAM_DECRYPT
+    s3->res_decrypted = false;
+#endif
+#if LT_R_MEM_CACHE
+    // Lines not yet written are lost, lt_session_abort() and lt_deinit() write them before.
+    if (s3->r_mem_cache) {
+        lt_secure_memzero(s3->r_mem_cache->lines, s3->r_mem_cache->count * sizeof(lt_r_mem_cache_line_t));
+        s3->r_mem_cache->tick = 0;
+    }
+#endif
+#if LT_L3_BUFF_POOL
+    if (s3->pool) {
+        lt_l3_buff_release(s3);
+        return;
+    }
+#endif
 #if LT_SEPARATE_L3_BUFF
     lt_secure_memzero(s3->buff, s3->buff_len);
 #else
@@ -70,22 +171,37 @@ lt_ret_t lt_l3_encrypt_request(lt_l3_state_t *s3)
         return LT_PARAM_ERR;
     }
 #endif
+    lt_ret_t ret;
+
+#if LT_L3_STREAM_DECRYPT
+    // The buffer is about to hold a new request, a response of a previous one which was never processed is gone.
+    s3->res_decrypted = false;
+#endif
+
     if (s3->session_status != LT_SECURE_SESSION_ON) {
-        return LT_HOST_NO_SESSION;
+        ret = LT_HOST_NO_SESSION;
+        goto exit;
     }
 
     struct lt_l3_gen_frame_t *p_frame = (struct lt_l3_gen_frame_t *)s3->buff;
 
     // p_frame->data is both input plaintext and output ciphertext buffer,
     // it is large enough to hold both plaintext and ciphertext + tag.
-    int ret = lt_aesgcm_encrypt(s3->crypto_ctx, s3->encryption_IV, TR01_L3_IV_SIZE, (uint8_t *)"", 0, p_frame->data,
-                                p_frame->cmd_size, p_frame->data, p_frame->cmd_size + TR01_L3_TAG_SIZE);
+    ret = lt_aesgcm_encrypt(s3->crypto_ctx, s3->encryption_IV, TR01_L3_IV_SIZE, (uint8_t *)"", 0, p_frame->data,
+                            p_frame->cmd_size, p_frame->data, p_frame->cmd_size + TR01_L3_TAG_SIZE);
     if (ret != LT_OK) {
         lt_l3_invalidate_host_session_data(s3);
-        return ret;
+        goto exit;
     }
 
-    return lt_l3_nonce_increase(s3->encryption_IV);
+    ret = lt_l3_nonce_increase(s3->encryption_IV);
+
+exit:
+    // Every lt_out__*() ends here after leasing the buffer, release it if the command is not going to be sent.
+    if (ret != LT_OK) {
+        lt_l3_buff_release(s3);
+    }
+    return ret;
 }
 
 lt_ret_t lt_l3_decrypt_response(lt_l3_state_t *s3)
@@ -101,6 +217,14 @@ lt_ret_t lt_l3_decrypt_response(lt_l3_state_t *s3)
 
     struct lt_l3_gen_frame_t *p_frame = (struct lt_l3_gen_frame_t *)s3->buff;
 
+#if LT_L3_STREAM_DECRYPT
+    // Already decrypted and verified by lt_l3_recv_response() while receiving.
+    if (s3->res_decrypted) {
+        s3->res_decrypted = false;
+        return lt_l3_result_to_ret(p_frame->data[0]);
+    }
+#endif
+
     if (p_frame->cmd_size > TR01_L3_RES_CIPHERTEXT_MAX_SIZE) {
         lt_l3_invalidate_host_session_data(s3);
         return LT_L3_RES_SIZE_ERROR;
@@ -125,32 +249,141 @@ lt_ret_t lt_l3_decrypt_response(lt_l3_state_t *s3)
         return ret;
     }
 
-    switch (p_frame->data[0]) {
-        case TR01_L3_RESULT_FAIL:
-            return LT_L3_FAIL;
-        case TR01_L3_RESULT_UNAUTHORIZED:
-            return LT_L3_UNAUTHORIZED;
-        case TR01_L3_RESULT_INVALID_CMD:
-            return LT_L3_INVALID_CMD;
-        case TR01_L3_RESULT_OK:
-            return LT_OK;
-        case TR01_L3_RESULT_SLOT_EMPTY:
-            return LT_L3_SLOT_EMPTY;
-        case TR01_L3_RESULT_SLOT_INVALID:
-            return LT_L3_SLOT_INVALID;
-        case TR01_L3_RESULT_INVALID_KEY:
-            return LT_L3_INVALID_KEY;
-        case TR01_L3_RESULT_SLOT_NOT_EMPTY:
-            return LT_L3_SLOT_NOT_EMPTY;
-        case TR01_L3_RESULT_SLOT_EXPIRED:
-            return LT_L3_SLOT_EXPIRED;
-        case TR01_L3_RESULT_UPDATE_ERR:
-            return LT_L3_UPDATE_ERR;
-        case TR01_L3_RESULT_COUNTER_INVALID:
-            return LT_L3_COUNTER_INVALID;
-        case TR01_L3_RESULT_HARDWARE_FAIL:
-            return LT_L3_HARDWARE_FAIL;
-        default:
-            return LT_L3_RESULT_UNKNOWN;
+    return lt_l3_result_to_ret(p_frame->data[0]);
+}
+
+#if LT_L3_STREAM_DECRYPT
+/** @brief State of L3 response decrypted while its chunks arrive. */
+struct lt_l3_stream_t {
+    lt_l3_state_t *s3;
+    /** Bytes of the L3 packet received so far. */
+    uint16_t received;
+    /** Bytes of plaintext stored into the L3 buffer. */
+    uint16_t stored;
+    /** The error breaks the session. */
+    bool fatal;
+    /** Tag following the ciphertext. */
+    uint8_t tag[TR01_L3_TAG_SIZE];
+};
+
+/** @brief Decrypts chunk of L3 response into the L3 buffer, see lt_l2_chunk_cb_t. */
+static lt_ret_t lt_l3_stream_chunk(void *cb_ctx, const uint8_t *chunk, const uint16_t chunk_len)
+{
+    struct lt_l3_stream_t *st = (struct lt_l3_stream_t *)cb_ctx;
+    lt_l3_state_t *s3 = st->s3;
+    struct lt_l3_gen_frame_t *p_frame = (struct lt_l3_gen_frame_t *)s3->buff;
+    lt_ret_t ret;
+    uint16_t pos = 0;
+
+    while (pos < chunk_len) {
+        uint16_t left = chunk_len - pos;
+        uint16_t n;
+
+        if (st->received < TR01_L3_SIZE_SIZE) {
+            // RES_SIZE is not encrypted, it may be split between two chunks.
+            n = lt_min(left, (uint16_t)(TR01_L3_SIZE_SIZE - st->received));
+            memcpy(s3->buff + st->received, chunk + pos, n);
+
+            if (st->received + n == TR01_L3_SIZE_SIZE) {
+                if (p_frame->cmd_size > TR01_L3_RES_CIPHERTEXT_MAX_SIZE) {
+                    st->fatal = true;
+                    return LT_L3_RES_SIZE_ERROR;
+                }
+                // Same bound as in lt_l3_decrypt_response(), the output may lag by an AES block into the tag space.
+                if (TR01_L3_SIZE_SIZE + p_frame->cmd_size + TR01_L3_TAG_SIZE > s3->buff_len) {
+                    st->fatal = true;
+                    return LT_L3_BUFFER_TOO_SMALL;
+                }
+                ret = lt_aesgcm_decrypt_start(s3->crypto_ctx, s3->decryption_IV, TR01_L3_IV_SIZE, (uint8_t *)"", 0);
+                if (ret != LT_OK) {
+                    st->fatal = true;
+                    return ret;
+                }
+            }
+        }
+        else if (st->received < TR01_L3_SIZE_SIZE + p_frame->cmd_size) {
+            uint32_t stored;
+
+            n = lt_min(left, (uint16_t)(TR01_L3_SIZE_SIZE + p_frame->cmd_size - st->received));
+            ret = lt_aesgcm_decrypt_update(s3->crypto_ctx, chunk + pos, n, p_frame->data + st->stored,
+                                           s3->buff_len - TR01_L3_SIZE_SIZE - st->stored, &stored);
+            if (ret != LT_OK) {
+                st->fatal = true;
+                return ret;
+            }
+            st->stored += stored;
+        }
+        else {
+            uint16_t tag_pos = st->received - TR01_L3_SIZE_SIZE - p_frame->cmd_size;
+
+            if (tag_pos + left > TR01_L3_TAG_SIZE) {
+                st->fatal = true;
+                return LT_L3_RES_SIZE_ERROR;
+            }
+            n = left;
+            memcpy(st->tag + tag_pos, chunk + pos, n);
+        }
+
+        pos += n;
+        st->received += n;
+    }
+
+    return LT_OK;
+}
+#endif
+
+lt_ret_t lt_l3_recv_response(lt_l2_state_t *s2, lt_l3_state_t *s3, const uint16_t max_len)
+{
+#if LT_L3_STREAM_DECRYPT
+#ifdef LT_REDUNDANT_ARG_CHECK
+    if (!s2 || !s3) {
+        return LT_PARAM_ERR;
+    }
+#endif
+    if (s3->session_status != LT_SECURE_SESSION_ON) {
+        return LT_HOST_NO_SESSION;
     }
+
+    struct lt_l3_gen_frame_t *p_frame = (struct lt_l3_gen_frame_t *)s3->buff;
+    struct lt_l3_stream_t st = {.s3 = s3, .received = 0, .stored = 0, .fatal = false};
+
+    s3->res_decrypted = false;
+
+    lt_ret_t ret = lt_l2_recv_encrypted_res_chunks(s2, max_len, lt_l3_stream_chunk, &st);
+    if (ret == LT_OK
+        && (st.received < TR01_L3_SIZE_SIZE
+            || st.received != TR01_L3_SIZE_SIZE + p_frame->cmd_size + TR01_L3_TAG_SIZE)) {
+        st.fatal = true;
+        ret = LT_L3_RES_SIZE_ERROR;
+    }
+    if (ret == LT_OK) {
+        uint32_t stored;
+
+        ret = lt_aesgcm_decrypt_finish(s3->crypto_ctx, st.tag, TR01_L3_TAG_SIZE, p_frame->data + st.stored,
+                                       s3->buff_len - TR01_L3_SIZE_SIZE - st.stored, &stored);
+        st.fatal = (ret != LT_OK);
+    }
+
+    if (ret != LT_OK) {
+        // Never leave unauthenticated plaintext behind.
+        if (st.fatal) {
+            lt_l3_invalidate_host_session_data(s3);
+        }
+        else {
+            lt_secure_memzero(s3->buff, s3->buff_len);
+        }
+        return ret;
+    }
+
+    ret = lt_l3_nonce_increase(s3->decryption_IV);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    s3->res_decrypted = true;
+
+    return LT_OK;
+#else
+    return lt_l2_recv_encrypted_res(s2, s3->buff, max_len);
+#endif
 }
@@ -62,7 +62,8 @@ extern "C" {
 
 /**
  * @brief Encrypts content of L3 buffer and fills it with cyphertext ready to be sent to TROPIC01.
- * @note This function expects that L3 buffer is already filled with data to be sent.
+ * @note This function expects that L3 buffer is already filled with data to be sent. On failure, the L3 buffer leased
+ *       from `LT_L3_BUFF_POOL` is released.
  *
  * @param s3          Structure holding l3 state
  *
@@ -71,6 +72,21 @@ extern "C" {
  */
 lt_ret_t lt_l3_encrypt_request(lt_l3_state_t *s3) __attribute__((warn_unused_result));
 
+/**
+ * @brief Receives L3 response from TROPIC01 into L3 buffer.
+ *
+ * With `LT_L3_STREAM_DECRYPT` each L2 chunk is decrypted as it arrives and the tag is verified after the last one,
+ * `lt_l3_decrypt_response()` then only checks the result. Otherwise the response is stored encrypted, as by
+ * `lt_l2_recv_encrypted_res()`.
+ *
+ * @param s2          Structure holding l2 state
+ * @param s3          Structure holding l3 state
+ * @param max_len     Maximal length of the L3 packet
+ * @return            LT_OK if success, otherwise returns other error code.
+ */
+lt_ret_t lt_l3_recv_response(lt_l2_state_t *s2, lt_l3_state_t *s3, const uint16_t max_len)
+    __attribute__((warn_unused_result));
+
 /**
  * @brief Decrypts response from TROPIC01 and fills L3 buffer with decrypted data.
  * @note This function is used after encrypted l3 payload was received from TROPIC01.
@@ -81,7 +97,40 @@ lt_ret_t lt_l3_encrypt_request(lt_l3_state_t *s3) __attribute__((warn_unused_res
 lt_ret_t lt_l3_decrypt_response(lt_l3_state_t *s3) __attribute__((warn_unused_result));
 
 /**
- * @brief Invalidates host's session data
+ * @brief Checks that L3 buffer can hold both the command and the largest result it may get.
+ * @note Called before filling the buffer with commands of variable size, so a too small buffer is refused before
+ *       anything is sent and the session stays usable.
+ *
+ * @param s3            Structure holding l3 state
+ * @param cmd_size      Size of the command (value of its CMD_SIZE field)
+ * @param res_size_max  Largest size of the result (value of its RES_SIZE field)
+ * @return              LT_OK if both fit, LT_L3_BUFFER_TOO_SMALL otherwise.
+ */
+lt_ret_t lt_l3_check_buff_len(const lt_l3_state_t *s3, const uint16_t cmd_size, const uint16_t res_size_max)
+    __attribute__((warn_unused_result));
+
+#if LT_L3_BUFF_POOL
+/**
+ * @brief Leases L3 buffer from the pool, if the handle uses one and does not hold a buffer already.
+ *
+ * @param s3          Structure holding l3 state
+ * @return            LT_OK if success, LT_L3_BUFF_POOL_EMPTY if all buffers are leased.
+ */
+lt_ret_t lt_l3_buff_lease(lt_l3_state_t *s3) __attribute__((warn_unused_result));
+
+/**
+ * @brief Zeroes the leased L3 buffer and returns it to the pool. Does nothing if no buffer is leased.
+ *
+ * @param s3          Structure holding l3 state
+ */
+void lt_l3_buff_release(lt_l3_state_t *s3);
+#else
+#define lt_l3_buff_lease(s3) ((void)(s3), LT_OK)
+#define lt_l3_buff_release(s3) ((void)(s3))
+#endif
+
+/**
+ * @brief Invalidates host's session data, zeroes the R-Memory cache and returns the leased L3 buffer, if any.
  *
  * @param s3          Structure holding l3 state
  */
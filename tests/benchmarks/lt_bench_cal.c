@@ -0,0 +1,445 @@
+/**
+ * @file lt_bench_cal.c
+ * @brief Micro-benchmark of the CAL (Crypto Abstraction Layer) primitives used by the libtropic Secure Channel.
+ *
+ * Measures AES-GCM encryption/decryption for L3 packet sizes, SHA-256, HMAC-SHA256, HKDF and X25519 and writes the
+ * results as JSON (or CSV) to stdout or to a file.
+ *
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "libtropic_common.h"
+#include "lt_aesgcm.h"
+#include "lt_bench_common.h"
+#include "lt_crypto_common.h"
+#include "lt_hkdf.h"
+#include "lt_hmac_sha256.h"
+#include "lt_l3_api_structs.h"
+#include "lt_sha256.h"
+#include "lt_x25519.h"
+#if LT_USE_TREZOR_CRYPTO
+#include "libtropic_trezor_crypto.h"
+#define LT_BENCH_CAL_NAME "trezor_crypto"
+#elif LT_USE_MBEDTLS_V4
+#include "libtropic_mbedtls_v4.h"
+#include "psa/crypto.h"
+#define LT_BENCH_CAL_NAME "mbedtls_v4"
+#else
+#error "No CAL selected for the benchmark (define LT_USE_TREZOR_CRYPTO=1 or LT_USE_MBEDTLS_V4=1)."
+#endif
+
+/** @brief Default number of measured iterations per operation. */
+#define LT_BENCH_CAL_ITERATIONS_DEFAULT 1000
+/** @brief Number of unmeasured iterations executed before each measurement. */
+#define LT_BENCH_CAL_WARMUP_ITERATIONS 16
+
+/**
+ * @brief L3 plaintext sizes for which AES-GCM is measured.
+ *
+ * Covers the smallest L3 results, the typical fixed-size commands/results, the L2 chunk boundary (an L3 packet
+ * larger than one chunk is split into multiple L2 frames) and the largest command and result.
+ */
+static const uint32_t lt_bench_cal_l3_sizes[] = {
+    TR01_L3_RESULT_SIZE,                 // Bare result (e.g. R_Mem_Data_Write, ECC_Key_Erase)
+    TR01_L3_R_MEM_DATA_READ_CMD_SIZE,    // Smallest slot-addressed commands
+    TR01_L3_R_CONFIG_READ_RES_SIZE,      // Config read results, MCounter_Get result
+    TR01_L3_PAIRING_KEY_WRITE_CMD_SIZE,  // Pairing_Key_Write, MAC_And_Destroy
+    TR01_L3_ECDSA_SIGN_CMD_SIZE,         // ECDSA_Sign, ECC_Key_Store
+    TR01_L3_ECDSA_SIGN_RES_SIZE,         // ECDSA/EdDSA signature results
+    TR01_L2_CHUNK_MAX_DATA_SIZE - TR01_L3_SIZE_SIZE - TR01_L3_TAG_SIZE,  // Largest packet fitting one L2 chunk
+    TR01_L2_CHUNK_MAX_DATA_SIZE,                                         // First packet spilling into 2 chunks
+    512,
+    1024,
+    2048,
+    TR01_L3_RES_CIPHERTEXT_MAX_SIZE,  // Largest result (Ping, Random_Value_Get)
+    TR01_L3_CMD_CIPHERTEXT_MAX_SIZE,  // Largest command (Ping)
+};
+
+/** @brief Input sizes for SHA-256 and HMAC-SHA256. The 32 B ones match the handshake transcript hashing. */
+static const uint32_t lt_bench_cal_hash_sizes[] = {1, 32, 64, 256, 1024, TR01_L3_CMD_CIPHERTEXT_MAX_SIZE};
+
+/** @brief Benchmark configuration parsed from the command line. */
+typedef struct lt_bench_cal_cfg_t {
+    size_t iterations;
+    lt_bench_report_t report;
+} lt_bench_cal_cfg_t;
+
+/** @brief Buffers are static so large L3 sizes do not need to live on the stack. */
+static uint8_t lt_bench_cal_plaintext[TR01_L3_CIPHERTEXT_MAX_SIZE];
+static uint8_t lt_bench_cal_ciphertext[TR01_L3_CIPHERTEXT_MAX_SIZE + TR01_L3_TAG_SIZE];
+// Room for the tag too, as decryption in parts may store plaintext up to one AES block later.
+static uint8_t lt_bench_cal_decrypted[TR01_L3_CIPHERTEXT_MAX_SIZE + TR01_L3_TAG_SIZE];
+
+static void lt_bench_cal_fill(uint8_t *buff, const size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        buff[i] = (uint8_t)rand();
+    }
+}
+
+static lt_ret_t lt_bench_cal_aesgcm(void *ctx, lt_bench_cal_cfg_t *cfg, uint64_t *samples)
+{
+    uint8_t key[32], iv[TR01_L3_IV_SIZE] = {0};
+    lt_bench_stats_t stats;
+    lt_ret_t ret;
+
+    lt_bench_cal_fill(key, sizeof(key));
+    ret = lt_aesgcm_encrypt_init(ctx, key, sizeof(key));
+    if (ret != LT_OK) {
+        return ret;
+    }
+    ret = lt_aesgcm_decrypt_init(ctx, key, sizeof(key));
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    for (size_t s = 0; s < sizeof(lt_bench_cal_l3_sizes) / sizeof(lt_bench_cal_l3_sizes[0]); s++) {
+        const uint32_t len = lt_bench_cal_l3_sizes[s];
+        lt_bench_cal_fill(lt_bench_cal_plaintext, len);
+
+        // Encryption
+        for (size_t i = 0; i < LT_BENCH_CAL_WARMUP_ITERATIONS + cfg->iterations; i++) {
+            const uint64_t start = lt_bench_now_ns();
+            ret = lt_aesgcm_encrypt(ctx, iv, sizeof(iv), (const uint8_t *)"", 0, lt_bench_cal_plaintext, len,
+                                    lt_bench_cal_ciphertext, len + TR01_L3_TAG_SIZE);
+            const uint64_t end = lt_bench_now_ns();
+            if (ret != LT_OK) {
+                return ret;
+            }
+            if (i >= LT_BENCH_CAL_WARMUP_ITERATIONS) {
+                samples[i - LT_BENCH_CAL_WARMUP_ITERATIONS] = end - start;
+            }
+        }
+        lt_bench_stats_compute(samples, cfg->iterations, &stats);
+        lt_bench_report_result(&cfg->report, "aesgcm_encrypt", len, &stats);
+
+        // Decryption (the same IV is reused on purpose, so every iteration authenticates the same ciphertext)
+        for (size_t i = 0; i < LT_BENCH_CAL_WARMUP_ITERATIONS + cfg->iterations; i++) {
+            const uint64_t start = lt_bench_now_ns();
+            ret = lt_aesgcm_decrypt(ctx, iv, sizeof(iv), (const uint8_t *)"", 0, lt_bench_cal_ciphertext,
+                                    len + TR01_L3_TAG_SIZE, lt_bench_cal_decrypted, len);
+            const uint64_t end = lt_bench_now_ns();
+            if (ret != LT_OK) {
+                return ret;
+            }
+            if (i >= LT_BENCH_CAL_WARMUP_ITERATIONS) {
+                samples[i - LT_BENCH_CAL_WARMUP_ITERATIONS] = end - start;
+            }
+        }
+        if (memcmp(lt_bench_cal_plaintext, lt_bench_cal_decrypted, len) != 0) {
+            fprintf(stderr, "AES-GCM round trip mismatch for size %" PRIu32 "!\n", len);
+            return LT_FAIL;
+        }
+        lt_bench_stats_compute(samples, cfg->iterations, &stats);
+        lt_bench_report_result(&cfg->report, "aesgcm_decrypt", len, &stats);
+
+#if LT_USE_TREZOR_CRYPTO
+        // Decryption in L2 chunk sized parts, as done with LT_L3_STREAM_DECRYPT (only trezor_crypto supports it)
+        memset(lt_bench_cal_decrypted, 0, len);
+        for (size_t i = 0; i < LT_BENCH_CAL_WARMUP_ITERATIONS + cfg->iterations; i++) {
+            uint32_t done = 0, stored = 0, part_stored;
+            const uint64_t start = lt_bench_now_ns();
+            ret = lt_aesgcm_decrypt_start(ctx, iv, sizeof(iv), (const uint8_t *)"", 0);
+            while (ret == LT_OK && done < len) {
+                const uint32_t part = lt_min(len - done, (uint32_t)TR01_L2_CHUNK_MAX_DATA_SIZE);
+                ret = lt_aesgcm_decrypt_update(ctx, lt_bench_cal_ciphertext + done, part,
+                                               lt_bench_cal_decrypted + stored,
+                                               sizeof(lt_bench_cal_decrypted) - stored, &part_stored);
+                done += part;
+                stored += part_stored;
+            }
+            if (ret == LT_OK) {
+                ret = lt_aesgcm_decrypt_finish(ctx, lt_bench_cal_ciphertext + len, TR01_L3_TAG_SIZE,
+                                               lt_bench_cal_decrypted + stored,
+                                               sizeof(lt_bench_cal_decrypted) - stored, &part_stored);
+            }
+            const uint64_t end = lt_bench_now_ns();
+            if (ret != LT_OK) {
+                return ret;
+            }
+            if (i >= LT_BENCH_CAL_WARMUP_ITERATIONS) {
+                samples[i - LT_BENCH_CAL_WARMUP_ITERATIONS] = end - start;
+            }
+        }
+        if (memcmp(lt_bench_cal_plaintext, lt_bench_cal_decrypted, len) != 0) {
+            fprintf(stderr, "AES-GCM round trip in parts mismatch for size %" PRIu32 "!\n", len);
+            return LT_FAIL;
+        }
+        lt_bench_stats_compute(samples, cfg->iterations, &stats);
+        lt_bench_report_result(&cfg->report, "aesgcm_decrypt_chunked", len, &stats);
+#endif
+    }
+
+    ret = lt_aesgcm_encrypt_deinit(ctx);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    return lt_aesgcm_decrypt_deinit(ctx);
+}
+
+static lt_ret_t lt_bench_cal_sha256(void *ctx, lt_bench_cal_cfg_t *cfg, uint64_t *samples)
+{
+    uint8_t digest[LT_SHA256_DIGEST_LENGTH];
+    lt_bench_stats_t stats;
+    lt_ret_t ret;
+
+    ret = lt_sha256_init(ctx);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    for (size_t s = 0; s < sizeof(lt_bench_cal_hash_sizes) / sizeof(lt_bench_cal_hash_sizes[0]); s++) {
+        const uint32_t len = lt_bench_cal_hash_sizes[s];
+        lt_bench_cal_fill(lt_bench_cal_plaintext, len);
+
+        // Measures the whole start/update/finish sequence, as used in lt_in__session_start().
+        for (size_t i = 0; i < LT_BENCH_CAL_WARMUP_ITERATIONS + cfg->iterations; i++) {
+            const uint64_t start = lt_bench_now_ns();
+            ret = lt_sha256_start(ctx);
+            if (ret == LT_OK) {
+                ret = lt_sha256_update(ctx, lt_bench_cal_plaintext, len);
+            }
+            if (ret == LT_OK) {
+                ret = lt_sha256_finish(ctx, digest);
+            }
+            const uint64_t end = lt_bench_now_ns();
+            if (ret != LT_OK) {
+                return ret;
+            }
+            if (i >= LT_BENCH_CAL_WARMUP_ITERATIONS) {
+                samples[i - LT_BENCH_CAL_WARMUP_ITERATIONS] = end - start;
+            }
+        }
+        lt_bench_stats_compute(samples, cfg->iterations, &stats);
+        lt_bench_report_result(&cfg->report, "sha256", len, &stats);
+    }
+
+    return LT_OK;
+}
+
+static lt_ret_t lt_bench_cal_hmac_sha256(lt_bench_cal_cfg_t *cfg, uint64_t *samples)
+{
+    uint8_t key[LT_HMAC_SHA256_HASH_LEN], out[LT_HMAC_SHA256_HASH_LEN];
+    lt_bench_stats_t stats;
+    lt_ret_t ret;
+
+    lt_bench_cal_fill(key, sizeof(key));
+
+    for (size_t s = 0; s < sizeof(lt_bench_cal_hash_sizes) / sizeof(lt_bench_cal_hash_sizes[0]); s++) {
+        const uint32_t len = lt_bench_cal_hash_sizes[s];
+        lt_bench_cal_fill(lt_bench_cal_plaintext, len);
+
+        for (size_t i = 0; i < LT_BENCH_CAL_WARMUP_ITERATIONS + cfg->iterations; i++) {
+            const uint64_t start = lt_bench_now_ns();
+            ret = lt_hmac_sha256(key, sizeof(key), lt_bench_cal_plaintext, len, out);
+            const uint64_t end = lt_bench_now_ns();
+            if (ret != LT_OK) {
+                return ret;
+            }
+            if (i >= LT_BENCH_CAL_WARMUP_ITERATIONS) {
+                samples[i - LT_BENCH_CAL_WARMUP_ITERATIONS] = end - start;
+            }
+        }
+        lt_bench_stats_compute(samples, cfg->iterations, &stats);
+        lt_bench_report_result(&cfg->report, "hmac_sha256", len, &stats);
+    }
+
+    return LT_OK;
+}
+
+static lt_ret_t lt_bench_cal_hkdf(lt_bench_cal_cfg_t *cfg, uint64_t *samples)
+{
+    uint8_t ck[32], input[TR01_X25519_KEY_LEN], out1[33], out2[32];
+    lt_bench_stats_t stats;
+    lt_ret_t ret;
+
+    lt_bench_cal_fill(ck, sizeof(ck));
+    lt_bench_cal_fill(input, sizeof(input));
+
+    // The handshake calls HKDF with one output (ck derivation) and with two outputs (kcmd/kres derivation).
+    for (uint8_t nouts = 1; nouts <= 2; nouts++) {
+        for (size_t i = 0; i < LT_BENCH_CAL_WARMUP_ITERATIONS + cfg->iterations; i++) {
+            const uint64_t start = lt_bench_now_ns();
+            ret = lt_hkdf(ck, sizeof(ck), input, sizeof(input), nouts, out1, out2);
+            const uint64_t end = lt_bench_now_ns();
+            if (ret != LT_OK) {
+                return ret;
+            }
+            if (i >= LT_BENCH_CAL_WARMUP_ITERATIONS) {
+                samples[i - LT_BENCH_CAL_WARMUP_ITERATIONS] = end - start;
+            }
+        }
+        lt_bench_stats_compute(samples, cfg->iterations, &stats);
+        lt_bench_report_result(&cfg->report, nouts == 1 ? "hkdf_1_output" : "hkdf_2_outputs", sizeof(input),
+                               &stats);
+    }
+
+    return LT_OK;
+}
+
+static lt_ret_t lt_bench_cal_x25519(lt_bench_cal_cfg_t *cfg, uint64_t *samples)
+{
+    uint8_t priv[TR01_X25519_KEY_LEN], pub[TR01_X25519_KEY_LEN], peer_pub[TR01_X25519_KEY_LEN],
+        secret[TR01_X25519_KEY_LEN];
+    lt_bench_stats_t stats;
+    lt_ret_t ret;
+
+    lt_bench_cal_fill(priv, sizeof(priv));
+    lt_bench_cal_fill(peer_pub, sizeof(peer_pub));
+
+    for (size_t i = 0; i < LT_BENCH_CAL_WARMUP_ITERATIONS + cfg->iterations; i++) {
+        const uint64_t start = lt_bench_now_ns();
+        ret = lt_X25519_scalarmult(priv, pub);
+        const uint64_t end = lt_bench_now_ns();
+        if (ret != LT_OK) {
+            return ret;
+        }
+        if (i >= LT_BENCH_CAL_WARMUP_ITERATIONS) {
+            samples[i - LT_BENCH_CAL_WARMUP_ITERATIONS] = end - start;
+        }
+    }
+    lt_bench_stats_compute(samples, cfg->iterations, &stats);
+    lt_bench_report_result(&cfg->report, "x25519_scalarmult", 0, &stats);
+
+    for (size_t i = 0; i < LT_BENCH_CAL_WARMUP_ITERATIONS + cfg->iterations; i++) {
+        const uint64_t start = lt_bench_now_ns();
+        ret = lt_X25519(priv, peer_pub, secret);
+        const uint64_t end = lt_bench_now_ns();
+        if (ret != LT_OK) {
+            return ret;
+        }
+        if (i >= LT_BENCH_CAL_WARMUP_ITERATIONS) {
+            samples[i - LT_BENCH_CAL_WARMUP_ITERATIONS] = end - start;
+        }
+    }
+    lt_bench_stats_compute(samples, cfg->iterations, &stats);
+    lt_bench_report_result(&cfg->report, "x25519", 0, &stats);
+
+    return LT_OK;
+}
+
+static void lt_bench_cal_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [-n iterations] [-f json|csv] [-o output_file]\n"
+            "  -n  Number of measured iterations per operation (default %d).\n"
+            "  -f  Output format (default json).\n"
+            "  -o  Output file (default stdout).\n",
+            prog, LT_BENCH_CAL_ITERATIONS_DEFAULT);
+}
+
+int main(int argc, char *argv[])
+{
+    lt_bench_cal_cfg_t cfg = {.iterations = LT_BENCH_CAL_ITERATIONS_DEFAULT,
+                              .report = {.out = stdout, .fmt = LT_BENCH_FMT_JSON}};
+    const char *out_path = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:f:o:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                cfg.iterations = strtoul(optarg, NULL, 10);
+                break;
+            case 'f':
+                if (strcmp(optarg, "csv") == 0) {
+                    cfg.report.fmt = LT_BENCH_FMT_CSV;
+                }
+                else if (strcmp(optarg, "json") != 0) {
+                    lt_bench_cal_usage(argv[0]);
+                    return 1;
+                }
+                break;
+            case 'o':
+                out_path = optarg;
+                break;
+            default:
+                lt_bench_cal_usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (cfg.iterations == 0) {
+        lt_bench_cal_usage(argv[0]);
+        return 1;
+    }
+
+#if LT_USE_MBEDTLS_V4
+    psa_status_t status = psa_crypto_init();
+    if (status != PSA_SUCCESS) {
+        fprintf(stderr, "PSA Crypto initialization failed, status=%" PRId32 " (psa_status_t)\n", status);
+        return 1;
+    }
+#endif
+
+#if LT_USE_TREZOR_CRYPTO
+    lt_ctx_trezor_crypto_t
+#elif LT_USE_MBEDTLS_V4
+    lt_ctx_mbedtls_v4_t
+#endif
+        crypto_ctx;
+    memset(&crypto_ctx, 0, sizeof(crypto_ctx));
+
+    uint64_t *samples = malloc(cfg.iterations * sizeof(uint64_t));
+    if (!samples) {
+        fprintf(stderr, "Cannot allocate %zu samples!\n", cfg.iterations);
+        return 1;
+    }
+
+    if (out_path) {
+        cfg.report.out = fopen(out_path, "w");
+        if (!cfg.report.out) {
+            fprintf(stderr, "Cannot open '%s' for writing!\n", out_path);
+            free(samples);
+            return 1;
+        }
+    }
+
+    // Fixed seed, so the measured inputs are the same across runs.
+    srand(0);
+
+    lt_ret_t ret = lt_crypto_ctx_init(&crypto_ctx);
+    if (ret == LT_OK) {
+        lt_bench_report_begin(&cfg.report, "cal", LT_BENCH_CAL_NAME);
+        ret = lt_bench_cal_aesgcm(&crypto_ctx, &cfg, samples);
+        if (ret == LT_OK) {
+            ret = lt_bench_cal_sha256(&crypto_ctx, &cfg, samples);
+        }
+        if (ret == LT_OK) {
+            ret = lt_bench_cal_hmac_sha256(&cfg, samples);
+        }
+        if (ret == LT_OK) {
+            ret = lt_bench_cal_hkdf(&cfg, samples);
+        }
+        if (ret == LT_OK) {
+            ret = lt_bench_cal_x25519(&cfg, samples);
+        }
+        lt_bench_report_end(&cfg.report);
+
+        lt_ret_t ret_deinit = lt_crypto_ctx_deinit(&crypto_ctx);
+        if (ret == LT_OK) {
+            ret = ret_deinit;
+        }
+    }
+
+    if (ret != LT_OK) {
+        fprintf(stderr, "CAL benchmark failed, ret=%d\n", ret);
+    }
+
+    if (out_path) {
+        fclose(cfg.report.out);
+    }
+    free(samples);
+
+#if LT_USE_MBEDTLS_V4
+    mbedtls_psa_crypto_free();
+#endif
+
+    return ret == LT_OK ? 0 : 1;
+}
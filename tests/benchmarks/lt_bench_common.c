@@ -0,0 +1,145 @@
+/**
+ * @file lt_bench_common.c
+ * @brief Timing, statistics and report helpers shared by the libtropic benchmarks.
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include "lt_bench_common.h"
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <time.h>
+
+uint64_t lt_bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static int lt_bench_cmp_u64(const void *a, const void *b)
+{
+    const uint64_t x = *(const uint64_t *)a;
+    const uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/** @brief Returns the nearest-rank percentile from sorted samples. */
+static uint64_t lt_bench_percentile(const uint64_t *sorted, const size_t count, const unsigned pct)
+{
+    size_t rank = (count * pct + 99) / 100;
+    if (rank == 0) {
+        rank = 1;
+    }
+    return sorted[rank - 1];
+}
+
+void lt_bench_stats_compute(uint64_t *samples, const size_t count, lt_bench_stats_t *stats)
+{
+    *stats = (lt_bench_stats_t){0};
+    if (!samples || count == 0) {
+        return;
+    }
+
+    qsort(samples, count, sizeof(uint64_t), lt_bench_cmp_u64);
+
+    stats->count = count;
+    for (size_t i = 0; i < count; i++) {
+        stats->total_ns += samples[i];
+    }
+    stats->min_ns = samples[0];
+    stats->max_ns = samples[count - 1];
+    stats->mean_ns = stats->total_ns / count;
+    stats->p50_ns = lt_bench_percentile(samples, count, 50);
+    stats->p90_ns = lt_bench_percentile(samples, count, 90);
+    stats->p99_ns = lt_bench_percentile(samples, count, 99);
+}
+
+double lt_bench_throughput_mbps(const lt_bench_stats_t *stats, const size_t bytes_per_op)
+{
+    if (!stats || stats->total_ns == 0 || bytes_per_op == 0) {
+        return 0.0;
+    }
+    // bytes / ns * 1e9 / 1e6 = bytes / ns * 1e3
+    return ((double)bytes_per_op * (double)stats->count * 1e3) / (double)stats->total_ns;
+}
+
+void lt_bench_report_begin(lt_bench_report_t *report, const char *bench_name, const char *backend)
+{
+    report->bench_name = bench_name;
+    report->backend = backend;
+    report->results_cnt = 0;
+
+    if (report->fmt == LT_BENCH_FMT_CSV) {
+        fprintf(report->out, "bench,backend,op,size,iterations,min_ns,p50_ns,p90_ns,p99_ns,max_ns,mean_ns,mb_per_s\n");
+        return;
+    }
+
+    fprintf(report->out, "{\n  \"bench\": \"%s\",\n  \"backend\": \"%s\",\n  \"results\": [", bench_name, backend);
+}
+
+void lt_bench_report_result(lt_bench_report_t *report, const char *op, const size_t size,
+                            const lt_bench_stats_t *stats)
+{
+    const double mbps = lt_bench_throughput_mbps(stats, size);
+
+    if (report->fmt == LT_BENCH_FMT_CSV) {
+        fprintf(report->out,
+                "%s,%s,%s,%zu,%zu,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%.3f\n",
+                report->bench_name, report->backend, op, size, stats->count, stats->min_ns, stats->p50_ns,
+                stats->p90_ns, stats->p99_ns, stats->max_ns, stats->mean_ns, mbps);
+    }
+    else {
+        fprintf(report->out,
+                "%s\n    {\"op\": \"%s\", \"size\": %zu, \"iterations\": %zu, \"min_ns\": %" PRIu64
+                ", \"p50_ns\": %" PRIu64 ", \"p90_ns\": %" PRIu64 ", \"p99_ns\": %" PRIu64 ", \"max_ns\": %" PRIu64
+                ", \"mean_ns\": %" PRIu64 ", \"mb_per_s\": %.3f}",
+                report->results_cnt ? "," : "", op, size, stats->count, stats->min_ns, stats->p50_ns, stats->p90_ns,
+                stats->p99_ns, stats->max_ns, stats->mean_ns, mbps);
+    }
+    report->results_cnt++;
+    fflush(report->out);
+}
+
+void lt_bench_report_end(lt_bench_report_t *report)
+{
+    if (report->fmt == LT_BENCH_FMT_JSON) {
+        fprintf(report->out, "\n  ]\n}\n");
+    }
+    fflush(report->out);
+}
+
+lt_ret_t lt_bench_measure(lt_bench_report_t *report, const lt_bench_op_t *op, const size_t warmup,
+                          const size_t iterations, uint64_t *samples)
+{
+    lt_bench_stats_t stats;
+    lt_ret_t ret;
+
+    for (size_t i = 0; i < warmup + iterations; i++) {
+        if (op->prepare) {
+            ret = op->prepare(op->arg);
+            if (ret != LT_OK) {
+                return ret;
+            }
+        }
+
+        const uint64_t start = lt_bench_now_ns();
+        ret = op->run(op->arg);
+        const uint64_t end = lt_bench_now_ns();
+        if (ret != LT_OK) {
+            return ret;
+        }
+
+        if (i >= warmup) {
+            samples[i - warmup] = end - start;
+        }
+    }
+
+    lt_bench_stats_compute(samples, iterations, &stats);
+    lt_bench_report_result(report, op->name, op->size, &stats);
+
+    return LT_OK;
+}
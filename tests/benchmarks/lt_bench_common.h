@@ -0,0 +1,151 @@
+#ifndef LT_BENCH_COMMON_H
+#define LT_BENCH_COMMON_H
+
+/**
+ * @file lt_bench_common.h
+ * @brief Timing, statistics and report helpers shared by the libtropic benchmarks.
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "libtropic_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Statistics computed over a set of per-iteration samples (in nanoseconds).
+ */
+typedef struct lt_bench_stats_t {
+    /** @brief Number of samples. */
+    size_t count;
+    /** @brief Sum of all samples. */
+    uint64_t total_ns;
+    /** @brief Shortest sample. */
+    uint64_t min_ns;
+    /** @brief Longest sample. */
+    uint64_t max_ns;
+    /** @brief Arithmetic mean. */
+    uint64_t mean_ns;
+    /** @brief 50th percentile (median). */
+    uint64_t p50_ns;
+    /** @brief 90th percentile. */
+    uint64_t p90_ns;
+    /** @brief 99th percentile. */
+    uint64_t p99_ns;
+} lt_bench_stats_t;
+
+/**
+ * @brief Returns a monotonic timestamp in nanoseconds.
+ *
+ * @return Current value of CLOCK_MONOTONIC in nanoseconds.
+ */
+uint64_t lt_bench_now_ns(void);
+
+/**
+ * @brief Computes statistics over the samples.
+ * @note The samples are sorted in place.
+ *
+ * @param samples  Array of per-iteration durations in nanoseconds
+ * @param count    Number of samples in the array
+ * @param stats    Output statistics
+ */
+void lt_bench_stats_compute(uint64_t *samples, const size_t count, lt_bench_stats_t *stats);
+
+/**
+ * @brief Returns throughput in MB/s (10^6 bytes per second) for given statistics.
+ *
+ * @param stats       Statistics of the measured operation
+ * @param bytes_per_op Number of bytes processed by a single operation
+ * @return            Throughput computed from the mean duration, 0 if not applicable.
+ */
+double lt_bench_throughput_mbps(const lt_bench_stats_t *stats, const size_t bytes_per_op);
+
+/**
+ * @brief Output formats of the benchmark report.
+ */
+typedef enum lt_bench_fmt_t { LT_BENCH_FMT_JSON = 0, LT_BENCH_FMT_CSV } lt_bench_fmt_t;
+
+/**
+ * @brief Report writer state.
+ */
+typedef struct lt_bench_report_t {
+    /** @brief Output stream. */
+    FILE *out;
+    /** @brief Output format. */
+    lt_bench_fmt_t fmt;
+    /** @private @brief Benchmark name, set by lt_bench_report_begin(). */
+    const char *bench_name;
+    /** @private @brief Backend name, set by lt_bench_report_begin(). */
+    const char *backend;
+    /** @brief Number of results written so far. */
+    size_t results_cnt;
+} lt_bench_report_t;
+
+/**
+ * @brief Writes the report header.
+ *
+ * @param report     Report writer state
+ * @param bench_name Name of the benchmark (e.g. "cal")
+ * @param backend    Name of the measured backend (e.g. CAL or HAL name)
+ */
+void lt_bench_report_begin(lt_bench_report_t *report, const char *bench_name, const char *backend);
+
+/**
+ * @brief Writes a single measured result into the report.
+ *
+ * @param report     Report writer state
+ * @param op         Name of the measured operation
+ * @param size       Payload size processed by a single operation in bytes (0 if not applicable)
+ * @param stats      Statistics of the operation
+ */
+void lt_bench_report_result(lt_bench_report_t *report, const char *op, const size_t size,
+                            const lt_bench_stats_t *stats);
+
+/**
+ * @brief Writes the report footer.
+ *
+ * @param report     Report writer state
+ */
+void lt_bench_report_end(lt_bench_report_t *report);
+
+/**
+ * @brief Description of a single measured operation.
+ */
+typedef struct lt_bench_op_t {
+    /** @brief Name of the operation, used in the report. */
+    const char *name;
+    /** @brief Payload size processed by a single run in bytes (0 if not applicable). */
+    size_t size;
+    /** @brief Optional callback executed (unmeasured) before every run, e.g. to erase a slot before writing. */
+    lt_ret_t (*prepare)(void *arg);
+    /** @brief Measured callback. */
+    lt_ret_t (*run)(void *arg);
+    /** @brief Argument passed to both callbacks. */
+    void *arg;
+} lt_bench_op_t;
+
+/**
+ * @brief Measures an operation and writes the result into the report.
+ *
+ * @param report      Report writer state
+ * @param op          Operation to measure
+ * @param warmup      Number of unmeasured runs executed first
+ * @param iterations  Number of measured runs
+ * @param samples     Scratch buffer for at least `iterations` samples
+ * @return            LT_OK if all runs succeeded, otherwise the first error returned by a callback.
+ */
+lt_ret_t lt_bench_measure(lt_bench_report_t *report, const lt_bench_op_t *op, const size_t warmup,
+                          const size_t iterations, uint64_t *samples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LT_BENCH_COMMON_H
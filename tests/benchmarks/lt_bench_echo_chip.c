@@ -0,0 +1,57 @@
+/**
+ * @file lt_bench_echo_chip.c
+ * @brief Stand-in chip of the transport benchmarks, which echoes L2 Requests in L2 Responses.
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include "lt_bench_echo_chip.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "libtropic_common.h"
+#include "lt_crc16.h"
+#include "lt_l1.h"
+#include "lt_l2_api_structs.h"
+#include "lt_l2_frame_check.h"
+
+lt_ret_t lt_bench_echo_chip_csn_low(void *ctx)
+{
+    lt_bench_echo_chip_t *chip = ctx;
+    chip->cursor = 0;
+    chip->first_transfer = true;
+    return LT_OK;
+}
+
+lt_ret_t lt_bench_echo_chip_spi_transfer(void *ctx, uint8_t *data, uint16_t len)
+{
+    lt_bench_echo_chip_t *chip = ctx;
+
+    if (chip->first_transfer && len >= TR01_L2_REQ_ID_SIZE + TR01_L2_REQ_RSP_LEN_SIZE
+        && data[0] != TR01_L1_GET_RESPONSE_REQ_ID) {
+        // L2 Request: prepare the response, clock out CHIP_STATUS only.
+        const uint8_t req_len = data[1];
+        if (req_len + TR01_L2_REQ_ID_SIZE + TR01_L2_REQ_RSP_LEN_SIZE > len) {
+            return LT_FAIL;
+        }
+        chip->rsp[0] = TR01_L1_CHIP_MODE_READY_bit;
+        chip->rsp[1] = TR01_L2_STATUS_REQUEST_OK;
+        chip->rsp[2] = req_len;
+        memcpy(&chip->rsp[3], &data[2], req_len);
+        add_crc(&chip->rsp[1]);
+        chip->rsp_len = 1 + TR01_L2_STATUS_SIZE + TR01_L2_REQ_RSP_LEN_SIZE + req_len + TR01_L2_REQ_RSP_CRC_SIZE;
+
+        memset(data, 0, len);
+        data[0] = TR01_L1_CHIP_MODE_READY_bit;
+    }
+    else {
+        for (uint16_t i = 0; i < len; i++) {
+            data[i] = chip->cursor < chip->rsp_len ? chip->rsp[chip->cursor++] : 0xff;
+        }
+    }
+    chip->first_transfer = false;
+
+    return LT_OK;
+}
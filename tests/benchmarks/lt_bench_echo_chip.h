@@ -0,0 +1,60 @@
+#ifndef LT_BENCH_ECHO_CHIP_H
+#define LT_BENCH_ECHO_CHIP_H
+
+/**
+ * @file lt_bench_echo_chip.h
+ * @brief Stand-in chip of the transport benchmarks, which echoes L2 Requests in L2 Responses.
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "libtropic_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Stand-in chip: answers CHIP_STATUS READY and echoes the data of the last L2 Request in an L2 Response.
+ */
+typedef struct lt_bench_echo_chip_t {
+    /** @brief CHIP_STATUS followed by the L2 Response frame. */
+    uint8_t rsp[TR01_L1_LEN_MAX];
+    /** @brief Number of valid bytes in `rsp`. */
+    uint16_t rsp_len;
+    /** @brief Next byte of `rsp` clocked out. */
+    uint16_t cursor;
+    /** @brief True for the first transfer after CSN low. */
+    bool first_transfer;
+} lt_bench_echo_chip_t;
+
+/**
+ * @brief Starts a new SPI frame (CSN low).
+ *
+ * @param ctx  Stand-in chip (`lt_bench_echo_chip_t`)
+ * @return     LT_OK
+ */
+lt_ret_t lt_bench_echo_chip_csn_low(void *ctx);
+
+/**
+ * @brief Transfers bytes within the current SPI frame.
+ *
+ * An L2 Request (first transfer of a frame not starting with Get_Response) prepares the response and clocks out
+ * CHIP_STATUS; other transfers clock out the response, then 0xFF.
+ *
+ * @param ctx   Stand-in chip (`lt_bench_echo_chip_t`)
+ * @param data  Bytes sent to the chip, replaced by the bytes received from it
+ * @param len   Number of bytes
+ * @return      LT_OK, or LT_FAIL for a malformed L2 Request.
+ */
+lt_ret_t lt_bench_echo_chip_spi_transfer(void *ctx, uint8_t *data, uint16_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LT_BENCH_ECHO_CHIP_H
@@ -0,0 +1,176 @@
+/**
+ * @file lt_bench_hex.c
+ * @brief Micro-benchmark of the hex codec used by the HALs talking to TROPIC01 over text protocols.
+ *
+ * Measures `lt_hex_encode()` and `lt_hex_decode()` against the per-byte `sprintf()`/`sscanf()` they replaced in the
+ * USB dongle HAL, for the sizes of SPI transfers done by libtropic.
+ *
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "libtropic_common.h"
+#include "libtropic_macros.h"
+#include "lt_bench_common.h"
+#include "lt_hex.h"
+
+/** @brief Default number of measured iterations per operation. */
+#define LT_BENCH_HEX_ITERATIONS_DEFAULT 100000
+/** @brief Number of unmeasured iterations executed before each measurement. */
+#define LT_BENCH_HEX_WARMUP_ITERATIONS 1000
+
+/** @brief Shared state of the measured operations. */
+static struct {
+    /** @brief Number of bytes encoded or decoded by the current operation. */
+    size_t len;
+    uint8_t bytes[TR01_L1_LEN_MAX];
+    /** @brief Hex characters of `bytes`, with space for the '\0' written by sprintf(). */
+    char hex[2 * TR01_L1_LEN_MAX + 1];
+} lt_bench;
+
+static lt_ret_t op_hex_encode(void *arg)
+{
+    LT_UNUSED(arg);
+    lt_hex_encode(lt_bench.bytes, lt_bench.len, lt_bench.hex);
+    return LT_OK;
+}
+
+static lt_ret_t op_hex_decode(void *arg)
+{
+    LT_UNUSED(arg);
+    return lt_hex_decode(lt_bench.hex, lt_bench.len, lt_bench.bytes);
+}
+
+static lt_ret_t op_sprintf_encode(void *arg)
+{
+    LT_UNUSED(arg);
+    for (size_t i = 0; i < lt_bench.len; i++) {
+        sprintf(&lt_bench.hex[i * 2], "%02" PRIX8, lt_bench.bytes[i]);
+    }
+    return LT_OK;
+}
+
+static lt_ret_t op_sscanf_decode(void *arg)
+{
+    LT_UNUSED(arg);
+    for (size_t i = 0; i < lt_bench.len; i++) {
+        if (sscanf(&lt_bench.hex[i * 2], "%02" SCNx8, &lt_bench.bytes[i]) != 1) {
+            return LT_FAIL;
+        }
+    }
+    return LT_OK;
+}
+
+static lt_ret_t lt_bench_hex_run(lt_bench_report_t *report, const size_t iterations, uint64_t *samples)
+{
+    // Single byte, CHIP_STATUS with a short L2 frame, and the largest transfer.
+    static const size_t lens[] = {1, 32, TR01_L1_LEN_MAX};
+    lt_ret_t ret;
+
+    for (size_t i = 0; i < TR01_L1_LEN_MAX; i++) {
+        lt_bench.bytes[i] = (uint8_t)(i * 151 + 7);
+    }
+    lt_hex_encode(lt_bench.bytes, TR01_L1_LEN_MAX, lt_bench.hex);
+    lt_bench.hex[2 * TR01_L1_LEN_MAX] = '\0';
+
+    for (size_t i = 0; i < sizeof(lens) / sizeof(lens[0]); i++) {
+        lt_bench.len = lens[i];
+
+        const lt_bench_op_t ops[] = {
+            {.name = "hex_encode", .size = lens[i], .run = op_hex_encode},
+            {.name = "hex_decode", .size = lens[i], .run = op_hex_decode},
+            {.name = "sprintf_encode", .size = lens[i], .run = op_sprintf_encode},
+            {.name = "sscanf_decode", .size = lens[i], .run = op_sscanf_decode},
+        };
+        for (size_t j = 0; j < sizeof(ops) / sizeof(ops[0]); j++) {
+            ret = lt_bench_measure(report, &ops[j], LT_BENCH_HEX_WARMUP_ITERATIONS, iterations, samples);
+            if (ret != LT_OK) {
+                fprintf(stderr, "Operation '%s' (size %zu) failed!\n", ops[j].name, lens[i]);
+                return ret;
+            }
+        }
+    }
+
+    return LT_OK;
+}
+
+static void lt_bench_hex_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [-n iterations] [-f json|csv] [-o output_file]\n"
+            "  -n  Number of measured iterations per operation (default %d).\n"
+            "  -f  Output format (default json).\n"
+            "  -o  Output file (default stdout).\n",
+            prog, LT_BENCH_HEX_ITERATIONS_DEFAULT);
+}
+
+int main(int argc, char *argv[])
+{
+    lt_bench_report_t report = {.out = stdout, .fmt = LT_BENCH_FMT_JSON};
+    size_t iterations = LT_BENCH_HEX_ITERATIONS_DEFAULT;
+    const char *out_path = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:f:o:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                iterations = strtoul(optarg, NULL, 10);
+                break;
+            case 'f':
+                if (strcmp(optarg, "csv") == 0) {
+                    report.fmt = LT_BENCH_FMT_CSV;
+                }
+                else if (strcmp(optarg, "json") != 0) {
+                    lt_bench_hex_usage(argv[0]);
+                    return 1;
+                }
+                break;
+            case 'o':
+                out_path = optarg;
+                break;
+            default:
+                lt_bench_hex_usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (iterations == 0) {
+        lt_bench_hex_usage(argv[0]);
+        return 1;
+    }
+
+    uint64_t *samples = malloc(iterations * sizeof(uint64_t));
+    if (!samples) {
+        fprintf(stderr, "Cannot allocate %zu samples!\n", iterations);
+        return 1;
+    }
+
+    if (out_path) {
+        report.out = fopen(out_path, "w");
+        if (!report.out) {
+            fprintf(stderr, "Cannot open '%s' for writing!\n", out_path);
+            free(samples);
+            return 1;
+        }
+    }
+
+    lt_bench_report_begin(&report, "hex", "table");
+    lt_ret_t ret = lt_bench_hex_run(&report, iterations, samples);
+    lt_bench_report_end(&report);
+
+    if (ret != LT_OK) {
+        fprintf(stderr, "Hex codec benchmark failed, ret=%d\n", ret);
+    }
+    if (out_path) {
+        fclose(report.out);
+    }
+    free(samples);
+
+    return ret == LT_OK ? 0 : 1;
+}
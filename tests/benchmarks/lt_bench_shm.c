@@ -0,0 +1,243 @@
+/**
+ * @file lt_bench_shm.c
+ * @brief Benchmark of the L1 layer over the POSIX shared memory HAL.
+ *
+ * The server side runs in a separate thread with a stand-in chip, which answers every L2 Request frame with an L2
+ * Response frame echoing the request data. No crypto and no model are involved, so the results show the cost of
+ * `lt_l1_write()`/`lt_l1_read()` and of the transport itself.
+ *
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "libtropic_common.h"
+#include "libtropic_port_posix_shm.h"
+#include "lt_bench_common.h"
+#include "lt_bench_echo_chip.h"
+#include "lt_crc16.h"
+#include "lt_l1.h"
+#include "lt_l1_port_wrap.h"
+#include "lt_l2_frame_check.h"
+#include "lt_shm_server.h"
+
+/** @brief Default number of measured iterations per operation. */
+#define LT_BENCH_SHM_ITERATIONS_DEFAULT 100000
+/** @brief Number of unmeasured iterations executed before each measurement. */
+#define LT_BENCH_SHM_WARMUP_ITERATIONS 1000
+/** @brief Default name of the shared memory object. */
+#define LT_BENCH_SHM_NAME_DEFAULT "/lt_bench_shm"
+/** @brief Arbitrary L2 Request ID of the frames sent by the benchmark. */
+#define LT_BENCH_SHM_REQ_ID 0x01
+
+static void *server_thread(void *arg)
+{
+    lt_shm_server_t *srv = arg;
+
+    if (lt_shm_server_run(srv) != LT_OK) {
+        fprintf(stderr, "Shared memory server failed!\n");
+    }
+    return NULL;
+}
+
+/** @brief Shared state of the measured operations. */
+static struct {
+    lt_l2_state_t *s2;
+    /** @brief Length of L2 Request data of the current operation. */
+    uint8_t data_len;
+} lt_bench;
+
+/** @brief Writes an L2 Request frame with `lt_bench.data_len` bytes of data. */
+static lt_ret_t op_l1_write(void *arg)
+{
+    LT_UNUSED(arg);
+    lt_l2_state_t *s2 = lt_bench.s2;
+
+    s2->buff[0] = LT_BENCH_SHM_REQ_ID;
+    s2->buff[1] = lt_bench.data_len;
+    memset(&s2->buff[2], 0x5a, lt_bench.data_len);
+    add_crc(s2->buff);
+
+    return lt_l1_write(s2, lt_bench.data_len + TR01_L2_REQ_ID_SIZE + TR01_L2_REQ_RSP_LEN_SIZE
+                               + TR01_L2_REQ_RSP_CRC_SIZE,
+                       LT_L1_TIMEOUT_MS_DEFAULT);
+}
+
+/** @brief Reads the L2 Response frame and checks that it echoes the request. */
+static lt_ret_t op_l1_read(void *arg)
+{
+    LT_UNUSED(arg);
+    lt_l2_state_t *s2 = lt_bench.s2;
+
+    lt_ret_t ret = lt_l1_read(s2, TR01_L1_LEN_MAX, LT_L1_TIMEOUT_MS_DEFAULT);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    if (s2->buff[2] != lt_bench.data_len) {
+        return LT_L1_DATA_LEN_ERROR;
+    }
+    return lt_l2_frame_check(s2->buff);
+}
+
+static lt_ret_t op_l1_write_read(void *arg)
+{
+    lt_ret_t ret = op_l1_write(arg);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    return op_l1_read(arg);
+}
+
+static lt_ret_t lt_bench_shm_run(lt_bench_report_t *report, const size_t iterations, uint64_t *samples)
+{
+    static const uint8_t data_lens[] = {0, 32, TR01_L2_CHUNK_MAX_DATA_SIZE};
+    lt_ret_t ret;
+
+    for (size_t i = 0; i < sizeof(data_lens); i++) {
+        lt_bench.data_len = data_lens[i];
+
+        const lt_bench_op_t ops[] = {
+            {.name = "l1_write", .size = data_lens[i], .run = op_l1_write},
+            // The stand-in chip keeps the response, so it can be read repeatedly.
+            {.name = "l1_read", .size = data_lens[i], .prepare = op_l1_write, .run = op_l1_read},
+            {.name = "l1_write_read", .size = data_lens[i], .run = op_l1_write_read},
+        };
+        for (size_t j = 0; j < sizeof(ops) / sizeof(ops[0]); j++) {
+            ret = lt_bench_measure(report, &ops[j], LT_BENCH_SHM_WARMUP_ITERATIONS, iterations, samples);
+            if (ret != LT_OK) {
+                fprintf(stderr, "Operation '%s' (size %u) failed!\n", ops[j].name, (unsigned)data_lens[i]);
+                return ret;
+            }
+        }
+    }
+
+    return LT_OK;
+}
+
+static void lt_bench_shm_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [-n iterations] [-f json|csv] [-o output_file] [-s shm_name]\n"
+            "  -n  Number of measured iterations per operation (default %d).\n"
+            "  -f  Output format (default json).\n"
+            "  -o  Output file (default stdout).\n"
+            "  -s  Name of the shared memory object (default %s).\n",
+            prog, LT_BENCH_SHM_ITERATIONS_DEFAULT, LT_BENCH_SHM_NAME_DEFAULT);
+}
+
+int main(int argc, char *argv[])
+{
+    lt_bench_report_t report = {.out = stdout, .fmt = LT_BENCH_FMT_JSON};
+    size_t iterations = LT_BENCH_SHM_ITERATIONS_DEFAULT;
+    const char *out_path = NULL;
+    const char *shm_name = LT_BENCH_SHM_NAME_DEFAULT;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:f:o:s:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                iterations = strtoul(optarg, NULL, 10);
+                break;
+            case 'f':
+                if (strcmp(optarg, "csv") == 0) {
+                    report.fmt = LT_BENCH_FMT_CSV;
+                }
+                else if (strcmp(optarg, "json") != 0) {
+                    lt_bench_shm_usage(argv[0]);
+                    return 1;
+                }
+                break;
+            case 'o':
+                out_path = optarg;
+                break;
+            case 's':
+                shm_name = optarg;
+                break;
+            default:
+                lt_bench_shm_usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (iterations == 0) {
+        lt_bench_shm_usage(argv[0]);
+        return 1;
+    }
+
+    static lt_bench_echo_chip_t chip;
+    lt_shm_server_t srv = {0};
+    srv.shm_name = shm_name;
+    srv.handler.csn_low = lt_bench_echo_chip_csn_low;
+    srv.handler.spi_transfer = lt_bench_echo_chip_spi_transfer;
+    srv.handler.ctx = &chip;
+    if (lt_shm_server_init(&srv) != LT_OK) {
+        fprintf(stderr, "Cannot create shared memory object '%s'!\n", shm_name);
+        return 1;
+    }
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, server_thread, &srv) != 0) {
+        fprintf(stderr, "Cannot start the server thread!\n");
+        lt_ret_t ret_unused = lt_shm_server_deinit(&srv);
+        LT_UNUSED(ret_unused);
+        return 1;
+    }
+
+    uint64_t *samples = malloc(iterations * sizeof(uint64_t));
+    if (!samples) {
+        fprintf(stderr, "Cannot allocate %zu samples!\n", iterations);
+    }
+
+    if (samples && out_path) {
+        report.out = fopen(out_path, "w");
+        if (!report.out) {
+            fprintf(stderr, "Cannot open '%s' for writing!\n", out_path);
+            free(samples);
+            samples = NULL;
+        }
+    }
+
+    lt_ret_t ret = LT_FAIL;
+    if (samples) {
+        lt_l2_state_t s2 = {0};
+        lt_dev_posix_shm_t device = {0};
+        device.shm_name = shm_name;
+        s2.device = &device;
+        lt_bench.s2 = &s2;
+
+        ret = lt_l1_init(&s2);
+        if (ret == LT_OK) {
+            lt_bench_report_begin(&report, "shm", "posix_shm");
+            ret = lt_bench_shm_run(&report, iterations, samples);
+            lt_bench_report_end(&report);
+
+            lt_ret_t ret_cleanup = lt_l1_deinit(&s2);
+            if (ret == LT_OK) {
+                ret = ret_cleanup;
+            }
+        }
+
+        if (ret != LT_OK) {
+            // Only L1 is linked in, so lt_ret_verbose() is not available.
+            fprintf(stderr, "Shared memory benchmark failed, ret=%d\n", ret);
+        }
+        if (out_path) {
+            fclose(report.out);
+        }
+        free(samples);
+    }
+
+    lt_shm_server_stop(&srv);
+    pthread_join(thread, NULL);
+    if (lt_shm_server_deinit(&srv) != LT_OK) {
+        ret = LT_FAIL;
+    }
+
+    return ret == LT_OK ? 0 : 1;
+}
@@ -0,0 +1,492 @@
+/**
+ * @file lt_bench_transport.c
+ * @brief End-to-end benchmark of libtropic against the TROPIC01 model over the POSIX TCP HAL.
+ *
+ * Measures latency percentiles and throughput of whole libtropic API calls (L1 transport, L2 framing, L3 encryption
+ * and the model's processing), so the results show the overhead of the whole stack between commits.
+ *
+ * When built with `LT_EMULATOR=1`, the benchmark runs against the in-process emulator instead (no model and no
+ * sockets), so the results contain only the CPU cost of libtropic and of the emulated chip.
+ *
+ * When built with `LT_FAULT_INJECTION=1`, the HAL is wrapped in the fault injection port, so the results include the
+ * recovery from the injected faults (rate set by `-F`) and the recovery costs are printed to stderr.
+ *
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <arpa/inet.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "lt_bench_common.h"
+#if LT_EMULATOR
+#include "libtropic_port_emulator.h"
+#include "lt_emu_chip.h"
+#define LT_BENCH_TRANSPORT_BACKEND "emulator/"
+#else
+#include "libtropic_port_posix_tcp.h"
+#define LT_BENCH_TRANSPORT_BACKEND "posix_tcp/"
+#endif
+#if LT_FAULT_INJECTION
+#include "libtropic_port_fault_injection.h"
+#define LT_BENCH_TRANSPORT_FI "fault_injection/"
+#else
+#define LT_BENCH_TRANSPORT_FI ""
+#endif
+#if LT_USE_TREZOR_CRYPTO
+#include "libtropic_trezor_crypto.h"
+#define LT_BENCH_CAL_NAME "trezor_crypto"
+typedef lt_ctx_trezor_crypto_t lt_bench_crypto_ctx_t;
+#elif LT_USE_MBEDTLS_V4
+#include "libtropic_mbedtls_v4.h"
+#include "psa/crypto.h"
+#define LT_BENCH_CAL_NAME "mbedtls_v4"
+typedef lt_ctx_mbedtls_v4_t lt_bench_crypto_ctx_t;
+#else
+#error "No CAL selected for the benchmark (define LT_USE_TREZOR_CRYPTO=1 or LT_USE_MBEDTLS_V4=1)."
+#endif
+
+#if LT_USE_SH0_ENG_SAMPLE
+#define LT_BENCH_SH0_PRIV sh0priv_eng_sample
+#define LT_BENCH_SH0_PUB sh0pub_eng_sample
+#else
+#define LT_BENCH_SH0_PRIV sh0priv_prod0
+#define LT_BENCH_SH0_PUB sh0pub_prod0
+#endif
+
+/** @brief Default number of measured iterations per operation. */
+#define LT_BENCH_TRANSPORT_ITERATIONS_DEFAULT 50
+/** @brief Number of unmeasured iterations executed before each measurement. */
+#define LT_BENCH_TRANSPORT_WARMUP_ITERATIONS 2
+/** @brief Default address of the model server. */
+#define LT_BENCH_TRANSPORT_ADDR_DEFAULT "127.0.0.1"
+/** @brief Default port of the model server. */
+#define LT_BENCH_TRANSPORT_PORT_DEFAULT 28992
+/** @brief Default probability of each injected fault in parts per million (only with fault injection). */
+#define LT_BENCH_TRANSPORT_FI_RATE_DEFAULT 1000
+
+/** @brief ECC slot used for the ECDSA key. The slot is erased when the benchmark finishes. */
+#define LT_BENCH_TRANSPORT_ECDSA_SLOT TR01_ECC_SLOT_30
+/** @brief ECC slot used for the EdDSA key. The slot is erased when the benchmark finishes. */
+#define LT_BENCH_TRANSPORT_EDDSA_SLOT TR01_ECC_SLOT_31
+/** @brief R-Memory slot used for the benchmark. The slot is erased when the benchmark finishes. */
+#define LT_BENCH_TRANSPORT_R_MEM_SLOT TR01_R_MEM_DATA_SLOT_MAX
+/** @brief Monotonic counter used for the benchmark. */
+#define LT_BENCH_TRANSPORT_MCOUNTER TR01_MCOUNTER_INDEX_15
+
+/** @brief State shared by all measured operations. */
+typedef struct lt_bench_transport_t {
+    lt_handle_t *h;
+    uint8_t stpub[TR01_STPUB_LEN];
+    uint8_t msg_out[TR01_PING_LEN_MAX];
+    uint8_t msg_in[TR01_PING_LEN_MAX];
+    uint16_t len;
+    uint8_t certs[LT_NUM_CERTIFICATES][TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE];
+} lt_bench_transport_t;
+
+static lt_bench_transport_t lt_bench;
+
+#if LT_FAULT_INJECTION
+/** @brief Clock of the fault injection port, so recovery costs are in the same time base as the results. */
+static uint64_t lt_bench_fi_clock_ns(void *clock_ctx)
+{
+    LT_UNUSED(clock_ctx);
+    return lt_bench_now_ns();
+}
+#endif
+
+static lt_ret_t lt_bench_op_ping(void *arg)
+{
+    lt_bench_transport_t *b = arg;
+    return lt_ping(b->h, b->msg_out, b->msg_in, b->len);
+}
+
+static lt_ret_t lt_bench_op_get_info_cert_store(void *arg)
+{
+    lt_bench_transport_t *b = arg;
+    struct lt_cert_store_t store = {.cert_len = {0},
+                                    .buf_len = {TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE,
+                                                TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE,
+                                                TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE,
+                                                TR01_L2_GET_INFO_REQ_CERT_SIZE_SINGLE},
+                                    .certs = {b->certs[0], b->certs[1], b->certs[2], b->certs[3]}};
+
+    lt_ret_t ret = lt_get_info_cert_store(b->h, &store);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    return lt_get_st_pub(&store, b->stpub);
+}
+
+static lt_ret_t lt_bench_op_handshake(void *arg)
+{
+    lt_bench_transport_t *b = arg;
+    return lt_session_start(b->h, b->stpub, TR01_PAIRING_KEY_SLOT_INDEX_0, LT_BENCH_SH0_PRIV, LT_BENCH_SH0_PUB);
+}
+
+static lt_ret_t lt_bench_op_ecdsa_sign(void *arg)
+{
+    lt_bench_transport_t *b = arg;
+    return lt_ecc_ecdsa_sign(b->h, LT_BENCH_TRANSPORT_ECDSA_SLOT, b->msg_out, b->len, b->msg_in);
+}
+
+static lt_ret_t lt_bench_op_eddsa_sign(void *arg)
+{
+    lt_bench_transport_t *b = arg;
+    return lt_ecc_eddsa_sign(b->h, LT_BENCH_TRANSPORT_EDDSA_SLOT, b->msg_out, b->len, b->msg_in);
+}
+
+static lt_ret_t lt_bench_op_r_mem_erase(void *arg)
+{
+    lt_bench_transport_t *b = arg;
+    return lt_r_mem_data_erase(b->h, LT_BENCH_TRANSPORT_R_MEM_SLOT);
+}
+
+static lt_ret_t lt_bench_op_r_mem_write(void *arg)
+{
+    lt_bench_transport_t *b = arg;
+    return lt_r_mem_data_write(b->h, LT_BENCH_TRANSPORT_R_MEM_SLOT, b->msg_out, b->len);
+}
+
+static lt_ret_t lt_bench_op_r_mem_read(void *arg)
+{
+    lt_bench_transport_t *b = arg;
+    uint16_t read_size;
+    return lt_r_mem_data_read(b->h, LT_BENCH_TRANSPORT_R_MEM_SLOT, b->msg_in, sizeof(b->msg_in), &read_size);
+}
+
+static lt_ret_t lt_bench_op_mcounter_init(void *arg)
+{
+    lt_bench_transport_t *b = arg;
+    return lt_mcounter_init(b->h, LT_BENCH_TRANSPORT_MCOUNTER, TR01_MCOUNTER_VALUE_MAX);
+}
+
+static lt_ret_t lt_bench_op_mcounter_update(void *arg)
+{
+    lt_bench_transport_t *b = arg;
+    return lt_mcounter_update(b->h, LT_BENCH_TRANSPORT_MCOUNTER);
+}
+
+static lt_ret_t lt_bench_op_mcounter_get(void *arg)
+{
+    lt_bench_transport_t *b = arg;
+    uint32_t value;
+    return lt_mcounter_get(b->h, LT_BENCH_TRANSPORT_MCOUNTER, &value);
+}
+
+static void lt_bench_fill(uint8_t *buff, const size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        buff[i] = (uint8_t)rand();
+    }
+}
+
+static lt_ret_t lt_bench_transport_run(lt_bench_report_t *report, const size_t iterations, uint64_t *samples)
+{
+    lt_bench_transport_t *b = &lt_bench;
+    lt_bench_op_t op = {.arg = b};
+    lt_ret_t ret;
+
+    lt_bench_fill(b->msg_out, sizeof(b->msg_out));
+
+    // Get_Info (L2 only, 4 certificates in multiple chunks), also provides STPUB for the handshake.
+    op.name = "get_info_cert_store";
+    op.size = TR01_L2_GET_INFO_REQ_CERT_SIZE_TOTAL;
+    op.run = lt_bench_op_get_info_cert_store;
+    ret = lt_bench_measure(report, &op, LT_BENCH_TRANSPORT_WARMUP_ITERATIONS, iterations, samples);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    op.name = "handshake";
+    op.size = 0;
+    op.run = lt_bench_op_handshake;
+    ret = lt_bench_measure(report, &op, LT_BENCH_TRANSPORT_WARMUP_ITERATIONS, iterations, samples);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    // Ping with power-of-two lengths from 1 B up to TR01_PING_LEN_MAX.
+    op.name = "ping";
+    op.run = lt_bench_op_ping;
+    for (uint32_t len = 1; len <= TR01_PING_LEN_MAX; len *= 2) {
+        b->len = (uint16_t)len;
+        op.size = len;
+        ret = lt_bench_measure(report, &op, LT_BENCH_TRANSPORT_WARMUP_ITERATIONS, iterations, samples);
+        if (ret != LT_OK) {
+            return ret;
+        }
+    }
+
+    // Signatures over a 32 B message (i.e. a hash).
+    ret = lt_ecc_key_erase(b->h, LT_BENCH_TRANSPORT_ECDSA_SLOT);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    ret = lt_ecc_key_generate(b->h, LT_BENCH_TRANSPORT_ECDSA_SLOT, TR01_CURVE_P256);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    ret = lt_ecc_key_erase(b->h, LT_BENCH_TRANSPORT_EDDSA_SLOT);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    ret = lt_ecc_key_generate(b->h, LT_BENCH_TRANSPORT_EDDSA_SLOT, TR01_CURVE_ED25519);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    b->len = 32;
+    op.size = b->len;
+    op.name = "ecdsa_sign";
+    op.run = lt_bench_op_ecdsa_sign;
+    ret = lt_bench_measure(report, &op, LT_BENCH_TRANSPORT_WARMUP_ITERATIONS, iterations, samples);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    op.name = "eddsa_sign";
+    op.run = lt_bench_op_eddsa_sign;
+    ret = lt_bench_measure(report, &op, LT_BENCH_TRANSPORT_WARMUP_ITERATIONS, iterations, samples);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    ret = lt_ecc_key_erase(b->h, LT_BENCH_TRANSPORT_ECDSA_SLOT);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    ret = lt_ecc_key_erase(b->h, LT_BENCH_TRANSPORT_EDDSA_SLOT);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    // R-Memory: the slot has to be erased before every write, so the erase is measured separately.
+    const uint16_t r_mem_sizes[] = {1, 32, b->h->tr01_attrs.r_mem_udata_slot_size_max};
+    for (size_t i = 0; i < sizeof(r_mem_sizes) / sizeof(r_mem_sizes[0]); i++) {
+        b->len = r_mem_sizes[i];
+        op.size = b->len;
+
+        op.name = "r_mem_write";
+        op.prepare = lt_bench_op_r_mem_erase;
+        op.run = lt_bench_op_r_mem_write;
+        ret = lt_bench_measure(report, &op, LT_BENCH_TRANSPORT_WARMUP_ITERATIONS, iterations, samples);
+        if (ret != LT_OK) {
+            return ret;
+        }
+
+        op.name = "r_mem_read";
+        op.prepare = NULL;
+        op.run = lt_bench_op_r_mem_read;
+        ret = lt_bench_measure(report, &op, LT_BENCH_TRANSPORT_WARMUP_ITERATIONS, iterations, samples);
+        if (ret != LT_OK) {
+            return ret;
+        }
+    }
+
+    op.name = "r_mem_erase";
+    op.size = 0;
+    op.run = lt_bench_op_r_mem_erase;
+    ret = lt_bench_measure(report, &op, LT_BENCH_TRANSPORT_WARMUP_ITERATIONS, iterations, samples);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+    // Monotonic counter. Initialized to the maximum, so the updates never reach zero.
+    op.name = "mcounter_init";
+    op.run = lt_bench_op_mcounter_init;
+    ret = lt_bench_measure(report, &op, LT_BENCH_TRANSPORT_WARMUP_ITERATIONS, iterations, samples);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    op.name = "mcounter_update";
+    op.run = lt_bench_op_mcounter_update;
+    ret = lt_bench_measure(report, &op, LT_BENCH_TRANSPORT_WARMUP_ITERATIONS, iterations, samples);
+    if (ret != LT_OK) {
+        return ret;
+    }
+    op.name = "mcounter_get";
+    op.run = lt_bench_op_mcounter_get;
+    return lt_bench_measure(report, &op, LT_BENCH_TRANSPORT_WARMUP_ITERATIONS, iterations, samples);
+}
+
+static void lt_bench_transport_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [-n iterations] [-f json|csv] [-o output_file] [-a address] [-p port] [-F rate_ppm]\n"
+            "  -n  Number of measured iterations per operation (default %d).\n"
+            "  -f  Output format (default json).\n"
+            "  -o  Output file (default stdout).\n"
+            "  -a  Address of the model server (default %s, ignored with the emulator).\n"
+            "  -p  Port of the model server (default %d, ignored with the emulator).\n"
+            "  -F  Probability of each injected fault in ppm (default %d, only with fault injection).\n",
+            prog, LT_BENCH_TRANSPORT_ITERATIONS_DEFAULT, LT_BENCH_TRANSPORT_ADDR_DEFAULT,
+            LT_BENCH_TRANSPORT_PORT_DEFAULT, LT_BENCH_TRANSPORT_FI_RATE_DEFAULT);
+}
+
+int main(int argc, char *argv[])
+{
+    lt_bench_report_t report = {.out = stdout, .fmt = LT_BENCH_FMT_JSON};
+    size_t iterations = LT_BENCH_TRANSPORT_ITERATIONS_DEFAULT;
+    const char *out_path = NULL;
+    const char *addr = LT_BENCH_TRANSPORT_ADDR_DEFAULT;
+    unsigned long port = LT_BENCH_TRANSPORT_PORT_DEFAULT;
+    unsigned long fi_rate_ppm = LT_BENCH_TRANSPORT_FI_RATE_DEFAULT;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:f:o:a:p:F:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                iterations = strtoul(optarg, NULL, 10);
+                break;
+            case 'f':
+                if (strcmp(optarg, "csv") == 0) {
+                    report.fmt = LT_BENCH_FMT_CSV;
+                }
+                else if (strcmp(optarg, "json") != 0) {
+                    lt_bench_transport_usage(argv[0]);
+                    return 1;
+                }
+                break;
+            case 'o':
+                out_path = optarg;
+                break;
+            case 'a':
+                addr = optarg;
+                break;
+            case 'p':
+                port = strtoul(optarg, NULL, 10);
+                break;
+            case 'F':
+                fi_rate_ppm = strtoul(optarg, NULL, 10);
+                break;
+            default:
+                lt_bench_transport_usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (iterations == 0 || port == 0 || port > UINT16_MAX || fi_rate_ppm > 1000000) {
+        lt_bench_transport_usage(argv[0]);
+        return 1;
+    }
+
+#if LT_USE_MBEDTLS_V4
+    psa_status_t status = psa_crypto_init();
+    if (status != PSA_SUCCESS) {
+        fprintf(stderr, "PSA Crypto initialization failed, status=%" PRId32 " (psa_status_t)\n", status);
+        return 1;
+    }
+#endif
+
+    lt_handle_t h = {0};
+#if LT_SEPARATE_L3_BUFF
+    static uint8_t l3_buffer[LT_SIZE_OF_L3_BUFF] __attribute__((aligned(16)));
+    h.l3.buff = l3_buffer;
+    h.l3.buff_len = sizeof(l3_buffer);
+#endif
+#if LT_EMULATOR
+    LT_UNUSED(addr);
+    static lt_bench_crypto_ctx_t chip_crypto_ctx;
+    static lt_emu_chip_t chip;
+    chip.config.crypto_ctx = &chip_crypto_ctx;
+    chip.config.pairing_keys[TR01_PAIRING_KEY_SLOT_INDEX_0] = LT_BENCH_SH0_PUB;
+    if (lt_emu_chip_init(&chip) != LT_OK) {
+        fprintf(stderr, "Cannot initialize the emulated chip!\n");
+        return 1;
+    }
+    lt_dev_emulator_t device = {0};
+    device.chip = &chip;
+#else
+    lt_dev_posix_tcp_t device = {0};
+    device.addr = inet_addr(addr);
+    device.port = (in_port_t)port;
+#endif
+#if LT_FAULT_INJECTION
+    lt_dev_fault_injection_t fi_device = {0};
+    fi_device.inner_device = &device;
+    for (int i = 0; i < LT_FI_FAULT_CNT; i++) {
+        fi_device.rate_ppm[i] = (uint32_t)fi_rate_ppm;
+    }
+    fi_device.clock_ns = lt_bench_fi_clock_ns;
+    h.l2.device = &fi_device;
+#else
+    LT_UNUSED(fi_rate_ppm);
+    h.l2.device = &device;
+#endif
+
+    lt_bench_crypto_ctx_t crypto_ctx;
+    h.l3.crypto_ctx = &crypto_ctx;
+    lt_bench.h = &h;
+
+    // The TCP HAL uses rand() for random numbers. Fixed seed, so the measured inputs are the same across runs.
+    srand(0);
+
+    uint64_t *samples = malloc(iterations * sizeof(uint64_t));
+    if (!samples) {
+        fprintf(stderr, "Cannot allocate %zu samples!\n", iterations);
+        return 1;
+    }
+
+    if (out_path) {
+        report.out = fopen(out_path, "w");
+        if (!report.out) {
+            fprintf(stderr, "Cannot open '%s' for writing!\n", out_path);
+            free(samples);
+            return 1;
+        }
+    }
+
+    lt_ret_t ret = lt_init(&h);
+    if (ret == LT_OK) {
+        lt_bench_report_begin(&report, "transport", LT_BENCH_TRANSPORT_FI LT_BENCH_TRANSPORT_BACKEND LT_BENCH_CAL_NAME);
+        ret = lt_bench_transport_run(&report, iterations, samples);
+        lt_bench_report_end(&report);
+
+        lt_ret_t ret_cleanup = lt_session_abort(&h);
+        if (ret == LT_OK) {
+            ret = ret_cleanup;
+        }
+        ret_cleanup = lt_deinit(&h);
+        if (ret == LT_OK) {
+            ret = ret_cleanup;
+        }
+    }
+
+    if (ret != LT_OK) {
+        fprintf(stderr, "Transport benchmark failed, ret=%d (%s)\n", ret, lt_ret_verbose(ret));
+    }
+
+#if LT_FAULT_INJECTION
+    for (int i = 0; i < LT_FI_FAULT_CNT; i++) {
+        const lt_fi_stats_t *st = &fi_device.stats[i];
+        fprintf(stderr,
+                "Fault %s: injected=%" PRIu32 " recovered=%" PRIu32 " unrecovered=%" PRIu32 " transfers=%" PRIu32
+                " bytes=%" PRIu32 " delay_ms=%" PRIu32 " mean_recovery_ns=%" PRIu64 "\n",
+                lt_fi_fault_name((lt_fi_fault_t)i), st->injected, st->recovered, st->unrecovered, st->transfers,
+                st->bytes, st->delay_ms, st->recovered ? st->time_ns / st->recovered : 0);
+    }
+#endif
+
+    if (out_path) {
+        fclose(report.out);
+    }
+    free(samples);
+
+#if LT_EMULATOR
+    if (lt_emu_chip_deinit(&chip) != LT_OK) {
+        ret = LT_FAIL;
+    }
+#endif
+
+#if LT_USE_MBEDTLS_V4
+    mbedtls_psa_crypto_free();
+#endif
+
+    return ret == LT_OK ? 0 : 1;
+}
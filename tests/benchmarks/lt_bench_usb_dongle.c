@@ -0,0 +1,457 @@
+/**
+ * @file lt_bench_usb_dongle.c
+ * @brief Benchmark of the L1 layer over the TS1302 USB dongle HAL.
+ *
+ * The dongle is simulated by a thread of the benchmark on the master side of a pseudoterminal: it speaks both the
+ * ASCII protocol and the binary framing of the dongle, passes the SPI transfers to a stand-in chip echoing L2
+ * Requests, and delays every reply by a configurable latency, which stands for the USB round trip. Replies to
+ * frames which arrive back-to-back are in flight at the same time, like on a real USB link, so the results show how
+ * much of the latency the synchronous and the asynchronous (`async`) modes of the HAL hide.
+ *
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#define _GNU_SOURCE  // posix_openpt(), grantpt(), unlockpt(), ptsname()
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "libtropic_common.h"
+#include "libtropic_macros.h"
+#include "libtropic_port_posix_usb_dongle.h"
+#include "lt_bench_common.h"
+#include "lt_bench_echo_chip.h"
+#include "lt_crc16.h"
+#include "lt_hex.h"
+#include "lt_l1.h"
+#include "lt_l1_port_wrap.h"
+#include "lt_l2_api_structs.h"
+#include "lt_l2_frame_check.h"
+
+/** @brief Default number of measured iterations per operation. */
+#define LT_BENCH_DONGLE_ITERATIONS_DEFAULT 1000
+/** @brief Number of unmeasured iterations executed before each measurement. */
+#define LT_BENCH_DONGLE_WARMUP_ITERATIONS 20
+/** @brief Default latency of a reply of the simulated dongle in microseconds. */
+#define LT_BENCH_DONGLE_LATENCY_US_DEFAULT 500
+/** @brief Arbitrary L2 Request ID of the frames sent by the benchmark (the L2 Request ID of Encrypted_Cmd). */
+#define LT_BENCH_DONGLE_REQ_ID 0x04
+/** @brief Maximal number of replies of the simulated dongle in flight. */
+#define LT_BENCH_DONGLE_REPLIES_MAX 32
+/** @brief Size of the receive buffer of the simulated dongle. */
+#define LT_BENCH_DONGLE_RX_SIZE 4096
+
+/** @brief Binary frame header and CRC lengths, and flags, as in the HAL. */
+#define LT_BENCH_DONGLE_BIN_HDR_LEN 3
+#define LT_BENCH_DONGLE_BIN_CRC_LEN 2
+#define LT_BENCH_DONGLE_BIN_FLAG_CSN_HIGH 0x01
+#define LT_BENCH_DONGLE_BIN_FLAG_ASCII 0x02
+
+/** @brief Reply of the simulated dongle waiting for its latency to pass. */
+typedef struct lt_bench_dongle_reply_t {
+    /** @brief Time when the reply is sent. */
+    uint64_t due_ns;
+    /** @brief Length of the reply. */
+    uint16_t len;
+    /** @brief The reply. */
+    uint8_t data[LT_USB_DONGLE_SPI_TRANSFER_BUFF_SIZE_MAX];
+} lt_bench_dongle_reply_t;
+
+/** @brief Simulated dongle. */
+typedef struct lt_bench_dongle_t {
+    /** @brief Master side of the pseudoterminal. */
+    int fd;
+    /** @brief Latency of every reply. */
+    uint64_t latency_ns;
+    /** @brief Stand-in chip behind the dongle. */
+    lt_bench_echo_chip_t chip;
+    /** @brief CSN is low (a transfer happened since the last CSN release). */
+    bool csn_low;
+    /** @brief The binary framing is active. */
+    bool binary;
+    /** @brief Ring of replies in flight. */
+    lt_bench_dongle_reply_t replies[LT_BENCH_DONGLE_REPLIES_MAX];
+    /** @brief Ring indices of the oldest reply and of the next free slot. */
+    size_t replies_head, replies_tail;
+    /** @brief Received bytes not processed yet. */
+    uint8_t rx[LT_BENCH_DONGLE_RX_SIZE];
+    /** @brief Number of bytes in `rx`. */
+    size_t rx_len;
+    /** @brief Set by the benchmark to end the thread. */
+    volatile bool stop;
+    /** @brief Set by the thread on a protocol error. */
+    volatile bool failed;
+} lt_bench_dongle_t;
+
+/** @brief Queues a reply to be sent when the latency passes, after the replies queued before it. */
+static lt_bench_dongle_reply_t *dongle_reply(lt_bench_dongle_t *dongle)
+{
+    if (dongle->replies_tail - dongle->replies_head >= LT_BENCH_DONGLE_REPLIES_MAX) {
+        dongle->failed = true;
+        return NULL;
+    }
+    lt_bench_dongle_reply_t *reply = &dongle->replies[dongle->replies_tail++ % LT_BENCH_DONGLE_REPLIES_MAX];
+    reply->due_ns = lt_bench_now_ns() + dongle->latency_ns;
+    reply->len = 0;
+    return reply;
+}
+
+/** @brief Passes a transfer to the stand-in chip, starting a new frame if CSN was released. */
+static void dongle_spi_transfer(lt_bench_dongle_t *dongle, uint8_t *data, uint16_t len)
+{
+    if (!dongle->csn_low) {
+        lt_ret_t ret_unused = lt_bench_echo_chip_csn_low(&dongle->chip);
+        LT_UNUSED(ret_unused);
+        dongle->csn_low = true;
+    }
+    if (lt_bench_echo_chip_spi_transfer(&dongle->chip, data, len) != LT_OK) {
+        dongle->failed = true;
+    }
+}
+
+/** @brief Processes one ASCII command, returns its length or 0 if it is not complete yet. */
+static size_t dongle_ascii_cmd(lt_bench_dongle_t *dongle)
+{
+    const uint8_t *end = memchr(dongle->rx, '\n', dongle->rx_len);
+    if (!end) {
+        return 0;
+    }
+    const size_t cmd_len = end - dongle->rx + 1;
+    lt_bench_dongle_reply_t *reply = dongle_reply(dongle);
+    if (!reply) {
+        return cmd_len;
+    }
+
+    if (cmd_len == 5 && memcmp(dongle->rx, "CS=0\n", 5) == 0) {
+        dongle->csn_low = false;
+        memcpy(reply->data, "OK\r\n", 4);
+        reply->len = 4;
+    }
+    else if (cmd_len == 9 && memcmp(dongle->rx, "MODE=BIN\n", 9) == 0) {
+        dongle->binary = true;
+        memcpy(reply->data, "OK\r\n", 4);
+        reply->len = 4;
+    }
+    else {
+        // Hex characters followed by "x\n".
+        uint8_t data[TR01_L1_LEN_MAX];
+        const uint16_t len = (cmd_len - 2) / 2;
+        if (cmd_len < 2 || len > TR01_L1_LEN_MAX || lt_hex_decode((const char *)dongle->rx, len, data) != LT_OK) {
+            dongle->failed = true;
+            return cmd_len;
+        }
+        dongle_spi_transfer(dongle, data, len);
+        lt_hex_encode(data, len, (char *)reply->data);
+        memcpy(reply->data + 2 * len, "\r\n", 2);
+        reply->len = 2 * len + 2;
+    }
+
+    return cmd_len;
+}
+
+/** @brief Processes one binary frame, returns its length or 0 if it is not complete yet. */
+static size_t dongle_binary_frame(lt_bench_dongle_t *dongle)
+{
+    if (dongle->rx_len < LT_BENCH_DONGLE_BIN_HDR_LEN) {
+        return 0;
+    }
+    const uint16_t len = dongle->rx[1] | (dongle->rx[2] << 8);
+    const size_t frame_len = LT_BENCH_DONGLE_BIN_HDR_LEN + len + LT_BENCH_DONGLE_BIN_CRC_LEN;
+    if (len > TR01_L1_LEN_MAX) {
+        dongle->failed = true;
+        return dongle->rx_len;
+    }
+    if (dongle->rx_len < frame_len) {
+        return 0;
+    }
+    uint16_t crc = crc16(dongle->rx, LT_BENCH_DONGLE_BIN_HDR_LEN + len);
+    if (dongle->rx[frame_len - 2] != (crc >> 8) || dongle->rx[frame_len - 1] != (crc & 0xff)) {
+        dongle->failed = true;
+        return frame_len;
+    }
+    lt_bench_dongle_reply_t *reply = dongle_reply(dongle);
+    if (!reply) {
+        return frame_len;
+    }
+
+    const uint8_t flags = dongle->rx[0];
+    reply->data[0] = 0;  // Status OK.
+    reply->data[1] = len & 0xff;
+    reply->data[2] = len >> 8;
+    if (len) {
+        memcpy(reply->data + LT_BENCH_DONGLE_BIN_HDR_LEN, dongle->rx + LT_BENCH_DONGLE_BIN_HDR_LEN, len);
+        dongle_spi_transfer(dongle, reply->data + LT_BENCH_DONGLE_BIN_HDR_LEN, len);
+    }
+    crc = crc16(reply->data, LT_BENCH_DONGLE_BIN_HDR_LEN + len);
+    reply->data[LT_BENCH_DONGLE_BIN_HDR_LEN + len] = crc >> 8;
+    reply->data[LT_BENCH_DONGLE_BIN_HDR_LEN + len + 1] = crc & 0xff;
+    reply->len = LT_BENCH_DONGLE_BIN_HDR_LEN + len + LT_BENCH_DONGLE_BIN_CRC_LEN;
+
+    if (flags & LT_BENCH_DONGLE_BIN_FLAG_CSN_HIGH) {
+        dongle->csn_low = false;
+    }
+    if (flags & LT_BENCH_DONGLE_BIN_FLAG_ASCII) {
+        dongle->binary = false;
+    }
+    return frame_len;
+}
+
+static void *dongle_thread(void *arg)
+{
+    lt_bench_dongle_t *dongle = arg;
+
+    while (!dongle->stop && !dongle->failed) {
+        int timeout_ms = 10;
+        if (dongle->replies_head != dongle->replies_tail) {
+            const uint64_t due_ns = dongle->replies[dongle->replies_head % LT_BENCH_DONGLE_REPLIES_MAX].due_ns;
+            const uint64_t now_ns = lt_bench_now_ns();
+            timeout_ms = due_ns > now_ns ? (int)((due_ns - now_ns + 999999) / 1000000) : 0;
+        }
+
+        struct pollfd pfd = {.fd = dongle->fd, .events = POLLIN};
+        // Sub-millisecond latencies are waited for by spinning on poll() with zero timeout.
+        if (poll(&pfd, 1, timeout_ms > 1 ? timeout_ms - 1 : 0) < 0 && errno != EINTR) {
+            dongle->failed = true;
+            break;
+        }
+        if (pfd.revents & POLLIN) {
+            ssize_t n = read(dongle->fd, dongle->rx + dongle->rx_len, sizeof(dongle->rx) - dongle->rx_len);
+            if (n > 0) {
+                dongle->rx_len += n;
+            }
+            size_t used;
+            while (dongle->rx_len
+                   && (used = dongle->binary ? dongle_binary_frame(dongle) : dongle_ascii_cmd(dongle)) != 0) {
+                memmove(dongle->rx, dongle->rx + used, dongle->rx_len - used);
+                dongle->rx_len -= used;
+            }
+        }
+
+        const uint64_t now_ns = lt_bench_now_ns();
+        while (dongle->replies_head != dongle->replies_tail) {
+            lt_bench_dongle_reply_t *reply = &dongle->replies[dongle->replies_head % LT_BENCH_DONGLE_REPLIES_MAX];
+            if (reply->due_ns > now_ns) {
+                break;
+            }
+            if (write(dongle->fd, reply->data, reply->len) != reply->len) {
+                dongle->failed = true;
+            }
+            dongle->replies_head++;
+        }
+    }
+
+    return NULL;
+}
+
+/** @brief Shared state of the measured operations. */
+static struct {
+    lt_l2_state_t *s2;
+    /** @brief Number of L2 Request/Response exchanges of the current operation. */
+    uint16_t chunks;
+} lt_bench;
+
+/** @brief Sends `lt_bench.chunks` L2 Requests with full chunks and reads and checks their L2 Responses. */
+static lt_ret_t op_l2_chunks(void *arg)
+{
+    LT_UNUSED(arg);
+    lt_l2_state_t *s2 = lt_bench.s2;
+
+    for (uint16_t i = 0; i < lt_bench.chunks; i++) {
+        s2->buff[0] = LT_BENCH_DONGLE_REQ_ID;
+        s2->buff[1] = TR01_L2_CHUNK_MAX_DATA_SIZE;
+        memset(&s2->buff[2], (uint8_t)i, TR01_L2_CHUNK_MAX_DATA_SIZE);
+        add_crc(s2->buff);
+
+        lt_ret_t ret = lt_l1_write(s2,
+                                   TR01_L2_REQ_ID_SIZE + TR01_L2_REQ_RSP_LEN_SIZE + TR01_L2_CHUNK_MAX_DATA_SIZE
+                                       + TR01_L2_REQ_RSP_CRC_SIZE,
+                                   LT_L1_TIMEOUT_MS_DEFAULT);
+        if (ret != LT_OK) {
+            return ret;
+        }
+        ret = lt_l1_read(s2, TR01_L1_LEN_MAX, LT_L1_TIMEOUT_MS_DEFAULT);
+        if (ret != LT_OK) {
+            return ret;
+        }
+        if (s2->buff[2] != TR01_L2_CHUNK_MAX_DATA_SIZE || s2->buff[3] != (uint8_t)i) {
+            return LT_L1_DATA_LEN_ERROR;
+        }
+        ret = lt_l2_frame_check(s2->buff);
+        if (ret != LT_OK) {
+            return ret;
+        }
+    }
+
+    return LT_OK;
+}
+
+static lt_ret_t lt_bench_dongle_run(lt_bench_report_t *report, const size_t iterations, uint64_t *samples)
+{
+    // Number of L2 chunks of the L3 Commands of: a short command (e.g. ECDSA_Sign), an R-Memory slot write (444 B),
+    // a Ping with 1 kB and with 4 kB (the largest L3 Command).
+    static const uint16_t chunks[] = {1, 2, 5, 17};
+    lt_ret_t ret;
+
+    for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+        lt_bench.chunks = chunks[i];
+
+        const lt_bench_op_t op
+            = {.name = "l2_chunks", .size = (size_t)chunks[i] * TR01_L2_CHUNK_MAX_DATA_SIZE, .run = op_l2_chunks};
+        ret = lt_bench_measure(report, &op, LT_BENCH_DONGLE_WARMUP_ITERATIONS, iterations, samples);
+        if (ret != LT_OK) {
+            fprintf(stderr, "Operation '%s' (%u chunks) failed!\n", op.name, (unsigned)chunks[i]);
+            return ret;
+        }
+    }
+
+    return LT_OK;
+}
+
+static void lt_bench_dongle_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [-n iterations] [-f json|csv] [-o output_file] [-l latency_us] [-a] [-B]\n"
+            "  -n  Number of measured iterations per operation (default %d).\n"
+            "  -f  Output format (default json).\n"
+            "  -o  Output file (default stdout).\n"
+            "  -l  Latency of every reply of the simulated dongle in microseconds (default %d).\n"
+            "  -a  Use the asynchronous mode of the HAL (I/O thread).\n"
+            "  -B  Use the binary framing.\n",
+            prog, LT_BENCH_DONGLE_ITERATIONS_DEFAULT, LT_BENCH_DONGLE_LATENCY_US_DEFAULT);
+}
+
+int main(int argc, char *argv[])
+{
+    lt_bench_report_t report = {.out = stdout, .fmt = LT_BENCH_FMT_JSON};
+    size_t iterations = LT_BENCH_DONGLE_ITERATIONS_DEFAULT;
+    unsigned long latency_us = LT_BENCH_DONGLE_LATENCY_US_DEFAULT;
+    const char *out_path = NULL;
+    bool async = false;
+    bool binary = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:f:o:l:aBh")) != -1) {
+        switch (opt) {
+            case 'n':
+                iterations = strtoul(optarg, NULL, 10);
+                break;
+            case 'f':
+                if (strcmp(optarg, "csv") == 0) {
+                    report.fmt = LT_BENCH_FMT_CSV;
+                }
+                else if (strcmp(optarg, "json") != 0) {
+                    lt_bench_dongle_usage(argv[0]);
+                    return 1;
+                }
+                break;
+            case 'o':
+                out_path = optarg;
+                break;
+            case 'l':
+                latency_us = strtoul(optarg, NULL, 10);
+                break;
+            case 'a':
+                async = true;
+                break;
+            case 'B':
+                binary = true;
+                break;
+            default:
+                lt_bench_dongle_usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (iterations == 0) {
+        lt_bench_dongle_usage(argv[0]);
+        return 1;
+    }
+
+    static lt_bench_dongle_t dongle;
+    dongle.latency_ns = (uint64_t)latency_us * 1000;
+    dongle.fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (dongle.fd < 0 || grantpt(dongle.fd) != 0 || unlockpt(dongle.fd) != 0) {
+        fprintf(stderr, "Cannot create a pseudoterminal: %s\n", strerror(errno));
+        return 1;
+    }
+    struct termios options;
+    if (tcgetattr(dongle.fd, &options) == 0) {
+        cfmakeraw(&options);
+        if (tcsetattr(dongle.fd, TCSANOW, &options) != 0) {
+            fprintf(stderr, "Cannot configure the pseudoterminal: %s\n", strerror(errno));
+        }
+    }
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, dongle_thread, &dongle) != 0) {
+        fprintf(stderr, "Cannot start the dongle thread!\n");
+        close(dongle.fd);
+        return 1;
+    }
+
+    uint64_t *samples = malloc(iterations * sizeof(uint64_t));
+    if (!samples) {
+        fprintf(stderr, "Cannot allocate %zu samples!\n", iterations);
+    }
+
+    if (samples && out_path) {
+        report.out = fopen(out_path, "w");
+        if (!report.out) {
+            fprintf(stderr, "Cannot open '%s' for writing!\n", out_path);
+            free(samples);
+            samples = NULL;
+        }
+    }
+
+    lt_ret_t ret = LT_FAIL;
+    if (samples) {
+        lt_l2_state_t s2 = {0};
+        lt_dev_posix_usb_dongle_t device = {0};
+        snprintf(device.dev_path, sizeof(device.dev_path), "%s", ptsname(dongle.fd));
+        device.baud_rate = 115200;
+        device.framing = binary ? LT_USB_DONGLE_FRAMING_BINARY : LT_USB_DONGLE_FRAMING_ASCII;
+        device.async = async;
+        s2.device = &device;
+        lt_bench.s2 = &s2;
+
+        ret = lt_l1_init(&s2);
+        if (ret == LT_OK) {
+            char backend[64];
+            snprintf(backend, sizeof(backend), "usb_dongle/%s/%s/%luus", binary ? "binary" : "ascii",
+                     async ? "async" : "sync", latency_us);
+            lt_bench_report_begin(&report, "usb_dongle", backend);
+            ret = lt_bench_dongle_run(&report, iterations, samples);
+            lt_bench_report_end(&report);
+
+            lt_ret_t ret_cleanup = lt_l1_deinit(&s2);
+            if (ret == LT_OK) {
+                ret = ret_cleanup;
+            }
+        }
+
+        if (ret != LT_OK) {
+            // Only L1 is linked in, so lt_ret_verbose() is not available.
+            fprintf(stderr, "USB dongle benchmark failed, ret=%d%s\n", ret,
+                    dongle.failed ? " (simulated dongle got an invalid command)" : "");
+        }
+        if (out_path) {
+            fclose(report.out);
+        }
+        free(samples);
+    }
+
+    dongle.stop = true;
+    pthread_join(thread, NULL);
+    close(dongle.fd);
+
+    return ret == LT_OK ? 0 : 1;
+}
@@ -0,0 +1,197 @@
+/**
+ * @file lt_test_rev_apply_config.c
+ * @brief Test applying R-Config and I-Config changes against a snapshot.
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <inttypes.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_functional_tests.h"
+#include "libtropic_logging.h"
+#include "string.h"
+
+// Shared with cleanup function.
+static struct lt_config_t g_r_config_backup;
+static lt_handle_t *g_h;
+
+static lt_ret_t lt_test_rev_apply_config_cleanup(void)
+{
+    lt_ret_t ret;
+    struct lt_config_t r_config;
+
+    LT_LOG_INFO("Starting secure session with slot %d", (int)TR01_PAIRING_KEY_SLOT_INDEX_0);
+    ret = lt_verify_chip_and_start_secure_session(g_h, LT_TEST_SH0_PRIV, LT_TEST_SH0_PUB,
+                                                  TR01_PAIRING_KEY_SLOT_INDEX_0);
+    if (LT_OK != ret) {
+        LT_LOG_ERROR("Failed to establish secure session.");
+        return ret;
+    }
+
+    LT_LOG_INFO("Erasing R config, so it can be restored");
+    ret = lt_r_config_erase(g_h);
+    if (LT_OK != ret) {
+        LT_LOG_ERROR("Failed to erase R config.");
+        return ret;
+    }
+
+    LT_LOG_INFO("Writing R config backup");
+    ret = lt_write_whole_R_config(g_h, &g_r_config_backup);
+    if (LT_OK != ret) {
+        LT_LOG_ERROR("Failed to write R config.");
+        return ret;
+    }
+
+    LT_LOG_INFO("Reading R config and checking if restored correctly");
+    ret = lt_read_whole_R_config(g_h, &r_config);
+    if (LT_OK != ret) {
+        LT_LOG_ERROR("Failed to read R config.");
+        return ret;
+    }
+    for (int i = 0; i < LT_CONFIG_OBJ_CNT; i++) {
+        if (r_config.obj[i] != g_r_config_backup.obj[i]) {
+            LT_LOG_ERROR("Slot %d was not correctly restored", i);
+            return LT_FAIL;
+        }
+    }
+
+    LT_LOG_INFO("Aborting secure session");
+    ret = lt_session_abort(g_h);
+    if (LT_OK != ret) {
+        LT_LOG_ERROR("Failed to abort secure session.");
+        return ret;
+    }
+
+    LT_LOG_INFO("Deinitializing handle");
+    ret = lt_deinit(g_h);
+    if (LT_OK != ret) {
+        LT_LOG_ERROR("Failed to deinitialize handle.");
+        return ret;
+    }
+
+    return LT_OK;
+}
+
+/**
+ * @brief Returns the number of L3 commands sent in the current Secure Session.
+ *
+ * @note The encryption nonce is incremented with every L3 command, so it works as a command counter both on the chip
+ *       and on the emulator.
+ */
+static uint32_t l3_cmd_cnt(const lt_handle_t *h)
+{
+    const uint8_t *iv = h->l3.encryption_IV;
+
+    return (uint32_t)iv[0] | ((uint32_t)iv[1] << 8) | ((uint32_t)iv[2] << 16) | ((uint32_t)iv[3] << 24);
+}
+
+/** @brief Returns the number of objects in `config` which are not erased. */
+static uint32_t written_obj_cnt(const struct lt_config_t *config)
+{
+    uint32_t cnt = 0;
+
+    for (int i = 0; i < LT_CONFIG_OBJ_CNT; i++) {
+        if (config->obj[i] != LT_CONFIG_OBJ_ERASED) {
+            cnt++;
+        }
+    }
+
+    return cnt;
+}
+
+/**
+ * @brief Applies `config` to the R-Config and checks that exactly `exp_cmd_cnt` L3 commands were sent and that the
+ *        snapshot and the R-Config equal `config`.
+ */
+static void apply_and_check(lt_handle_t *h, const struct lt_config_t *config, struct lt_config_t *snapshot,
+                            uint32_t exp_cmd_cnt)
+{
+    struct lt_config_t r_config;
+    uint32_t cmd_cnt = l3_cmd_cnt(h);
+
+    LT_TEST_ASSERT(LT_OK, lt_apply_R_config(h, config, snapshot));
+    LT_LOG_INFO("L3 commands sent: %" PRIu32 ", expected: %" PRIu32, l3_cmd_cnt(h) - cmd_cnt, exp_cmd_cnt);
+    LT_TEST_ASSERT(1, exp_cmd_cnt == l3_cmd_cnt(h) - cmd_cnt);
+    LT_TEST_ASSERT(0, memcmp(snapshot, config, sizeof(struct lt_config_t)));
+    LT_TEST_ASSERT(LT_OK, lt_read_whole_R_config(h, &r_config));
+    LT_TEST_ASSERT(0, memcmp(&r_config, config, sizeof(struct lt_config_t)));
+}
+
+void lt_test_rev_apply_config(lt_handle_t *h)
+{
+    LT_LOG_INFO("----------------------------------------------");
+    LT_LOG_INFO("lt_test_rev_apply_config()");
+    LT_LOG_INFO("----------------------------------------------");
+
+    // Making the handle accessible to the cleanup function.
+    g_h = h;
+
+    struct lt_config_t snapshot, config;
+    uint32_t cmd_cnt;
+
+    LT_LOG_INFO("Initializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_init(h));
+
+    LT_LOG_INFO("Starting Secure Session with key %d", (int)TR01_PAIRING_KEY_SLOT_INDEX_0);
+    LT_TEST_ASSERT(LT_OK, lt_verify_chip_and_start_secure_session(h, LT_TEST_SH0_PRIV, LT_TEST_SH0_PUB,
+                                                                  TR01_PAIRING_KEY_SLOT_INDEX_0));
+    LT_LOG_LINE();
+
+    LT_LOG_INFO("Backing up the whole R config");
+    LT_TEST_ASSERT(LT_OK, lt_read_whole_R_config(h, &g_r_config_backup));
+    LT_LOG_LINE();
+
+    // No we have the R config backed up. From this moment now it makes
+    // sense to call the cleanup function.
+    lt_test_cleanup_function = &lt_test_rev_apply_config_cleanup;
+
+    LT_LOG_INFO("Erasing R config and taking a snapshot");
+    LT_TEST_ASSERT(LT_OK, lt_r_config_erase(h));
+    LT_TEST_ASSERT(LT_OK, lt_read_whole_R_config(h, &snapshot));
+    LT_LOG_LINE();
+
+    LT_LOG_INFO("Applying the same R config, nothing should be sent");
+    config = snapshot;
+    apply_and_check(h, &config, &snapshot, 0);
+
+    LT_LOG_INFO("Applying R config changing one erased object, only that object should be written");
+    config.obj[TR01_CFG_UAP_MCOUNTER_INIT_IDX] = 0x0000ff00;
+    apply_and_check(h, &config, &snapshot, 1);
+
+    LT_LOG_INFO("Applying R config changing another erased object, only that object should be written");
+    config.obj[TR01_CFG_UAP_MCOUNTER_GET_IDX] = 0x0000ff00;
+    apply_and_check(h, &config, &snapshot, 1);
+
+    LT_LOG_INFO("Applying R config changing a written object, R config should be erased and written objects rewritten");
+    config.obj[TR01_CFG_UAP_MCOUNTER_GET_IDX] = 0x000000ff;
+    apply_and_check(h, &config, &snapshot, 1 + written_obj_cnt(&config));
+
+    LT_LOG_INFO("Applying the backed up R config");
+    apply_and_check(h, &g_r_config_backup, &snapshot, 1 + written_obj_cnt(&g_r_config_backup));
+    LT_LOG_LINE();
+
+    LT_LOG_INFO("Taking a snapshot of I config");
+    LT_TEST_ASSERT(LT_OK, lt_read_whole_I_config(h, &snapshot));
+
+    LT_LOG_INFO("Applying the same I config, nothing should be sent");
+    config = snapshot;
+    cmd_cnt = l3_cmd_cnt(h);
+    LT_TEST_ASSERT(LT_OK, lt_apply_I_config(h, &config, &snapshot));
+    LT_TEST_ASSERT(1, cmd_cnt == l3_cmd_cnt(h));
+    LT_TEST_ASSERT(0, memcmp(&snapshot, &config, sizeof(struct lt_config_t)));
+
+    LT_LOG_INFO("Checking that I config bits cannot be set");
+    snapshot.obj[TR01_CFG_UAP_PING_IDX] &= 0xfffffffe;
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_apply_I_config(h, &config, &snapshot));
+    LT_TEST_ASSERT(1, cmd_cnt == l3_cmd_cnt(h));
+    LT_LOG_LINE();
+
+    // Call cleanup function, but don't call it from LT_TEST_ASSERT anymore.
+    lt_test_cleanup_function = NULL;
+    LT_LOG_INFO("Starting post-test cleanup");
+    LT_TEST_ASSERT(LT_OK, lt_test_rev_apply_config_cleanup());
+    LT_LOG_INFO("Post-test cleanup was successful");
+}
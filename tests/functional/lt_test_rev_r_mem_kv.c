@@ -0,0 +1,263 @@
+/**
+ * @file lt_test_rev_r_mem_kv.c
+ * @brief Test the key/value store layered on the R-Memory User Data slots
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <inttypes.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_functional_tests.h"
+#include "libtropic_kv.h"
+#include "libtropic_logging.h"
+#include "lt_crc16.h"
+#include "lt_random.h"
+#include "string.h"
+
+/** @brief First slot used by the store, the last 32 slots are used. */
+#define KV_FIRST_SLOT (TR01_R_MEM_DATA_SLOT_MAX + 1 - KV_SLOT_CNT)
+/** @brief Number of slots used by the store. */
+#define KV_SLOT_CNT 32
+/** @brief Number of keys used by the test. */
+#define KV_KEY_CNT 4
+/** @brief Two keys with the same hash, the store refuses to hold both. */
+#define KV_COLLIDING_KEY_1 "k_7g4wbz8c"
+#define KV_COLLIDING_KEY_2 "k_m9wt3llt"
+/** @brief Size of the header of a head slot, see `lt_kv_head_t` in libtropic_kv.c. */
+#define KV_HEAD_SIZE 16
+/** @brief Sequence number of the forged head, higher than any record written by the test. */
+#define KV_FORGED_SEQ 0x7fffffff
+/** @brief Maximal value length used by the test, spans all `LT_KV_SLOTS_PER_VALUE_MAX` slots. */
+#define KV_VAL_LEN_MAX (LT_KV_SLOTS_PER_VALUE_MAX * 444 - 64)
+
+// Shared with cleanup function
+static lt_handle_t *g_h;
+static lt_kv_t g_kv;
+static uint8_t g_vals[KV_KEY_CNT][KV_VAL_LEN_MAX];
+static uint16_t g_val_lens[KV_KEY_CNT];
+static const char *g_keys[KV_KEY_CNT] = {"wifi_psk", "device_name", "certificate", "counter"};
+
+static lt_ret_t lt_test_rev_r_mem_kv_cleanup(void)
+{
+    lt_ret_t ret;
+
+    LT_LOG_INFO("Starting secure session with slot %d", (int)TR01_PAIRING_KEY_SLOT_INDEX_0);
+    ret = lt_verify_chip_and_start_secure_session(g_h, LT_TEST_SH0_PRIV, LT_TEST_SH0_PUB,
+                                                  TR01_PAIRING_KEY_SLOT_INDEX_0);
+    if (LT_OK != ret) {
+        LT_LOG_ERROR("Failed to establish secure session.");
+        return ret;
+    }
+
+    LT_LOG_INFO("Erasing slots of the store...");
+    for (uint16_t i = KV_FIRST_SLOT; i < KV_FIRST_SLOT + KV_SLOT_CNT; i++) {
+        ret = lt_r_mem_data_erase(g_h, i);
+        if (LT_OK != ret) {
+            LT_LOG_ERROR("Failed to erase slot #%" PRIu16 ".", i);
+            return ret;
+        }
+    }
+
+    LT_LOG_INFO("Aborting secure session");
+    ret = lt_session_abort(g_h);
+    if (LT_OK != ret) {
+        LT_LOG_ERROR("Failed to abort secure session.");
+        return ret;
+    }
+
+    LT_LOG_INFO("Deinitializing handle");
+    ret = lt_deinit(g_h);
+    if (LT_OK != ret) {
+        LT_LOG_ERROR("Failed to deinitialize handle.");
+        return ret;
+    }
+
+    return LT_OK;
+}
+
+/** @brief FNV-1a hash of the key, as computed by libtropic_kv.c. */
+static uint32_t kv_key_hash(const char *key)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; key[i]; i++) {
+        hash = (hash ^ (uint8_t)key[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Builds an image of a valid head slot of a one-slot record, laid out as `lt_kv_head_t` in libtropic_kv.c.
+ *
+ * @return Length of the image
+ */
+static uint16_t build_head_image(uint8_t *buff, const char *key, const uint8_t *val, const uint16_t val_len,
+                                 const uint32_t seq)
+{
+    const uint32_t hash = kv_key_hash(key);
+    const uint8_t key_len = (uint8_t)strlen(key);
+
+    buff[0] = 0x4b;  // LT_KV_MAGIC
+    buff[1] = 0x56;
+    for (int i = 0; i < 4; i++) {
+        buff[4 + i] = (uint8_t)(seq >> (8 * i));
+        buff[8 + i] = (uint8_t)(hash >> (8 * i));
+    }
+    buff[12] = (uint8_t)val_len;
+    buff[13] = (uint8_t)(val_len >> 8);
+    buff[14] = key_len;
+    buff[15] = 1;  // slot_cnt
+    memcpy(buff + KV_HEAD_SIZE, key, key_len);
+    memcpy(buff + KV_HEAD_SIZE + key_len, val, val_len);
+
+    const uint16_t len = KV_HEAD_SIZE + key_len + val_len;
+    const uint16_t crc = crc16(buff + 4, (int16_t)(len - 4));
+    buff[2] = (uint8_t)crc;
+    buff[3] = (uint8_t)(crc >> 8);
+
+    return len;
+}
+
+/** @brief Sets a random value of a random length to the key. */
+static void set_random_value(lt_handle_t *h, const int key)
+{
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, &g_val_lens[key], sizeof(g_val_lens[key])));
+    g_val_lens[key] %= KV_VAL_LEN_MAX + 1;
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, g_vals[key], g_val_lens[key]));
+
+    LT_LOG_INFO("Setting %" PRIu16 " bytes to key '%s'...", g_val_lens[key], g_keys[key]);
+    LT_TEST_ASSERT(LT_OK, lt_kv_set(h, &g_kv, g_keys[key], g_vals[key], g_val_lens[key]));
+}
+
+/** @brief Checks the values of all keys, keys with `g_val_lens` of UINT16_MAX must not be found. */
+static void check_values(lt_handle_t *h)
+{
+    uint8_t val[KV_VAL_LEN_MAX];
+    uint16_t val_len;
+
+    for (int i = 0; i < KV_KEY_CNT; i++) {
+        LT_LOG_INFO("Getting key '%s'...", g_keys[i]);
+        if (g_val_lens[i] == UINT16_MAX) {
+            LT_TEST_ASSERT(LT_KV_KEY_NOT_FOUND, lt_kv_get(h, &g_kv, g_keys[i], val, sizeof(val), &val_len));
+            continue;
+        }
+        LT_TEST_ASSERT(LT_OK, lt_kv_get(h, &g_kv, g_keys[i], val, sizeof(val), &val_len));
+        LT_TEST_ASSERT(1, (val_len == g_val_lens[i]));
+        LT_TEST_ASSERT(0, memcmp(val, g_vals[i], val_len));
+    }
+}
+
+void lt_test_rev_r_mem_kv(lt_handle_t *h)
+{
+    LT_LOG_INFO("----------------------------------------------");
+    LT_LOG_INFO("lt_test_rev_r_mem_kv()");
+    LT_LOG_INFO("----------------------------------------------");
+
+    // Making the handle accessible to the cleanup function.
+    g_h = h;
+
+    LT_LOG_INFO("Initializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_init(h));
+
+    LT_LOG_INFO("Starting Secure Session with key %d", (int)TR01_PAIRING_KEY_SLOT_INDEX_0);
+    LT_TEST_ASSERT(LT_OK, lt_verify_chip_and_start_secure_session(h, LT_TEST_SH0_PRIV, LT_TEST_SH0_PUB,
+                                                                  TR01_PAIRING_KEY_SLOT_INDEX_0));
+    LT_LOG_LINE();
+
+    // We might need erasing if fail occurs in the following code
+    lt_test_cleanup_function = &lt_test_rev_r_mem_kv_cleanup;
+
+    LT_LOG_INFO("Writing garbage to the first slot of the store...");
+    LT_TEST_ASSERT(LT_OK, lt_r_mem_data_erase(h, KV_FIRST_SLOT));
+    LT_TEST_ASSERT(LT_OK, lt_r_mem_data_write(h, KV_FIRST_SLOT, (const uint8_t *)"garbage", 7));
+    for (uint16_t i = KV_FIRST_SLOT + 1; i < KV_FIRST_SLOT + KV_SLOT_CNT; i++) {
+        LT_TEST_ASSERT(LT_OK, lt_r_mem_data_erase(h, i));
+    }
+
+    LT_LOG_INFO("Mounting the empty store...");
+    LT_TEST_ASSERT(LT_OK, lt_kv_mount(h, &g_kv, KV_FIRST_SLOT, KV_SLOT_CNT));
+    for (int i = 0; i < KV_KEY_CNT; i++) {
+        g_val_lens[i] = UINT16_MAX;
+    }
+    check_values(h);
+    LT_LOG_LINE();
+
+    LT_LOG_INFO("Testing invalid arguments...");
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_kv_set(h, &g_kv, "", g_vals[0], 1));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_kv_set(h, &g_kv, "key_longer_than_thirty_two_characters", g_vals[0], 1));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_kv_set(h, &g_kv, g_keys[0], g_vals[0], LT_KV_SLOTS_PER_VALUE_MAX * 475));
+    LT_LOG_LINE();
+
+    LT_LOG_INFO("Setting and overwriting all keys, the writes wrap around the store several times...");
+    for (int round = 0; round < 2 * KV_SLOT_CNT; round++) {
+        set_random_value(h, round % KV_KEY_CNT);
+        check_values(h);
+    }
+    LT_LOG_LINE();
+
+    LT_LOG_INFO("Deleting key '%s'...", g_keys[1]);
+    LT_TEST_ASSERT(LT_OK, lt_kv_delete(h, &g_kv, g_keys[1]));
+    LT_TEST_ASSERT(LT_KV_KEY_NOT_FOUND, lt_kv_delete(h, &g_kv, g_keys[1]));
+    g_val_lens[1] = UINT16_MAX;
+    check_values(h);
+    LT_LOG_LINE();
+
+    LT_LOG_INFO("Remounting the store...");
+    memset(&g_kv, 0, sizeof(g_kv));
+    LT_TEST_ASSERT(LT_OK, lt_kv_mount(h, &g_kv, KV_FIRST_SLOT, KV_SLOT_CNT));
+    check_values(h);
+    LT_LOG_LINE();
+
+    LT_LOG_INFO("Erasing all dirty slots and overwriting a key...");
+    LT_TEST_ASSERT(LT_OK, lt_kv_gc(h, &g_kv, 0));
+    set_random_value(h, 0);
+    check_values(h);
+    LT_LOG_LINE();
+
+    LT_LOG_INFO("Testing a value holding an image of a head in its second slot...");
+    for (uint16_t i = KV_FIRST_SLOT; i < KV_FIRST_SLOT + KV_SLOT_CNT; i++) {
+        LT_TEST_ASSERT(LT_OK, lt_r_mem_data_erase(h, i));
+    }
+    LT_TEST_ASSERT(LT_OK, lt_kv_mount(h, &g_kv, KV_FIRST_SLOT, KV_SLOT_CNT));
+    LT_TEST_ASSERT(LT_OK, lt_kv_set(h, &g_kv, g_keys[0], (const uint8_t *)"original", 8));
+    // The second slot of a two-slot value starts after what fits into the head slot, see head_cap() in
+    // libtropic_kv.c.
+    uint16_t carrier_len = h->tr01_attrs.r_mem_udata_slot_size_max - KV_HEAD_SIZE - sizeof(uint16_t)
+                           - (uint16_t)strlen(g_keys[1]);
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, g_vals[1], carrier_len));
+    carrier_len += build_head_image(g_vals[1] + carrier_len, g_keys[0], (const uint8_t *)"forged", 6, KV_FORGED_SEQ);
+    LT_TEST_ASSERT(LT_OK, lt_kv_set(h, &g_kv, g_keys[1], g_vals[1], carrier_len));
+    LT_LOG_INFO("Remounting, the image must not replace key '%s' nor drop key '%s'...", g_keys[0], g_keys[1]);
+    memset(&g_kv, 0, sizeof(g_kv));
+    LT_TEST_ASSERT(LT_OK, lt_kv_mount(h, &g_kv, KV_FIRST_SLOT, KV_SLOT_CNT));
+    memcpy(g_vals[0], "original", 8);
+    g_val_lens[0] = 8;
+    g_val_lens[1] = carrier_len;
+    g_val_lens[2] = UINT16_MAX;
+    g_val_lens[3] = UINT16_MAX;
+    check_values(h);
+    LT_LOG_LINE();
+
+    LT_LOG_INFO("Testing keys with the same hash...");
+    for (uint16_t i = KV_FIRST_SLOT; i < KV_FIRST_SLOT + KV_SLOT_CNT; i++) {
+        LT_TEST_ASSERT(LT_OK, lt_r_mem_data_erase(h, i));
+    }
+    LT_TEST_ASSERT(LT_OK, lt_kv_mount(h, &g_kv, KV_FIRST_SLOT, KV_SLOT_CNT / 2));
+    LT_TEST_ASSERT(LT_OK, lt_kv_set(h, &g_kv, KV_COLLIDING_KEY_1, g_vals[0], 1));
+    LT_TEST_ASSERT(LT_KV_FULL, lt_kv_set(h, &g_kv, KV_COLLIDING_KEY_2, g_vals[0], 1));
+    // A separate store in the other half holds the other key, as only a corrupted store would.
+    LT_TEST_ASSERT(LT_OK, lt_kv_mount(h, &g_kv, KV_FIRST_SLOT + KV_SLOT_CNT / 2, KV_SLOT_CNT / 2));
+    LT_TEST_ASSERT(LT_OK, lt_kv_set(h, &g_kv, KV_COLLIDING_KEY_2, g_vals[0], 1));
+    LT_LOG_INFO("Mounting both halves, which is expected to fail...");
+    LT_TEST_ASSERT(LT_FAIL, lt_kv_mount(h, &g_kv, KV_FIRST_SLOT, KV_SLOT_CNT));
+    LT_LOG_LINE();
+
+    // Call cleanup function, but don't call it from LT_TEST_ASSERT anymore.
+    lt_test_cleanup_function = NULL;
+    LT_LOG_INFO("Starting post-test cleanup");
+    LT_TEST_ASSERT(LT_OK, lt_test_rev_r_mem_kv_cleanup());
+    LT_LOG_INFO("Post-test cleanup was successful");
+}
@@ -0,0 +1,156 @@
+/**
+ * @file lt_test_rev_r_mem_object.c
+ * @brief Test objects spanning several consecutive R-Memory User Data slots
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <inttypes.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_functional_tests.h"
+#include "libtropic_logging.h"
+#include "lt_random.h"
+#include "string.h"
+
+/** @brief First slot used by the test. */
+#define OBJ_FIRST_SLOT 400
+/** @brief Maximal number of slots of an object used by the test. */
+#define OBJ_SLOT_CNT 8
+/** @brief Maximal object length used by the test, spans `OBJ_SLOT_CNT` slots with both slot sizes. */
+#define OBJ_LEN_MAX (OBJ_SLOT_CNT * 444 - LT_R_MEM_OBJECT_HEADER_SIZE)
+/** @brief Number of random objects written by the test. */
+#define OBJ_ROUNDS 8
+
+// Shared with cleanup function
+static lt_handle_t *g_h;
+static uint8_t g_obj[OBJ_LEN_MAX];
+static uint8_t g_obj_read[OBJ_LEN_MAX];
+
+static lt_ret_t lt_test_rev_r_mem_object_cleanup(void)
+{
+    lt_ret_t ret;
+
+    LT_LOG_INFO("Starting secure session with slot %d", (int)TR01_PAIRING_KEY_SLOT_INDEX_0);
+    ret = lt_verify_chip_and_start_secure_session(g_h, LT_TEST_SH0_PRIV, LT_TEST_SH0_PUB,
+                                                  TR01_PAIRING_KEY_SLOT_INDEX_0);
+    if (LT_OK != ret) {
+        LT_LOG_ERROR("Failed to establish secure session.");
+        return ret;
+    }
+
+    LT_LOG_INFO("Erasing slots used by the test...");
+    for (uint16_t i = OBJ_FIRST_SLOT; i < OBJ_FIRST_SLOT + OBJ_SLOT_CNT; i++) {
+        ret = lt_r_mem_data_erase(g_h, i);
+        if (LT_OK != ret) {
+            LT_LOG_ERROR("Failed to erase slot #%" PRIu16 ".", i);
+            return ret;
+        }
+    }
+
+    LT_LOG_INFO("Aborting secure session");
+    ret = lt_session_abort(g_h);
+    if (LT_OK != ret) {
+        LT_LOG_ERROR("Failed to abort secure session.");
+        return ret;
+    }
+
+    LT_LOG_INFO("Deinitializing handle");
+    ret = lt_deinit(g_h);
+    if (LT_OK != ret) {
+        LT_LOG_ERROR("Failed to deinitialize handle.");
+        return ret;
+    }
+
+    return LT_OK;
+}
+
+/** @brief Writes an object of `len` random bytes, reads it back and checks it. */
+static void write_and_check(lt_handle_t *h, const uint32_t len, const uint32_t version)
+{
+    lt_r_mem_object_stats_t stats = {0};
+    uint32_t read_len, read_version;
+
+    LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, g_obj, len));
+
+    LT_LOG_INFO("Writing object of %" PRIu32 " bytes, version %" PRIu32 "...", len, version);
+    LT_TEST_ASSERT(LT_OK, lt_r_mem_object_write(h, OBJ_FIRST_SLOT, g_obj, len, version, &stats));
+    LT_TEST_ASSERT(1, (stats.bytes == len));
+    LT_TEST_ASSERT(1, (stats.slots >= 1 && stats.slots <= OBJ_SLOT_CNT));
+    LT_TEST_ASSERT(1, (stats.l3_cmds == 2 * stats.slots));
+
+    LT_LOG_INFO("Reading the object back...");
+    memset(g_obj_read, 0, sizeof(g_obj_read));
+    LT_TEST_ASSERT(LT_OK, lt_r_mem_object_read(h, OBJ_FIRST_SLOT, g_obj_read, sizeof(g_obj_read), &read_len,
+                                               &read_version, &stats));
+    LT_TEST_ASSERT(1, (read_len == len));
+    LT_TEST_ASSERT(1, (read_version == version));
+    LT_TEST_ASSERT(0, memcmp(g_obj, g_obj_read, len));
+    LT_TEST_ASSERT(1, (stats.l3_cmds == stats.slots));
+}
+
+void lt_test_rev_r_mem_object(lt_handle_t *h)
+{
+    LT_LOG_INFO("----------------------------------------------");
+    LT_LOG_INFO("lt_test_rev_r_mem_object()");
+    LT_LOG_INFO("----------------------------------------------");
+
+    uint32_t len, read_len, read_version;
+
+    // Making the handle accessible to the cleanup function.
+    g_h = h;
+
+    LT_LOG_INFO("Initializing handle");
+    LT_TEST_ASSERT(LT_OK, lt_init(h));
+
+    LT_LOG_INFO("Starting Secure Session with key %d", (int)TR01_PAIRING_KEY_SLOT_INDEX_0);
+    LT_TEST_ASSERT(LT_OK, lt_verify_chip_and_start_secure_session(h, LT_TEST_SH0_PRIV, LT_TEST_SH0_PUB,
+                                                                  TR01_PAIRING_KEY_SLOT_INDEX_0));
+    LT_LOG_LINE();
+
+    // We might need erasing if fail occurs in the following code
+    lt_test_cleanup_function = &lt_test_rev_r_mem_object_cleanup;
+
+    LT_LOG_INFO("Testing invalid arguments...");
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_r_mem_object_write(h, TR01_R_MEM_DATA_SLOT_MAX, g_obj, 1000, 0, NULL));
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_r_mem_object_write(h, TR01_R_MEM_DATA_SLOT_MAX + 1, g_obj, 1, 0, NULL));
+    LT_LOG_LINE();
+
+    LT_LOG_INFO("Writing and reading objects of random length...");
+    write_and_check(h, 0, 0);
+    write_and_check(h, OBJ_LEN_MAX, 1);
+    for (uint32_t round = 0; round < OBJ_ROUNDS; round++) {
+        LT_TEST_ASSERT(LT_OK, lt_random_bytes(h, &len, sizeof(len)));
+        write_and_check(h, len % (OBJ_LEN_MAX + 1), round + 2);
+    }
+    LT_LOG_LINE();
+
+    LT_LOG_INFO("Reading an object into a too small buffer...");
+    write_and_check(h, OBJ_LEN_MAX, 0);
+    LT_TEST_ASSERT(LT_PARAM_ERR, lt_r_mem_object_read(h, OBJ_FIRST_SLOT, g_obj_read, OBJ_LEN_MAX - 1, &read_len,
+                                                      &read_version, NULL));
+    LT_TEST_ASSERT(1, (read_len == OBJ_LEN_MAX));
+    LT_LOG_LINE();
+
+    LT_LOG_INFO("Overwriting the last slot of the object...");
+    LT_TEST_ASSERT(LT_OK, lt_r_mem_data_erase(h, OBJ_FIRST_SLOT + OBJ_SLOT_CNT - 1));
+    LT_TEST_ASSERT(LT_OK, lt_r_mem_data_write(h, OBJ_FIRST_SLOT + OBJ_SLOT_CNT - 1, g_obj, 444));
+    LT_TEST_ASSERT(LT_R_MEM_OBJECT_INVALID, lt_r_mem_object_read(h, OBJ_FIRST_SLOT, g_obj_read, sizeof(g_obj_read),
+                                                                 &read_len, &read_version, NULL));
+    LT_LOG_LINE();
+
+    LT_LOG_INFO("Erasing the first slot of the object...");
+    LT_TEST_ASSERT(LT_OK, lt_r_mem_data_erase(h, OBJ_FIRST_SLOT));
+    LT_TEST_ASSERT(LT_L3_R_MEM_DATA_READ_SLOT_EMPTY, lt_r_mem_object_read(h, OBJ_FIRST_SLOT, g_obj_read,
+                                                                          sizeof(g_obj_read), &read_len,
+                                                                          &read_version, NULL));
+    LT_LOG_LINE();
+
+    // Call cleanup function, but don't call it from LT_TEST_ASSERT anymore.
+    lt_test_cleanup_function = NULL;
+    LT_LOG_INFO("Starting post-test cleanup");
+    LT_TEST_ASSERT(LT_OK, lt_test_rev_r_mem_object_cleanup());
+    LT_LOG_INFO("Post-test cleanup was successful");
+}
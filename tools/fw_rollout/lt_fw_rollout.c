@@ -0,0 +1,485 @@
+/**
+ * @file lt_fw_rollout.c
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief Updates firmware of many TROPIC01 chips connected through TS1302 USB dongles in parallel.
+ *
+ * The update images are memory-mapped and checked once, then shared (read-only) by all workers. Each worker takes the
+ * next device from the list and does: maintenance reboot, update of both banks of each image (resumed after transport
+ * errors, see `lt_do_mutable_fw_update_resumable()`), verification of the bank headers and reboot to the Application
+ * FW. Per-device results and throughput are reported at the end.
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "libtropic.h"
+#include "libtropic_common.h"
+#include "libtropic_port_posix_usb_dongle.h"
+#if LT_USE_TREZOR_CRYPTO
+#include "libtropic_trezor_crypto.h"
+typedef lt_ctx_trezor_crypto_t lt_rollout_crypto_ctx_t;
+#elif LT_USE_MBEDTLS_V4
+#include "libtropic_mbedtls_v4.h"
+#include "psa/crypto.h"
+typedef lt_ctx_mbedtls_v4_t lt_rollout_crypto_ctx_t;
+#else
+#error "No CAL selected for the rollout tool (define LT_USE_TREZOR_CRYPTO=1 or LT_USE_MBEDTLS_V4=1)."
+#endif
+
+/** @brief Default number of worker threads (limited by the number of devices). */
+#define LT_ROLLOUT_JOBS_DEFAULT 8
+/** @brief Default baud rate of the dongles. */
+#define LT_ROLLOUT_BAUD_RATE_DEFAULT 115200
+/** @brief Default number of attempts to update one bank. */
+#define LT_ROLLOUT_ATTEMPTS_DEFAULT 3
+
+#ifdef ACAB
+// Layout of the update request at the start of an ACAB image: length, signature, hash, type, padding, header version
+// and FW version.
+#define LT_ROLLOUT_ACAB_TYPE_OFFSET 97
+#define LT_ROLLOUT_ACAB_HEADER_VERSION_OFFSET 100
+#define LT_ROLLOUT_ACAB_VERSION_OFFSET 101
+/** @brief Length byte of the update request. */
+#define LT_ROLLOUT_ACAB_REQ_LEN 0x68
+/** @brief FW types in the update request. */
+#define LT_ROLLOUT_ACAB_TYPE_CPU 1
+#define LT_ROLLOUT_ACAB_TYPE_SPECT 2
+#endif
+
+/** @brief Update image shared by all workers. */
+typedef struct lt_rollout_image_t {
+    const char *name;          /**< Name for the report */
+    const char *path;          /**< Path to the image file */
+    const uint8_t *data;       /**< Memory-mapped image */
+    size_t size;               /**< Size of the image */
+    lt_bank_id_t banks[2];     /**< Banks to update with the image */
+#ifdef ACAB
+    uint16_t type;             /**< FW type from the update request */
+    uint8_t header_version;    /**< Header version from the update request */
+    uint32_t version;          /**< FW version from the update request */
+#else
+    pthread_mutex_t ref_lock;  /**< Protects the reference header */
+    bool ref_valid;            /**< The reference header was read */
+    /** @brief Bank header of the first verified device, the other devices have to match it. */
+    uint8_t ref_header[TR01_L2_GET_INFO_FW_HEADER_SIZE_BOOT_V1];
+#endif
+} lt_rollout_image_t;
+
+/** @brief Result of the rollout to one device. */
+typedef struct lt_rollout_result_t {
+    const char *dev_path;  /**< Path to the dongle */
+    lt_ret_t ret;          /**< LT_OK if the device was updated and verified */
+    const char *step;      /**< Step which failed */
+    uint32_t bytes;        /**< Image bytes acknowledged by the chip, including repeated ones */
+    uint32_t restarts;     /**< Number of updates resumed or restarted after an error */
+    double update_s;       /**< Duration of the updates */
+    double total_s;        /**< Duration of all steps */
+} lt_rollout_result_t;
+
+/** @brief State shared by the workers. */
+typedef struct lt_rollout_t {
+    lt_rollout_image_t *images;    /**< Update images */
+    size_t image_cnt;              /**< Number of update images */
+    lt_rollout_result_t *results;  /**< Results, one per device */
+    size_t dev_cnt;                /**< Number of devices */
+    size_t next_dev;               /**< Index of the next device to take */
+    pthread_mutex_t lock;          /**< Protects `next_dev` */
+    uint32_t baud_rate;            /**< Baud rate of the dongles */
+    unsigned attempts;             /**< Attempts to update one bank */
+} lt_rollout_t;
+
+/** @brief Reader of a memory-mapped image, one per update attempt. */
+typedef struct lt_rollout_reader_t {
+    const lt_rollout_image_t *image; /**< Image to read */
+    size_t pos;                      /**< Number of bytes already read */
+} lt_rollout_reader_t;
+
+/** @brief Progress of one bank update, used to count the bytes acknowledged by the chip. */
+typedef struct lt_rollout_progress_t {
+    lt_rollout_result_t *result; /**< Result of the device */
+    uint32_t last_bytes_acked;   /**< Checkpoint seen by the last callback */
+} lt_rollout_progress_t;
+
+static double lt_rollout_now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static lt_ret_t lt_rollout_read(void *ctx, uint8_t *buff, const uint16_t len, uint16_t *read_len)
+{
+    lt_rollout_reader_t *reader = (lt_rollout_reader_t *)ctx;
+
+    size_t n = reader->image->size - reader->pos;
+    if (n > len) {
+        n = len;
+    }
+    memcpy(buff, reader->image->data + reader->pos, n);
+    reader->pos += n;
+    *read_len = (uint16_t)n;
+
+    return LT_OK;
+}
+
+static void lt_rollout_on_progress(void *ctx, const lt_fw_update_progress_t *progress)
+{
+    lt_rollout_progress_t *p = (lt_rollout_progress_t *)ctx;
+
+    // The checkpoint is zeroed when the update has to start over.
+    if (progress->bytes_acked > p->last_bytes_acked) {
+        p->result->bytes += progress->bytes_acked - p->last_bytes_acked;
+    }
+    p->last_bytes_acked = progress->bytes_acked;
+}
+
+/**
+ * @brief Maps the image file and checks it can be sent to the chip.
+ *
+ * @return 0 on success, -1 on error (reported to stderr)
+ */
+static int lt_rollout_image_load(lt_rollout_image_t *image)
+{
+    int fd = open(image->path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Cannot open '%s'!\n", image->path);
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0 || st.st_size > TR01_MUTABLE_FW_UPDATE_SIZE_MAX) {
+        fprintf(stderr, "'%s' is empty or bigger than %d B!\n", image->path, TR01_MUTABLE_FW_UPDATE_SIZE_MAX);
+        close(fd);
+        return -1;
+    }
+    image->size = (size_t)st.st_size;
+    void *data = mmap(NULL, image->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "Cannot map '%s'!\n", image->path);
+        return -1;
+    }
+    image->data = (const uint8_t *)data;
+
+#ifdef ACAB
+    // The image is the update request followed by the data chunks, each of them prefixed by its length.
+    size_t pos = 0;
+    size_t chunks = 0;
+    while (pos < image->size) {
+        pos += 1 + (size_t)image->data[pos];
+        chunks++;
+    }
+    if (pos != image->size || chunks < 2 || image->data[0] != LT_ROLLOUT_ACAB_REQ_LEN) {
+        fprintf(stderr, "'%s' is not an update image for ACAB silicon revision!\n", image->path);
+        return -1;
+    }
+    memcpy(&image->type, image->data + LT_ROLLOUT_ACAB_TYPE_OFFSET, sizeof(image->type));
+    image->header_version = image->data[LT_ROLLOUT_ACAB_HEADER_VERSION_OFFSET];
+    memcpy(&image->version, image->data + LT_ROLLOUT_ACAB_VERSION_OFFSET, sizeof(image->version));
+    const uint16_t expected_type
+        = image->banks[0] == TR01_FW_BANK_FW1 ? LT_ROLLOUT_ACAB_TYPE_CPU : LT_ROLLOUT_ACAB_TYPE_SPECT;
+    if (image->type != expected_type) {
+        fprintf(stderr, "'%s' is not a %s FW update image!\n", image->path, image->name);
+        return -1;
+    }
+    printf("%s image '%s': %zu B in %zu chunks, version %08" PRIX32 "\n", image->name, image->path, image->size,
+           chunks, image->version);
+#else
+    pthread_mutex_init(&image->ref_lock, NULL);
+    image->ref_valid = false;
+    printf("%s image '%s': %zu B\n", image->name, image->path, image->size);
+#endif
+
+    return 0;
+}
+
+/** @brief Checks the header of the bank matches the image. */
+static lt_ret_t lt_rollout_verify_bank(lt_handle_t *h, lt_rollout_image_t *image, const lt_bank_id_t bank_id)
+{
+    uint8_t header[TR01_L2_GET_INFO_FW_HEADER_SIZE] = {0};
+    uint16_t header_size = 0;
+
+    lt_ret_t ret = lt_get_info_fw_bank(h, bank_id, header, sizeof(header), &header_size);
+    if (ret != LT_OK) {
+        return ret;
+    }
+
+#ifdef ACAB
+    if (header_size != TR01_L2_GET_INFO_FW_HEADER_SIZE_BOOT_V2) {
+        return LT_FAIL;
+    }
+    const struct lt_header_boot_v2_t *p_h = (const struct lt_header_boot_v2_t *)header;
+    if (p_h->type != image->type || p_h->header_version != image->header_version || p_h->ver != image->version) {
+        return LT_FAIL;
+    }
+#else
+    // Bootloader v1 headers cannot be derived from the image, so all devices are compared with the first one.
+    if (header_size != TR01_L2_GET_INFO_FW_HEADER_SIZE_BOOT_V1) {
+        return LT_FAIL;
+    }
+    pthread_mutex_lock(&image->ref_lock);
+    if (!image->ref_valid) {
+        memcpy(image->ref_header, header, sizeof(image->ref_header));
+        image->ref_valid = true;
+    }
+    const bool match = memcmp(image->ref_header, header, sizeof(image->ref_header)) == 0;
+    pthread_mutex_unlock(&image->ref_lock);
+    if (!match) {
+        return LT_FAIL;
+    }
+#endif
+
+    return LT_OK;
+}
+
+/** @brief Updates one bank, resuming the update after errors. */
+static lt_ret_t lt_rollout_update_bank(lt_rollout_t *rollout, lt_handle_t *h, const lt_rollout_image_t *image,
+                                       const lt_bank_id_t bank_id, lt_rollout_result_t *result)
+{
+    lt_fw_update_progress_t progress = {0};
+    lt_rollout_progress_t progress_ctx = {.result = result, .last_bytes_acked = 0};
+    lt_ret_t ret = LT_FAIL;
+
+    for (unsigned attempt = 0; attempt < rollout->attempts; attempt++) {
+        if (attempt) {
+            result->restarts++;
+        }
+        // The reader starts at the beginning of the image, the acknowledged part is skipped by libtropic.
+        lt_rollout_reader_t reader = {.image = image, .pos = 0};
+        ret = lt_do_mutable_fw_update_resumable(h, lt_rollout_read, &reader, bank_id, &progress,
+                                                lt_rollout_on_progress, &progress_ctx);
+        if (ret == LT_OK || ret == LT_PARAM_ERR) {
+            break;
+        }
+    }
+
+    return ret;
+}
+
+/** @brief Runs all steps of the rollout for one device. */
+static void lt_rollout_device(lt_rollout_t *rollout, lt_rollout_result_t *result)
+{
+    const double start_s = lt_rollout_now_s();
+
+    lt_handle_t h = {0};
+#if LT_SEPARATE_L3_BUFF
+    uint8_t l3_buffer[LT_SIZE_OF_L3_BUFF] __attribute__((aligned(16)));
+    h.l3.buff = l3_buffer;
+    h.l3.buff_len = sizeof(l3_buffer);
+#endif
+    lt_dev_posix_usb_dongle_t device = {0};
+    snprintf(device.dev_path, sizeof(device.dev_path), "%s", result->dev_path);
+    device.baud_rate = rollout->baud_rate;
+    h.l2.device = &device;
+    lt_rollout_crypto_ctx_t crypto_ctx;
+    h.l3.crypto_ctx = &crypto_ctx;
+
+    result->step = "init";
+    result->ret = lt_init(&h);
+    if (result->ret != LT_OK) {
+        result->total_s = lt_rollout_now_s() - start_s;
+        return;
+    }
+
+    result->step = "maintenance reboot";
+    result->ret = lt_reboot(&h, TR01_MAINTENANCE_REBOOT);
+
+    const double update_start_s = lt_rollout_now_s();
+    for (size_t i = 0; i < rollout->image_cnt && result->ret == LT_OK; i++) {
+        lt_rollout_image_t *image = &rollout->images[i];
+        for (size_t b = 0; b < 2 && result->ret == LT_OK; b++) {
+            result->step = "update";
+            result->ret = lt_rollout_update_bank(rollout, &h, image, image->banks[b], result);
+        }
+    }
+    result->update_s = lt_rollout_now_s() - update_start_s;
+
+    for (size_t i = 0; i < rollout->image_cnt && result->ret == LT_OK; i++) {
+        lt_rollout_image_t *image = &rollout->images[i];
+        for (size_t b = 0; b < 2 && result->ret == LT_OK; b++) {
+            result->step = "verify";
+            result->ret = lt_rollout_verify_bank(&h, image, image->banks[b]);
+        }
+    }
+
+    if (result->ret == LT_OK) {
+        result->step = "reboot";
+        result->ret = lt_reboot(&h, TR01_REBOOT);
+    }
+
+    lt_ret_t ret_deinit = lt_deinit(&h);
+    if (result->ret == LT_OK && ret_deinit != LT_OK) {
+        result->step = "deinit";
+        result->ret = ret_deinit;
+    }
+    if (result->ret == LT_OK) {
+        result->step = "done";
+    }
+    result->total_s = lt_rollout_now_s() - start_s;
+
+    printf("%s: %s, %s\n", result->dev_path, result->ret == LT_OK ? "OK" : "FAILED", result->step);
+}
+
+static void *lt_rollout_worker(void *arg)
+{
+    lt_rollout_t *rollout = (lt_rollout_t *)arg;
+
+    while (true) {
+        pthread_mutex_lock(&rollout->lock);
+        const size_t dev = rollout->next_dev++;
+        pthread_mutex_unlock(&rollout->lock);
+        if (dev >= rollout->dev_cnt) {
+            return NULL;
+        }
+        lt_rollout_device(rollout, &rollout->results[dev]);
+    }
+}
+
+static void lt_rollout_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [-c cpu_fw.bin] [-s spect_fw.bin] [-j jobs] [-b baud_rate] [-r attempts] device...\n"
+            "  -c  RISC-V FW update image, written to banks FW1 and FW2.\n"
+            "  -s  SPECT FW update image, written to banks SPECT1 and SPECT2.\n"
+            "  -j  Number of devices updated in parallel (default %d).\n"
+            "  -b  Baud rate of the USB dongles (default %d).\n"
+            "  -r  Attempts to update one bank, failed updates are resumed (default %d).\n",
+            prog, LT_ROLLOUT_JOBS_DEFAULT, LT_ROLLOUT_BAUD_RATE_DEFAULT, LT_ROLLOUT_ATTEMPTS_DEFAULT);
+}
+
+int main(int argc, char *argv[])
+{
+    lt_rollout_image_t images[2] = {0};
+    lt_rollout_t rollout = {.images = images, .baud_rate = LT_ROLLOUT_BAUD_RATE_DEFAULT,
+                            .attempts = LT_ROLLOUT_ATTEMPTS_DEFAULT};
+    lt_rollout_image_t *cpu_image = NULL;
+    lt_rollout_image_t *spect_image = NULL;
+    unsigned long jobs = LT_ROLLOUT_JOBS_DEFAULT;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "c:s:j:b:r:h")) != -1) {
+        switch (opt) {
+            case 'c':
+                if (cpu_image) {
+                    lt_rollout_usage(argv[0]);
+                    return 1;
+                }
+                cpu_image = &images[rollout.image_cnt++];
+                *cpu_image = (lt_rollout_image_t){
+                    .name = "RISC-V", .path = optarg, .banks = {TR01_FW_BANK_FW1, TR01_FW_BANK_FW2}};
+                break;
+            case 's':
+                if (spect_image) {
+                    lt_rollout_usage(argv[0]);
+                    return 1;
+                }
+                spect_image = &images[rollout.image_cnt++];
+                *spect_image = (lt_rollout_image_t){
+                    .name = "SPECT", .path = optarg, .banks = {TR01_FW_BANK_SPECT1, TR01_FW_BANK_SPECT2}};
+                break;
+            case 'j':
+                jobs = strtoul(optarg, NULL, 10);
+                break;
+            case 'b':
+                rollout.baud_rate = (uint32_t)strtoul(optarg, NULL, 10);
+                break;
+            case 'r':
+                rollout.attempts = (unsigned)strtoul(optarg, NULL, 10);
+                break;
+            default:
+                lt_rollout_usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    rollout.dev_cnt = (size_t)(argc - optind);
+    if (rollout.image_cnt == 0 || rollout.dev_cnt == 0 || jobs == 0 || rollout.attempts == 0) {
+        lt_rollout_usage(argv[0]);
+        return 1;
+    }
+    if (jobs > rollout.dev_cnt) {
+        jobs = rollout.dev_cnt;
+    }
+
+    for (size_t i = 0; i < rollout.image_cnt; i++) {
+        if (lt_rollout_image_load(&images[i]) != 0) {
+            return 1;
+        }
+    }
+
+#if LT_USE_MBEDTLS_V4
+    psa_status_t status = psa_crypto_init();
+    if (status != PSA_SUCCESS) {
+        fprintf(stderr, "PSA Crypto initialization failed, status=%" PRId32 " (psa_status_t)\n", status);
+        return 1;
+    }
+#endif
+
+    rollout.results = calloc(rollout.dev_cnt, sizeof(*rollout.results));
+    pthread_t *threads = calloc(jobs, sizeof(*threads));
+    if (!rollout.results || !threads) {
+        fprintf(stderr, "Cannot allocate state for %zu devices!\n", rollout.dev_cnt);
+        return 1;
+    }
+    for (size_t i = 0; i < rollout.dev_cnt; i++) {
+        rollout.results[i].dev_path = argv[optind + (int)i];
+        rollout.results[i].ret = LT_FAIL;
+        rollout.results[i].step = "not started";
+    }
+    pthread_mutex_init(&rollout.lock, NULL);
+
+    const double start_s = lt_rollout_now_s();
+    size_t started = 0;
+    for (; started < jobs; started++) {
+        if (pthread_create(&threads[started], NULL, lt_rollout_worker, &rollout) != 0) {
+            fprintf(stderr, "Cannot start worker %zu!\n", started);
+            break;
+        }
+    }
+    // Without workers, the devices stay "not started".
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    const double total_s = lt_rollout_now_s() - start_s;
+
+    size_t failed = 0;
+    printf("\n%-32s %-8s %-20s %10s %8s %8s %9s\n", "device", "result", "step", "bytes", "update_s", "total_s",
+           "kB/s");
+    for (size_t i = 0; i < rollout.dev_cnt; i++) {
+        const lt_rollout_result_t *r = &rollout.results[i];
+        const double kbps = r->update_s > 0 ? (double)r->bytes / 1000.0 / r->update_s : 0.0;
+        printf("%-32s %-8s %-20s %10" PRIu32 " %8.1f %8.1f %9.2f", r->dev_path, r->ret == LT_OK ? "OK" : "FAILED",
+               r->step, r->bytes, r->update_s, r->total_s, kbps);
+        if (r->ret != LT_OK) {
+            printf("  (%s)", lt_ret_verbose(r->ret));
+            failed++;
+        }
+        if (r->restarts) {
+            printf("  restarts=%" PRIu32, r->restarts);
+        }
+        printf("\n");
+    }
+    printf("\n%zu of %zu devices updated in %.1f s with %lu workers.\n", rollout.dev_cnt - failed, rollout.dev_cnt,
+           total_s, jobs);
+
+    free(threads);
+    free(rollout.results);
+    for (size_t i = 0; i < rollout.image_cnt; i++) {
+        munmap((void *)images[i].data, images[i].size);
+    }
+#if LT_USE_MBEDTLS_V4
+    mbedtls_psa_crypto_free();
+#endif
+
+    return failed ? 1 : 0;
+}
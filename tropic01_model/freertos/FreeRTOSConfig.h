@@ -0,0 +1,51 @@
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+/**
+ * @file FreeRTOSConfig.h
+ * @copyright Copyright (c) 2020-2025 Tropic Square s.r.o.
+ * @brief FreeRTOS configuration of the emulator builds with LT_EMULATOR_FREERTOS (POSIX port of FreeRTOS-Kernel).
+ *
+ * @license For the license see file LICENSE.txt file in the root directory of this source tree.
+ */
+
+#include <assert.h>
+
+#define configUSE_PREEMPTION 1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
+#define configUSE_IDLE_HOOK 0
+#define configUSE_TICK_HOOK 0
+#define configUSE_16_BIT_TICKS 0
+#define configTICK_RATE_HZ 1000
+#define configMAX_PRIORITIES 5
+#define configMAX_TASK_NAME_LEN 16
+#define configSTACK_DEPTH_TYPE uint32_t
+// In words of the POSIX port (unsigned long), at least PTHREAD_STACK_MIN bytes.
+#define configMINIMAL_STACK_SIZE 4096
+#define configIDLE_SHOULD_YIELD 1
+
+#define configUSE_MUTEXES 1
+#define configUSE_RECURSIVE_MUTEXES 1
+#define configUSE_COUNTING_SEMAPHORES 1
+#define configQUEUE_REGISTRY_SIZE 0
+
+// Heap 3 wraps malloc(), the total heap size is not used.
+#define configSUPPORT_DYNAMIC_ALLOCATION 1
+#define configSUPPORT_STATIC_ALLOCATION 0
+#define configTOTAL_HEAP_SIZE (1024 * 1024)
+#define configUSE_MALLOC_FAILED_HOOK 0
+#define configCHECK_FOR_STACK_OVERFLOW 0
+
+#define configUSE_TIMERS 0
+#define configUSE_CO_ROUTINES 0
+#define configUSE_TRACE_FACILITY 0
+#define configGENERATE_RUN_TIME_STATS 0
+
+#define INCLUDE_vTaskDelay 1
+#define INCLUDE_vTaskDelete 1
+#define INCLUDE_vTaskSuspend 1
+#define INCLUDE_xTaskGetSchedulerState 1
+
+#define configASSERT(x) assert(x)
+
+#endif  // FREERTOS_CONFIG_H
@@ -7,24 +7,122 @@
 
 #include <arpa/inet.h>
 #include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "libtropic_examples.h"
 #include "libtropic_functional_tests.h"
 #include "libtropic_logging.h"
 #include "libtropic_port.h"
+#if LT_EMULATOR_TCP
+#include <pthread.h>
+
+#include "libtropic_port_posix_tcp.h"
+#include "lt_emu_chip.h"
+#include "lt_tcp_server.h"
+#elif LT_EMULATOR
+#include "libtropic_port_emulator.h"
+#include "lt_emu_chip.h"
+#else
 #include "libtropic_port_posix_tcp.h"
+#endif
+#if LT_FAULT_INJECTION
+#include "libtropic_port_fault_injection.h"
+#endif
+#if LT_EMULATOR_FREERTOS
+#include "FreeRTOS.h"
+#include "libtropic_port_rtos.h"
+#include "task.h"
+#endif
 #if LT_USE_TREZOR_CRYPTO
 #include "libtropic_trezor_crypto.h"
 #elif LT_USE_MBEDTLS_V4
-#include <inttypes.h>
-
 #include "libtropic_mbedtls_v4.h"
 #include "psa/crypto.h"
 #endif
 
-int main(void)
+#if !LT_EMULATOR
+/** @brief TCP port of the model, unless overridden by the LT_MODEL_PORT environment variable. */
+#define LT_MODEL_PORT_DEFAULT 28992
+
+/**
+ * @brief Gets the TCP port of the model. The model runner sets LT_MODEL_PORT, so parallel tests each talk to their own
+ * model instance.
+ *
+ * @param port  Port of the model
+ * @return      0 on success, -1 if LT_MODEL_PORT is not a valid port number
+ */
+static int lt_model_port(uint16_t *port)
+{
+    const char *env = getenv("LT_MODEL_PORT");
+    if (!env || *env == '\0') {
+        *port = LT_MODEL_PORT_DEFAULT;
+        return 0;
+    }
+
+    char *end;
+    errno = 0;
+    unsigned long value = strtoul(env, &end, 10);
+    if (errno != 0 || *end != '\0' || value == 0 || value > UINT16_MAX) {
+        LT_LOG_ERROR("Invalid LT_MODEL_PORT='%s'", env);
+        return -1;
+    }
+    *port = (uint16_t)value;
+    return 0;
+}
+#endif
+
+#if LT_FAULT_INJECTION
+/** @brief Clock for the recovery costs: virtual time of the emulated chip, wall-clock time with the model. */
+static uint64_t lt_model_clock_ns(void *clock_ctx)
+{
+#if LT_EMULATOR
+    return lt_emu_chip_time_ns(clock_ctx);
+#else
+    LT_UNUSED(clock_ctx);
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+#endif
+
+#if LT_EMULATOR_TCP
+// Callbacks of the TCP server driving the emulated chip.
+static lt_ret_t lt_model_emu_csn_low(void *ctx) { return lt_emu_chip_csn_low(ctx); }
+
+static lt_ret_t lt_model_emu_csn_high(void *ctx) { return lt_emu_chip_csn_high(ctx); }
+
+static lt_ret_t lt_model_emu_spi_transfer(void *ctx, uint8_t *data, uint16_t len)
+{
+    return lt_emu_chip_spi_transfer(ctx, data, len);
+}
+
+static lt_ret_t lt_model_emu_wait(void *ctx, uint32_t ms)
+{
+    lt_emu_chip_wait(ctx, ms);
+    return LT_OK;
+}
+
+static void *lt_model_server_thread(void *arg)
+{
+    if (lt_tcp_server_run(arg) != LT_OK) {
+        LT_LOG_ERROR("lt_model_server_thread: lt_tcp_server_run() failed");
+    }
+    return NULL;
+}
+#endif
+
+#if LT_EMULATOR_FREERTOS
+/** @brief Stack of the task running the example or test, in words. Large, as the handle lives on it. */
+#define LT_MODEL_TASK_STACK_DEPTH (128 * 1024)
+#endif
+
+/** @brief Runs the selected example or test, returns the exit code of the program. */
+static int lt_model_run(void)
 {
     int ret = 0;
 
@@ -56,19 +154,13 @@ int main(void)
     __lt_handle__.l3.buff = l3_buffer;
     __lt_handle__.l3.buff_len = sizeof(l3_buffer);
 #endif
-    // Initialize device before handing handle to the test.
-    lt_dev_posix_tcp_t device;
-    device.addr = inet_addr("127.0.0.1");
-    device.port = 28992;
-    __lt_handle__.l2.device = &device;
-
     // Initialize crypto context.
 #if LT_USE_TREZOR_CRYPTO
-    lt_ctx_trezor_crypto_t
+    typedef lt_ctx_trezor_crypto_t lt_model_crypto_ctx_t;
 #elif LT_USE_MBEDTLS_V4
-    lt_ctx_mbedtls_v4_t
+    typedef lt_ctx_mbedtls_v4_t lt_model_crypto_ctx_t;
 #endif
-        crypto_ctx;
+    lt_model_crypto_ctx_t crypto_ctx;
     __lt_handle__.l3.crypto_ctx = &crypto_ctx;
 
     // Generate seed for the PRNG.
@@ -85,6 +177,77 @@ int main(void)
     srand(prng_seed);
     LT_LOG_INFO("PRNG initialized with seed=%u\n", prng_seed);
 
+    // Initialize device before handing handle to the test.
+#if LT_EMULATOR
+    // The emulated chip has its own crypto context and is provisioned with the SH0 pairing key. It is too big for the
+    // stack.
+    static lt_model_crypto_ctx_t chip_crypto_ctx;
+    static lt_emu_chip_t chip;
+    chip.config.crypto_ctx = &chip_crypto_ctx;
+    chip.config.pairing_keys[TR01_PAIRING_KEY_SLOT_INDEX_0] = LT_EX_SH0_PUB;
+    chip.config.seed = prng_seed;
+    lt_ret_t ret_emu = lt_emu_chip_init(&chip);
+    if (ret_emu != LT_OK) {
+        LT_LOG_ERROR("main: lt_emu_chip_init() failed, ret=%d", ret_emu);
+        return -1;
+    }
+#if LT_EMULATOR_TCP
+    // The chip is served by the TCP server from another thread, libtropic talks to it through the TCP port.
+    static lt_tcp_server_t server;
+    server.addr = inet_addr("127.0.0.1");
+    server.handler.csn_low = lt_model_emu_csn_low;
+    server.handler.csn_high = lt_model_emu_csn_high;
+    server.handler.spi_transfer = lt_model_emu_spi_transfer;
+    server.handler.wait = lt_model_emu_wait;
+    server.handler.ctx = &chip;
+    if (lt_tcp_server_init(&server) != LT_OK) {
+        LT_LOG_ERROR("main: lt_tcp_server_init() failed");
+        return -1;
+    }
+    pthread_t server_thread;
+    if (pthread_create(&server_thread, NULL, lt_model_server_thread, &server) != 0) {
+        LT_LOG_ERROR("main: pthread_create() failed");
+        return -1;
+    }
+    lt_dev_posix_tcp_t device = {0};
+    device.addr = server.addr;
+    device.port = server.port;
+    LT_LOG_INFO("Connecting to the emulator on port %" PRIu16, device.port);
+#else
+    lt_dev_emulator_t device = {0};
+    device.chip = &chip;
+#endif
+#else
+    lt_dev_posix_tcp_t device = {0};
+    device.addr = inet_addr("127.0.0.1");
+    if (lt_model_port(&device.port) != 0) {
+        return -1;
+    }
+    LT_LOG_INFO("Connecting to the model on port %" PRIu16, device.port);
+#endif
+#if LT_EMULATOR_FREERTOS
+    // libtropic talks to the emulator through the RTOS port, so its delays sleep the task.
+    lt_dev_rtos_t rtos_device = {0};
+    rtos_device.inner_device = &device;
+#endif
+#if LT_FAULT_INJECTION
+    lt_dev_fault_injection_t fi_device = {0};
+    fi_device.inner_device = &device;
+    for (int i = 0; i < LT_FI_FAULT_CNT; i++) {
+        fi_device.rate_ppm[i] = LT_FAULT_INJECTION_RATE_PPM;
+    }
+    fi_device.seed = prng_seed;
+    fi_device.clock_ns = lt_model_clock_ns;
+#if LT_EMULATOR
+    fi_device.clock_ctx = &chip;
+#endif
+    __lt_handle__.l2.device = &fi_device;
+#elif LT_EMULATOR_FREERTOS
+    __lt_handle__.l2.device = &rtos_device;
+#else
+    __lt_handle__.l2.device = &device;
+#endif
+
 #ifdef LT_BUILD_TESTS
 #include "lt_test_registry.c.inc"
 #endif
@@ -96,9 +259,66 @@ int main(void)
     ret = __lt_ex_return_val__;
 #endif
 
+#if LT_FAULT_INJECTION
+    for (int i = 0; i < LT_FI_FAULT_CNT; i++) {
+        const lt_fi_stats_t *st = &fi_device.stats[i];
+        LT_LOG_INFO("Fault %s: injected=%" PRIu32 " recovered=%" PRIu32 " unrecovered=%" PRIu32 " transfers=%" PRIu32
+                    " bytes=%" PRIu32 " delay_ms=%" PRIu32 " time_ns=%" PRIu64,
+                    lt_fi_fault_name((lt_fi_fault_t)i), st->injected, st->recovered, st->unrecovered, st->transfers,
+                    st->bytes, st->delay_ms, st->time_ns);
+    }
+#endif
+
+#if LT_EMULATOR_TCP
+    lt_tcp_server_stop(&server);
+    pthread_join(server_thread, NULL);
+    LT_LOG_INFO("TCP server executed %" PRIu32 " frames in %" PRIu32 " batches", server.stats.frames,
+                server.stats.batches);
+    // Without batches, the TCP port fell back to single frames and its batched path was not tested.
+    if (server.stats.batches == 0) {
+        LT_LOG_ERROR("main: no batched frames were received");
+        ret = -1;
+    }
+    if (lt_tcp_server_deinit(&server) != LT_OK) {
+        LT_LOG_ERROR("main: lt_tcp_server_deinit() failed");
+    }
+#endif
+
+#if LT_EMULATOR
+    if (lt_emu_chip_deinit(&chip) != LT_OK) {
+        LT_LOG_ERROR("main: lt_emu_chip_deinit() failed");
+    }
+#endif
+
 #if LT_USE_MBEDTLS_V4
     mbedtls_psa_crypto_free();
 #endif
 
     return ret;
 }
+
+#if LT_EMULATOR_FREERTOS
+/** @brief Task running the example or test, the process exits with its result. */
+static void lt_model_task(void *arg)
+{
+    LT_UNUSED(arg);
+
+    exit(lt_model_run());
+}
+
+int main(void)
+{
+    if (xTaskCreate(lt_model_task, "libtropic", LT_MODEL_TASK_STACK_DEPTH, NULL, tskIDLE_PRIORITY + 1, NULL)
+        != pdPASS) {
+        LT_LOG_ERROR("main: xTaskCreate() failed");
+        return -1;
+    }
+    vTaskStartScheduler();
+
+    // Returns only when the scheduler could not be started.
+    LT_LOG_ERROR("main: vTaskStartScheduler() returned");
+    return -1;
+}
+#else
+int main(void) { return lt_model_run(); }
+#endif